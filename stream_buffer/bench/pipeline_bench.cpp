@@ -0,0 +1,658 @@
+// End-to-end throughput, loss and latency of the receive/decode pipeline
+//
+// A sender stamps every I080 packet with its send time as information_time
+// and feeds a BufferProcessor, either through an in-process fake receiver or
+// over loopback multicast. Each run sweeps one message rate, datagram size
+// and buffer size and reports the sustained delivery rate, the messages
+// lost, and two latency stages from the send time: received (slot receive
+// time, kernel time over multicast) and delivered to a sink after decoding.
+// Paced senders stamp the scheduled send time, so a pipeline that falls
+// behind shows the backlog as latency.
+//
+// Results can be saved as a baseline and later runs compared against it;
+// the program exits with 1 when a run regresses past the threshold.
+
+#include "core/buffer_processor.h"
+#include "processing/latency_tracker.h"
+#include "utils/tsc_clock.h"
+#include "../test/tfe_test_packets.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace stream_buffer;
+using namespace stream_buffer::processing;
+using namespace stream_buffer::testing;
+
+namespace
+{
+    const common::i64 NS_PER_MS = 1000000;
+    const common::i64 NS_PER_SEC = 1000000000;
+    const size_t MIN_BUFFER_KB = 128;       // Room for the largest slot
+    const common::i64 DRAIN_IDLE_MS = 200;  // Delivery stalled this long ends the drain
+    const common::i64 DRAIN_MAX_MS = 3000;
+    const double LATENCY_SLACK_US = 5.0;    // p99 changes below this are noise, whatever the percentage
+
+    struct BenchConfig
+    {
+        bool multicast = false;                    // Loopback multicast instead of the fake receiver
+        std::vector<size_t> rates = {100000, 0};   // Messages per second, 0 = as fast as possible
+        std::vector<size_t> sizes = {256, 1400};   // Datagram payload bytes, filled with whole packets
+        std::vector<size_t> buffers_kb = {1024, 16384};
+        size_t duration_ms = 500;                  // Sending time per run
+        std::string group_ip = "239.255.0.42";
+        int port = 31042;
+        std::string interface_ip = "127.0.0.1";
+        std::string baseline_path;                 // Compare against this file
+        std::string save_path;                     // Write the results here
+        double threshold_pct = 10.0;               // Throughput drop or p99 rise counted as a regression
+        double loss_tolerance_pct = 0.5;           // Loss rise, in percentage points, counted as a regression
+    };
+
+    struct RunResult
+    {
+        std::string key;
+        common::u64 messages_sent = 0;
+        common::u64 messages_delivered = 0;
+        double throughput = 0.0; // Messages delivered per second
+        double megabytes = 0.0;  // Payload MB delivered per second
+        double loss_pct = 0.0;
+        LatencySnapshot received;
+        LatencySnapshot delivered;
+    };
+
+    common::i64 ReadRealtimeNs()
+    {
+        return utils::GetClock().NowRealtimeNs();
+    }
+
+    // hhmmssmmmuuu in UTC, the form of information_time
+    common::u64 ToInformationTime(common::i64 realtime_ns)
+    {
+        common::i64 time_of_day = realtime_ns % (86400 * NS_PER_SEC);
+        common::u64 seconds = static_cast<common::u64>(time_of_day / NS_PER_SEC);
+        common::u64 micros = static_cast<common::u64>(time_of_day % NS_PER_SEC / 1000);
+        common::u64 hhmmss = (seconds / 3600) * 10000 + (seconds / 60 % 60) * 100 + seconds % 60;
+        return hhmmss * 1000000 + micros;
+    }
+
+    /**
+     * Datagrams of identical I080 packets, restamped and sent on a schedule
+     */
+    class FeedGenerator
+    {
+    public:
+        FeedGenerator(size_t datagram_bytes, size_t rate, size_t duration_ms)
+            : packet_size_(tfe::CalculatePacketSize(sizeof(tfe::BodyI080))),
+              packets_per_datagram_(datagram_bytes / packet_size_ > 0 ? datagram_bytes / packet_size_ : 1),
+              interval_ns_(rate > 0 ? static_cast<common::i64>(packets_per_datagram_) * NS_PER_SEC / static_cast<common::i64>(rate) : 0),
+              duration_ns_(static_cast<common::i64>(duration_ms) * NS_PER_MS),
+              start_ns_(0),
+              datagrams_(0),
+              messages_sent_(0),
+              done_(false)
+        {
+            for (size_t i = 0; i < packets_per_datagram_; ++i)
+            {
+                AppendQuote(i);
+            }
+        }
+
+        size_t GetPacketsPerDatagram() const { return packets_per_datagram_; }
+        size_t GetDatagramSize() const { return datagram_.size(); }
+        common::i64 GetStartNs() const { return start_ns_; }
+        common::u64 GetMessagesSent() const { return messages_sent_.load(std::memory_order_acquire); }
+        bool IsDone() const { return done_.load(std::memory_order_acquire); }
+
+        /**
+         * Wait for the next send slot and write the datagram, 0 once the run is over
+         */
+        size_t Next(char *out, size_t size)
+        {
+            if (done_.load(std::memory_order_relaxed) || size < datagram_.size())
+            {
+                return 0;
+            }
+
+            common::i64 now = ReadRealtimeNs();
+            if (datagrams_ == 0)
+            {
+                start_ns_ = now;
+            }
+            if (now - start_ns_ >= duration_ns_)
+            {
+                done_.store(true, std::memory_order_release);
+                return 0;
+            }
+
+            // Stamp the scheduled time, not the time we got round to it
+            common::i64 send_ns = now;
+            if (interval_ns_ > 0)
+            {
+                send_ns = start_ns_ + static_cast<common::i64>(datagrams_) * interval_ns_;
+                // Yield while waiting so the pipeline threads run on small machines
+                while (now < send_ns)
+                {
+                    sched_yield();
+                    now = ReadRealtimeNs();
+                }
+            }
+
+            Stamp(ToInformationTime(send_ns));
+            std::memcpy(out, datagram_.data(), datagram_.size());
+            datagrams_++;
+            messages_sent_.store(messages_sent_.load(std::memory_order_relaxed) + packets_per_datagram_,
+                                 std::memory_order_release);
+            return datagram_.size();
+        }
+
+    private:
+        void AppendQuote(size_t index)
+        {
+            size_t offset = datagram_.size();
+            datagram_.resize(offset + packet_size_, 0);
+            char *packet = datagram_.data() + offset;
+
+            tfe::Header *header = reinterpret_cast<tfe::Header *>(packet);
+            header->esc_code = static_cast<char>(tfe::ESC_CODE);
+            header->transmission_code = tfe::TRANSMISSION_FUTURES_TRADING;
+            header->message_kind = tfe::KIND_BEST_QUOTES;
+            header->version_no = 0x01;
+            EncodeBcd(sizeof(tfe::BodyI080), header->body_length, sizeof(header->body_length));
+
+            tfe::BodyI080 *body = reinterpret_cast<tfe::BodyI080 *>(packet + sizeof(tfe::Header));
+            char id[16];
+            std::snprintf(id, sizeof(id), "Q%09u", static_cast<unsigned>(index));
+            std::memcpy(body->prod_id_s, id, sizeof(body->prod_id_s));
+            for (size_t level = 0; level < tfe::QUOTE_LEVELS; ++level)
+            {
+                body->buy[level].price_sign = '0';
+                EncodeBcd(2000000 - level, body->buy[level].price, sizeof(body->buy[level].price));
+                EncodeBcd(1 + level, body->buy[level].quantity, sizeof(body->buy[level].quantity));
+                body->sell[level].price_sign = '0';
+                EncodeBcd(2000001 + level, body->sell[level].price, sizeof(body->sell[level].price));
+                EncodeBcd(1 + level, body->sell[level].quantity, sizeof(body->sell[level].quantity));
+            }
+            packet[packet_size_ - 2] = 0x0D;
+            packet[packet_size_ - 1] = static_cast<char>(tfe::TERMINAL_CODE);
+        }
+
+        // New time and sequence in every packet, checksums recomputed
+        void Stamp(common::u64 information_time)
+        {
+            size_t checksum_pos = packet_size_ - tfe::TERMINAL_CODE_SIZE - tfe::CHECK_SUM_SIZE;
+            for (size_t i = 0; i < packets_per_datagram_; ++i)
+            {
+                char *packet = datagram_.data() + i * packet_size_;
+                tfe::Header *header = reinterpret_cast<tfe::Header *>(packet);
+                EncodeBcd(information_time, header->information_time, sizeof(header->information_time));
+                EncodeBcd((datagrams_ * packets_per_datagram_ + i) % 100000000ULL,
+                          header->information_seq, sizeof(header->information_seq));
+                packet[checksum_pos] = static_cast<char>(tfe::ComputeChecksum(packet, checksum_pos + 1));
+            }
+        }
+
+        size_t packet_size_;
+        size_t packets_per_datagram_;
+        common::i64 interval_ns_;
+        common::i64 duration_ns_;
+        common::i64 start_ns_;
+        common::u64 datagrams_;
+        std::vector<char> datagram_;
+        std::atomic<common::u64> messages_sent_;
+        std::atomic<bool> done_;
+    };
+
+    /**
+     * The sender in process: datagrams appear when the receive thread asks for them
+     */
+    class FakeReceiver : public network::INetworkReceiver
+    {
+    public:
+        explicit FakeReceiver(FeedGenerator &generator) : generator_(generator) {}
+
+        int ReceiveData(char *buffer, size_t buffer_size) override
+        {
+            network::DatagramInfo info;
+            return ReceiveDatagram(buffer, buffer_size, &info);
+        }
+
+        int ReceiveDatagram(char *buffer, size_t buffer_size, network::DatagramInfo *info) override
+        {
+            *info = network::DatagramInfo();
+            size_t size = generator_.Next(buffer, buffer_size);
+            if (size == 0)
+            {
+                // Like a quiet socket with a receive timeout
+                usleep(1000);
+                errno = EAGAIN;
+                return -1;
+            }
+            info->receive_time_ns = ReadRealtimeNs();
+            return static_cast<int>(size);
+        }
+
+    private:
+        FeedGenerator &generator_;
+    };
+
+    /**
+     * Counts delivered messages and their latency from the send time
+     */
+    class DeliverySink : public IMessageSink
+    {
+    public:
+        DeliverySink() : tracker_(0), delivered_(0), last_delivery_ns_(0) {}
+
+        void OnMessage(const NormalizedMessage &message) override
+        {
+            common::i64 now = ReadRealtimeNs();
+            tracker_.Record(message.transmission_code, LatencyKind::QUOTE, message.information_time_ns, now);
+            delivered_.store(delivered_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+            last_delivery_ns_.store(now, std::memory_order_relaxed);
+        }
+
+        common::u64 GetDelivered() const { return delivered_.load(std::memory_order_acquire); }
+        common::i64 GetLastDeliveryNs() const { return last_delivery_ns_.load(std::memory_order_relaxed); }
+        LatencySnapshot GetLatency() const { return tracker_.SnapshotAll(); }
+
+    private:
+        LatencyTracker tracker_;
+        std::atomic<common::u64> delivered_;
+        std::atomic<common::i64> last_delivery_ns_;
+    };
+
+    struct SenderArgs
+    {
+        FeedGenerator *generator;
+        const BenchConfig *config;
+    };
+
+    // Loopback multicast sender thread
+    void *SendMulticast(void *arg)
+    {
+        SenderArgs *args = static_cast<SenderArgs *>(arg);
+        int fd = socket(AF_INET, SOCK_DGRAM, 0);
+        if (fd < 0)
+        {
+            std::perror("socket");
+            return nullptr;
+        }
+        in_addr interface_addr;
+        interface_addr.s_addr = inet_addr(args->config->interface_ip.c_str());
+        unsigned char loop = 1;
+        setsockopt(fd, IPPROTO_IP, IP_MULTICAST_IF, &interface_addr, sizeof(interface_addr));
+        setsockopt(fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+
+        sockaddr_in group;
+        std::memset(&group, 0, sizeof(group));
+        group.sin_family = AF_INET;
+        group.sin_addr.s_addr = inet_addr(args->config->group_ip.c_str());
+        group.sin_port = htons(static_cast<uint16_t>(args->config->port));
+
+        std::vector<char> datagram(args->generator->GetDatagramSize());
+        size_t size;
+        while ((size = args->generator->Next(datagram.data(), datagram.size())) > 0)
+        {
+            sendto(fd, datagram.data(), size, 0, reinterpret_cast<sockaddr *>(&group), sizeof(group));
+        }
+        close(fd);
+        return nullptr;
+    }
+
+    std::string MakeKey(const BenchConfig &config, size_t rate, size_t size, size_t buffer_kb)
+    {
+        std::ostringstream key;
+        key << (config.multicast ? "multicast" : "fake") << "/rate=" << rate << "/size=" << size
+            << "/buffer=" << buffer_kb << "k";
+        return key.str();
+    }
+
+    RunResult Run(const BenchConfig &config, size_t rate, size_t size, size_t buffer_kb)
+    {
+        RunResult result;
+        result.key = MakeKey(config, rate, size, buffer_kb);
+
+        FeedGenerator generator(size, rate, config.duration_ms);
+        DeliverySink sink;
+
+        common::MulticastConfig multicast;
+        multicast.group_ip = config.group_ip;
+        multicast.port = config.port;
+        multicast.interface_ip = config.interface_ip;
+
+        common::ProcessingConfig processing;
+        processing.datagram_slots = true; // Receive time per datagram
+        processing.track_latency = true;
+        processing.exchange_utc_offset_min = 0;
+
+        std::unique_ptr<network::INetworkReceiver> receiver;
+        if (!config.multicast)
+        {
+            receiver.reset(new FakeReceiver(generator));
+        }
+        core::BufferProcessor processor(multicast, buffer_kb * 1024, std::move(receiver), nullptr, processing);
+        processor.AddSink(&sink);
+        if (!processor.Start())
+        {
+            std::fprintf(stderr, "Failed to start the pipeline for %s\n", result.key.c_str());
+            return result;
+        }
+
+        if (config.multicast)
+        {
+            SenderArgs args = {&generator, &config};
+            pthread_t sender;
+            pthread_create(&sender, nullptr, SendMulticast, &args);
+            pthread_join(sender, nullptr);
+        }
+        else
+        {
+            while (!generator.IsDone())
+            {
+                usleep(10000);
+            }
+        }
+
+        // Wait for the pipeline to deliver what it has, or stall
+        common::i64 drain_start = ReadRealtimeNs();
+        common::u64 delivered = sink.GetDelivered();
+        common::i64 last_progress = drain_start;
+        while (delivered < generator.GetMessagesSent())
+        {
+            usleep(1000);
+            common::i64 now = ReadRealtimeNs();
+            common::u64 current = sink.GetDelivered();
+            if (current != delivered)
+            {
+                delivered = current;
+                last_progress = now;
+            }
+            if (now - last_progress > DRAIN_IDLE_MS * NS_PER_MS || now - drain_start > DRAIN_MAX_MS * NS_PER_MS)
+            {
+                break;
+            }
+        }
+        processor.Stop();
+
+        result.messages_sent = generator.GetMessagesSent();
+        result.messages_delivered = sink.GetDelivered();
+        double elapsed = static_cast<double>(sink.GetLastDeliveryNs() - generator.GetStartNs()) / NS_PER_SEC;
+        if (elapsed > 0.0)
+        {
+            result.throughput = static_cast<double>(result.messages_delivered) / elapsed;
+            result.megabytes = result.throughput * static_cast<double>(generator.GetDatagramSize()) /
+                               static_cast<double>(generator.GetPacketsPerDatagram()) / 1e6;
+        }
+        if (result.messages_sent > 0)
+        {
+            result.loss_pct = 100.0 * static_cast<double>(result.messages_sent - result.messages_delivered) /
+                              static_cast<double>(result.messages_sent);
+        }
+        result.received = processor.GetLatencyTracker()->SnapshotAll();
+        result.delivered = sink.GetLatency();
+        return result;
+    }
+
+    double ToMicroseconds(common::i64 ns)
+    {
+        return static_cast<double>(ns) / 1000.0;
+    }
+
+    // key -> (metric -> value)
+    typedef std::map<std::string, std::map<std::string, double>> Baseline;
+
+    bool LoadBaseline(const std::string &path, Baseline *baseline)
+    {
+        std::ifstream file(path.c_str());
+        if (!file)
+        {
+            return false;
+        }
+        std::string line;
+        while (std::getline(file, line))
+        {
+            std::istringstream fields(line);
+            std::string key, field;
+            if (!(fields >> key) || key[0] == '#')
+            {
+                continue;
+            }
+            while (fields >> field)
+            {
+                size_t equals = field.find('=');
+                if (equals != std::string::npos)
+                {
+                    (*baseline)[key][field.substr(0, equals)] = std::strtod(field.c_str() + equals + 1, nullptr);
+                }
+            }
+        }
+        return true;
+    }
+
+    bool SaveBaseline(const std::string &path, const std::vector<RunResult> &results)
+    {
+        std::ofstream file(path.c_str());
+        if (!file)
+        {
+            return false;
+        }
+        file << "# pipeline_bench baseline: key throughput loss_pct e2e_p99_us\n";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const RunResult &result = results[i];
+            file << result.key << " throughput=" << static_cast<common::u64>(result.throughput)
+                 << " loss_pct=" << result.loss_pct
+                 << " e2e_p99_us=" << ToMicroseconds(result.delivered.GetPercentile(0.99)) << "\n";
+        }
+        return static_cast<bool>(file);
+    }
+
+    // Print every regression against the baseline, return how many there were
+    size_t Compare(const BenchConfig &config, const Baseline &baseline, const std::vector<RunResult> &results)
+    {
+        size_t regressions = 0;
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const RunResult &result = results[i];
+            Baseline::const_iterator entry = baseline.find(result.key);
+            if (entry == baseline.end())
+            {
+                std::printf("  %-44s no baseline\n", result.key.c_str());
+                continue;
+            }
+            const std::map<std::string, double> &base = entry->second;
+            double limit = config.threshold_pct / 100.0;
+
+            std::map<std::string, double>::const_iterator value = base.find("throughput");
+            if (value != base.end() && result.throughput < value->second * (1.0 - limit))
+            {
+                std::printf("  REGRESSION %s: throughput %.0f -> %.0f msg/s\n", result.key.c_str(),
+                            value->second, result.throughput);
+                regressions++;
+            }
+            value = base.find("loss_pct");
+            if (value != base.end() && result.loss_pct > value->second + config.loss_tolerance_pct)
+            {
+                std::printf("  REGRESSION %s: loss %.2f%% -> %.2f%%\n", result.key.c_str(),
+                            value->second, result.loss_pct);
+                regressions++;
+            }
+
+            // Unpaced runs measure how deep the queue gets, not latency
+            value = base.find("e2e_p99_us");
+            double p99 = ToMicroseconds(result.delivered.GetPercentile(0.99));
+            if (result.key.find("/rate=0/") == std::string::npos && value != base.end() &&
+                p99 > value->second * (1.0 + limit) + LATENCY_SLACK_US)
+            {
+                std::printf("  REGRESSION %s: e2e p99 %.1f -> %.1f us\n", result.key.c_str(), value->second, p99);
+                regressions++;
+            }
+        }
+        return regressions;
+    }
+
+    std::vector<size_t> ParseList(const char *text)
+    {
+        std::vector<size_t> values;
+        std::string list(text);
+        size_t start = 0;
+        while (start <= list.size())
+        {
+            size_t end = list.find(',', start);
+            if (end == std::string::npos)
+            {
+                end = list.size();
+            }
+            if (end > start)
+            {
+                values.push_back(std::strtoul(list.substr(start, end - start).c_str(), nullptr, 10));
+            }
+            start = end + 1;
+        }
+        return values;
+    }
+
+    void PrintUsage(const char *program)
+    {
+        std::fprintf(stderr,
+                     "Usage: %s [--transport fake|multicast] [--rates 100000,0] [--sizes 256,1400]\n"
+                     "          [--buffers-kb 1024,16384] [--duration-ms 500] [--group IP] [--port N]\n"
+                     "          [--interface-ip IP] [--baseline FILE] [--save-baseline FILE]\n"
+                     "          [--threshold PCT] [--loss-tolerance PCT]\n",
+                     program);
+    }
+} // anonymous namespace
+
+int main(int argc, char *argv[])
+{
+    BenchConfig config;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string arg = argv[i];
+        if (arg == "--transport" && (std::string(argv[i + 1]) == "fake" || std::string(argv[i + 1]) == "multicast"))
+        {
+            config.multicast = std::string(argv[i + 1]) == "multicast";
+        }
+        else if (arg == "--rates")
+        {
+            config.rates = ParseList(argv[i + 1]);
+        }
+        else if (arg == "--sizes")
+        {
+            config.sizes = ParseList(argv[i + 1]);
+        }
+        else if (arg == "--buffers-kb")
+        {
+            config.buffers_kb = ParseList(argv[i + 1]);
+        }
+        else if (arg == "--duration-ms")
+        {
+            config.duration_ms = std::strtoul(argv[i + 1], nullptr, 10);
+        }
+        else if (arg == "--group")
+        {
+            config.group_ip = argv[i + 1];
+        }
+        else if (arg == "--port")
+        {
+            config.port = std::atoi(argv[i + 1]);
+        }
+        else if (arg == "--interface-ip")
+        {
+            config.interface_ip = argv[i + 1];
+        }
+        else if (arg == "--baseline")
+        {
+            config.baseline_path = argv[i + 1];
+        }
+        else if (arg == "--save-baseline")
+        {
+            config.save_path = argv[i + 1];
+        }
+        else if (arg == "--threshold")
+        {
+            config.threshold_pct = std::strtod(argv[i + 1], nullptr);
+        }
+        else if (arg == "--loss-tolerance")
+        {
+            config.loss_tolerance_pct = std::strtod(argv[i + 1], nullptr);
+        }
+        else
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (argc % 2 == 0)
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    std::printf("Pipeline: %s receiver, %zu ms per run\n", config.multicast ? "loopback multicast" : "fake",
+                config.duration_ms);
+    std::printf("%-9s %6s %8s %12s %8s %7s %10s %10s %10s %10s %10s\n", "rate", "bytes", "buffer", "msg/s",
+                "MB/s", "loss%", "recv_p50", "recv_p99", "e2e_p50", "e2e_p99", "e2e_p999");
+
+    std::vector<RunResult> results;
+    for (size_t b = 0; b < config.buffers_kb.size(); ++b)
+    {
+        size_t buffer_kb = config.buffers_kb[b] < MIN_BUFFER_KB ? MIN_BUFFER_KB : config.buffers_kb[b];
+        for (size_t s = 0; s < config.sizes.size(); ++s)
+        {
+            for (size_t r = 0; r < config.rates.size(); ++r)
+            {
+                RunResult result = Run(config, config.rates[r], config.sizes[s], buffer_kb);
+                std::printf("%-9s %6zu %7zuk %12.0f %8.1f %7.2f %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+                            config.rates[r] == 0 ? "max" : std::to_string(config.rates[r]).c_str(),
+                            config.sizes[s], buffer_kb, result.throughput, result.megabytes, result.loss_pct,
+                            ToMicroseconds(result.received.GetPercentile(0.50)),
+                            ToMicroseconds(result.received.GetPercentile(0.99)),
+                            ToMicroseconds(result.delivered.GetPercentile(0.50)),
+                            ToMicroseconds(result.delivered.GetPercentile(0.99)),
+                            ToMicroseconds(result.delivered.GetPercentile(0.999)));
+                results.push_back(result);
+            }
+        }
+    }
+    std::printf("Latencies in us from the send time; recv = slot receive time, e2e = delivered to a sink\n");
+
+    int status = 0;
+    if (!config.baseline_path.empty())
+    {
+        Baseline baseline;
+        if (!LoadBaseline(config.baseline_path, &baseline))
+        {
+            std::fprintf(stderr, "Cannot read baseline %s\n", config.baseline_path.c_str());
+            return 1;
+        }
+        std::printf("Against %s (threshold %.1f%%):\n", config.baseline_path.c_str(), config.threshold_pct);
+        size_t regressions = Compare(config, baseline, results);
+        std::printf("  %zu regression%s\n", regressions, regressions == 1 ? "" : "s");
+        status = regressions > 0 ? 1 : 0;
+    }
+    if (!config.save_path.empty())
+    {
+        if (!SaveBaseline(config.save_path, results))
+        {
+            std::fprintf(stderr, "Cannot write baseline %s\n", config.save_path.c_str());
+            return 1;
+        }
+        std::printf("Baseline saved to %s\n", config.save_path.c_str());
+    }
+    return status;
+}
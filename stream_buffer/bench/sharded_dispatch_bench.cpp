@@ -0,0 +1,222 @@
+// Throughput of the sharded dispatch stage against the number of workers
+//
+// Replays synthetic multi-product I020 traffic through TFEProcessor and
+// hands every trade to a handler doing a configurable amount of per-product
+// work, either inline on the processing thread or across N shard workers.
+
+#include "processing/sharded_dispatcher.h"
+#include "processing/tfe_processor.h"
+#include "../test/tfe_test_packets.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace stream_buffer;
+using namespace stream_buffer::processing;
+using namespace stream_buffer::testing;
+
+namespace
+{
+    struct BenchConfig
+    {
+        size_t products = 512;      // Distinct product ids in the traffic
+        size_t messages = 1000000;  // Trades replayed per run
+        size_t work = 200;          // Handler iterations per message
+        std::vector<size_t> workers = {0, 1, 2, 4, 8}; // 0 = inline on the processing thread
+    };
+
+    // Append one I020 packet with a valid checksum
+    void AppendTrade(size_t product, common::u64 seq, std::vector<char> *stream)
+    {
+        size_t offset = stream->size();
+        stream->resize(offset + tfe::CalculatePacketSize(sizeof(tfe::BodyI020)), 0);
+        char *packet = stream->data() + offset;
+
+        tfe::Header *header = reinterpret_cast<tfe::Header *>(packet);
+        header->esc_code = static_cast<char>(tfe::ESC_CODE);
+        header->transmission_code = tfe::TRANSMISSION_FUTURES_TRADING;
+        header->message_kind = tfe::KIND_MATCH;
+        EncodeBcd(91500000000ULL + seq, header->information_time, sizeof(header->information_time));
+        EncodeBcd(seq % 100000000ULL, header->information_seq, sizeof(header->information_seq));
+        header->version_no = 0x01;
+        EncodeBcd(sizeof(tfe::BodyI020), header->body_length, sizeof(header->body_length));
+
+        tfe::BodyI020 *body = reinterpret_cast<tfe::BodyI020 *>(packet + sizeof(tfe::Header));
+        char id[16];
+        std::snprintf(id, sizeof(id), "B%09u", static_cast<unsigned>(product % 1000000000));
+        std::memcpy(body->prod_id_s, id, sizeof(body->prod_id_s));
+        EncodeBcd(91500000000ULL + seq, body->match_time, sizeof(body->match_time));
+        body->first_match_price_sign = '0';
+        EncodeBcd(2000000 + seq % 1000, body->first_match_price, sizeof(body->first_match_price));
+        EncodeBcd(1 + seq % 10, body->first_match_qty, sizeof(body->first_match_qty));
+
+        size_t total = tfe::CalculatePacketSize(sizeof(tfe::BodyI020));
+        size_t checksum_pos = total - tfe::TERMINAL_CODE_SIZE - tfe::CHECK_SUM_SIZE;
+        packet[checksum_pos] = static_cast<char>(tfe::ComputeChecksum(packet, checksum_pos + 1));
+        packet[total - 2] = 0x0D;
+        packet[total - 1] = static_cast<char>(tfe::TERMINAL_CODE);
+    }
+
+    // Stand-in for a book or analytics handler: per-product state plus CPU work
+    class WorkSink : public IMessageSink
+    {
+    public:
+        explicit WorkSink(size_t work) : work_(work), state_(4096, 0), checksum_(0) {}
+
+        void OnMessage(const NormalizedMessage &message) override
+        {
+            common::u64 &state = state_[HashProductId(message.product_id) & (state_.size() - 1)];
+            common::u64 value = state ^ static_cast<common::u64>(message.price);
+            for (size_t i = 0; i < work_; ++i)
+            {
+                value = value * 6364136223846793005ULL + static_cast<common::u64>(message.quantity);
+            }
+            state = value;
+            checksum_ += value;
+        }
+
+        common::u64 GetChecksum() const { return checksum_; }
+
+    private:
+        size_t work_;
+        std::vector<common::u64> state_;
+        common::u64 checksum_;
+    };
+
+    // Feed the stream through the processor in receive-sized batches
+    double Run(const BenchConfig &config, size_t workers, const std::vector<char> &stream)
+    {
+        TFEProcessor processor;
+        std::unique_ptr<WorkSink> inline_sink;
+        std::unique_ptr<ShardedDispatcher> dispatcher;
+
+        if (workers == 0)
+        {
+            inline_sink.reset(new WorkSink(config.work));
+            processor.AddSink(inline_sink.get());
+        }
+        else
+        {
+            std::vector<std::unique_ptr<IMessageSink>> sinks;
+            for (size_t i = 0; i < workers; ++i)
+            {
+                sinks.emplace_back(new WorkSink(config.work));
+            }
+            dispatcher.reset(new ShardedDispatcher(std::move(sinks)));
+            if (!dispatcher->Start())
+            {
+                std::fprintf(stderr, "Failed to start %zu workers\n", workers);
+                return 0.0;
+            }
+            processor.AddSink(dispatcher.get());
+        }
+
+        const size_t batch_size = 64 * 1024;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        size_t offset = 0;
+        while (offset < stream.size())
+        {
+            size_t length = stream.size() - offset < batch_size ? stream.size() - offset : batch_size;
+            core::BatchResult result = processor.ProcessBatch(stream.data() + offset, length);
+            offset += result.bytes_consumed;
+            if (result.bytes_consumed == 0)
+            {
+                break;
+            }
+        }
+        if (dispatcher)
+        {
+            dispatcher->Drain();
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        if (dispatcher)
+        {
+            dispatcher->Stop();
+        }
+        return static_cast<double>(config.messages) / elapsed.count();
+    }
+
+    std::vector<size_t> ParseList(const char *text)
+    {
+        std::vector<size_t> values;
+        std::string list(text);
+        size_t start = 0;
+        while (start <= list.size())
+        {
+            size_t end = list.find(',', start);
+            if (end == std::string::npos)
+            {
+                end = list.size();
+            }
+            if (end > start)
+            {
+                values.push_back(std::strtoul(list.substr(start, end - start).c_str(), nullptr, 10));
+            }
+            start = end + 1;
+        }
+        return values;
+    }
+} // anonymous namespace
+
+int main(int argc, char *argv[])
+{
+    BenchConfig config;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string arg = argv[i];
+        if (arg == "--products")
+        {
+            config.products = std::strtoul(argv[i + 1], nullptr, 10);
+        }
+        else if (arg == "--messages")
+        {
+            config.messages = std::strtoul(argv[i + 1], nullptr, 10);
+        }
+        else if (arg == "--work")
+        {
+            config.work = std::strtoul(argv[i + 1], nullptr, 10);
+        }
+        else if (arg == "--workers")
+        {
+            config.workers = ParseList(argv[i + 1]);
+        }
+        else
+        {
+            std::fprintf(stderr, "Usage: %s [--products N] [--messages N] [--work N] [--workers 0,1,2,4]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (config.products == 0)
+    {
+        config.products = 1;
+    }
+
+    std::vector<char> stream;
+    stream.reserve(config.messages * tfe::CalculatePacketSize(sizeof(tfe::BodyI020)));
+    for (size_t i = 0; i < config.messages; ++i)
+    {
+        AppendTrade(i % config.products, i + 1, &stream);
+    }
+
+    std::printf("Sharded dispatch: %zu messages, %zu products, %zu work iterations\n",
+                config.messages, config.products, config.work);
+    std::printf("%-10s %16s %10s\n", "workers", "messages/s", "speedup");
+
+    double baseline = 0.0;
+    for (size_t i = 0; i < config.workers.size(); ++i)
+    {
+        double rate = Run(config, config.workers[i], stream);
+        if (i == 0)
+        {
+            baseline = rate;
+        }
+        std::printf("%-10s %16.0f %9.2fx\n",
+                    config.workers[i] == 0 ? "inline" : std::to_string(config.workers[i]).c_str(),
+                    rate, baseline > 0.0 ? rate / baseline : 0.0);
+    }
+    return 0;
+}
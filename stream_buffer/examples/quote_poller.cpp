@@ -0,0 +1,49 @@
+// Poll the latest quote and trade of products from the snapshot table
+//
+// Usage: quote_poller <table> <product> [product...]
+//   table    File given as quote_snapshot in the stream_buffer config
+//   product  Product id, padded with spaces to 10 characters
+
+#include "processing/quote_snapshot.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+using namespace stream_buffer;
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+    {
+        std::fprintf(stderr, "Usage: %s <table> <product> [product...]\n", argv[0]);
+        return 1;
+    }
+
+    processing::QuoteSnapshotReader reader;
+    if (!reader.Open(argv[1]))
+    {
+        std::fprintf(stderr, "Cannot open snapshot table %s\n", argv[1]);
+        return 1;
+    }
+
+    for (int i = 2; i < argc; ++i)
+    {
+        char product_id[processing::constants::PRODUCT_ID_SIZE];
+        std::memset(product_id, ' ', sizeof(product_id));
+        std::memcpy(product_id, argv[i], std::min(std::strlen(argv[i]), sizeof(product_id)));
+
+        processing::QuoteSnapshot snapshot;
+        if (!reader.Read(product_id, &snapshot))
+        {
+            std::printf("%.10s not in table\n", product_id);
+            continue;
+        }
+
+        std::printf("%.10s bid %lld @ %s  ask %s @ %lld  last %s x %lld  (%u updates)\n", product_id,
+                    static_cast<long long>(snapshot.bid_quantity), snapshot.GetBidPrice().ToString().c_str(),
+                    snapshot.GetAskPrice().ToString().c_str(), static_cast<long long>(snapshot.ask_quantity),
+                    snapshot.GetLastPrice().ToString().c_str(), static_cast<long long>(snapshot.last_quantity),
+                    snapshot.update_count);
+    }
+    return 0;
+}
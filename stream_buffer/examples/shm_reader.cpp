@@ -0,0 +1,101 @@
+// Follow the decoded feed published by stream_buffer in shared memory
+//
+// Usage: shm_reader [name] [--oldest]
+//   name      Shared-memory ring name, "/stream_buffer" by default
+//   --oldest  Start with the messages still in the ring instead of new ones
+
+#include "ipc/shm_reader.h"
+#include <signal.h>
+#include <time.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+using namespace stream_buffer;
+
+namespace
+{
+    volatile sig_atomic_t g_stop = 0;
+
+    void HandleSignal(int)
+    {
+        g_stop = 1;
+    }
+
+    void PrintMessage(const processing::NormalizedMessage &message)
+    {
+        switch (message.type)
+        {
+        case processing::MessageType::PRODUCT_INFO:
+            std::printf("%012llu %.10s REF   %s\n",
+                        static_cast<unsigned long long>(message.information_time), message.product_id,
+                        message.GetPrice().ToString().c_str());
+            break;
+        case processing::MessageType::TRADE:
+            std::printf("%012llu %.10s TRADE %s x %lld\n",
+                        static_cast<unsigned long long>(message.information_time), message.product_id,
+                        message.GetPrice().ToString().c_str(), static_cast<long long>(message.quantity));
+            break;
+        case processing::MessageType::QUOTE:
+            std::printf("%012llu %.10s QUOTE %lld @ %s / %s @ %lld\n",
+                        static_cast<unsigned long long>(message.information_time), message.product_id,
+                        static_cast<long long>(message.bid_quantity), message.GetBidPrice().ToString().c_str(),
+                        message.GetAskPrice().ToString().c_str(), static_cast<long long>(message.ask_quantity));
+            break;
+        }
+    }
+} // anonymous namespace
+
+int main(int argc, char *argv[])
+{
+    std::string name = "/stream_buffer";
+    ipc::ShmReader::StartPosition start = ipc::ShmReader::StartPosition::LATEST;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--oldest") == 0)
+        {
+            start = ipc::ShmReader::StartPosition::OLDEST;
+        }
+        else
+        {
+            name = argv[i];
+        }
+    }
+
+    signal(SIGINT, HandleSignal);
+    signal(SIGTERM, HandleSignal);
+
+    ipc::ShmReader reader;
+    if (!reader.Open(name, start))
+    {
+        std::fprintf(stderr, "Cannot open shared-memory ring %s, is stream_buffer running?\n", name.c_str());
+        return 1;
+    }
+    std::printf("Following %s (%llu slots)\n", name.c_str(), static_cast<unsigned long long>(reader.GetCapacity()));
+
+    processing::NormalizedMessage message;
+    unsigned long long received = 0;
+    while (!g_stop)
+    {
+        if (reader.TryRead(&message))
+        {
+            PrintMessage(message);
+            received++;
+            continue;
+        }
+
+        if (reader.IsWriterClosed())
+        {
+            std::printf("Publisher closed the ring\n");
+            break;
+        }
+
+        // Nothing new: poll again shortly, a latency-critical reader would spin
+        struct timespec delay = {0, 100000};
+        nanosleep(&delay, nullptr);
+    }
+
+    std::printf("Received %llu messages, lost %llu\n", received,
+                static_cast<unsigned long long>(reader.GetLostCount()));
+    return 0;
+}
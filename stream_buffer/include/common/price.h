@@ -0,0 +1,195 @@
+#pragma once
+
+#include "common/types.h"
+#include <string>
+
+namespace stream_buffer
+{
+    namespace common
+    {
+
+        namespace constants
+        {
+            // Largest decimal scale a Price can carry (10^18 still fits in int64_t)
+            constexpr u8 MAX_PRICE_SCALE = 18;
+        }
+
+        /**
+         * @brief Return 10^exponent as an integer
+         * @param exponent Power of ten, 0..MAX_PRICE_SCALE
+         * @return 10^exponent, 10^MAX_PRICE_SCALE for larger exponents
+         */
+        inline i64 Pow10(u8 exponent)
+        {
+            static const i64 table[constants::MAX_PRICE_SCALE + 1] = {
+                1LL,
+                10LL,
+                100LL,
+                1000LL,
+                10000LL,
+                100000LL,
+                1000000LL,
+                10000000LL,
+                100000000LL,
+                1000000000LL,
+                10000000000LL,
+                100000000000LL,
+                1000000000000LL,
+                10000000000000LL,
+                100000000000000LL,
+                1000000000000000LL,
+                10000000000000000LL,
+                100000000000000000LL,
+                1000000000000000000LL};
+            return table[exponent < constants::MAX_PRICE_SCALE ? exponent : constants::MAX_PRICE_SCALE];
+        }
+
+        /**
+         * @brief Fixed-point price with a per-instrument decimal scale
+         *
+         * The value is mantissa / 10^scale, where the scale comes from the
+         * I010 decimal locator of the instrument. Prices of the same
+         * instrument share a scale, so arithmetic and comparison between them
+         * are plain integer operations. Mixed scales are widened to the larger
+         * scale first; overflow of the widened mantissa is not checked.
+         * Scales above MAX_PRICE_SCALE are clamped to it, as FromBcd rejects them.
+         */
+        class Price
+        {
+        public:
+            Price() : mantissa_(0), scale_(0) {}
+
+            Price(i64 mantissa, u8 scale)
+                : mantissa_(mantissa), scale_(scale < constants::MAX_PRICE_SCALE ? scale : constants::MAX_PRICE_SCALE) {}
+
+            /**
+             * @brief Build a price from a BCD field
+             * @param data Pointer to BCD data
+             * @param length Length of the BCD data in bytes
+             * @param scale Decimal locator of the instrument
+             * @param price Output price
+             * @return true on success, false if the BCD data is invalid
+             */
+            static bool FromBcd(const void *data, size_t length, u8 scale, Price *price);
+
+            i64 GetMantissa() const { return mantissa_; }
+            u8 GetScale() const { return scale_; }
+
+            /**
+             * @brief Express the price with another scale
+             *
+             * Narrowing truncates toward zero.
+             *
+             * @param scale Target scale, clamped to MAX_PRICE_SCALE
+             * @return Rescaled price
+             */
+            Price Rescale(u8 scale) const
+            {
+                if (scale > constants::MAX_PRICE_SCALE)
+                {
+                    scale = constants::MAX_PRICE_SCALE;
+                }
+                if (scale == scale_)
+                {
+                    return *this;
+                }
+                if (scale > scale_)
+                {
+                    return Price(mantissa_ * Pow10(scale - scale_), scale);
+                }
+                return Price(mantissa_ / Pow10(scale_ - scale), scale);
+            }
+
+            Price operator+(const Price &other) const
+            {
+                if (scale_ == other.scale_)
+                {
+                    return Price(mantissa_ + other.mantissa_, scale_);
+                }
+                u8 scale = scale_ > other.scale_ ? scale_ : other.scale_;
+                return Price(Rescale(scale).mantissa_ + other.Rescale(scale).mantissa_, scale);
+            }
+
+            Price operator-(const Price &other) const
+            {
+                if (scale_ == other.scale_)
+                {
+                    return Price(mantissa_ - other.mantissa_, scale_);
+                }
+                u8 scale = scale_ > other.scale_ ? scale_ : other.scale_;
+                return Price(Rescale(scale).mantissa_ - other.Rescale(scale).mantissa_, scale);
+            }
+
+            Price operator-() const
+            {
+                return Price(-mantissa_, scale_);
+            }
+
+            // Scale by an integer quantity (e.g. price * volume)
+            Price operator*(i64 quantity) const
+            {
+                return Price(mantissa_ * quantity, scale_);
+            }
+
+            Price &operator+=(const Price &other)
+            {
+                *this = *this + other;
+                return *this;
+            }
+
+            Price &operator-=(const Price &other)
+            {
+                *this = *this - other;
+                return *this;
+            }
+
+            bool operator==(const Price &other) const { return Compare(other) == 0; }
+            bool operator!=(const Price &other) const { return Compare(other) != 0; }
+            bool operator<(const Price &other) const { return Compare(other) < 0; }
+            bool operator<=(const Price &other) const { return Compare(other) <= 0; }
+            bool operator>(const Price &other) const { return Compare(other) > 0; }
+            bool operator>=(const Price &other) const { return Compare(other) >= 0; }
+
+            /**
+             * @brief Convert to floating point (for display and analytics only)
+             */
+            double ToDouble() const
+            {
+                return static_cast<double>(mantissa_) / static_cast<double>(Pow10(scale_));
+            }
+
+            /**
+             * @brief Format into a caller supplied buffer without allocating
+             * @param out Output buffer
+             * @param size Size of the output buffer
+             * @return Number of characters written (excluding the terminator), 0 if the buffer is too small
+             */
+            size_t Format(char *out, size_t size) const;
+
+            /**
+             * @brief Format as a decimal string, e.g. "17250.50"
+             */
+            std::string ToString() const;
+
+        private:
+            int Compare(const Price &other) const
+            {
+                i64 lhs = mantissa_;
+                i64 rhs = other.mantissa_;
+                if (scale_ > other.scale_)
+                {
+                    rhs *= Pow10(scale_ - other.scale_);
+                }
+                else if (scale_ < other.scale_)
+                {
+                    lhs *= Pow10(other.scale_ - scale_);
+                }
+                return lhs < rhs ? -1 : (lhs > rhs ? 1 : 0);
+            }
+
+            i64 mantissa_;
+            u8 scale_;
+        };
+
+    } // namespace common
+} // namespace stream_buffer
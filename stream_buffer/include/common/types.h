@@ -3,6 +3,8 @@
 #include <cstdint>
 #include <cstddef>
 #include <string>
+#include <utility>
+#include <vector>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
@@ -18,6 +20,8 @@ namespace stream_buffer
             // Buffer sizes
             constexpr int MEGA_BYTE = 1048576;
             constexpr int DEFAULT_BUFFER_SIZE = 80;
+            constexpr size_t CACHE_LINE_SIZE = 64;
+            constexpr size_t MAX_DATAGRAM_SIZE = 65507; // Largest UDP payload over IPv4
 
             // Return codes
             constexpr int JOIN_FAILED = -1;
@@ -66,6 +70,8 @@ namespace stream_buffer
             std::string interface_name;
             std::string interface_ip;
             int recv_buffer_size;
+            // (transmission_code, message_kind) pairs the kernel should deliver, empty for no socket filter
+            std::vector<std::pair<char, char>> socket_filter_message_types;
 
             explicit MulticastConfig(
                 SocketDomain domain = SocketDomain::IPV4,
@@ -85,6 +91,64 @@ namespace stream_buffer
                                             recv_buffer_size(recv_buffer_size) {}
         };
 
+        // Message subscription settings shared by the user-space and kernel filters
+        class SubscriptionConfig
+        {
+        public:
+            // (transmission_code, message_kind) pairs to keep, empty to keep all
+            std::vector<std::pair<char, char>> message_types;
+            // Product ids to keep, empty to keep all
+            std::vector<std::string> products;
+
+            bool IsEnabled() const
+            {
+                return !message_types.empty() || !products.empty();
+            }
+        };
+
+        // What the receive thread does when the buffer cannot take another datagram
+        enum class OverflowPolicy
+        {
+            BLOCK,       // Wait a bounded time for the processing thread, then drop
+            DROP_NEWEST, // Read and discard new datagrams, keeping the socket drained
+            SPILL,       // Append new datagrams to a disk-backed overflow file, replayed in order
+            GROW,        // Enlarge the buffer a limited number of times, then drop
+        };
+
+        // Buffer overflow settings
+        class OverflowConfig
+        {
+        public:
+            OverflowPolicy policy = OverflowPolicy::BLOCK;
+            int block_timeout_ms = 100;                     // BLOCK: longest wait for space per datagram
+            std::string spill_path = "stream_buffer.spill"; // SPILL: overflow file
+            size_t grow_size = 0;                           // GROW: bytes added per growth, 0 for the buffer size
+            size_t max_grow_count = 1;                      // GROW: growths allowed before dropping
+        };
+
+        // Configuration class for the processing pipeline
+        class ProcessingConfig
+        {
+        public:
+            std::string reference_snapshot_path; // I010 reference data snapshot, empty to disable
+            SubscriptionConfig subscription;     // Messages to process, everything by default
+            bool validate_checksum = true;       // Disable only when packets are verified upstream
+            std::string shm_name;                // Shared-memory ring for local readers, empty to disable
+            size_t shm_capacity = 65536;         // Messages kept in the shared-memory ring
+            std::string quote_snapshot_path;     // Latest-quote table file for polling readers, empty to disable
+            OverflowConfig overflow;             // Receive behaviour when the buffer is full
+            size_t buffer_chunk_size = 0;        // Chunk size of a segmented buffer capped at the buffer size, 0 for one allocation
+            bool datagram_slots = false;         // Queue each datagram in its own slot with length, source and kernel time
+            std::string stats_socket_path;       // Unix socket serving metric snapshots, empty to disable
+            bool perf_profile = false;           // Count CPU events per datagram received and per packet decoded
+            std::string trace_path;              // Chrome trace JSON written on exit, empty to disable tracing
+            bool track_latency = false;          // Exchange-to-receive latency per line and message kind
+            int exchange_utc_offset_min = 480;   // Offset of the exchange timestamps from UTC, Taipei by default
+            std::string tick_store_path;         // Directory of columnar tick files, empty to disable
+            std::string checkpoint_path;         // State checkpoint file restored on start, empty to disable
+            int checkpoint_interval_ms = 1000;   // Time between checkpoints
+        };
+
         // Return codes
         enum class Status
         {
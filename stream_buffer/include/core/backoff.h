@@ -0,0 +1,51 @@
+#pragma once
+
+#include <sched.h>
+#include <time.h>
+
+namespace stream_buffer
+{
+    namespace core
+    {
+
+        /**
+         * @brief Progressive wait for lock-free polling loops
+         *
+         * Spins first, then yields the CPU, then sleeps briefly so an idle
+         * thread does not burn a core.
+         */
+        class Backoff
+        {
+        public:
+            static constexpr unsigned SPIN_ITERATIONS = 256; // Busy polls before yielding
+            static constexpr unsigned YIELD_ITERATIONS = 64; // Yields before sleeping
+            static constexpr long IDLE_SLEEP_NS = 50000;     // Sleep once idle
+
+            Backoff() : idle_(0) {}
+
+            void Pause()
+            {
+                if (idle_ < SPIN_ITERATIONS)
+                {
+                    ++idle_;
+                }
+                else if (idle_ < SPIN_ITERATIONS + YIELD_ITERATIONS)
+                {
+                    ++idle_;
+                    sched_yield();
+                }
+                else
+                {
+                    struct timespec delay = {0, IDLE_SLEEP_NS};
+                    nanosleep(&delay, nullptr);
+                }
+            }
+
+            void Reset() { idle_ = 0; }
+
+        private:
+            unsigned idle_;
+        };
+
+    } // namespace core
+} // namespace stream_buffer
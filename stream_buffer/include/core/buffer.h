@@ -3,22 +3,124 @@
 #include <cstddef>
 #include <memory>
 #include "common/types.h"
+#include "core/datagram_slot.h"
 
 namespace stream_buffer
 {
     namespace core
     {
 
+        // Outcome of processing a span of queued data
+        struct BatchResult
+        {
+            size_t bytes_consumed = 0; // Bytes that can be removed from the buffer
+            size_t message_count = 0;  // Complete packets handled
+        };
+
         // Interface for buffer processing strategies
         class IBufferProcessor
         {
         public:
             virtual ~IBufferProcessor() = default;
             virtual size_t ProcessMessage(const char *message, size_t length) = 0;
+
+            /**
+             * @brief Process as many complete packets as the span holds
+             *
+             * The default implementation calls ProcessMessage() until it asks
+             * for more data. Implementations override it with a non-virtual loop.
+             *
+             * @param data Start of the queued data
+             * @param length Length of the queued data
+             * @return Bytes consumed and packets handled
+             */
+            virtual BatchResult ProcessBatch(const char *data, size_t length);
+
+            /**
+             * @brief Process the packets of one datagram queued in slot mode
+             *
+             * The default implementation runs ProcessBatch() over the payload;
+             * bytes it leaves over are lost with the datagram.
+             */
+            virtual BatchResult ProcessDatagram(const DatagramSlot &slot);
+
+            /**
+             * @brief Process every complete slot in the span
+             * @param data Start of the first slot
+             * @param length Length of the queued slots
+             * @return Bytes of the slots handled and packets found in them
+             */
+            virtual BatchResult ProcessSlots(const char *data, size_t length);
+        };
+
+        /**
+         * @brief Storage shared by the receive and processing threads
+         *
+         * The receive thread writes at the end pointer outside the lock, the
+         * processing thread reads from the top pointer outside the lock; every
+         * other call is made with the lock held.
+         */
+        class IBuffer
+        {
+        public:
+            virtual ~IBuffer() = default;
+
+            // Buffer state queries
+            virtual size_t GetQueuedSize() const = 0;
+
+            /**
+             * @brief Bytes queued in the whole buffer
+             *
+             * GetQueuedSize() covers only the contiguous span at the top pointer.
+             */
+            virtual size_t GetTotalQueuedSize() const = 0;
+            virtual size_t GetAvailableSize() const = 0;
+            virtual size_t GetTotalCapacity() const = 0;
+
+            // Buffer pointers for direct access
+            virtual char *GetBufferEndPtr() const = 0;
+            virtual char *GetBufferTopPtr() const = 0;
+            virtual size_t GetBufferTop() const = 0;
+            virtual size_t GetBufferEnd() const = 0;
+
+            // State predicates
+            virtual bool IsEmpty() const = 0;
+            virtual bool ShouldCompact() const = 0;
+            virtual bool HasPendingData() const = 0;
+
+            /**
+             * @brief Whether the data at the top will never be extended
+             *
+             * A partial packet left there can then never complete.
+             */
+            virtual bool IsTopSegmentComplete() const = 0;
+
+            // Buffer operations
+            virtual void CompactBuffer() = 0;
+            virtual void AppendData(size_t data_size) = 0;
+            virtual void RemoveProcessedData(size_t bytes_processed) = 0;
+            virtual size_t ProcessPendingData() = 0;
+            virtual BatchResult ProcessPendingBatch(size_t length) = 0;
+            virtual BatchResult ProcessPendingSlots(size_t length) = 0;
+            virtual void Reset() = 0;
+
+            /**
+             * @brief Make room to write at least min_size contiguous bytes, if the buffer allows
+             * @param min_size Contiguous space wanted at the end pointer
+             * @return Contiguous space available at the end pointer
+             */
+            virtual size_t Reserve(size_t min_size) = 0;
+
+            /**
+             * @brief Raise the capacity
+             * @param additional_size Bytes to add to the capacity
+             * @return true on success, false if the allocation failed
+             */
+            virtual bool Grow(size_t additional_size) = 0;
         };
 
         // StreamBuffer class with clear responsibility and improved interface
-        class Buffer
+        class Buffer : public IBuffer
         {
         public:
             // Constructor with dependency injection for processor
@@ -26,7 +128,7 @@ namespace stream_buffer
                 size_t buffer_size = common::constants::DEFAULT_BUFFER_SIZE * common::constants::MEGA_BYTE,
                 std::unique_ptr<IBufferProcessor> processor = nullptr);
 
-            ~Buffer();
+            ~Buffer() override;
 
             // No copy constructor/assignment to prevent resource leaks
             Buffer(const Buffer &) = delete;
@@ -38,27 +140,41 @@ namespace stream_buffer
 
             // Buffer state queries
             size_t GetUsedSize() const;
-            size_t GetQueuedSize() const;
-            size_t GetAvailableSize() const;
-            size_t GetTotalCapacity() const;
+            size_t GetQueuedSize() const override;
+            size_t GetTotalQueuedSize() const override { return GetQueuedSize(); }
+            size_t GetAvailableSize() const override;
+            size_t GetTotalCapacity() const override;
 
             // Buffer pointers for direct access
-            char *GetBufferEndPtr() const;
-            char *GetBufferTopPtr() const;
-            size_t GetBufferTop() const;
-            size_t GetBufferEnd() const;
+            char *GetBufferEndPtr() const override;
+            char *GetBufferTopPtr() const override;
+            size_t GetBufferTop() const override;
+            size_t GetBufferEnd() const override;
 
             // State predicates
-            bool IsEmpty() const;
-            bool ShouldCompact() const;
-            bool HasPendingData() const;
+            bool IsEmpty() const override;
+            bool ShouldCompact() const override;
+            bool HasPendingData() const override;
+            bool IsTopSegmentComplete() const override { return false; }
 
             // Buffer operations
-            void CompactBuffer();
-            void AppendData(size_t data_size);
-            void RemoveProcessedData(size_t bytes_processed);
-            size_t ProcessPendingData();
-            void Reset();
+            void CompactBuffer() override;
+            void AppendData(size_t data_size) override;
+            void RemoveProcessedData(size_t bytes_processed) override;
+            size_t ProcessPendingData() override;
+            BatchResult ProcessPendingBatch(size_t length) override;
+            BatchResult ProcessPendingSlots(size_t length) override;
+            void Reset() override;
+
+            // Space is only freed by compaction, which the caller schedules
+            size_t Reserve(size_t min_size) override;
+
+            /**
+             * @brief Enlarge the buffer, moving the queued data to the front
+             * @param additional_size Bytes to add to the capacity
+             * @return true on success, false if the allocation failed
+             */
+            bool Grow(size_t additional_size) override;
 
         private:
             size_t top_ = 0;
@@ -72,4 +188,4 @@ namespace stream_buffer
         };
 
     } // namespace core
-} // namespace stream_buffer
\ No newline at end of file
+} // namespace stream_buffer
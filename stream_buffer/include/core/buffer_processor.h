@@ -1,8 +1,21 @@
 #pragma once
 
 #include "core/buffer.h"
+#include "core/chunked_buffer.h"
 #include "core/thread_sync.h"
+#include "core/overflow.h"
 #include "network/multicast.h"
+#include "processing/reference_data.h"
+#include "processing/message_filter.h"
+#include "processing/normalized_message.h"
+#include "processing/quote_snapshot.h"
+#include "processing/tfe_processor.h"
+#include "processing/latency_tracker.h"
+#include "processing/tick_store.h"
+#include "processing/state_checkpoint.h"
+#include "ipc/shm_publisher.h"
+#include "ipc/stats_server.h"
+#include "utils/perf_counters.h"
 #include "common/types.h"
 #include <atomic>
 #include <memory>
@@ -21,6 +34,28 @@ namespace stream_buffer
         public:
             virtual ~IMessageProcessor() = default;
             virtual bool ProcessMessage(char *data, size_t length) = 0;
+
+            /**
+             * @brief Process the whole queued span in one call
+             *
+             * The default implementation hands the span to ProcessMessage()
+             * and treats it as fully consumed on success.
+             *
+             * @param data Start of the queued data
+             * @param length Length of the queued data
+             * @param result Bytes consumed and packets handled
+             * @return true on success, false on a fatal processing error
+             */
+            virtual bool ProcessBatch(char *data, size_t length, BatchResult *result)
+            {
+                if (!ProcessMessage(data, length))
+                {
+                    return false;
+                }
+                result->bytes_consumed = length;
+                result->message_count = 1;
+                return true;
+            }
         };
 
         /**
@@ -36,12 +71,14 @@ namespace stream_buffer
              * @param buffer_size Buffer size in bytes
              * @param network_receiver Network receiver implementation
              * @param message_processor Message processor implementation
+             * @param processing_config Processing pipeline configuration
              */
             explicit BufferProcessor(
                 const common::MulticastConfig &config,
                 size_t buffer_size = common::constants::DEFAULT_BUFFER_SIZE * common::constants::MEGA_BYTE,
                 std::unique_ptr<network::INetworkReceiver> network_receiver = nullptr,
-                std::unique_ptr<IMessageProcessor> message_processor = nullptr);
+                std::unique_ptr<IMessageProcessor> message_processor = nullptr,
+                const common::ProcessingConfig &processing_config = common::ProcessingConfig());
 
             /**
              * @brief Destructor
@@ -53,16 +90,81 @@ namespace stream_buffer
             BufferProcessor &operator=(const BufferProcessor &) = delete;
 
             /**
-             * @brief Run the buffer processor
+             * @brief Run the buffer processor until Enter is pressed
              */
             void Run();
 
             /**
-             * @brief Stop the buffer processor
+             * @brief Set up the socket, unless a receiver was injected, and start both threads
+             * @return false if the socket could not be set up
+             */
+            bool Start();
+
+            /**
+             * @brief Stop both threads and release the socket
+             *
+             * A receive blocked on a quiet socket gives up after RECEIVE_TIMEOUT_MS,
+             * so this returns within a fraction of a second.
              */
             void Stop();
 
+            /**
+             * @brief Get the I010 reference data cache (safe to read from any thread)
+             */
+            const processing::ReferenceDataStore &GetReferenceData() const { return *reference_data_; }
+
+            /**
+             * @brief Get the subscription filter (skipped count is safe to read from any thread)
+             */
+            const processing::MessageFilter &GetMessageFilter() const { return *message_filter_; }
+
+            /**
+             * @brief Get the latest-quote table, nullptr unless quote_snapshot_path is set (safe to read from any thread)
+             */
+            const processing::QuoteSnapshotTable *GetQuoteSnapshots() const { return quote_snapshots_.get(); }
+
+            /**
+             * @brief Forward decoded messages to a sink, before Run
+             * @param sink Sink called on the processing thread (not owned)
+             */
+            void AddSink(processing::IMessageSink *sink);
+
+            /**
+             * @brief Get the overflow counters (safe to read from any thread)
+             */
+            OverflowStats GetOverflowStats() const { return overflow_counters_.Snapshot(); }
+
+            /**
+             * @brief Replace the default overflow line on stderr, before Run
+             * @param alert Called on the receive thread when an overflow starts or falls back to dropping
+             */
+            void SetOverflowAlert(OverflowAlert alert) { overflow_alert_ = alert; }
+
+            /**
+             * @brief Get the hardware counter totals, nullptr unless perf_profile is set (safe to read from any thread)
+             */
+            const utils::PerfProfiler *GetProfiler() const { return profiler_.get(); }
+
+            /**
+             * @brief Get the feed latency distributions, nullptr unless track_latency is set (safe to read from any thread)
+             */
+            const processing::LatencyTracker *GetLatencyTracker() const { return latency_tracker_.get(); }
+
+            /**
+             * @brief Get the tick store sink, nullptr unless tick_store_path is set (counts are safe to read from any thread)
+             */
+            const processing::TickStoreSink *GetTickStore() const { return tick_store_.get(); }
+
+            /**
+             * @brief Get the state checkpointer, nullptr unless checkpoint_path is set
+             */
+            const processing::StateCheckpointer *GetCheckpointer() const { return checkpointer_.get(); }
+
         private:
+            // Contiguous or chunked storage, as configured
+            static IBuffer *MakeBuffer(size_t buffer_size, const common::ProcessingConfig &processing_config,
+                                       std::unique_ptr<IBufferProcessor> processor);
+
             // Thread functions
             static void *ReceiveThreadFunction(void *arg);
             static void *ProcessThreadFunction(void *arg);
@@ -71,16 +173,63 @@ namespace stream_buffer
             void StartThreads();
             void JoinThreads();
 
+            // Receive into data; false on a fatal socket error, *received is 0 after a temporary one
+            bool ReceiveInto(char *data, size_t size, int *received, network::DatagramInfo *info = nullptr);
+
+            // Receive one datagram as queued: raw, or behind a slot header in slot mode
+            bool ReceiveFrame(char *data, size_t size, size_t *frame_size);
+
+            // Apply the overflow policy for one datagram; false on a fatal socket error
+            bool HandleBufferFull();
+            bool WaitForSpace();
+            bool GrowBuffer();
+            bool DropDatagram();
+            bool SpillDatagram();
+
+            // Move spilled bytes back into the buffer, in arrival order
+            void ReplaySpill(size_t avail);
+
+            // Compact and count it; the lock must be held and no span handed out
+            void CompactBuffer();
+
+            // Publish the buffer occupancy to the metrics registry
+            void UpdateBufferGauges();
+
+            // Space the buffer must offer before a datagram is received into it
+            size_t GetRequiredSpace() const;
+
+            void RaiseOverflowAlert(const char *reason);
+
             // Member variables
-            std::unique_ptr<Buffer> buffer_;
+            std::unique_ptr<processing::ReferenceDataStore> reference_data_;
+            std::unique_ptr<processing::MessageFilter> message_filter_;
+            std::unique_ptr<ipc::ShmPublisher> shm_publisher_;
+            std::unique_ptr<processing::QuoteSnapshotTable> quote_snapshots_;
+            std::unique_ptr<ipc::StatsServer> stats_server_;
+            std::unique_ptr<utils::PerfProfiler> profiler_;
+            std::unique_ptr<processing::LatencyTracker> latency_tracker_;
+            std::unique_ptr<processing::TickStoreSink> tick_store_;
+            std::unique_ptr<processing::StateCheckpointer> checkpointer_;
+            processing::TFEProcessor *tfe_processor_; // Owned by buffer_
+            std::unique_ptr<IBuffer> buffer_;
             std::unique_ptr<ThreadSync> sync_;
             std::unique_ptr<network::INetworkReceiver> network_receiver_;
             std::unique_ptr<IMessageProcessor> message_processor_;
+            std::unique_ptr<SpillSegment> spill_;
+            std::unique_ptr<char[]> scratch_; // Datagrams dropped or spilled while the buffer is full
+            common::u32 datagram_sequence_{0};
+            OverflowCounters overflow_counters_;
+            OverflowAlert overflow_alert_;
+            bool overflow_active_{false}; // Receive thread is inside an overflow episode
+            bool grow_disabled_{false};   // GROW: an allocation failed, drop instead of growing
 
             common::MulticastConfig config_;
+            common::ProcessingConfig processing_config_;
             pthread_t receive_thread_id_;
             pthread_t process_thread_id_;
             std::atomic<bool> running_{false};
+            bool started_{false}; // Threads are running or waiting to be joined
+            bool processing_{false}; // Processing thread holds a span outside the lock
             int socket_id_{-1};
         };
 
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "core/buffer.h"
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace stream_buffer
+{
+    namespace core
+    {
+        namespace constants
+        {
+            constexpr size_t DEFAULT_CHUNK_SIZE = 2 * 1048576; // Chunk size of a segmented buffer
+            constexpr size_t MAX_SPARE_CHUNKS = 2;             // Consumed chunks kept for reuse
+        } // namespace constants
+
+        /**
+         * @brief Buffer made of a chain of fixed-size chunks
+         *
+         * Datagrams are written whole into the last chunk; when it cannot take
+         * another one a chunk is taken from the free list, or allocated while
+         * under the memory cap. Packets therefore never straddle chunks and
+         * nothing is ever moved or reallocated. The processing thread reads the
+         * first chunk, which goes back to the free list once fully consumed.
+         * Only a few spare chunks are kept, so memory follows the backlog.
+         */
+        class ChunkedBuffer : public IBuffer
+        {
+        public:
+            /**
+             * @brief Construct an empty chunk chain
+             * @param max_size Memory cap; at least one chunk is always allowed
+             * @param chunk_size Bytes per chunk, raised to the largest datagram if smaller
+             * @param processor Processor for the queued data
+             */
+            explicit ChunkedBuffer(size_t max_size,
+                                   size_t chunk_size = constants::DEFAULT_CHUNK_SIZE,
+                                   std::unique_ptr<IBufferProcessor> processor = nullptr);
+            ~ChunkedBuffer() override;
+
+            // Prevent copying
+            ChunkedBuffer(const ChunkedBuffer &) = delete;
+            ChunkedBuffer &operator=(const ChunkedBuffer &) = delete;
+
+            // Buffer state queries, for the first chunk when reading and the last when writing
+            size_t GetQueuedSize() const override;
+            size_t GetTotalQueuedSize() const override;
+            size_t GetAvailableSize() const override;
+            size_t GetTotalCapacity() const override;
+
+            // Buffer pointers for direct access
+            char *GetBufferEndPtr() const override;
+            char *GetBufferTopPtr() const override;
+            size_t GetBufferTop() const override;
+            size_t GetBufferEnd() const override;
+
+            // State predicates
+            bool IsEmpty() const override;
+            bool ShouldCompact() const override { return false; }
+            bool HasPendingData() const override;
+            bool IsTopSegmentComplete() const override { return chunks_.size() > 1; }
+
+            // Buffer operations
+            void CompactBuffer() override {}
+            void AppendData(size_t data_size) override;
+            void RemoveProcessedData(size_t bytes_processed) override;
+            size_t ProcessPendingData() override;
+            BatchResult ProcessPendingBatch(size_t length) override;
+            BatchResult ProcessPendingSlots(size_t length) override;
+            void Reset() override;
+
+            // Move on to a fresh chunk when the last one is too full
+            size_t Reserve(size_t min_size) override;
+
+            // Allow more chunks; nothing is allocated until they are needed
+            bool Grow(size_t additional_size) override;
+
+            size_t GetChunkSize() const { return chunk_size_; }
+            size_t GetChunkCount() const { return chunks_.size(); }
+            size_t GetMaxChunkCount() const { return max_chunks_; }
+
+            // Chunks currently allocated, in use or spare
+            size_t GetAllocatedCount() const { return chunks_.size() + free_chunks_.size(); }
+            size_t GetPeakAllocatedCount() const { return peak_allocated_; }
+
+        private:
+            struct Chunk
+            {
+                explicit Chunk(char *buffer) : data(buffer) {}
+
+                std::unique_ptr<char[]> data;
+                size_t top = 0;
+                size_t end = 0;
+            };
+
+            // Spare chunk or a new allocation, nullptr at the cap or when out of memory
+            std::unique_ptr<Chunk> AcquireChunk();
+            void ReleaseChunk(std::unique_ptr<Chunk> chunk);
+
+            Chunk &Head() const { return *chunks_.front(); }
+            Chunk &Tail() const { return *chunks_.back(); }
+
+            size_t chunk_size_;
+            size_t max_chunks_;
+            size_t peak_allocated_ = 0;
+            std::deque<std::unique_ptr<Chunk>> chunks_; // Never empty
+            std::vector<std::unique_ptr<Chunk>> free_chunks_;
+            std::unique_ptr<IBufferProcessor> processor_;
+        };
+
+    } // namespace core
+} // namespace stream_buffer
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "common/types.h"
+#include <cstddef>
+
+namespace stream_buffer
+{
+    namespace core
+    {
+        namespace constants
+        {
+            constexpr size_t SLOT_ALIGNMENT = 8;        // Slots start on 8 byte boundaries
+            constexpr common::u8 SLOT_TRUNCATED = 0x01; // The kernel cut the datagram short
+        } // namespace constants
+
+        /**
+         * @brief Header of one queued datagram
+         *
+         * In datagram slot mode the receive thread writes this header in front
+         * of every datagram, so the processing thread handles each one on its
+         * own and damage never spreads past a datagram boundary.
+         */
+        struct DatagramSlot
+        {
+            common::u32 length;          // Payload bytes following the header
+            common::u16 source_port;     // Host byte order
+            common::u8 flags;            // constants::SLOT_*
+            common::u8 reserved;
+            common::u32 source_ip;       // Network byte order
+            common::u32 sequence;        // Datagrams received before this one
+            common::i64 receive_time_ns; // Kernel receive time (CLOCK_REALTIME), TscClock time if the kernel gave none
+
+            const char *GetPayload() const { return reinterpret_cast<const char *>(this + 1); }
+            bool IsTruncated() const { return (flags & constants::SLOT_TRUNCATED) != 0; }
+        };
+
+        static_assert(sizeof(DatagramSlot) == 24, "DatagramSlot layout must stay fixed");
+
+        /**
+         * @brief Bytes a slot takes in the buffer, header and padding included
+         */
+        constexpr size_t GetSlotSize(size_t payload_length)
+        {
+            return (sizeof(DatagramSlot) + payload_length + constants::SLOT_ALIGNMENT - 1) &
+                   ~(constants::SLOT_ALIGNMENT - 1);
+        }
+
+        namespace constants
+        {
+            constexpr size_t MAX_SLOT_SIZE = GetSlotSize(common::constants::MAX_DATAGRAM_SIZE);
+        } // namespace constants
+
+        /**
+         * @brief Call f(slot) for every complete slot in a span
+         * @return Bytes covered by the complete slots
+         */
+        template <typename Function>
+        inline size_t ForEachSlot(const char *data, size_t length, Function f)
+        {
+            size_t offset = 0;
+            while (length - offset >= sizeof(DatagramSlot))
+            {
+                const DatagramSlot *slot = reinterpret_cast<const DatagramSlot *>(data + offset);
+                size_t slot_size = GetSlotSize(slot->length);
+                if (slot_size > length - offset)
+                {
+                    break;
+                }
+                f(*slot);
+                offset += slot_size;
+            }
+            return offset;
+        }
+
+    } // namespace core
+} // namespace stream_buffer
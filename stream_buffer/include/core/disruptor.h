@@ -0,0 +1,223 @@
+#pragma once
+
+#include "common/types.h"
+#include "core/backoff.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace stream_buffer
+{
+    namespace core
+    {
+
+        /**
+         * @brief Sequence counter alone on its cache lines
+         */
+        struct PaddedSequence
+        {
+            PaddedSequence() : value(-1) {}
+
+            char padding0[common::constants::CACHE_LINE_SIZE];
+            std::atomic<common::i64> value; // Last sequence written or consumed, -1 before the first
+            char padding1[common::constants::CACHE_LINE_SIZE];
+        };
+
+        /**
+         * @brief Pre-allocated ring shared by one producer and several consumers
+         *
+         * The producer claims a sequence, fills the slot in place and publishes
+         * it. Every consumer reads the same slot through its own cursor, so
+         * nothing is copied per consumer. A consumer may depend on others and
+         * then only sees a slot once all of them released it. The producer
+         * never overwrites a slot that some consumer still needs. No locks
+         * are taken; waiting sides back off.
+         *
+         * Consumers must be registered before the first Next().
+         */
+        template <typename T>
+        class Disruptor
+        {
+        public:
+            /**
+             * @brief Construct a ring
+             * @param capacity Minimum number of slots, rounded up to a power of two
+             */
+            explicit Disruptor(size_t capacity)
+                : capacity_(RoundUpPowerOfTwo(capacity < 2 ? 2 : capacity)),
+                  mask_(capacity_ - 1),
+                  slots_(new T[capacity_]()),
+                  next_(0),
+                  cached_gate_(-1) {}
+
+            // Prevent copying
+            Disruptor(const Disruptor &) = delete;
+            Disruptor &operator=(const Disruptor &) = delete;
+
+            /**
+             * @brief Register a consumer
+             * @param dependencies Consumers that must release a slot first, all previously registered
+             * @return Consumer id
+             */
+            size_t AddConsumer(const std::vector<size_t> &dependencies = std::vector<size_t>())
+            {
+                std::unique_ptr<Consumer> consumer(new Consumer());
+                for (size_t i = 0; i < dependencies.size(); ++i)
+                {
+                    if (dependencies[i] < consumers_.size())
+                    {
+                        consumer->dependencies.push_back(dependencies[i]);
+                    }
+                }
+                consumers_.push_back(std::move(consumer));
+                return consumers_.size() - 1;
+            }
+
+            /**
+             * @brief Claim the next slot without waiting (producer only)
+             * @param sequence Output sequence of the claimed slot
+             * @return false if the slot is still needed by a consumer
+             */
+            bool TryNext(common::i64 *sequence)
+            {
+                common::i64 wrap_point = next_ - static_cast<common::i64>(capacity_);
+                if (wrap_point > cached_gate_)
+                {
+                    cached_gate_ = GetMinimumConsumerSequence(next_ - 1);
+                    if (wrap_point > cached_gate_)
+                    {
+                        return false;
+                    }
+                }
+                *sequence = next_++;
+                return true;
+            }
+
+            /**
+             * @brief Claim the next slot, waiting for the slowest consumer (producer only)
+             * @return Sequence of the claimed slot
+             */
+            common::i64 Next()
+            {
+                common::i64 sequence = 0;
+                Backoff backoff;
+                while (!TryNext(&sequence))
+                {
+                    backoff.Pause();
+                }
+                return sequence;
+            }
+
+            /**
+             * @brief Make a claimed slot, and every slot before it, visible (producer only)
+             * @param sequence Sequence returned by Next
+             */
+            void Publish(common::i64 sequence)
+            {
+                cursor_.value.store(sequence, std::memory_order_release);
+            }
+
+            // Slot of a sequence, writable between Next and Publish
+            T &Get(common::i64 sequence) { return slots_[static_cast<size_t>(sequence) & mask_]; }
+            const T &Get(common::i64 sequence) const { return slots_[static_cast<size_t>(sequence) & mask_]; }
+
+            /**
+             * @brief Highest sequence a consumer may read (consumer only)
+             * @param consumer Consumer id
+             * @return Highest readable sequence, the consumer's own sequence if nothing is new
+             */
+            common::i64 GetAvailable(size_t consumer) const
+            {
+                common::i64 available = cursor_.value.load(std::memory_order_acquire);
+                const std::vector<size_t> &dependencies = consumers_[consumer]->dependencies;
+                for (size_t i = 0; i < dependencies.size(); ++i)
+                {
+                    common::i64 upstream = consumers_[dependencies[i]]->sequence.value.load(std::memory_order_acquire);
+                    if (upstream < available)
+                    {
+                        available = upstream;
+                    }
+                }
+                return available;
+            }
+
+            /**
+             * @brief Mark every slot up to a sequence as consumed (consumer only)
+             * @param consumer Consumer id
+             * @param sequence Last sequence handled
+             */
+            void Release(size_t consumer, common::i64 sequence)
+            {
+                consumers_[consumer]->sequence.value.store(sequence, std::memory_order_release);
+            }
+
+            // Last published sequence, -1 if none
+            common::i64 GetCursor() const { return cursor_.value.load(std::memory_order_acquire); }
+
+            // Last sequence released by a consumer, -1 if none
+            common::i64 GetConsumerSequence(size_t consumer) const
+            {
+                return consumers_[consumer]->sequence.value.load(std::memory_order_acquire);
+            }
+
+            // Published slots not yet released by a consumer
+            common::i64 GetLag(size_t consumer) const
+            {
+                return GetCursor() - GetConsumerSequence(consumer);
+            }
+
+            // Lag of the slowest consumer
+            common::i64 GetMaxLag() const
+            {
+                common::i64 cursor = GetCursor();
+                return cursor - GetMinimumConsumerSequence(cursor);
+            }
+
+            size_t GetConsumerCount() const { return consumers_.size(); }
+            size_t GetCapacity() const { return capacity_; }
+
+        private:
+            struct Consumer
+            {
+                PaddedSequence sequence;
+                std::vector<size_t> dependencies;
+            };
+
+            static size_t RoundUpPowerOfTwo(size_t value)
+            {
+                size_t result = 1;
+                while (result < value)
+                {
+                    result <<= 1;
+                }
+                return result;
+            }
+
+            // Slowest consumer sequence, at most bound
+            common::i64 GetMinimumConsumerSequence(common::i64 bound) const
+            {
+                common::i64 minimum = bound;
+                for (size_t i = 0; i < consumers_.size(); ++i)
+                {
+                    common::i64 sequence = consumers_[i]->sequence.value.load(std::memory_order_acquire);
+                    if (sequence < minimum)
+                    {
+                        minimum = sequence;
+                    }
+                }
+                return minimum;
+            }
+
+            const size_t capacity_;
+            const size_t mask_;
+            std::unique_ptr<T[]> slots_;
+            std::vector<std::unique_ptr<Consumer>> consumers_;
+
+            // Producer side
+            common::i64 next_;        // Next sequence to claim
+            common::i64 cached_gate_; // Slowest consumer at the last check
+            PaddedSequence cursor_;   // Last published sequence
+        };
+
+    } // namespace core
+} // namespace stream_buffer
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "common/types.h"
+#include <atomic>
+#include <functional>
+#include <string>
+
+namespace stream_buffer
+{
+    namespace core
+    {
+
+        /**
+         * @brief Accounting of buffer overflow handling
+         */
+        struct OverflowStats
+        {
+            common::u64 full_events = 0;       // Times the buffer became full
+            common::u64 block_waits = 0;       // BLOCK: waits for space
+            common::u64 block_timeouts = 0;    // BLOCK: waits that ran out
+            common::u64 dropped_datagrams = 0; // Datagrams read and discarded
+            common::u64 dropped_bytes = 0;
+            common::u64 spilled_bytes = 0;     // SPILL: bytes written to the overflow file
+            common::u64 replayed_bytes = 0;    // SPILL: bytes moved back into the buffer
+            common::u64 spill_errors = 0;      // SPILL: writes that failed, datagram dropped
+            common::u64 grow_count = 0;        // GROW: times the buffer was enlarged
+            common::u64 grown_bytes = 0;
+
+            /**
+             * @brief One "counter overflow_<name> <value>" line per field, as served by the stats endpoint
+             */
+            std::string Format() const;
+        };
+
+        /**
+         * @brief Overflow counters written by the receive thread, readable from any thread
+         */
+        class OverflowCounters
+        {
+        public:
+            std::atomic<common::u64> full_events{0};
+            std::atomic<common::u64> block_waits{0};
+            std::atomic<common::u64> block_timeouts{0};
+            std::atomic<common::u64> dropped_datagrams{0};
+            std::atomic<common::u64> dropped_bytes{0};
+            std::atomic<common::u64> spilled_bytes{0};
+            std::atomic<common::u64> replayed_bytes{0};
+            std::atomic<common::u64> spill_errors{0};
+            std::atomic<common::u64> grow_count{0};
+            std::atomic<common::u64> grown_bytes{0};
+
+            static void Add(std::atomic<common::u64> &counter, common::u64 value)
+            {
+                counter.fetch_add(value, std::memory_order_relaxed);
+            }
+
+            OverflowStats Snapshot() const;
+        };
+
+        /**
+         * @brief Name of a policy as used in the configuration file
+         */
+        const char *OverflowPolicyName(common::OverflowPolicy policy);
+
+        /**
+         * @brief Called on the receive thread when overflow handling changes state
+         *
+         * The reason is a short static string, e.g. "buffer full". Keep the
+         * callback cheap; the socket is not read while it runs.
+         */
+        using OverflowAlert = std::function<void(common::OverflowPolicy policy, const char *reason,
+                                                 const OverflowStats &stats)>;
+
+        /**
+         * @brief Disk-backed FIFO of raw bytes for the SPILL policy
+         *
+         * The receive thread appends datagrams while the buffer is full and
+         * reads them back, in order, once space frees up. The file is
+         * truncated each time it has been fully replayed.
+         */
+        class SpillSegment
+        {
+        public:
+            SpillSegment();
+            ~SpillSegment();
+
+            // Prevent copying
+            SpillSegment(const SpillSegment &) = delete;
+            SpillSegment &operator=(const SpillSegment &) = delete;
+
+            /**
+             * @brief Create or truncate the overflow file
+             * @return true on success
+             */
+            bool Open(const std::string &path);
+
+            // Close and remove the file
+            void Close();
+
+            bool IsOpen() const { return fd_ >= 0; }
+
+            /**
+             * @brief Append bytes at the end
+             * @return true if every byte was written
+             */
+            bool Append(const char *data, size_t length);
+
+            /**
+             * @brief Read the oldest bytes
+             * @param data Output buffer
+             * @param max_length Most bytes to read
+             * @return Bytes read, 0 if empty or on error
+             */
+            size_t Read(char *data, size_t max_length);
+
+            // Bytes written but not read back yet
+            size_t GetPendingSize() const { return write_offset_ - read_offset_; }
+
+            bool IsEmpty() const { return write_offset_ == read_offset_; }
+
+        private:
+            std::string path_;
+            int fd_;
+            size_t read_offset_;
+            size_t write_offset_;
+        };
+
+    } // namespace core
+} // namespace stream_buffer
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "common/types.h"
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+namespace stream_buffer
+{
+    namespace core
+    {
+
+        /**
+         * @brief Single-writer sequence lock around a trivially copyable value
+         *
+         * The writer never blocks. Readers copy the value and retry if the
+         * sequence changed while they were copying, so a read is wait-free as
+         * long as the writer is not updating the same slot.
+         */
+        template <typename T>
+        class SeqLock
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "SeqLock requires a trivially copyable type");
+
+        public:
+            SeqLock() : sequence_(0)
+            {
+                std::memset(&value_, 0, sizeof(value_));
+            }
+
+            SeqLock(const SeqLock &) = delete;
+            SeqLock &operator=(const SeqLock &) = delete;
+
+            /**
+             * @brief Publish a new value (single writer only)
+             * @param value Value to store
+             */
+            void Store(const T &value)
+            {
+                common::u32 sequence = sequence_.load(std::memory_order_relaxed);
+                sequence_.store(sequence + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+                std::memcpy(&value_, &value, sizeof(T));
+                sequence_.store(sequence + 2, std::memory_order_release);
+            }
+
+            /**
+             * @brief Try to read a consistent copy of the value
+             * @param value Output value
+             * @return true if the copy is consistent, false if a write raced with it
+             */
+            bool TryLoad(T *value) const
+            {
+                common::u32 before = sequence_.load(std::memory_order_acquire);
+                if (before & 1)
+                {
+                    return false;
+                }
+                std::memcpy(value, &value_, sizeof(T));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                return sequence_.load(std::memory_order_relaxed) == before;
+            }
+
+            /**
+             * @brief Read a consistent copy of the value, retrying on a concurrent write
+             * @param value Output value
+             */
+            void Load(T *value) const
+            {
+                while (!TryLoad(value))
+                {
+                }
+            }
+
+            /**
+             * @brief Access the value without synchronization (writer thread only)
+             */
+            const T &Peek() const
+            {
+                return value_;
+            }
+
+            /**
+             * @brief Get the current sequence number (even when stable, 0 if never written)
+             */
+            common::u32 GetSequence() const
+            {
+                return sequence_.load(std::memory_order_acquire);
+            }
+
+        private:
+            std::atomic<common::u32> sequence_;
+            T value_;
+        };
+
+    } // namespace core
+} // namespace stream_buffer
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "common/types.h"
+#include <atomic>
+#include <memory>
+#include <type_traits>
+
+namespace stream_buffer
+{
+    namespace core
+    {
+
+        /**
+         * @brief Bounded lock-free single-producer single-consumer queue
+         *
+         * Capacity is rounded up to a power of two. Head and tail are kept on
+         * separate cache lines and each side caches the other side's index,
+         * so the shared indices are only read when the cached view runs out.
+         */
+        template <typename T>
+        class SpscQueue
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "SpscQueue requires a trivially copyable type");
+
+        public:
+            /**
+             * @brief Construct a queue
+             * @param capacity Minimum number of elements the queue can hold
+             */
+            explicit SpscQueue(size_t capacity)
+                : capacity_(RoundUpPowerOfTwo(capacity < 2 ? 2 : capacity)),
+                  mask_(capacity_ - 1),
+                  slots_(new T[capacity_]),
+                  head_(0), cached_tail_(0), tail_(0), cached_head_(0) {}
+
+            // Prevent copying
+            SpscQueue(const SpscQueue &) = delete;
+            SpscQueue &operator=(const SpscQueue &) = delete;
+
+            /**
+             * @brief Append an element (producer only)
+             * @param value Element to append
+             * @return false if the queue is full
+             */
+            bool TryPush(const T &value)
+            {
+                size_t tail = tail_.load(std::memory_order_relaxed);
+                if (tail - cached_head_ == capacity_)
+                {
+                    cached_head_ = head_.load(std::memory_order_acquire);
+                    if (tail - cached_head_ == capacity_)
+                    {
+                        return false;
+                    }
+                }
+                slots_[tail & mask_] = value;
+                tail_.store(tail + 1, std::memory_order_release);
+                return true;
+            }
+
+            /**
+             * @brief Remove the oldest element (consumer only)
+             * @param value Output element
+             * @return false if the queue is empty
+             */
+            bool TryPop(T *value)
+            {
+                size_t head = head_.load(std::memory_order_relaxed);
+                if (head == cached_tail_)
+                {
+                    cached_tail_ = tail_.load(std::memory_order_acquire);
+                    if (head == cached_tail_)
+                    {
+                        return false;
+                    }
+                }
+                *value = slots_[head & mask_];
+                head_.store(head + 1, std::memory_order_release);
+                return true;
+            }
+
+            // Approximate number of queued elements (any thread)
+            size_t GetSize() const
+            {
+                return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+            }
+
+            bool IsEmpty() const { return GetSize() == 0; }
+
+            size_t GetCapacity() const { return capacity_; }
+
+        private:
+            static size_t RoundUpPowerOfTwo(size_t value)
+            {
+                size_t result = 1;
+                while (result < value)
+                {
+                    result <<= 1;
+                }
+                return result;
+            }
+
+            const size_t capacity_;
+            const size_t mask_;
+            std::unique_ptr<T[]> slots_;
+
+            // Full cache lines between the groups keep them apart whatever the
+            // object alignment, which plain new does not raise above 16 in C++11
+            char padding0_[common::constants::CACHE_LINE_SIZE];
+
+            // Consumer side
+            std::atomic<size_t> head_;
+            size_t cached_tail_;
+            char padding1_[common::constants::CACHE_LINE_SIZE];
+
+            // Producer side
+            std::atomic<size_t> tail_;
+            size_t cached_head_;
+            char padding2_[common::constants::CACHE_LINE_SIZE];
+        };
+
+    } // namespace core
+} // namespace stream_buffer
@@ -24,8 +24,16 @@ namespace stream_buffer
             void Lock();
             void Unlock();
             void Signal();
+            void Broadcast();
             void Wait();
 
+            /**
+             * @brief Wait with a timeout, the lock must be held
+             * @param timeout_ms Longest wait in milliseconds
+             * @return false if the wait timed out
+             */
+            bool TimedWait(int timeout_ms);
+
         private:
             pthread_mutex_t mutex_;
             pthread_cond_t condition_;
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "ipc/shm_ring.h"
+#include "processing/normalized_message.h"
+#include <string>
+
+namespace stream_buffer
+{
+    namespace ipc
+    {
+
+        /**
+         * @brief Publishes normalized messages into a /dev/shm ring
+         *
+         * The writer never waits for readers: slow readers are overrun and
+         * detect it through the slot sequence. Any number of ShmReader
+         * instances in other processes can follow the ring without syscalls.
+         */
+        class ShmPublisher : public processing::IMessageSink
+        {
+        public:
+            ShmPublisher();
+            ~ShmPublisher() override;
+
+            // Prevent copying
+            ShmPublisher(const ShmPublisher &) = delete;
+            ShmPublisher &operator=(const ShmPublisher &) = delete;
+
+            /**
+             * @brief Create the ring, replacing any stale ring of the same name
+             * @param name POSIX shared-memory name, e.g. "/stream_buffer"
+             * @param capacity Minimum number of slots, rounded up to a power of two
+             * @return true on success
+             */
+            bool Open(const std::string &name, size_t capacity = constants::DEFAULT_SHM_RING_CAPACITY);
+
+            /**
+             * @brief Mark the ring closed for readers and remove it
+             */
+            void Close();
+
+            bool IsOpen() const { return header_ != nullptr; }
+
+            /**
+             * @brief Publish one message (single writer)
+             */
+            void OnMessage(const processing::NormalizedMessage &message) override;
+
+            // Messages published since Open
+            common::u64 GetPublishedCount() const { return next_ - 1; }
+
+        private:
+            std::string name_;
+            void *mapping_;
+            size_t mapping_size_;
+            ShmRingHeader *header_;
+            ShmRingSlot *slots_;
+            common::u64 mask_;
+            common::u64 next_; // Sequence of the next message, 1-based
+        };
+
+    } // namespace ipc
+} // namespace stream_buffer
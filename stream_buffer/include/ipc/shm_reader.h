@@ -0,0 +1,85 @@
+#pragma once
+
+#include "ipc/shm_ring.h"
+#include "processing/normalized_message.h"
+#include <string>
+
+namespace stream_buffer
+{
+    namespace ipc
+    {
+
+        /**
+         * @brief Follows a ring written by ShmPublisher in another process
+         *
+         * Reads are plain loads from the mapping, with no syscalls and no
+         * effect on the writer or on other readers. A reader that falls more
+         * than a ring behind skips to the oldest message still available and
+         * counts what it missed.
+         */
+        class ShmReader
+        {
+        public:
+            // Where a new reader starts
+            enum class StartPosition
+            {
+                LATEST, // Only messages published after Open
+                OLDEST, // Everything still in the ring
+            };
+
+            ShmReader();
+            ~ShmReader();
+
+            // Prevent copying
+            ShmReader(const ShmReader &) = delete;
+            ShmReader &operator=(const ShmReader &) = delete;
+
+            /**
+             * @brief Map an existing ring read-only
+             * @param name POSIX shared-memory name used by the publisher
+             * @param start Where to start reading
+             * @return true on success
+             */
+            bool Open(const std::string &name, StartPosition start = StartPosition::LATEST);
+
+            void Close();
+
+            bool IsOpen() const { return header_ != nullptr; }
+
+            /**
+             * @brief Read the next message if one is available
+             * @param message Output message
+             * @return false if the reader has caught up with the writer
+             */
+            bool TryRead(processing::NormalizedMessage *message);
+
+            // Messages overwritten before this reader got to them
+            common::u64 GetLostCount() const { return lost_; }
+
+            // Sequence of the next message to read, 1-based
+            common::u64 GetNextSequence() const { return next_; }
+
+            // Messages published but not read yet
+            common::u64 GetBacklog() const;
+
+            // The writer closed the ring; a restarted writer creates a new one
+            bool IsWriterClosed() const;
+
+            common::u64 GetCapacity() const { return capacity_; }
+
+        private:
+            // Jump to the oldest message the writer has not overwritten yet
+            void SkipOverrun();
+
+            void *mapping_;
+            size_t mapping_size_;
+            const ShmRingHeader *header_;
+            const ShmRingSlot *slots_;
+            common::u64 capacity_;
+            common::u64 mask_;
+            common::u64 next_; // Sequence of the next message, 1-based
+            common::u64 lost_;
+        };
+
+    } // namespace ipc
+} // namespace stream_buffer
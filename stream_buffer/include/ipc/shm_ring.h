@@ -0,0 +1,71 @@
+#pragma once
+
+#include "common/types.h"
+#include "processing/normalized_message.h"
+#include <atomic>
+
+namespace stream_buffer
+{
+    namespace ipc
+    {
+
+        namespace constants
+        {
+            constexpr char SHM_RING_MAGIC[8] = {'S', 'B', 'S', 'H', 'M', 'R', 'N', 'G'};
+            constexpr common::u32 SHM_RING_VERSION = 2;
+            constexpr size_t DEFAULT_SHM_RING_CAPACITY = 65536; // Messages kept in the ring
+            constexpr common::u32 SHM_RING_ACTIVE = 1;          // Writer is publishing
+            constexpr common::u32 SHM_RING_CLOSED = 2;          // Writer has gone, reopen to follow a new one
+        }
+
+        static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "Shared-memory ring needs lock-free 64-bit atomics");
+
+        /**
+         * @brief Header at the start of a shared-memory ring
+         *
+         * Shared between processes, so the layout is fixed and versioned.
+         */
+        struct ShmRingHeader
+        {
+            char magic[8];
+            common::u32 version;
+            common::u32 slot_size;            // sizeof(ShmRingSlot)
+            common::u64 capacity;             // Number of slots, a power of two
+            common::i32 writer_pid;
+            std::atomic<common::u32> state;   // SHM_RING_ACTIVE or SHM_RING_CLOSED
+            char padding0[common::constants::CACHE_LINE_SIZE - 32];
+
+            std::atomic<common::u64> write_sequence; // Messages published so far
+            char padding1[common::constants::CACHE_LINE_SIZE - sizeof(std::atomic<common::u64>)];
+        };
+
+        /**
+         * @brief One message slot with its own sequence lock
+         *
+         * Message n (1-based) lives in slot (n - 1) % capacity. The writer
+         * sets the slot sequence to 2n - 1 while copying and to 2n once the
+         * message is complete, so a reader can tell a pending, a complete
+         * and an overwritten slot apart.
+         */
+        struct ShmRingSlot
+        {
+            std::atomic<common::u64> sequence;
+            processing::NormalizedMessage message;
+            char padding[2 * common::constants::CACHE_LINE_SIZE - sizeof(std::atomic<common::u64>) -
+                         sizeof(processing::NormalizedMessage)];
+        };
+
+        static_assert(sizeof(ShmRingHeader) == 2 * common::constants::CACHE_LINE_SIZE, "ShmRingHeader layout changed");
+        static_assert(sizeof(ShmRingSlot) == 2 * common::constants::CACHE_LINE_SIZE, "ShmRingSlot layout changed");
+
+        /**
+         * @brief Size of the shared-memory object for a ring
+         * @param capacity Number of slots
+         */
+        inline size_t ShmRingSize(size_t capacity)
+        {
+            return sizeof(ShmRingHeader) + capacity * sizeof(ShmRingSlot);
+        }
+
+    } // namespace ipc
+} // namespace stream_buffer
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "utils/metrics.h"
+#include <pthread.h>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace stream_buffer
+{
+    namespace ipc
+    {
+        namespace constants
+        {
+            constexpr int STATS_POLL_INTERVAL_MS = 200; // How often the server thread checks for Stop
+        } // namespace constants
+
+        /**
+         * @brief Serves metric snapshots on a Unix domain socket
+         *
+         * Every connection receives MetricsSnapshot::Format() of the registry
+         * and is closed; the snapshot is only taken when someone asks, so the
+         * recording threads never see the server.
+         */
+        class StatsServer
+        {
+        public:
+            explicit StatsServer(const utils::MetricsRegistry &registry = utils::GetMetrics());
+            ~StatsServer();
+
+            // Prevent copying
+            StatsServer(const StatsServer &) = delete;
+            StatsServer &operator=(const StatsServer &) = delete;
+
+            /**
+             * @brief Listen on path, replacing a stale socket, and start serving
+             * @return true on success
+             */
+            bool Start(const std::string &path);
+
+            /**
+             * @brief Append more text to every snapshot, before Start
+             * @param section Called on the server thread for each connection
+             */
+            void AddSection(const std::function<std::string()> &section) { sections_.push_back(section); }
+
+            /**
+             * @brief Stop serving and remove the socket
+             */
+            void Stop();
+
+            bool IsRunning() const { return running_; }
+
+            // Snapshots served since Start
+            common::u64 GetServedCount() const { return served_.load(std::memory_order_relaxed); }
+
+        private:
+            static void *ServerThreadFunction(void *arg);
+            void Serve();
+
+            const utils::MetricsRegistry &registry_;
+            std::vector<std::function<std::string()>> sections_;
+            std::string path_;
+            int listen_fd_;
+            pthread_t thread_id_;
+            std::atomic<bool> running_{false};
+            std::atomic<common::u64> served_{0};
+        };
+
+        /**
+         * @brief Fetch one snapshot from a stats socket
+         * @param path Socket path given to StatsServer::Start
+         * @param text Output snapshot text
+         * @return true on success
+         */
+        bool QueryStats(const std::string &path, std::string *text);
+
+    } // namespace ipc
+} // namespace stream_buffer
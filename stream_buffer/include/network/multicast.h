@@ -12,6 +12,11 @@ namespace stream_buffer
 {
     namespace network
     {
+        namespace constants
+        {
+            constexpr int RECEIVE_TIMEOUT_MS = 200; // Longest a blocked receive keeps the receive thread from stopping
+        } // namespace constants
+
         /**
          * @brief Create a multicast socket
          *
@@ -50,6 +55,34 @@ namespace stream_buffer
             const std::string &group_ip,
             const std::string &interface_ip);
 
+        /**
+         * @brief Ask the kernel to timestamp every datagram on arrival (SO_TIMESTAMPNS)
+         *
+         * @param socket_fd Socket file descriptor
+         * @return int 0 on success, -1 on error
+         */
+        int EnableReceiveTimestamps(int socket_fd);
+
+        /**
+         * @brief Make blocking receives give up with EAGAIN after a while (SO_RCVTIMEO)
+         *
+         * @param socket_fd Socket file descriptor
+         * @param timeout_ms Longest wait for a datagram
+         * @return int 0 on success, -1 on error
+         */
+        int SetReceiveTimeout(int socket_fd, int timeout_ms);
+
+        /**
+         * @brief Details of a received datagram
+         */
+        struct DatagramInfo
+        {
+            common::u32 source_ip = 0; // Network byte order
+            common::u16 source_port = 0;
+            bool truncated = false;          // Larger than the receive buffer
+            common::i64 receive_time_ns = 0; // Kernel receive time (CLOCK_REALTIME), 0 if unavailable
+        };
+
         /**
          * @brief Network receiver interface
          */
@@ -66,6 +99,23 @@ namespace stream_buffer
              * @return int Bytes received or -1 on error
              */
             virtual int ReceiveData(char *buffer, size_t buffer_size) = 0;
+
+            /**
+             * @brief Receive one datagram with its source and arrival time
+             *
+             * The default implementation calls ReceiveData() and leaves the
+             * details empty.
+             *
+             * @param buffer Buffer to store received data
+             * @param buffer_size Size of the buffer
+             * @param info Filled in for the received datagram
+             * @return int Bytes received or -1 on error
+             */
+            virtual int ReceiveDatagram(char *buffer, size_t buffer_size, DatagramInfo *info)
+            {
+                *info = DatagramInfo();
+                return ReceiveData(buffer, buffer_size);
+            }
         };
 
         /**
@@ -90,6 +140,16 @@ namespace stream_buffer
              */
             int ReceiveData(char *buffer, size_t buffer_size) override;
 
+            /**
+             * @brief Receive one datagram with its source and kernel timestamp
+             *
+             * @param buffer Buffer to store received data
+             * @param buffer_size Size of the buffer
+             * @param info Filled in for the received datagram
+             * @return int Bytes received or -1 on error
+             */
+            int ReceiveDatagram(char *buffer, size_t buffer_size, DatagramInfo *info) override;
+
             /**
              * @brief Get the source IP address of the last received packet
              *
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "common/types.h"
+#include <linux/filter.h>
+#include <utility>
+#include <vector>
+
+namespace stream_buffer
+{
+    namespace network
+    {
+
+        namespace constants
+        {
+            // Offsets seen by a UDP socket filter: the program starts at the UDP header
+            constexpr common::u32 UDP_HEADER_SIZE = 8;
+            constexpr common::u32 TFE_TRANSMISSION_CODE_OFFSET = UDP_HEADER_SIZE + 1;
+            // Conditional jump offsets are 8 bits wide
+            constexpr size_t MAX_FILTER_MESSAGE_TYPES = 254;
+        }
+
+        /**
+         * @brief Build a classic BPF program that keeps only the given TFE message types
+         *
+         * The program loads the transmission_code and message_kind bytes of
+         * the first TFE packet in the UDP payload with one 16-bit load and
+         * accepts the datagram if the pair is in the list. Datagrams too short
+         * to hold those bytes are dropped by the kernel.
+         *
+         * @param message_types (transmission_code, message_kind) pairs to keep
+         * @param program Output program
+         * @return true on success, false if the list is empty or too long
+         */
+        bool BuildMessageTypeFilter(
+            const std::vector<std::pair<char, char>> &message_types,
+            std::vector<struct sock_filter> *program);
+
+        /**
+         * @brief Attach a message type filter to a socket with SO_ATTACH_FILTER
+         *
+         * @param socket_fd Socket file descriptor
+         * @param message_types (transmission_code, message_kind) pairs to keep
+         * @return int 0 on success, -1 on error
+         */
+        int AttachMessageTypeFilter(
+            int socket_fd,
+            const std::vector<std::pair<char, char>> &message_types);
+
+    } // namespace network
+} // namespace stream_buffer
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "common/types.h"
+#include "core/seqlock.h"
+#include "processing/normalized_message.h"
+#include "processing/symbol_index.h"
+#include <pthread.h>
+#include <atomic>
+#include <memory>
+
+namespace stream_buffer
+{
+    namespace processing
+    {
+
+        /**
+         * @brief Keeps only the latest message per (product, message type)
+         *
+         * The producer overwrites the slot of the key under its sequence lock
+         * and marks the key in a dirty bitmap; it never waits for the
+         * consumer. The consumer drains the dirty keys at its own pace and
+         * always receives the freshest message of each key. Updates that were
+         * overwritten before being drained are counted as conflated.
+         *
+         * OnMessage must be called from a single producer thread and Drain
+         * from a single consumer thread.
+         */
+        class ConflatingSink : public IMessageSink
+        {
+        public:
+            /**
+             * @brief Construct a conflating sink
+             * @param consumer Sink drained by the thread started with Start (optional)
+             * @param max_symbols Maximum number of distinct products
+             */
+            explicit ConflatingSink(std::unique_ptr<IMessageSink> consumer = nullptr,
+                                    common::u32 max_symbols = constants::DEFAULT_MAX_SYMBOLS);
+            ~ConflatingSink() override;
+
+            // Prevent copying
+            ConflatingSink(const ConflatingSink &) = delete;
+            ConflatingSink &operator=(const ConflatingSink &) = delete;
+
+            /**
+             * @brief Replace the pending message of the key (producer only)
+             */
+            void OnMessage(const NormalizedMessage &message) override;
+
+            /**
+             * @brief Deliver the latest message of every dirty key (consumer only)
+             * @param consumer Sink receiving the messages
+             * @param max_messages Stop after this many messages, the rest stay dirty
+             * @return Number of messages delivered
+             */
+            size_t Drain(IMessageSink *consumer, size_t max_messages = static_cast<size_t>(-1));
+
+            /**
+             * @brief Start a thread draining into the consumer given at construction
+             * @return true on success
+             */
+            bool Start();
+
+            /**
+             * @brief Deliver what is still dirty and join the drain thread
+             */
+            void Stop();
+
+            // Messages offered by the producer
+            common::u64 GetUpdateCount() const { return update_count_.load(std::memory_order_relaxed); }
+
+            // Messages overwritten before the consumer drained them
+            common::u64 GetConflatedCount() const { return conflated_count_.load(std::memory_order_relaxed); }
+
+            // Messages handed to the consumer
+            common::u64 GetDeliveredCount() const { return delivered_count_.load(std::memory_order_relaxed); }
+
+            // Messages dropped because the product table was full
+            common::u64 GetOverflowCount() const { return overflow_count_.load(std::memory_order_relaxed); }
+
+        private:
+            static void *DrainThreadFunction(void *arg);
+
+            // Mark the key dirty, return false if it already was
+            bool MarkDirty(size_t key);
+
+            SymbolIndex symbols_;
+            size_t key_count_;
+            std::unique_ptr<core::SeqLock<NormalizedMessage>[]> slots_;
+            std::unique_ptr<std::atomic<common::u64>[]> dirty_;   // One bit per key
+            std::unique_ptr<std::atomic<common::u64>[]> summary_; // One bit per non-empty dirty word
+            size_t dirty_words_;
+            size_t summary_words_;
+
+            std::unique_ptr<IMessageSink> consumer_;
+            pthread_t drain_thread_;
+            std::atomic<bool> running_;
+            bool started_;
+
+            std::atomic<common::u64> update_count_;
+            std::atomic<common::u64> conflated_count_;
+            std::atomic<common::u64> delivered_count_;
+            std::atomic<common::u64> overflow_count_;
+        };
+
+    } // namespace processing
+} // namespace stream_buffer
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "common/types.h"
+#include "core/disruptor.h"
+#include "processing/normalized_message.h"
+#include <pthread.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace stream_buffer
+{
+    namespace processing
+    {
+
+        namespace constants
+        {
+            constexpr size_t DEFAULT_FANOUT_CAPACITY = 65536; // Ring slots shared by all consumers
+            constexpr size_t FANOUT_LAG_SAMPLE_INTERVAL = 64;  // Messages between lag gauge updates, a power of two
+        }
+
+        /**
+         * @brief Delivers every normalized message to several consumers
+         *
+         * Messages are written once into a disruptor ring and each consumer
+         * thread reads them in place at its own pace. A consumer registered
+         * with dependencies only sees a message after those consumers handled
+         * it, e.g. a recorder that must run after the book builder. The
+         * producer waits when the slowest consumer is a full ring behind.
+         * OnMessage and Drain must be called from a single producer thread.
+         */
+        class FanOutDispatcher : public IMessageSink
+        {
+        public:
+            /**
+             * @brief Construct a dispatcher
+             * @param capacity Ring size in messages
+             */
+            explicit FanOutDispatcher(size_t capacity = constants::DEFAULT_FANOUT_CAPACITY);
+            ~FanOutDispatcher() override;
+
+            // Prevent copying
+            FanOutDispatcher(const FanOutDispatcher &) = delete;
+            FanOutDispatcher &operator=(const FanOutDispatcher &) = delete;
+
+            /**
+             * @brief Register a consumer, before Start
+             * @param sink Sink called from the consumer's own thread
+             * @param dependencies Ids of consumers that must handle each message first
+             * @return Consumer id
+             */
+            size_t AddConsumer(std::unique_ptr<IMessageSink> sink,
+                               const std::vector<size_t> &dependencies = std::vector<size_t>());
+
+            /**
+             * @brief Start one thread per consumer
+             * @return true on success
+             */
+            bool Start();
+
+            /**
+             * @brief Let every consumer catch up with the producer and join them
+             */
+            void Stop();
+
+            /**
+             * @brief Publish a message to all consumers
+             *
+             * Before Start, and after Stop, the sinks are called inline in
+             * registration order.
+             */
+            void OnMessage(const NormalizedMessage &message) override;
+
+            /**
+             * @brief Flush the sinks when running inline, consumers flush their own
+             */
+            void Flush() override;
+
+            /**
+             * @brief Wait until every consumer handled every published message
+             */
+            void Drain();
+
+            size_t GetConsumerCount() const { return consumers_.size(); }
+
+            // Messages published but not yet handled by the slowest consumer
+            common::i64 GetMaxLag() const { return ring_.GetMaxLag(); }
+
+            // Messages published but not yet handled by one consumer
+            common::i64 GetLag(size_t consumer) const { return ring_.GetLag(consumer); }
+
+            // Highest lag seen by the producer, sampled every FANOUT_LAG_SAMPLE_INTERVAL messages
+            common::i64 GetPeakLag() const { return peak_lag_.load(std::memory_order_relaxed); }
+
+        private:
+            struct Consumer;
+
+            static void *ConsumerThreadFunction(void *arg);
+            void RunConsumer(Consumer &consumer);
+
+            core::Disruptor<NormalizedMessage> ring_;
+            std::vector<std::unique_ptr<Consumer>> consumers_;
+            std::atomic<bool> running_;
+            std::atomic<common::i64> peak_lag_;
+            bool started_;
+        };
+
+    } // namespace processing
+} // namespace stream_buffer
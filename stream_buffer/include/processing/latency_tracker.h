@@ -0,0 +1,198 @@
+#pragma once
+
+#include "common/types.h"
+#include <atomic>
+#include <memory>
+#include <string>
+
+namespace stream_buffer
+{
+    namespace processing
+    {
+        namespace constants
+        {
+            constexpr size_t LATENCY_SUB_BUCKET_BITS = 4;                          // 16 buckets per power of two, within 6.25%
+            constexpr size_t LATENCY_SUB_BUCKETS = 1u << LATENCY_SUB_BUCKET_BITS;
+            constexpr size_t LATENCY_BUCKETS = 40 * LATENCY_SUB_BUCKETS;          // Up to 2^43 ns, about 2.4 hours
+            constexpr size_t LATENCY_LINES = 10;                                   // One per transmission code digit
+            constexpr int DEFAULT_EXCHANGE_UTC_OFFSET_MIN = 480;                   // TAIFEX quotes Taipei time
+            constexpr common::i64 NS_PER_DAY = 86400LL * 1000000000LL;
+        } // namespace constants
+
+        // Message types tracked separately within a line
+        enum class LatencyKind : common::u8
+        {
+            I010,
+            TRADE,
+            QUOTE,
+            OTHER,
+            COUNT
+        };
+
+        constexpr size_t LATENCY_KIND_COUNT = static_cast<size_t>(LatencyKind::COUNT);
+
+        const char *GetLatencyKindName(LatencyKind kind);
+
+        /**
+         * @brief Latency distribution of one line and kind at one point in time
+         */
+        struct LatencySnapshot
+        {
+            common::u64 count = 0;
+            common::u64 sum_ns = 0;
+            common::i64 min_ns = 0;    // Signed: negative when the exchange clock runs ahead of ours
+            common::i64 max_ns = 0;
+            common::u64 negative = 0;  // Received before the exchange timestamp, not in the buckets
+            common::u64 invalid = 0;   // Timestamp is not a time of day
+            common::u64 buckets[constants::LATENCY_BUCKETS] = {};
+
+            /**
+             * @brief Upper bound of the bucket holding the given fraction of values, capped at the maximum
+             * @param quantile Fraction between 0 and 1
+             */
+            common::i64 GetPercentile(double quantile) const;
+
+            // Fold another distribution into this one
+            void Merge(const LatencySnapshot &other);
+        };
+
+        /**
+         * @brief Exchange-to-receive latency per line and message kind
+         *
+         * Compares the information_time of every message, local exchange time
+         * of day, with the time we received it. Lines are transmission codes.
+         * Values go into log-linear buckets, 16 per power of two, so recording
+         * is a bucket index and a few relaxed stores. Only one thread may
+         * record; any thread may take snapshots.
+         */
+        class LatencyTracker
+        {
+        public:
+            /**
+             * @brief Construct a tracker
+             * @param utc_offset_minutes Offset of the exchange's time of day from UTC
+             */
+            explicit LatencyTracker(int utc_offset_minutes = constants::DEFAULT_EXCHANGE_UTC_OFFSET_MIN);
+
+            // Prevent copying
+            LatencyTracker(const LatencyTracker &) = delete;
+            LatencyTracker &operator=(const LatencyTracker &) = delete;
+
+            /**
+             * @brief Record one message
+             * @param transmission_code Line the message came on
+             * @param kind Message type
+             * @param information_time_ns Exchange time, nanoseconds since local midnight
+             * @param receive_time_ns Receive time, CLOCK_REALTIME nanoseconds
+             */
+            void Record(char transmission_code, LatencyKind kind, common::i64 information_time_ns,
+                        common::i64 receive_time_ns)
+            {
+                Cell &cell = GetCell(transmission_code, kind);
+                if (information_time_ns < 0 || information_time_ns >= constants::NS_PER_DAY)
+                {
+                    Bump(cell.invalid, 1);
+                    return;
+                }
+
+                common::i64 latency = GetTimeOfDayNs(receive_time_ns) - information_time_ns;
+
+                // A message stamped just before midnight and received just after, or the reverse
+                if (latency > constants::NS_PER_DAY / 2)
+                {
+                    latency -= constants::NS_PER_DAY;
+                }
+                else if (latency < -constants::NS_PER_DAY / 2)
+                {
+                    latency += constants::NS_PER_DAY;
+                }
+
+                common::u64 count = cell.count.load(std::memory_order_relaxed);
+                if (count == 0 || latency < cell.min_ns.load(std::memory_order_relaxed))
+                {
+                    cell.min_ns.store(latency, std::memory_order_relaxed);
+                }
+                if (count == 0 || latency > cell.max_ns.load(std::memory_order_relaxed))
+                {
+                    cell.max_ns.store(latency, std::memory_order_relaxed);
+                }
+                cell.count.store(count + 1, std::memory_order_relaxed);
+                if (latency < 0)
+                {
+                    Bump(cell.negative, 1);
+                    return;
+                }
+                Bump(cell.buckets[GetBucket(static_cast<common::u64>(latency))], 1);
+                Bump(cell.sum_ns, static_cast<common::u64>(latency));
+            }
+
+            LatencySnapshot Snapshot(char transmission_code, LatencyKind kind) const;
+
+            // Every line and kind merged
+            LatencySnapshot SnapshotAll() const;
+
+            /**
+             * @brief One "latency <line> <kind> ..." line per line and kind seen,
+             *        then the total, as served by the stats endpoint
+             */
+            std::string Format() const;
+
+            // Nanoseconds since local exchange midnight at a CLOCK_REALTIME time
+            common::i64 GetTimeOfDayNs(common::i64 realtime_ns) const
+            {
+                common::i64 local = (realtime_ns + utc_offset_ns_) % constants::NS_PER_DAY;
+                return local < 0 ? local + constants::NS_PER_DAY : local;
+            }
+
+            // Index of the bucket holding value
+            static size_t GetBucket(common::u64 value)
+            {
+                if (value < constants::LATENCY_SUB_BUCKETS)
+                {
+                    return static_cast<size_t>(value);
+                }
+                size_t shift = 63 - static_cast<size_t>(__builtin_clzll(value)) - constants::LATENCY_SUB_BUCKET_BITS;
+                size_t bucket = (shift << constants::LATENCY_SUB_BUCKET_BITS) + static_cast<size_t>(value >> shift);
+                return bucket < constants::LATENCY_BUCKETS ? bucket : constants::LATENCY_BUCKETS - 1;
+            }
+
+            // Largest value in a bucket
+            static common::u64 GetBucketUpperBound(size_t bucket);
+
+        private:
+            struct Cell
+            {
+                std::atomic<common::u64> count;
+                std::atomic<common::u64> sum_ns;
+                std::atomic<common::i64> min_ns;
+                std::atomic<common::i64> max_ns;
+                std::atomic<common::u64> negative;
+                std::atomic<common::u64> invalid;
+                std::atomic<common::u64> buckets[constants::LATENCY_BUCKETS];
+            };
+
+            // Single writer, so a relaxed load and store is enough
+            static void Bump(std::atomic<common::u64> &value, common::u64 delta)
+            {
+                value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+            }
+
+            // Transmission codes are validated digits by the header decoder
+            Cell &GetCell(char transmission_code, LatencyKind kind) const
+            {
+                size_t line = static_cast<size_t>(static_cast<unsigned char>(transmission_code) - '0');
+                if (line >= constants::LATENCY_LINES)
+                {
+                    line = 0;
+                }
+                return cells_[line * LATENCY_KIND_COUNT + static_cast<size_t>(kind)];
+            }
+
+            static void Read(const Cell &cell, LatencySnapshot *snapshot);
+
+            common::i64 utc_offset_ns_;
+            std::unique_ptr<Cell[]> cells_;
+        };
+
+    } // namespace processing
+} // namespace stream_buffer
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "common/types.h"
+#include "processing/symbol_index.h"
+#include "processing/tfe.h"
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace stream_buffer
+{
+    namespace processing
+    {
+
+        namespace constants
+        {
+            constexpr size_t MESSAGE_TYPE_BITS = 256 * 256; // Every (transmission_code, message_kind) pair
+            constexpr size_t PRODUCT_FILTER_BITS = 1 << 16; // Hashed product bitset size
+        }
+
+        /**
+         * @brief Subscription filter evaluated on raw header bytes
+         *
+         * A bitmap over (transmission_code, message_kind) rejects unwanted
+         * message types, and a hashed product bitset rejects unwanted
+         * products by reading the product id at its fixed offset after the
+         * header. Hash collisions can let an unsubscribed product through, but
+         * a subscribed product is never dropped. Only message types that start
+         * their body with a product id are subject to the product filter.
+         */
+        class MessageFilter
+        {
+        public:
+            /**
+             * @brief Build the filter from the subscription config
+             * @param config Subscription settings
+             */
+            explicit MessageFilter(const common::SubscriptionConfig &config = common::SubscriptionConfig());
+
+            // Prevent copying
+            MessageFilter(const MessageFilter &) = delete;
+            MessageFilter &operator=(const MessageFilter &) = delete;
+
+            /**
+             * @brief Decide whether a complete packet should be processed
+             *
+             * Counts the packet as skipped when it is rejected. Called from the
+             * processing thread only.
+             *
+             * @param packet Start of the packet (ESC byte)
+             * @param body_size Decoded body length
+             * @return true to process the packet, false to skip it
+             */
+            bool Accept(const char *packet, size_t body_size)
+            {
+                if (!enabled_)
+                {
+                    return true;
+                }
+
+                size_t type = MessageTypeKey(packet[1], packet[2]);
+                if (!TestBit(type_bits_, type) ||
+                    (filter_products_ && TestBit(product_keyed_bits_, type) &&
+                     body_size >= constants::PRODUCT_ID_SIZE &&
+                     !TestBit(product_bits_, ProductKey(packet + sizeof(tfe::Header)))))
+                {
+                    skipped_.store(skipped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                    return false;
+                }
+                return true;
+            }
+
+            bool IsEnabled() const { return enabled_; }
+
+            /**
+             * @brief Number of packets rejected so far (any thread)
+             */
+            common::u64 GetSkippedCount() const { return skipped_.load(std::memory_order_relaxed); }
+
+        private:
+            static size_t MessageTypeKey(char transmission_code, char message_kind)
+            {
+                return (static_cast<size_t>(static_cast<common::u8>(transmission_code)) << 8) |
+                       static_cast<common::u8>(message_kind);
+            }
+
+            static size_t ProductKey(const char *product_id)
+            {
+                // The top bits depend on every byte of the id
+                return static_cast<size_t>(HashProductId(product_id) >> 48) & (constants::PRODUCT_FILTER_BITS - 1);
+            }
+
+            static bool TestBit(const common::u64 *bits, size_t index)
+            {
+                return (bits[index >> 6] >> (index & 63)) & 1;
+            }
+
+            static void SetBit(common::u64 *bits, size_t index)
+            {
+                bits[index >> 6] |= 1ULL << (index & 63);
+            }
+
+            bool enabled_;
+            bool filter_products_;
+            std::atomic<common::u64> skipped_;
+            common::u64 type_bits_[constants::MESSAGE_TYPE_BITS / 64];
+            common::u64 product_keyed_bits_[constants::MESSAGE_TYPE_BITS / 64];
+            common::u64 product_bits_[constants::PRODUCT_FILTER_BITS / 64];
+        };
+
+        /**
+         * @brief Parse a subscribe_messages list such as "1:1,2:1"
+         * @param text Comma separated <trans>:<kind> pairs, blanks around items ignored
+         * @param message_types Appended with the parsed pairs
+         * @return false if an item is not a <trans>:<kind> pair
+         */
+        bool ParseMessageTypes(const std::string &text, std::vector<std::pair<char, char>> *message_types);
+
+        /**
+         * @brief Parse a subscribe_products list such as "TXFL4,MXFL4"
+         * @param text Comma separated product ids, blanks around items and empty items dropped
+         * @param products Appended with the parsed ids
+         * @return false if an id is longer than PRODUCT_ID_SIZE and could never match
+         */
+        bool ParseProductList(const std::string &text, std::vector<std::string> *products);
+
+    } // namespace processing
+} // namespace stream_buffer
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "common/price.h"
+#include "common/types.h"
+#include <type_traits>
+
+namespace stream_buffer
+{
+    namespace processing
+    {
+
+        // Kind of event carried by a NormalizedMessage
+        enum class MessageType : common::u8
+        {
+            PRODUCT_INFO = 0, // I010, price is the reference price
+            TRADE = 1,        // One match of an I020
+            QUOTE = 2,        // I080 top of book
+        };
+
+        namespace constants
+        {
+            constexpr size_t MESSAGE_TYPE_COUNT = 3; // Number of MessageType values
+        }
+
+        /**
+         * @brief Fixed-size, decoded form of a market data message
+         *
+         * Plain data so it can be copied through queues, seqlocks and shared
+         * memory. Prices are mantissas in units of 10^-price_scale.
+         */
+        struct NormalizedMessage
+        {
+            common::u64 information_time;    // hhmmssuuuuuu from the packet header
+            common::i64 information_time_ns; // information_time as nanoseconds since midnight
+            common::u32 information_seq;
+            common::u32 symbol;              // Symbol index, INVALID_SYMBOL if unknown
+            char product_id[10];
+            char transmission_code;
+            MessageType type;
+            common::u8 price_scale;
+            common::u8 reserved[3];
+            common::i64 price;               // Trade or reference price
+            common::i64 quantity;            // Trade quantity
+            common::i64 bid_price;
+            common::i64 bid_quantity;
+            common::i64 ask_price;
+            common::i64 ask_quantity;
+
+            common::Price GetPrice() const { return common::Price(price, price_scale); }
+            common::Price GetBidPrice() const { return common::Price(bid_price, price_scale); }
+            common::Price GetAskPrice() const { return common::Price(ask_price, price_scale); }
+        };
+
+        static_assert(std::is_trivially_copyable<NormalizedMessage>::value, "NormalizedMessage must be trivially copyable");
+        static_assert(sizeof(NormalizedMessage) == 88, "NormalizedMessage layout changed");
+
+        /**
+         * @brief Consumer of normalized messages
+         */
+        class IMessageSink
+        {
+        public:
+            virtual ~IMessageSink() = default;
+
+            // Handle one message
+            virtual void OnMessage(const NormalizedMessage &message) = 0;
+
+            // Called when the producer has no more data for now
+            virtual void Flush() {}
+        };
+
+    } // namespace processing
+} // namespace stream_buffer
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "processing/normalized_message.h"
+#include "processing/tfe_decoder.h"
+#include <cstring>
+
+namespace stream_buffer
+{
+    namespace processing
+    {
+
+        namespace detail
+        {
+            // Fill the fields common to every message type
+            inline void NormalizeHeader(const MessageView &view, const char *product_id, MessageType type,
+                                        NormalizedMessage *message)
+            {
+                std::memset(message, 0, sizeof(*message));
+                message->information_time = view.GetHeader().information_time;
+                message->information_time_ns = view.GetHeader().information_time_ns;
+                message->information_seq = view.GetHeader().information_seq;
+                message->symbol = view.GetSymbol();
+                std::memcpy(message->product_id, product_id, sizeof(message->product_id));
+                message->transmission_code = view.GetHeader().transmission_code;
+                message->type = type;
+                message->price_scale = view.GetPriceScale();
+            }
+        } // namespace detail
+
+        /**
+         * @brief Convert an I010 view, price is the reference price
+         * @return false if the body fails to decode
+         */
+        inline bool Normalize(const I010View &view, NormalizedMessage *message)
+        {
+            common::Price price;
+            if (!view.GetReferencePrice(&price))
+            {
+                return false;
+            }
+            detail::NormalizeHeader(view, view.GetProductId(), MessageType::PRODUCT_INFO, message);
+            message->price = price.GetMantissa();
+            message->price_scale = price.GetScale();
+            return true;
+        }
+
+        /**
+         * @brief Convert one match of an I020 view
+         * @param match Match index below GetMatchCount(), 0 is the first match
+         * @return false if the match fails to decode
+         */
+        inline bool Normalize(const TradeView &view, size_t match, NormalizedMessage *message)
+        {
+            common::Price price;
+            common::i64 quantity = 0;
+            if (!view.GetMatch(match, &price, &quantity))
+            {
+                return false;
+            }
+            detail::NormalizeHeader(view, view.GetProductId(), MessageType::TRADE, message);
+            message->price = price.GetMantissa();
+            message->quantity = quantity;
+            return true;
+        }
+
+        /**
+         * @brief Convert the top level of an I080 view
+         * @return false if the body fails to decode
+         */
+        inline bool Normalize(const QuoteView &view, NormalizedMessage *message)
+        {
+            common::Price bid, ask;
+            common::i64 bid_quantity = 0, ask_quantity = 0;
+            if (!view.GetBid(0, &bid, &bid_quantity) || !view.GetAsk(0, &ask, &ask_quantity))
+            {
+                return false;
+            }
+            detail::NormalizeHeader(view, view.GetProductId(), MessageType::QUOTE, message);
+            message->bid_price = bid.GetMantissa();
+            message->bid_quantity = bid_quantity;
+            message->ask_price = ask.GetMantissa();
+            message->ask_quantity = ask_quantity;
+            return true;
+        }
+
+    } // namespace processing
+} // namespace stream_buffer
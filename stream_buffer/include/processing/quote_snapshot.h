@@ -0,0 +1,200 @@
+#pragma once
+
+#include "common/types.h"
+#include "core/seqlock.h"
+#include "processing/normalized_message.h"
+#include "processing/symbol_index.h"
+#include <atomic>
+#include <string>
+#include <unordered_map>
+
+namespace stream_buffer
+{
+    namespace processing
+    {
+
+        namespace constants
+        {
+            constexpr common::u8 SNAPSHOT_HAS_REFERENCE = 0x01;
+            constexpr common::u8 SNAPSHOT_HAS_QUOTE = 0x02;
+            constexpr common::u8 SNAPSHOT_HAS_TRADE = 0x04;
+        }
+
+        /**
+         * @brief Latest known state of one product
+         *
+         * Prices are mantissas in units of 10^-price_scale.
+         */
+        struct QuoteSnapshot
+        {
+            char product_id[constants::PRODUCT_ID_SIZE];
+            common::u8 price_scale;
+            common::u8 flags;          // SNAPSHOT_HAS_* bits
+            common::u32 update_count;  // Messages applied to the snapshot
+            common::i64 bid_price;
+            common::i64 bid_quantity;
+            common::i64 ask_price;
+            common::i64 ask_quantity;
+            common::i64 last_price;
+            common::i64 last_quantity;
+            common::i64 reference_price;
+            common::u64 quote_time;    // information_time of the last quote
+            common::u64 trade_time;    // information_time of the last trade
+
+            common::Price GetBidPrice() const { return common::Price(bid_price, price_scale); }
+            common::Price GetAskPrice() const { return common::Price(ask_price, price_scale); }
+            common::Price GetLastPrice() const { return common::Price(last_price, price_scale); }
+            common::Price GetReferencePrice() const { return common::Price(reference_price, price_scale); }
+        };
+
+        /**
+         * @brief Table slot, two cache lines so a read touches at most two
+         */
+        struct QuoteSnapshotSlot
+        {
+            core::SeqLock<QuoteSnapshot> snapshot;
+            char padding[2 * common::constants::CACHE_LINE_SIZE - sizeof(core::SeqLock<QuoteSnapshot>)];
+        };
+
+        /**
+         * @brief Header of a mapped snapshot table
+         */
+        struct QuoteSnapshotHeader
+        {
+            char magic[8];
+            common::u32 version;
+            common::u32 slot_size;             // sizeof(QuoteSnapshotSlot)
+            common::u32 max_symbols;
+            std::atomic<common::u32> symbol_count; // Slots in use, published after the slot
+            char padding[2 * common::constants::CACHE_LINE_SIZE - 24];
+        };
+
+        static_assert(sizeof(QuoteSnapshotSlot) == 2 * common::constants::CACHE_LINE_SIZE, "QuoteSnapshotSlot layout changed");
+        static_assert(sizeof(QuoteSnapshotHeader) == 2 * common::constants::CACHE_LINE_SIZE, "QuoteSnapshotHeader layout changed");
+
+        /**
+         * @brief Symbol-indexed table of the latest quote and trade per product
+         *
+         * The processing thread applies messages as a sink; every slot has its
+         * own sequence lock, so readers in any thread copy a consistent
+         * snapshot without ever blocking the writer. When created on a file
+         * (e.g. under /dev/shm) the table can also be polled by other
+         * processes through QuoteSnapshotReader.
+         */
+        class QuoteSnapshotTable : public IMessageSink
+        {
+        public:
+            /**
+             * @brief Construct a table
+             * @param max_symbols Maximum number of distinct products
+             * @param path File to map for other processes, empty for private memory
+             */
+            explicit QuoteSnapshotTable(common::u32 max_symbols = constants::DEFAULT_MAX_SYMBOLS,
+                                        const std::string &path = std::string());
+            ~QuoteSnapshotTable() override;
+
+            // Prevent copying
+            QuoteSnapshotTable(const QuoteSnapshotTable &) = delete;
+            QuoteSnapshotTable &operator=(const QuoteSnapshotTable &) = delete;
+
+            /**
+             * @brief Apply a message (writer thread only)
+             */
+            void OnMessage(const NormalizedMessage &message) override;
+
+            /**
+             * @brief Put back a snapshot saved earlier, e.g. from a checkpoint (writer thread only)
+             * @return false if the table is full
+             */
+            bool Restore(const QuoteSnapshot &snapshot);
+
+            /**
+             * @brief Find the slot of a product (any thread)
+             * @return Slot index or INVALID_SYMBOL if the product was never seen
+             */
+            common::u32 Find(const char *product_id) const { return symbols_.Find(product_id); }
+
+            /**
+             * @brief Copy a consistent snapshot (any thread, wait-free for the writer)
+             * @param slot Slot index returned by Find
+             * @param snapshot Output snapshot
+             * @return false if the slot is not in use
+             */
+            bool Read(common::u32 slot, QuoteSnapshot *snapshot) const;
+
+            // Find and Read in one call
+            bool Read(const char *product_id, QuoteSnapshot *snapshot) const
+            {
+                return Read(Find(product_id), snapshot);
+            }
+
+            common::u32 GetSize() const { return header_ ? header_->symbol_count.load(std::memory_order_acquire) : 0; }
+
+            // Products dropped because the table was full
+            common::u64 GetOverflowCount() const { return overflow_count_.load(std::memory_order_relaxed); }
+
+            // Whether the table is visible to other processes
+            bool IsShared() const { return !path_.empty(); }
+
+        private:
+            SymbolIndex symbols_;
+            std::string path_;
+            void *mapping_;
+            size_t mapping_size_;
+            QuoteSnapshotHeader *header_;
+            QuoteSnapshotSlot *slots_;
+            std::atomic<common::u64> overflow_count_;
+        };
+
+        /**
+         * @brief Read-only view of a table mapped by another process
+         */
+        class QuoteSnapshotReader
+        {
+        public:
+            QuoteSnapshotReader();
+            ~QuoteSnapshotReader();
+
+            // Prevent copying
+            QuoteSnapshotReader(const QuoteSnapshotReader &) = delete;
+            QuoteSnapshotReader &operator=(const QuoteSnapshotReader &) = delete;
+
+            /**
+             * @brief Map a table file read-only
+             * @param path File passed to QuoteSnapshotTable
+             * @return true on success
+             */
+            bool Open(const std::string &path);
+
+            void Close();
+
+            /**
+             * @brief Find the slot of a product, scanning slots added since the last miss
+             * @return Slot index or INVALID_SYMBOL if the product is not in the table
+             */
+            common::u32 Find(const char *product_id);
+
+            /**
+             * @brief Copy a consistent snapshot
+             * @return false if the slot is not in use
+             */
+            bool Read(common::u32 slot, QuoteSnapshot *snapshot) const;
+
+            bool Read(const char *product_id, QuoteSnapshot *snapshot)
+            {
+                return Read(Find(product_id), snapshot);
+            }
+
+            common::u32 GetSize() const;
+
+        private:
+            void *mapping_;
+            size_t mapping_size_;
+            const QuoteSnapshotHeader *header_;
+            const QuoteSnapshotSlot *slots_;
+            common::u32 scanned_; // Slots already added to the local index
+            std::unordered_map<std::string, common::u32> index_;
+        };
+
+    } // namespace processing
+} // namespace stream_buffer
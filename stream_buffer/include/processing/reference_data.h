@@ -0,0 +1,147 @@
+#pragma once
+
+#include "common/types.h"
+#include "common/price.h"
+#include "core/seqlock.h"
+#include "processing/symbol_index.h"
+#include "processing/tfe.h"
+#include <atomic>
+#include <memory>
+#include <string>
+
+namespace stream_buffer
+{
+    namespace processing
+    {
+
+        /**
+         * @brief Latest I010 product definition in native form
+         */
+        struct ReferenceRecord
+        {
+            char product_id[constants::PRODUCT_ID_SIZE];
+            char transmission_code;   // '1' futures, '4' options
+            char prod_kind;
+            char dynamic_banding;
+            common::u8 decimal_locator;
+            common::u8 strike_price_decimal_locator;
+            common::u8 flow_group;
+            common::i64 reference_price; // Mantissa scaled by decimal_locator
+            common::u32 begin_date;      // yyyymmdd
+            common::u32 end_date;        // yyyymmdd
+            common::u32 delivery_date;   // yyyymmdd
+            common::u32 update_count;    // Number of I010 messages seen for the product
+
+            /**
+             * @brief Get the reference price as a fixed-point price
+             */
+            common::Price GetReferencePrice() const
+            {
+                return common::Price(reference_price, decimal_locator);
+            }
+        };
+
+        /**
+         * @brief Last-value cache of I010 product definitions
+         *
+         * The processing thread is the only writer. Other threads read through
+         * the lock-free symbol index and per-record sequence locks. The table
+         * can be saved to and restored from an mmap'd snapshot file so that a
+         * restart has reference data before the next I010 cycle.
+         */
+        class ReferenceDataStore
+        {
+        public:
+            /**
+             * @brief Construct a store
+             * @param max_products Maximum number of distinct products
+             */
+            explicit ReferenceDataStore(common::u32 max_products = constants::DEFAULT_MAX_SYMBOLS);
+
+            // Prevent copying
+            ReferenceDataStore(const ReferenceDataStore &) = delete;
+            ReferenceDataStore &operator=(const ReferenceDataStore &) = delete;
+
+            /**
+             * @brief Store an I010 body (writer thread only)
+             * @param transmission_code Transmission code of the message header
+             * @param body I010 body
+             * @return Symbol index of the product or INVALID_SYMBOL on error
+             */
+            common::u32 Update(char transmission_code, const tfe::BodyI010 &body);
+
+            /**
+             * @brief Store a record as-is (writer thread only)
+             * @param record Record to store
+             * @return Symbol index of the product or INVALID_SYMBOL if the store is full
+             */
+            common::u32 Update(const ReferenceRecord &record);
+
+            /**
+             * @brief Store a saved record, keeping its update_count (writer thread only)
+             * @param record Record from a snapshot or checkpoint
+             * @return Symbol index of the product or INVALID_SYMBOL if the store is full
+             */
+            common::u32 Restore(const ReferenceRecord &record);
+
+            /**
+             * @brief Look up a product (any thread)
+             * @param product_id Product id, PRODUCT_ID_SIZE bytes
+             * @param record Output record
+             * @return true if the product is known
+             */
+            bool Lookup(const char *product_id, ReferenceRecord *record) const;
+
+            /**
+             * @brief Read a record by symbol index (any thread)
+             * @param symbol Symbol index
+             * @param record Output record
+             * @return true if the symbol exists
+             */
+            bool GetRecord(common::u32 symbol, ReferenceRecord *record) const;
+
+            /**
+             * @brief Read the decimal locator of a symbol without copying its record (any thread)
+             * @param symbol Symbol index
+             * @return Decimal locator, 0 if the symbol does not exist
+             */
+            common::u8 GetDecimalLocator(common::u32 symbol) const
+            {
+                return symbol < symbols_.GetSize() ? decimal_locators_[symbol].load(std::memory_order_relaxed) : 0;
+            }
+
+            /**
+             * @brief Get the symbol index shared with other per-product tables
+             */
+            const SymbolIndex &GetSymbolIndex() const { return symbols_; }
+
+            common::u32 GetSize() const { return symbols_.GetSize(); }
+
+            /**
+             * @brief Write all records to a snapshot file
+             *
+             * The file is written under a temporary name and renamed into place,
+             * so readers never see a partial snapshot.
+             *
+             * @param path Snapshot file path
+             * @return true on success
+             */
+            bool SaveSnapshot(const std::string &path) const;
+
+            /**
+             * @brief Load records from a snapshot file (writer thread only)
+             * @param path Snapshot file path
+             * @return Number of records loaded, or -1 on error
+             */
+            int LoadSnapshot(const std::string &path);
+
+        private:
+            common::u32 Write(const ReferenceRecord &record, bool count_update);
+
+            SymbolIndex symbols_;
+            std::unique_ptr<core::SeqLock<ReferenceRecord>[]> records_;
+            std::unique_ptr<std::atomic<common::u8>[]> decimal_locators_; // Copied from records_ for the decoder
+        };
+
+    } // namespace processing
+} // namespace stream_buffer
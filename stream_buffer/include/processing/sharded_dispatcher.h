@@ -0,0 +1,101 @@
+#pragma once
+
+#include "common/types.h"
+#include "core/spsc_queue.h"
+#include "processing/normalized_message.h"
+#include <pthread.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace stream_buffer
+{
+    namespace processing
+    {
+
+        namespace constants
+        {
+            constexpr size_t DEFAULT_SHARD_QUEUE_CAPACITY = 65536; // Messages per worker queue
+            constexpr size_t MAX_SHARD_WORKERS = 64;
+            constexpr size_t QUEUE_DEPTH_SAMPLE_INTERVAL = 64; // Messages between queue depth gauge updates, a power of two
+        }
+
+        /**
+         * @brief Routes normalized messages to worker threads by product
+         *
+         * Each worker owns one sink and one SPSC queue. A product always maps
+         * to the same worker, so per-product ordering is preserved while
+         * different products are handled in parallel. OnMessage and Drain
+         * must be called from a single producer thread. When the queue of a
+         * worker is full the producer waits, applying backpressure upstream.
+         * Worker sinks are flushed whenever their queue runs empty.
+         */
+        class ShardedDispatcher : public IMessageSink
+        {
+        public:
+            /**
+             * @brief Construct a dispatcher
+             * @param worker_sinks One sink per worker, each only called from its worker thread
+             * @param queue_capacity Queue size per worker
+             */
+            explicit ShardedDispatcher(std::vector<std::unique_ptr<IMessageSink>> worker_sinks,
+                                       size_t queue_capacity = constants::DEFAULT_SHARD_QUEUE_CAPACITY);
+            ~ShardedDispatcher() override;
+
+            // Prevent copying
+            ShardedDispatcher(const ShardedDispatcher &) = delete;
+            ShardedDispatcher &operator=(const ShardedDispatcher &) = delete;
+
+            /**
+             * @brief Start the worker threads
+             * @return true on success
+             */
+            bool Start();
+
+            /**
+             * @brief Deliver every queued message and join the workers
+             */
+            void Stop();
+
+            /**
+             * @brief Queue a message for the worker owning its product
+             *
+             * Before Start, and after Stop, the sink is called inline.
+             */
+            void OnMessage(const NormalizedMessage &message) override;
+
+            /**
+             * @brief Flush the worker sinks when running inline, workers flush their own
+             */
+            void Flush() override;
+
+            /**
+             * @brief Wait until the workers have handled every queued message
+             */
+            void Drain();
+
+            size_t GetWorkerCount() const { return workers_.size(); }
+
+            // Worker that owns a product
+            size_t GetShard(const char *product_id) const;
+
+            // Messages handled by one worker
+            common::u64 GetProcessedCount(size_t worker) const;
+
+            // Times the producer found a worker queue full
+            common::u64 GetBackpressureCount() const { return backpressure_count_; }
+
+        private:
+            struct Worker;
+
+            static void *WorkerThreadFunction(void *arg);
+            void RunWorker(Worker &worker);
+
+            std::vector<std::unique_ptr<Worker>> workers_;
+            std::atomic<bool> running_;
+            bool started_;
+            common::u64 backpressure_count_;
+        };
+
+    } // namespace processing
+} // namespace stream_buffer
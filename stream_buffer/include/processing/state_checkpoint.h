@@ -0,0 +1,210 @@
+#pragma once
+
+#include "common/types.h"
+#include "processing/normalized_message.h"
+#include "processing/quote_snapshot.h"
+#include "processing/reference_data.h"
+#include <pthread.h>
+#include <atomic>
+#include <string>
+
+namespace stream_buffer
+{
+    namespace processing
+    {
+
+        namespace constants
+        {
+            constexpr int CHECKPOINT_INTERVAL_MS = 1000;  // Default time between checkpoints
+            constexpr size_t CHECKPOINT_LINES = 10;       // One per transmission code digit
+            constexpr common::u32 CHECKPOINT_VERSION = 1;
+        }
+
+        /**
+         * @brief First bytes of a checkpoint file
+         *
+         * Two regions of region_size bytes follow at region_offset. Each is a
+         * CheckpointRegionHeader, max_symbols ReferenceRecord slots and
+         * max_symbols QuoteSnapshot slots.
+         */
+        struct CheckpointFileHeader
+        {
+            char magic[8];
+            common::u32 version;
+            common::u32 max_symbols;
+            common::u32 reference_size;   // sizeof(ReferenceRecord)
+            common::u32 quote_size;       // sizeof(QuoteSnapshot)
+            common::u32 lines;
+            common::u32 message_types;
+            common::u64 region_offset;    // Page aligned
+            common::u64 region_size;      // Page aligned
+            char padding[16];
+        };
+
+        /**
+         * @brief State saved in one region, valid when the checksum matches
+         */
+        struct CheckpointRegionHeader
+        {
+            common::u64 checksum;         // Of everything after it up to the last used slot
+            common::u64 generation;       // Increases by one per checkpoint, 0 if never written
+            common::i64 saved_time_ns;    // CLOCK_REALTIME
+            common::u64 message_count;    // Messages seen by the checkpointer
+            common::u32 reference_count;
+            common::u32 quote_count;
+            common::u32 sequences[constants::CHECKPOINT_LINES * constants::MESSAGE_TYPE_COUNT];
+            char padding[96];
+        };
+
+        static_assert(sizeof(CheckpointFileHeader) == 64, "CheckpointFileHeader layout changed");
+        static_assert(sizeof(CheckpointRegionHeader) == 256, "CheckpointRegionHeader layout changed");
+
+        /**
+         * @brief Periodic checkpoints of the state a restart needs mid-session
+         *
+         * Saves the I010 reference cache, the top of book per product and the
+         * last information_seq per line and message type to an mmap'd file.
+         * The file holds two regions and each checkpoint overwrites the older
+         * one, so a crash while writing leaves the previous checkpoint intact.
+         * Slots are copied through their sequence locks on the checkpoint
+         * thread and written only when they changed, so the processing thread
+         * never waits and msync only writes dirty pages. As a sink, added
+         * after the tables it saves, it costs the processing thread two
+         * stores per message. The sequences are informational: they are
+         * restored for GetLastSequence, but nothing skips or detects gaps
+         * with them.
+         */
+        class StateCheckpointer : public IMessageSink
+        {
+        public:
+            /**
+             * @brief Construct a checkpointer
+             * @param path Checkpoint file, kept across restarts
+             * @param reference Reference cache to save and restore, may be nullptr
+             * @param quotes Top-of-book table to save and restore, may be nullptr
+             * @param interval_ms Time between checkpoints
+             * @param max_symbols Slots per table, at least the tables' capacity
+             */
+            StateCheckpointer(const std::string &path, ReferenceDataStore *reference, QuoteSnapshotTable *quotes,
+                              int interval_ms = constants::CHECKPOINT_INTERVAL_MS,
+                              common::u32 max_symbols = constants::DEFAULT_MAX_SYMBOLS);
+            ~StateCheckpointer() override;
+
+            // Prevent copying
+            StateCheckpointer(const StateCheckpointer &) = delete;
+            StateCheckpointer &operator=(const StateCheckpointer &) = delete;
+
+            /**
+             * @brief Map the file, keeping existing checkpoints of the same layout
+             * @return false if the file could not be created or mapped
+             */
+            bool Open();
+
+            /**
+             * @brief Load the newest valid checkpoint into the tables (before processing starts)
+             * @return Generation loaded, 0 if there was none
+             */
+            common::u64 Restore();
+
+            /**
+             * @brief Start the checkpoint thread
+             */
+            bool Start();
+
+            /**
+             * @brief Stop the checkpoint thread and write a final checkpoint
+             */
+            void Stop();
+
+            /**
+             * @brief Write a checkpoint now, unless nothing was seen since the last one
+             *
+             * Called by the checkpoint thread; may be called directly while it is not running.
+             * @return true if a checkpoint was written
+             */
+            bool Checkpoint();
+
+            // Track the last sequence number (processing thread only)
+            void OnMessage(const NormalizedMessage &message) override
+            {
+                size_t slot = GetSequenceSlot(message.transmission_code, message.type);
+                if (slot < constants::CHECKPOINT_LINES * constants::MESSAGE_TYPE_COUNT)
+                {
+                    sequences_[slot].store(message.information_seq, std::memory_order_release);
+                }
+                message_count_.store(message_count_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+
+            // Last information_seq seen or restored for a line and type, 0 if none (informational)
+            common::u32 GetLastSequence(char transmission_code, MessageType type) const;
+
+            // Generation of the newest checkpoint in the file
+            common::u64 GetGeneration() const { return generation_.load(std::memory_order_relaxed); }
+
+            // CLOCK_REALTIME when the newest checkpoint was saved, 0 if none
+            common::i64 GetLastCheckpointTimeNs() const { return saved_time_ns_.load(std::memory_order_relaxed); }
+
+            // Generation loaded by Restore, 0 if none
+            common::u64 GetRestoredGeneration() const { return restored_generation_; }
+
+            // How old the restored checkpoint was when loaded
+            common::i64 GetRestoredAgeNs() const { return restored_age_ns_; }
+
+            // Time Restore took to load it
+            common::i64 GetRestoreDurationNs() const { return restore_duration_ns_; }
+
+            /**
+             * @brief Format the checkpoint and restore figures for the stats socket
+             * @return One "checkpoint ..." line
+             */
+            std::string Format() const;
+
+            // Checkpoints written by this process
+            common::u64 GetCheckpointCount() const { return checkpoint_count_.load(std::memory_order_relaxed); }
+
+            // Slots rewritten by the last checkpoint
+            common::u64 GetLastChangedSlots() const { return changed_slots_; }
+
+        private:
+            static size_t GetSequenceSlot(char transmission_code, MessageType type)
+            {
+                size_t line = static_cast<size_t>(static_cast<unsigned char>(transmission_code) - '0');
+                return line * constants::MESSAGE_TYPE_COUNT + static_cast<size_t>(type);
+            }
+
+            CheckpointRegionHeader *GetRegion(size_t region) const;
+            ReferenceRecord *GetReferenceSlots(CheckpointRegionHeader *region) const;
+            QuoteSnapshot *GetQuoteSlots(CheckpointRegionHeader *region) const;
+
+            // Checksum of a region's used part
+            common::u64 ComputeChecksum(CheckpointRegionHeader *region) const;
+            bool IsValid(CheckpointRegionHeader *region) const;
+
+            static void *CheckpointThreadFunction(void *arg);
+            void RunCheckpoints();
+
+            std::string path_;
+            ReferenceDataStore *reference_;
+            QuoteSnapshotTable *quotes_;
+            int interval_ms_;
+            common::u32 max_symbols_;
+            char *mapping_;
+            size_t mapping_size_;
+            size_t region_size_;
+            std::atomic<common::u64> generation_;
+            std::atomic<common::i64> saved_time_ns_;
+            common::u64 saved_message_count_;    // message_count_ at the last checkpoint
+            common::u64 changed_slots_;
+            common::u64 restored_generation_;    // Set by Restore before any other thread starts
+            common::i64 restored_age_ns_;
+            common::i64 restore_duration_ns_;
+            std::atomic<common::u32> sequences_[constants::CHECKPOINT_LINES * constants::MESSAGE_TYPE_COUNT];
+            std::atomic<common::u64> message_count_;
+            std::atomic<common::u64> checkpoint_count_;
+            pthread_t thread_;
+            std::atomic<bool> running_;
+            bool started_;
+        };
+
+    } // namespace processing
+} // namespace stream_buffer
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "common/types.h"
+#include <atomic>
+#include <cstring>
+#include <memory>
+
+namespace stream_buffer
+{
+    namespace processing
+    {
+
+        namespace constants
+        {
+            constexpr size_t PRODUCT_ID_SIZE = 10;        // X(10) product code
+            constexpr common::u32 INVALID_SYMBOL = 0xFFFFFFFF; // Returned when a product is unknown
+            constexpr common::u32 DEFAULT_MAX_SYMBOLS = 32768;
+        }
+
+        /**
+         * @brief Hash a fixed-width product id
+         * @param product_id Product id, PRODUCT_ID_SIZE bytes
+         * @return 64-bit hash
+         */
+        inline common::u64 HashProductId(const char *product_id)
+        {
+            // Two unaligned loads cover the 10-byte id
+            common::u64 head = 0;
+            common::u16 tail = 0;
+            std::memcpy(&head, product_id, sizeof(head));
+            std::memcpy(&tail, product_id + sizeof(head), sizeof(tail));
+
+            // Every byte reaches the top half of the product; fold it into the low half too,
+            // since option series differ only in their last bytes
+            common::u64 hash = (head ^ (tail * 0xC2B2AE3D27D4EB4FULL)) * 0x9E3779B97F4A7C15ULL;
+            return hash ^ (hash >> 32);
+        }
+
+        /**
+         * @brief Map from fixed-width product id to a dense symbol index
+         *
+         * Indices are assigned in insertion order starting at 0, so they can
+         * address flat per-symbol tables. One thread inserts; any number of
+         * threads may look up concurrently without locks. Entries are never
+         * removed.
+         */
+        class SymbolIndex
+        {
+        public:
+            /**
+             * @brief Construct an index
+             * @param max_symbols Maximum number of distinct products
+             */
+            explicit SymbolIndex(common::u32 max_symbols = constants::DEFAULT_MAX_SYMBOLS);
+
+            // Prevent copying
+            SymbolIndex(const SymbolIndex &) = delete;
+            SymbolIndex &operator=(const SymbolIndex &) = delete;
+
+            /**
+             * @brief Find a product (any thread)
+             * @param product_id Product id, PRODUCT_ID_SIZE bytes
+             * @return Symbol index or INVALID_SYMBOL if not present
+             */
+            common::u32 Find(const char *product_id) const;
+
+            /**
+             * @brief Find a product or insert it (writer thread only)
+             * @param product_id Product id, PRODUCT_ID_SIZE bytes
+             * @return Symbol index or INVALID_SYMBOL if the index is full
+             */
+            common::u32 Insert(const char *product_id);
+
+            /**
+             * @brief Copy the product id of a symbol
+             * @param symbol Symbol index
+             * @param product_id Output buffer of PRODUCT_ID_SIZE bytes
+             * @return true if the symbol exists
+             */
+            bool GetProductId(common::u32 symbol, char *product_id) const;
+
+            common::u32 GetSize() const { return size_.load(std::memory_order_acquire); }
+            common::u32 GetCapacity() const { return max_symbols_; }
+
+        private:
+            struct Entry
+            {
+                std::atomic<common::u32> symbol_plus_one; // 0 while the entry is empty
+                char product_id[constants::PRODUCT_ID_SIZE];
+            };
+
+            common::u32 max_symbols_;
+            common::u32 mask_;
+            std::atomic<common::u32> size_;
+            std::unique_ptr<Entry[]> entries_;
+            std::unique_ptr<common::u32[]> entry_of_symbol_;
+        };
+
+    } // namespace processing
+} // namespace stream_buffer
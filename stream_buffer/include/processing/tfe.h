@@ -1,10 +1,16 @@
 #pragma once
 
 #include "utils/debug.h"
+#include "common/price.h"
+#include "utils/checksum.h"
 #include <cstdint>
 #include <cstring>
 #include <string>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace stream_buffer
 {
     namespace processing
@@ -14,12 +20,24 @@ namespace stream_buffer
 
             // Packet constants
             constexpr uint8_t ESC_CODE = 0x1B;       // Escape code marker (ASCII ESC)
-            constexpr uint8_t CHECKSUM_CODE = 0x0D;  // Checksum value (typically CR)
             constexpr uint8_t TERMINAL_CODE = 0x0A;  // Terminal code (typically LF)
             constexpr size_t CHECK_SUM_SIZE = 1;     // Checksum size in bytes
             constexpr size_t TERMINAL_CODE_SIZE = 2; // Terminal code size in bytes
             constexpr size_t MAX_BODY_SIZE = 4096;   // Maximum allowed body size
 
+            // Transmission codes
+            constexpr char TRANSMISSION_FUTURES_BASIC = '1';   // Futures reference data
+            constexpr char TRANSMISSION_FUTURES_TRADING = '2'; // Futures trades and quotes
+            constexpr char TRANSMISSION_OPTIONS_BASIC = '4';   // Options reference data
+            constexpr char TRANSMISSION_OPTIONS_TRADING = '5'; // Options trades and quotes
+
+            // Message kinds within a transmission code
+            constexpr char KIND_PRODUCT_INFO = '1'; // I010 with a basic transmission code
+            constexpr char KIND_MATCH = '1';        // I020 with a trading transmission code
+            constexpr char KIND_BEST_QUOTES = '2';  // I080 with a trading transmission code
+
+            constexpr size_t QUOTE_LEVELS = 5;      // Depth of the I080 order book
+
 #pragma pack(push, 1) // Disable alignment for accurate packet structure
 
             /**
@@ -137,7 +155,15 @@ namespace stream_buffer
                     std::memcpy(prod_id_copy, prod_id_s, sizeof(prod_id_s));
                     FMT_PRINT("Product ID: %s\n", prod_id_copy);
 
-                    FMT_PRINT("Reference Price: %lld\n", utils::decode_bcd(reference_price, sizeof(reference_price)));
+                    common::Price price;
+                    if (GetReferencePrice(&price))
+                    {
+                        FMT_PRINT("Reference Price: %s\n", price.ToString().c_str());
+                    }
+                    else
+                    {
+                        FMT_PRINT("Reference Price: invalid\n");
+                    }
                     FMT_PRINT("Product Kind: %c\n", prod_kind);
                     FMT_PRINT("Decimal Locator: %u\n", static_cast<unsigned>(utils::decode_bcd(&decimal_locator, sizeof(decimal_locator))));
                     FMT_PRINT("Strike Price Decimal Locator: %u\n",
@@ -158,6 +184,36 @@ namespace stream_buffer
                     return std::string(prod_id_s, sizeof(prod_id_s));
                 }
 
+                /**
+                 * @brief Get the price decimal locator
+                 * @return Number of decimal places of futures prices, 0 if invalid
+                 */
+                uint8_t GetDecimalLocator() const
+                {
+                    long long locator = utils::decode_bcd(&decimal_locator, sizeof(decimal_locator));
+                    return locator < 0 ? 0 : static_cast<uint8_t>(locator);
+                }
+
+                /**
+                 * @brief Get the strike price decimal locator
+                 * @return Number of decimal places of option strike prices, 0 if invalid
+                 */
+                uint8_t GetStrikePriceDecimalLocator() const
+                {
+                    long long locator = utils::decode_bcd(&strike_price_decimal_locator, sizeof(strike_price_decimal_locator));
+                    return locator < 0 ? 0 : static_cast<uint8_t>(locator);
+                }
+
+                /**
+                 * @brief Get the reference price scaled by the decimal locator
+                 * @param price Output price
+                 * @return true on success, false if the BCD data is invalid
+                 */
+                bool GetReferencePrice(common::Price *price) const
+                {
+                    return common::Price::FromBcd(reference_price, sizeof(reference_price), GetDecimalLocator(), price);
+                }
+
                 /**
                  * @brief Validate body fields
                  * @return true if body is valid, false otherwise
@@ -182,8 +238,189 @@ namespace stream_buffer
                 }
             };
 
+            /**
+             * @brief Trade structure (I020)
+             *
+             * Fixed leading part of a match message. It is followed by
+             * match_display_item further MatchItem entries and a MatchTotals
+             * trailer.
+             */
+            struct BodyI020
+            {
+                char prod_id_s[10];           // X(10) product code
+                uint8_t match_time[6];        // 9(12) -> 6 bytes BCD (hhmmssmmmuuu)
+                char first_match_price_sign;  // X(1)  -> '-' negative, otherwise positive
+                uint8_t first_match_price[5]; // 9(9)  -> 5 bytes BCD
+                uint8_t first_match_qty[4];   // 9(8)  -> 4 bytes BCD
+                uint8_t match_display_item;   // 9(2)  -> 1 byte BCD, number of further matches
+            };
+
+            /**
+             * @brief Additional match entry following BodyI020
+             */
+            struct MatchItem
+            {
+                char match_price_sign;  // X(1)
+                uint8_t match_price[5]; // 9(9)
+                uint8_t match_qty[4];   // 9(8)
+            };
+
+            /**
+             * @brief Trailer of an I020 body
+             */
+            struct MatchTotals
+            {
+                uint8_t match_total_qty[4]; // 9(8)
+                uint8_t match_buy_cnt[4];   // 9(8)
+                uint8_t match_sell_cnt[4];  // 9(8)
+            };
+
+            /**
+             * @brief One price level of the I080 order book
+             */
+            struct QuoteLevel
+            {
+                char price_sign;     // X(1)
+                uint8_t price[5];    // 9(9)
+                uint8_t quantity[4]; // 9(8)
+            };
+
+            /**
+             * @brief Best quotes structure (I080)
+             */
+            struct BodyI080
+            {
+                char prod_id_s[10];            // X(10) product code
+                QuoteLevel buy[QUOTE_LEVELS];  // Best bids, best first
+                QuoteLevel sell[QUOTE_LEVELS]; // Best asks, best first
+            };
+
 #pragma pack(pop)
 
+            /**
+             * @brief Header fields decoded to native integers
+             */
+            struct DecodedHeader
+            {
+                uint64_t information_time;    // hhmmssmmmuuu as a decimal number
+                int64_t information_time_ns;  // The same time as nanoseconds since midnight
+                uint32_t information_seq;
+                uint16_t body_length;
+                uint8_t version_no;
+                char transmission_code;
+                char message_kind;
+
+                /**
+                 * @brief Print header information for debugging
+                 */
+                void Print() const
+                {
+                    FMT_PRINT("TFE Header:\n");
+                    FMT_PRINT("  Trans Code: %c\n", transmission_code);
+                    FMT_PRINT("  Message Kind: %c\n", message_kind);
+                    FMT_PRINT("  Info Time: %llu\n", static_cast<unsigned long long>(information_time));
+                    FMT_PRINT("  Info Seq: %u\n", information_seq);
+                    FMT_PRINT("  Version No: %u\n", static_cast<unsigned>(version_no));
+                    FMT_PRINT("  Body Length: %u\n", static_cast<unsigned>(body_length));
+                }
+            };
+
+            /**
+             * @brief Check that a transmission code is an ASCII digit
+             */
+            inline bool IsTransmissionCode(char code)
+            {
+                return code >= '0' && code <= '9';
+            }
+
+            /**
+             * @brief Check that a message kind is an ASCII digit or upper case letter
+             */
+            inline bool IsMessageKind(char kind)
+            {
+                return (kind >= '0' && kind <= '9') || (kind >= 'A' && kind <= 'Z');
+            }
+
+            /**
+             * @brief Validate and decode a header in a single pass
+             *
+             * Loads the 16 header bytes once, checks the ESC code, the
+             * transmission code and message kind, and every BCD nibble with
+             * vector compares, then converts each BCD byte to binary in the same
+             * register before combining the fields.
+             *
+             * @param data Start of the packet, at least sizeof(Header) bytes
+             * @param decoded Output header
+             * @return true if the header is valid, false otherwise
+             */
+            inline bool DecodeHeader(const char *data, DecodedHeader *decoded)
+            {
+                // Byte offsets of the BCD fields within the header
+                constexpr unsigned BCD_BYTES_MASK = 0xFFF8; // bytes 3..15
+
+                uint8_t binary[sizeof(Header)];
+#if defined(__SSE2__)
+                const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+                const __m128i nibble_mask = _mm_set1_epi8(0x0F);
+                const __m128i nine = _mm_set1_epi8(9);
+                const __m128i low = _mm_and_si128(bytes, nibble_mask);
+                const __m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble_mask);
+                const __m128i invalid = _mm_or_si128(_mm_cmpgt_epi8(low, nine), _mm_cmpgt_epi8(high, nine));
+                if (_mm_movemask_epi8(invalid) & BCD_BYTES_MASK)
+                {
+                    return false;
+                }
+
+                // Packed BCD to binary: byte - 6 * high_nibble
+                const __m128i high_times_two = _mm_add_epi8(high, high);
+                const __m128i high_times_six = _mm_add_epi8(high_times_two, _mm_add_epi8(high_times_two, high_times_two));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(binary), _mm_sub_epi8(bytes, high_times_six));
+#else
+                for (size_t i = 0; i < sizeof(Header); ++i)
+                {
+                    uint8_t byte = static_cast<uint8_t>(data[i]);
+                    uint8_t high = byte >> 4;
+                    uint8_t low = byte & 0x0F;
+                    if (((BCD_BYTES_MASK >> i) & 1) && (high > 9 || low > 9))
+                    {
+                        return false;
+                    }
+                    binary[i] = static_cast<uint8_t>(high * 10 + low);
+                }
+#endif
+                if (static_cast<uint8_t>(data[0]) != ESC_CODE ||
+                    !IsTransmissionCode(data[1]) ||
+                    !IsMessageKind(data[2]))
+                {
+                    return false;
+                }
+
+                uint16_t body_length = static_cast<uint16_t>(binary[14] * 100 + binary[15]);
+                if (body_length > MAX_BODY_SIZE)
+                {
+                    return false;
+                }
+
+                uint64_t information_time = 0;
+                for (size_t i = 3; i < 9; ++i)
+                {
+                    information_time = information_time * 100 + binary[i];
+                }
+
+                // hh, mm and ss are already binary; mmm and uuu span three BCD bytes
+                int64_t seconds = (binary[3] * 60 + binary[4]) * 60 + binary[5];
+                int64_t microseconds = (binary[6] * 100 + binary[7]) * 100 + binary[8];
+
+                decoded->information_time = information_time;
+                decoded->information_time_ns = seconds * 1000000000LL + microseconds * 1000;
+                decoded->information_seq = ((binary[9] * 100u + binary[10]) * 100u + binary[11]) * 100u + binary[12];
+                decoded->version_no = binary[13];
+                decoded->body_length = body_length;
+                decoded->transmission_code = data[1];
+                decoded->message_kind = data[2];
+                return true;
+            }
+
             /**
              * @brief Calculate packet total size from body size
              * @param body_size Size of packet body
@@ -194,6 +431,21 @@ namespace stream_buffer
                 return sizeof(Header) + body_size + CHECK_SUM_SIZE + TERMINAL_CODE_SIZE;
             }
 
+            /**
+             * @brief Compute the checksum of a packet
+             *
+             * The TFE checksum is the XOR of every byte after the ESC code up to,
+             * but not including, the checksum byte.
+             *
+             * @param data Packet data
+             * @param length Packet length excluding terminal code
+             * @return Expected checksum byte
+             */
+            inline uint8_t ComputeChecksum(const char *data, size_t length)
+            {
+                return utils::xor_checksum(data + 1, length - 1 - CHECK_SUM_SIZE);
+            }
+
             /**
              * @brief Validate packet checksum
              * @param data Packet data
@@ -207,14 +459,87 @@ namespace stream_buffer
                     return false;
                 }
 
-                // Simple checksum validation - in a real implementation this would be more complex
-                uint8_t checksum = data[length - 1];
-                return checksum == CHECKSUM_CODE;
+                return static_cast<uint8_t>(data[length - 1]) == ComputeChecksum(data, length);
+            }
+
+            /**
+             * @brief Decode a sign byte and BCD magnitude into a signed integer
+             * @param sign Sign byte, '-' for negative
+             * @param data Pointer to BCD data
+             * @param length Length of the BCD data in bytes
+             * @param value Output value
+             * @return true on success, false if the BCD data is invalid
+             */
+            inline bool DecodeSignedBcd(char sign, const uint8_t *data, size_t length, int64_t *value)
+            {
+                long long magnitude = utils::decode_bcd(data, length);
+                if (magnitude < 0)
+                {
+                    return false;
+                }
+                *value = sign == '-' ? -magnitude : magnitude;
+                return true;
+            }
+
+            /**
+             * @brief Find the next candidate packet header
+             * @param data Data to search
+             * @param length Length of the data
+             * @return Offset of the next ESC code that may start a header, or length if none
+             */
+            inline size_t FindNextHeader(const char *data, size_t length)
+            {
+                if (!data || length == 0)
+                {
+                    return 0;
+                }
+
+                for (size_t i = 0; i < length; ++i)
+                {
+                    if (static_cast<uint8_t>(data[i]) == ESC_CODE)
+                    {
+                        // Check if we have enough data for a potential header
+                        if (i + sizeof(Header) <= length)
+                        {
+                            const auto *possible_header = reinterpret_cast<const Header *>(data + i);
+                            // Do a quick validation of key fields
+                            if (IsTransmissionCode(possible_header->transmission_code))
+                            {
+                                FMT_PRINT("Found potential header at offset %zu\n", i);
+                                return i;
+                            }
+                        }
+                        else
+                        {
+                            // Found ESC but not enough data to validate header
+                            FMT_PRINT("Found ESC code at offset %zu but not enough data for header\n", i);
+                            return i;
+                        }
+                    }
+                }
+
+                // No potential header found
+                return length;
+            }
+
+            /**
+             * @brief Skip a packet start that failed validation
+             * @param data Start of the rejected packet
+             * @param length Length of the queued data
+             * @return Offset of the next candidate header after the rejected one
+             */
+            inline size_t SkipToNextHeader(const char *data, size_t length)
+            {
+                // Search from the next byte, the current ESC already failed validation
+                return length > 1 ? FindNextHeader(data + 1, length - 1) + 1 : length;
             }
 
             // Ensure structures have the expected sizes
             static_assert(sizeof(Header) == 16, "TFE::Header struct size mismatch!");
             static_assert(sizeof(BodyI010) == 32, "TFE::BodyI010 struct size mismatch!");
+            static_assert(sizeof(BodyI020) == 27, "TFE::BodyI020 struct size mismatch!");
+            static_assert(sizeof(MatchItem) == 10, "TFE::MatchItem struct size mismatch!");
+            static_assert(sizeof(BodyI080) == 110, "TFE::BodyI080 struct size mismatch!");
 
         } // namespace tfe
     } // namespace processing
@@ -0,0 +1,411 @@
+#pragma once
+
+#include "common/price.h"
+#include "common/types.h"
+#include "core/buffer.h"
+#include "processing/message_filter.h"
+#include "processing/reference_data.h"
+#include "processing/tfe.h"
+#include "utils/trace.h"
+
+namespace stream_buffer
+{
+    namespace processing
+    {
+
+        /**
+         * @brief Read-only view of a validated TFE packet
+         *
+         * Views point into the receive buffer and are only valid for the
+         * duration of the handler callback.
+         */
+        class MessageView
+        {
+        public:
+            MessageView(const tfe::DecodedHeader &header, const char *packet,
+                        common::u32 symbol, common::u8 price_scale)
+                : header_(header), packet_(packet), symbol_(symbol), price_scale_(price_scale) {}
+
+            const tfe::DecodedHeader &GetHeader() const { return header_; }
+
+            // Start of the packet (ESC code)
+            const char *GetPacket() const { return packet_; }
+            size_t GetPacketSize() const { return tfe::CalculatePacketSize(header_.body_length); }
+
+            const char *GetBodyData() const { return packet_ + sizeof(tfe::Header); }
+            size_t GetBodyLength() const { return header_.body_length; }
+
+            /**
+             * @brief Symbol index from the reference data, INVALID_SYMBOL if unknown
+             */
+            common::u32 GetSymbol() const { return symbol_; }
+
+            /**
+             * @brief Price decimal scale from the reference data, 0 if unknown
+             */
+            common::u8 GetPriceScale() const { return price_scale_; }
+
+        protected:
+            common::Price MakePrice(common::i64 mantissa) const
+            {
+                return common::Price(mantissa, price_scale_);
+            }
+
+            const tfe::DecodedHeader &header_;
+            const char *packet_;
+            common::u32 symbol_;
+            common::u8 price_scale_;
+        };
+
+        /**
+         * @brief View of an I010 product definition
+         */
+        class I010View : public MessageView
+        {
+        public:
+            I010View(const tfe::DecodedHeader &header, const char *packet,
+                     common::u32 symbol, common::u8 price_scale)
+                : MessageView(header, packet, symbol, price_scale) {}
+
+            const tfe::BodyI010 &GetBody() const
+            {
+                return *reinterpret_cast<const tfe::BodyI010 *>(GetBodyData());
+            }
+
+            const char *GetProductId() const { return GetBody().prod_id_s; }
+
+            bool GetReferencePrice(common::Price *price) const { return GetBody().GetReferencePrice(price); }
+        };
+
+        /**
+         * @brief View of an I020 trade
+         */
+        class TradeView : public MessageView
+        {
+        public:
+            TradeView(const tfe::DecodedHeader &header, const char *packet,
+                      common::u32 symbol, common::u8 price_scale)
+                : MessageView(header, packet, symbol, price_scale) {}
+
+            const tfe::BodyI020 &GetBody() const
+            {
+                return *reinterpret_cast<const tfe::BodyI020 *>(GetBodyData());
+            }
+
+            const char *GetProductId() const { return GetBody().prod_id_s; }
+
+            // Match time as hhmmssmmmuuu, or -1 if invalid
+            long long GetMatchTime() const
+            {
+                return utils::decode_bcd(GetBody().match_time, sizeof(GetBody().match_time));
+            }
+
+            // Number of matches carried by the message, including the first one
+            size_t GetMatchCount() const
+            {
+                long long items = utils::decode_bcd(&GetBody().match_display_item, sizeof(GetBody().match_display_item));
+                size_t count = 1 + (items < 0 ? 0 : static_cast<size_t>(items));
+                // The items sit between the fixed part and the totals trailer
+                size_t fixed = sizeof(tfe::BodyI020) + sizeof(tfe::MatchTotals);
+                size_t available = 1 + (GetBodyLength() > fixed ? (GetBodyLength() - fixed) / sizeof(tfe::MatchItem) : 0);
+                return count < available ? count : available;
+            }
+
+            /**
+             * @brief Get one match of the message
+             * @param index Match index, 0 is the first match
+             * @param price Output price scaled by the product decimal locator
+             * @param quantity Output quantity
+             * @return true on success
+             */
+            bool GetMatch(size_t index, common::Price *price, common::i64 *quantity) const
+            {
+                common::i64 mantissa = 0;
+                long long qty = -1;
+                if (index == 0)
+                {
+                    const tfe::BodyI020 &body = GetBody();
+                    if (!tfe::DecodeSignedBcd(body.first_match_price_sign, body.first_match_price,
+                                              sizeof(body.first_match_price), &mantissa))
+                    {
+                        return false;
+                    }
+                    qty = utils::decode_bcd(body.first_match_qty, sizeof(body.first_match_qty));
+                }
+                else
+                {
+                    if (index >= GetMatchCount())
+                    {
+                        return false;
+                    }
+                    const tfe::MatchItem &item = reinterpret_cast<const tfe::MatchItem *>(
+                        GetBodyData() + sizeof(tfe::BodyI020))[index - 1];
+                    if (!tfe::DecodeSignedBcd(item.match_price_sign, item.match_price,
+                                              sizeof(item.match_price), &mantissa))
+                    {
+                        return false;
+                    }
+                    qty = utils::decode_bcd(item.match_qty, sizeof(item.match_qty));
+                }
+
+                if (qty < 0)
+                {
+                    return false;
+                }
+                *price = MakePrice(mantissa);
+                *quantity = qty;
+                return true;
+            }
+
+            // Price and quantity of the first match
+            bool GetPrice(common::Price *price, common::i64 *quantity) const
+            {
+                return GetMatch(0, price, quantity);
+            }
+        };
+
+        /**
+         * @brief View of an I080 best quotes message
+         */
+        class QuoteView : public MessageView
+        {
+        public:
+            QuoteView(const tfe::DecodedHeader &header, const char *packet,
+                      common::u32 symbol, common::u8 price_scale)
+                : MessageView(header, packet, symbol, price_scale) {}
+
+            const tfe::BodyI080 &GetBody() const
+            {
+                return *reinterpret_cast<const tfe::BodyI080 *>(GetBodyData());
+            }
+
+            const char *GetProductId() const { return GetBody().prod_id_s; }
+
+            bool GetBid(size_t level, common::Price *price, common::i64 *quantity) const
+            {
+                return level < tfe::QUOTE_LEVELS && DecodeLevel(GetBody().buy[level], price, quantity);
+            }
+
+            bool GetAsk(size_t level, common::Price *price, common::i64 *quantity) const
+            {
+                return level < tfe::QUOTE_LEVELS && DecodeLevel(GetBody().sell[level], price, quantity);
+            }
+
+        private:
+            bool DecodeLevel(const tfe::QuoteLevel &quote, common::Price *price, common::i64 *quantity) const
+            {
+                common::i64 mantissa = 0;
+                long long qty = utils::decode_bcd(quote.quantity, sizeof(quote.quantity));
+                if (qty < 0 || !tfe::DecodeSignedBcd(quote.price_sign, quote.price, sizeof(quote.price), &mantissa))
+                {
+                    return false;
+                }
+                *price = MakePrice(mantissa);
+                *quantity = qty;
+                return true;
+            }
+        };
+
+        /**
+         * @brief No-op handler to derive from
+         *
+         * Handlers hide only the callbacks they need; the decoder calls the
+         * most derived one, resolved at compile time.
+         */
+        class HandlerBase
+        {
+        public:
+            // Every accepted packet, before the typed callback
+            void OnMessage(const MessageView &) {}
+            void OnI010(const I010View &) {}
+            void OnTrade(const TradeView &) {}
+            void OnQuote(const QuoteView &) {}
+            // Accepted packets with no typed callback
+            void OnUnknown(const MessageView &) {}
+            // Packets whose XOR checksum did not match, before the resync
+            void OnChecksumError(const char *, size_t) {}
+            // Bytes dropped while resynchronising after an invalid header or checksum
+            void OnResync(const char *, size_t) {}
+        };
+
+        /**
+         * @brief Options shared by every decoder instantiation
+         */
+        struct DecoderOptions
+        {
+            MessageFilter *filter = nullptr;                       // Subscription filter, not owned
+            bool validate_checksum = true;                         // Verify the XOR checksum
+            const ReferenceDataStore *reference_data = nullptr;    // Resolves symbols and price scales
+        };
+
+        /**
+         * @brief TFE framing and decoding loop, statically bound to a handler
+         *
+         * @tparam Handler Type providing the HandlerBase callbacks
+         */
+        template <typename Handler>
+        class Decoder
+        {
+        public:
+            explicit Decoder(Handler &handler, const DecoderOptions &options = DecoderOptions())
+                : handler_(handler), options_(options) {}
+
+            /**
+             * @brief Decode every complete packet in the span
+             * @param data Start of the queued data
+             * @param length Length of the queued data
+             * @return Bytes consumed and packets delivered to the handler
+             */
+            core::BatchResult Decode(const char *data, size_t length)
+            {
+                core::BatchResult result;
+                if (!data)
+                {
+                    return result;
+                }
+
+                while (length - result.bytes_consumed >= sizeof(tfe::Header))
+                {
+                    bool handled = false;
+                    size_t processed = DecodePacket(data + result.bytes_consumed,
+                                                    length - result.bytes_consumed, &handled);
+                    if (processed == 0)
+                    {
+                        break; // Partial packet, wait for more data
+                    }
+                    result.bytes_consumed += processed;
+                    if (handled)
+                    {
+                        result.message_count++;
+                    }
+                }
+
+                return result;
+            }
+
+            /**
+             * @brief Validate, decode and dispatch one packet
+             * @param message Start of the packet, at least sizeof(tfe::Header) bytes
+             * @param length Length of the queued data
+             * @param handled Set when the packet reached the handler
+             * @return Bytes consumed, 0 if the packet is incomplete
+             */
+            size_t DecodePacket(const char *message, size_t length, bool *handled)
+            {
+                // Validate and decode the whole header in one pass
+                tfe::DecodedHeader header;
+                if (!tfe::DecodeHeader(message, &header))
+                {
+                    FMT_PRINT("Invalid TFE header\n");
+                    return Resync(message, length);
+                }
+
+                if (header.body_length == 0)
+                {
+                    FMT_PRINT("Invalid body length in TFE header\n");
+                    return Resync(message, length);
+                }
+
+                size_t total_size = tfe::CalculatePacketSize(header.body_length);
+                if (length < total_size)
+                {
+                    FMT_PRINT("Incomplete packet: expected %zu bytes, got %zu\n", total_size, length);
+                    return 0; // Not enough data yet, wait for more
+                }
+
+                // Skip unsubscribed messages before any further decoding
+                if (options_.filter && !options_.filter->Accept(message, header.body_length))
+                {
+                    return total_size;
+                }
+
+                // Validate checksum unless it is trusted upstream
+                if (options_.validate_checksum &&
+                    !tfe::ValidateChecksum(message, total_size - tfe::TERMINAL_CODE_SIZE))
+                {
+                    FMT_PRINT("Invalid checksum\n");
+                    handler_.OnChecksumError(message, total_size);
+                    return Resync(message, length);
+                }
+
+                {
+                    TRACE_SCOPE(trace, utils::TraceEvent::DISPATCH);
+                    trace.SetArg(total_size);
+                    Dispatch(header, message);
+                }
+                *handled = true;
+                return total_size;
+            }
+
+            const DecoderOptions &GetOptions() const { return options_; }
+
+        private:
+            size_t Resync(const char *message, size_t length)
+            {
+                size_t skipped = tfe::SkipToNextHeader(message, length);
+                FMT_PRINT("Skipping data, next potential header at offset: %zu\n", skipped);
+                handler_.OnResync(message, skipped);
+                return skipped;
+            }
+
+            void ResolveSymbol(const char *product_id, common::u32 *symbol, common::u8 *price_scale) const
+            {
+                *symbol = constants::INVALID_SYMBOL;
+                *price_scale = 0;
+                if (!options_.reference_data)
+                {
+                    return;
+                }
+
+                *symbol = options_.reference_data->GetSymbolIndex().Find(product_id);
+                *price_scale = options_.reference_data->GetDecimalLocator(*symbol);
+            }
+
+            void Dispatch(const tfe::DecodedHeader &header, const char *packet)
+            {
+                const char *body = packet + sizeof(tfe::Header);
+                common::u32 symbol = constants::INVALID_SYMBOL;
+                common::u8 price_scale = 0;
+                bool is_basic = header.transmission_code == tfe::TRANSMISSION_FUTURES_BASIC ||
+                                header.transmission_code == tfe::TRANSMISSION_OPTIONS_BASIC;
+                bool is_trading = header.transmission_code == tfe::TRANSMISSION_FUTURES_TRADING ||
+                                  header.transmission_code == tfe::TRANSMISSION_OPTIONS_TRADING;
+
+                if (is_basic && header.message_kind == tfe::KIND_PRODUCT_INFO &&
+                    header.body_length >= sizeof(tfe::BodyI010))
+                {
+                    ResolveSymbol(body, &symbol, &price_scale);
+                    I010View view(header, packet, symbol, price_scale);
+                    handler_.OnMessage(view);
+                    handler_.OnI010(view);
+                }
+                else if (is_trading && header.message_kind == tfe::KIND_MATCH &&
+                         header.body_length >= sizeof(tfe::BodyI020))
+                {
+                    ResolveSymbol(body, &symbol, &price_scale);
+                    TradeView view(header, packet, symbol, price_scale);
+                    handler_.OnMessage(view);
+                    handler_.OnTrade(view);
+                }
+                else if (is_trading && header.message_kind == tfe::KIND_BEST_QUOTES &&
+                         header.body_length >= sizeof(tfe::BodyI080))
+                {
+                    ResolveSymbol(body, &symbol, &price_scale);
+                    QuoteView view(header, packet, symbol, price_scale);
+                    handler_.OnMessage(view);
+                    handler_.OnQuote(view);
+                }
+                else
+                {
+                    MessageView view(header, packet, symbol, price_scale);
+                    handler_.OnMessage(view);
+                    handler_.OnUnknown(view);
+                }
+            }
+
+            Handler &handler_;
+            DecoderOptions options_;
+        };
+
+    } // namespace processing
+} // namespace stream_buffer
@@ -2,7 +2,16 @@
 
 #include "core/buffer.h"
 #include "processing/tfe.h"
+#include "processing/tfe_decoder.h"
+#include "processing/reference_data.h"
+#include "processing/message_filter.h"
+#include "processing/normalized_message.h"
+#include "processing/latency_tracker.h"
+#include "utils/perf_counters.h"
+#include "utils/tsc_clock.h"
 #include <cstdint>
+#include <memory>
+#include <vector>
 
 namespace stream_buffer
 {
@@ -13,16 +22,143 @@ namespace stream_buffer
         class TFEProcessor : public core::IBufferProcessor
         {
         public:
-            TFEProcessor() = default;
+            /**
+             * @brief Construct a TFE processor
+             * @param reference_data Store updated with every I010 message (optional, not owned)
+             * @param filter Subscription filter applied before decoding (optional, not owned)
+             * @param validate_checksum Verify the XOR checksum of every packet
+             */
+            explicit TFEProcessor(ReferenceDataStore *reference_data = nullptr,
+                                  MessageFilter *filter = nullptr,
+                                  bool validate_checksum = true)
+                : handler_(reference_data), decoder_(handler_, MakeOptions(reference_data, filter, validate_checksum)) {}
             ~TFEProcessor() override = default;
 
             // Process a TFE message from the buffer
             size_t ProcessMessage(const char *message, size_t length) override;
 
+            // Process every complete TFE packet in the span
+            core::BatchResult ProcessBatch(const char *data, size_t length) override;
+
+            // Process the packets of one datagram; skipped or leftover bytes mark it as damaged
+            core::BatchResult ProcessDatagram(const core::DatagramSlot &slot) override;
+
+            // Process every queued datagram, flushing the sinks once
+            core::BatchResult ProcessSlots(const char *data, size_t length) override;
+
+            /**
+             * @brief Datagrams that were truncated or held bytes outside valid packets
+             */
+            common::u64 GetDamagedDatagramCount() const { return damaged_datagrams_; }
+
+            /**
+             * @brief Forward normalized I010, trade and quote messages to a sink, one trade per I020 match
+             * @param sink Sink called on the processing thread (not owned)
+             */
+            void AddSink(IMessageSink *sink) { handler_.AddSink(sink); }
+
+            /**
+             * @brief Count hardware events around every packet, by message type
+             *
+             * The counters are opened on the thread calling the first batch.
+             * Each packet costs a counter read, so this is a profiling mode.
+             *
+             * @param profiler Receives the per-packet counts (not owned)
+             */
+            void EnableProfiling(utils::PerfProfiler *profiler) { profiler_ = profiler; }
+
+            /**
+             * @brief Record the exchange-to-receive latency of every message
+             *
+             * The receive time is the kernel time of the datagram in slot mode
+             * and the time the batch is decoded otherwise.
+             *
+             * @param tracker Receives one value per message (not owned)
+             */
+            void SetLatencyTracker(LatencyTracker *tracker) { handler_.SetLatencyTracker(tracker); }
+
         private:
-            // Find the next packet header in the buffer
-            size_t FindNextHeader(const char *data, size_t length);
+            // Prints every message, keeps the reference data up to date and feeds the sinks
+            class Handler : public HandlerBase
+            {
+            public:
+                explicit Handler(ReferenceDataStore *reference_data) : reference_data_(reference_data) {}
+
+                void AddSink(IMessageSink *sink) { sinks_.push_back(sink); }
+                void FlushSinks();
+
+                void SetLatencyTracker(LatencyTracker *tracker) { latency_tracker_ = tracker; }
+                bool IsTrackingLatency() const { return latency_tracker_ != nullptr; }
+
+                // CLOCK_REALTIME time the packets decoded next were received
+                void SetReceiveTime(common::i64 receive_time_ns) { receive_time_ns_ = receive_time_ns; }
+
+                void OnMessage(const MessageView &view);
+                void OnI010(const I010View &view);
+                void OnTrade(const TradeView &view);
+                void OnQuote(const QuoteView &view);
+                void OnUnknown(const MessageView &view);
+                void OnChecksumError(const char *message, size_t length);
+                void OnResync(const char *data, size_t skipped);
+
+                // Bytes skipped while looking for a packet header
+                size_t GetResyncBytes() const { return resync_bytes_; }
+
+                // Type of the last packet, SKIPPED until a callback sets it
+                utils::PerfScope GetScope() const { return scope_; }
+                void ResetScope() { scope_ = utils::PerfScope::SKIPPED; }
+
+            private:
+                template <typename View>
+                void Forward(const View &view);
+
+                // One message per match, all with the packet's time and sequence
+                void Forward(const TradeView &view);
+
+                void Publish(const NormalizedMessage &message);
+
+                void RecordLatency(const MessageView &view, LatencyKind kind)
+                {
+                    if (latency_tracker_)
+                    {
+                        const tfe::DecodedHeader &header = view.GetHeader();
+                        latency_tracker_->Record(header.transmission_code, kind, header.information_time_ns,
+                                                 receive_time_ns_);
+                    }
+                }
+
+                ReferenceDataStore *reference_data_;
+                std::vector<IMessageSink *> sinks_;
+                LatencyTracker *latency_tracker_ = nullptr;
+                common::i64 receive_time_ns_ = 0;
+                size_t resync_bytes_ = 0;
+                utils::PerfScope scope_ = utils::PerfScope::SKIPPED;
+            };
+
+            static DecoderOptions MakeOptions(ReferenceDataStore *reference_data, MessageFilter *filter,
+                                              bool validate_checksum);
+
+            // Decode the span, packet by packet under the counters when profiling
+            core::BatchResult Decode(const char *data, size_t length);
+            core::BatchResult DecodeProfiled(const char *data, size_t length);
+
+            core::BatchResult DecodeDatagram(const core::DatagramSlot &slot);
+
+            // Stamp packets without a kernel receive time with the current time
+            void StampReceiveTime()
+            {
+                if (handler_.IsTrackingLatency())
+                {
+                    handler_.SetReceiveTime(utils::GetClock().NowRealtimeNs());
+                }
+            }
+
+            Handler handler_;
+            Decoder<Handler> decoder_;
+            common::u64 damaged_datagrams_ = 0;
+            utils::PerfProfiler *profiler_ = nullptr;
+            std::unique_ptr<utils::PerfRecorder> recorder_; // Opened on the processing thread
         };
 
     } // namespace processing
-} // namespace stream_buffer
\ No newline at end of file
+} // namespace stream_buffer
@@ -0,0 +1,360 @@
+#pragma once
+
+#include "common/types.h"
+#include "core/spsc_queue.h"
+#include "processing/normalized_message.h"
+#include "processing/symbol_index.h"
+#include <pthread.h>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace stream_buffer
+{
+    namespace processing
+    {
+
+        namespace constants
+        {
+            constexpr common::u32 TICK_BLOCK_ROWS = 4096;           // Rows per block, a multiple of 8
+            constexpr size_t TICK_QUEUE_CAPACITY = 262144;          // Messages between the live path and the writer
+            constexpr common::u32 TICK_STORE_VERSION = 1;
+            constexpr size_t TICK_HEADER_SIZE = 64;                 // TickFileHeader and TickBlockHeader
+        }
+
+        /**
+         * @brief Fixed-width columns of a tick file
+         *
+         * TIME is the information_time_ns of the message, SYMBOL
+         * an index into the store's symbols file. Prices are mantissas in
+         * units of 10^-PRICE_SCALE.
+         */
+        enum class TickColumn : common::u8
+        {
+            TIME,         // i64
+            SEQ,          // u32
+            SYMBOL,       // u32
+            PRICE_SCALE,  // u8
+            PRICE,        // i64, trade or reference price
+            QUANTITY,     // i64
+            BID_PRICE,    // i64
+            BID_QUANTITY, // i64
+            ASK_PRICE,    // i64
+            ASK_QUANTITY, // i64
+            COUNT
+        };
+
+        constexpr size_t TICK_COLUMN_COUNT = static_cast<size_t>(TickColumn::COUNT);
+
+        // Bytes per value of a column
+        size_t GetTickColumnWidth(TickColumn column);
+
+        const char *GetTickColumnName(TickColumn column);
+
+        // Bit set of the columns stored for a message type
+        common::u32 GetTickColumnMask(MessageType type);
+
+        // File name of a message type within a store directory, "trade.ticks" etc.
+        std::string GetTickFileName(MessageType type);
+
+        // Index file next to a tick file, "trade.index" etc.
+        std::string GetTickIndexName(MessageType type);
+
+        // Product ids of the store, PRODUCT_ID_SIZE bytes each in symbol order
+        constexpr const char *TICK_SYMBOLS_FILE = "symbols";
+
+        /**
+         * @brief Convert nanoseconds since midnight back to the hhmmssmmmuuu information_time
+         */
+        inline common::u64 NsToInformationTime(common::i64 time_ns)
+        {
+            common::u64 microseconds = static_cast<common::u64>(time_ns) / 1000ULL;
+            common::u64 seconds = microseconds / 1000000ULL;
+            return ((seconds / 3600 * 100 + seconds / 60 % 60) * 100 + seconds % 60) * 1000000ULL +
+                   microseconds % 1000000ULL;
+        }
+
+        /**
+         * @brief First bytes of a tick file
+         *
+         * Blocks of block_size bytes follow at data_offset. Each block is a
+         * TickBlockHeader and then, column by column in TickColumn order,
+         * block_rows values of every column in column_mask.
+         */
+        struct TickFileHeader
+        {
+            char magic[8];
+            common::u32 version;
+            common::u8 message_type;   // MessageType
+            common::u8 reserved[3];
+            common::u32 column_mask;   // 1 << TickColumn
+            common::u32 block_rows;
+            common::u64 block_size;    // Page aligned
+            common::u64 data_offset;   // Page aligned
+            common::u64 block_count;   // Blocks holding published rows, the last one may be partial
+            common::u64 row_count;     // Rows published
+            char padding[8];
+        };
+
+        /**
+         * @brief First bytes of a block
+         */
+        struct TickBlockHeader
+        {
+            common::u32 row_count;
+            common::u32 reserved;
+            common::i64 min_time_ns;
+            common::i64 max_time_ns;
+            common::u64 first_row;     // Rows in the earlier blocks
+            char padding[32];
+        };
+
+        /**
+         * @brief One entry per block in the index file, for time range lookups
+         */
+        struct TickIndexEntry
+        {
+            common::i64 min_time_ns;
+            common::i64 max_time_ns;
+            common::u64 first_row;
+            common::u32 row_count;
+            common::u32 block;
+        };
+
+        static_assert(sizeof(TickFileHeader) == constants::TICK_HEADER_SIZE, "TickFileHeader layout changed");
+        static_assert(sizeof(TickBlockHeader) == constants::TICK_HEADER_SIZE, "TickBlockHeader layout changed");
+        static_assert(sizeof(TickIndexEntry) == 32, "TickIndexEntry layout changed");
+
+        /**
+         * @brief Offset of a column's first value within a block
+         */
+        size_t GetTickColumnOffset(common::u32 column_mask, common::u32 block_rows, TickColumn column);
+
+        /**
+         * @brief Appends messages to the columnar files of one store directory
+         *
+         * One file per message type. Only the block being filled is mapped;
+         * when it is full the file is extended by one block and the next one
+         * is mapped. Row counts, the file header and the block's index entry
+         * are published by Flush(), so readers see whole rows only. Single
+         * threaded; use TickStoreSink to keep it off the processing thread.
+         */
+        class TickStoreWriter
+        {
+        public:
+            explicit TickStoreWriter(common::u32 block_rows = constants::TICK_BLOCK_ROWS);
+            ~TickStoreWriter();
+
+            // Prevent copying
+            TickStoreWriter(const TickStoreWriter &) = delete;
+            TickStoreWriter &operator=(const TickStoreWriter &) = delete;
+
+            /**
+             * @brief Create the directory if needed and open its files for appending
+             *
+             * Files already in the directory are continued after the rows they
+             * published, so a restart keeps the session's ticks.
+             *
+             * @return false if a file could not be opened or was written with another layout
+             */
+            bool Open(const std::string &directory);
+
+            bool IsOpen() const { return open_; }
+
+            /**
+             * @brief Append a message to the file of its type
+             * @return false if it could not be stored
+             */
+            bool Append(const NormalizedMessage &message);
+
+            // Publish the rows appended so far
+            void Flush();
+
+            // Flush and release the files
+            void Close();
+
+            common::u64 GetRowCount(MessageType type) const;
+
+        private:
+            class ColumnFile;
+
+            bool LoadSymbols(const std::string &directory);
+            common::u32 GetSymbol(const char *product_id);
+
+            common::u32 block_rows_;
+            bool open_;
+            std::unique_ptr<ColumnFile> files_[constants::MESSAGE_TYPE_COUNT];
+            std::unique_ptr<SymbolIndex> symbols_;
+            int symbols_fd_;
+        };
+
+        /**
+         * @brief Sink that hands messages to a TickStoreWriter on its own thread
+         *
+         * OnMessage only copies the message into an SPSC queue; when the
+         * writer falls behind and the queue is full the message is dropped
+         * and counted rather than delaying the processing thread.
+         */
+        class TickStoreSink : public IMessageSink
+        {
+        public:
+            /**
+             * @brief Construct a sink
+             * @param directory Store directory, one per session
+             * @param queue_capacity Messages that can wait for the writer
+             * @param block_rows Rows per block
+             */
+            explicit TickStoreSink(const std::string &directory,
+                                   size_t queue_capacity = constants::TICK_QUEUE_CAPACITY,
+                                   common::u32 block_rows = constants::TICK_BLOCK_ROWS);
+            ~TickStoreSink() override;
+
+            // Prevent copying
+            TickStoreSink(const TickStoreSink &) = delete;
+            TickStoreSink &operator=(const TickStoreSink &) = delete;
+
+            /**
+             * @brief Open the store and start the writer thread
+             * @return false if the store could not be opened
+             */
+            bool Start();
+
+            /**
+             * @brief Write every queued message, close the files and join the writer
+             */
+            void Stop();
+
+            // Queue a message (producer thread only)
+            void OnMessage(const NormalizedMessage &message) override;
+
+            // Messages written to the files
+            common::u64 GetWrittenCount() const { return written_.load(std::memory_order_relaxed); }
+
+            // Messages lost because the queue was full or the store failed
+            common::u64 GetDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+        private:
+            static void *WriterThreadFunction(void *arg);
+            void RunWriter();
+
+            std::string directory_;
+            core::SpscQueue<NormalizedMessage> queue_;
+            TickStoreWriter writer_;
+            pthread_t thread_;
+            std::atomic<bool> running_;
+            bool started_;
+            std::atomic<common::u64> written_;
+            std::atomic<common::u64> dropped_;
+        };
+
+        /**
+         * @brief Rows to select from a tick store
+         */
+        struct TickQuery
+        {
+            MessageType type = MessageType::TRADE;
+            std::vector<common::u32> symbols;                                // Store symbols, empty for every product
+            common::i64 begin_ns = 0;                                        // Inclusive, nanoseconds since midnight
+            common::i64 end_ns = std::numeric_limits<common::i64>::max();    // Exclusive
+        };
+
+        /**
+         * @brief Work done by a query
+         */
+        struct TickQueryStats
+        {
+            common::u64 blocks = 0;       // Blocks in the file
+            common::u64 blocks_read = 0;  // Blocks whose columns were scanned
+            common::u64 rows_read = 0;
+            common::u64 rows_matched = 0;
+        };
+
+        /**
+         * @brief Read-only view of a tick store directory
+         *
+         * Files are mapped as they are when opened; rows the writer publishes
+         * later are seen after opening again. A query narrows the blocks to
+         * scan by binary search on the block index, skips blocks whose time
+         * range misses the query, and reads only the time and symbol columns
+         * of the rest until a row matches.
+         */
+        class TickStoreReader
+        {
+        public:
+            TickStoreReader();
+            ~TickStoreReader();
+
+            // Prevent copying
+            TickStoreReader(const TickStoreReader &) = delete;
+            TickStoreReader &operator=(const TickStoreReader &) = delete;
+
+            /**
+             * @brief Map the files of a store directory read-only
+             * @param directory Directory passed to TickStoreWriter
+             * @return false if a file is missing or has an incompatible format
+             */
+            bool Open(const std::string &directory);
+
+            void Close();
+
+            /**
+             * @brief Find the store symbol of a product
+             * @param product_id Product id, PRODUCT_ID_SIZE bytes
+             * @return Symbol or INVALID_SYMBOL if the product was never recorded
+             */
+            common::u32 Find(const char *product_id) const;
+
+            /**
+             * @brief Symbols of every product whose id starts with prefix, e.g. "TXF"
+             */
+            std::vector<common::u32> FindPrefix(const std::string &prefix) const;
+
+            /**
+             * @brief Copy the product id of a symbol
+             * @param product_id Output buffer of PRODUCT_ID_SIZE bytes
+             * @return false if the symbol is not in the store
+             */
+            bool GetProductId(common::u32 symbol, char *product_id) const;
+
+            common::u32 GetSymbolCount() const { return static_cast<common::u32>(product_ids_.size()); }
+
+            // Rows of a message type published when the store was opened
+            common::u64 GetRowCount(MessageType type) const;
+
+            /**
+             * @brief Append the matching rows, in recording order, as messages
+             *
+             * information_time, information_seq, symbol (the store's), product_id,
+             * type, price_scale and the prices and quantities of the type are set.
+             * @param query Rows to select
+             * @param messages Output rows
+             * @param stats Optional work done
+             * @return Number of rows appended
+             */
+            size_t Query(const TickQuery &query, std::vector<NormalizedMessage> *messages,
+                         TickQueryStats *stats = nullptr) const;
+
+        private:
+            struct TypeFile
+            {
+                const char *mapping = nullptr;
+                size_t mapping_size = 0;
+                TickFileHeader header;                  // As of Open
+                std::vector<TickIndexEntry> index;      // Blocks with published rows, capped to the header
+                std::vector<common::i64> running_max;   // Largest max_time_ns up to each block
+                std::vector<common::i64> remaining_min; // Smallest min_time_ns from each block on
+            };
+
+            bool OpenType(const std::string &directory, MessageType type);
+            bool LoadSymbols(const std::string &directory);
+
+            TypeFile files_[constants::MESSAGE_TYPE_COUNT];
+            std::vector<std::string> product_ids_;
+            std::unordered_map<std::string, common::u32> symbols_;
+        };
+
+    } // namespace processing
+} // namespace stream_buffer
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace stream_buffer
+{
+    namespace utils
+    {
+
+        /**
+         * @brief XOR all bytes of a range together
+         *
+         * Uses SSE2/AVX2 XOR reduction over 64-byte blocks when available and
+         * a word-at-a-time scalar loop for the tail.
+         *
+         * @param data Pointer to the data
+         * @param length Length of the data in bytes
+         * @return XOR of all bytes, 0 for an empty range
+         */
+        uint8_t xor_checksum(const void *data, size_t length);
+
+    } // namespace utils
+} // namespace stream_buffer
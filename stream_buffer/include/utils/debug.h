@@ -4,12 +4,14 @@
 #include <cstdint>
 #include <string>
 
-// Debug modes
+// Debug modes, build with -DDEBUG_MODE=0 to compile logging out
+#ifndef DEBUG_MODE
 #define DEBUG_MODE 1
+#endif
 #define DEBUG_STRUCT_INFO 1
 
 // Debug printf wrapper macros - only produce output in debug mode
-#if defined(DEBUG) || defined(_DEBUG) || defined(DEBUG_MODE)
+#if defined(DEBUG) || defined(_DEBUG) || DEBUG_MODE
 #define FMT_PRINT(...) ::printf("[%s:%d] ", __FILE__, __LINE__), ::printf(__VA_ARGS__)
 #define FMT_PRINTLN(...)                          \
     do                                            \
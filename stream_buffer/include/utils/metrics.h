@@ -0,0 +1,213 @@
+#pragma once
+
+#include "common/types.h"
+#include <atomic>
+#include <memory>
+#include <string>
+
+namespace stream_buffer
+{
+    namespace utils
+    {
+        namespace constants
+        {
+            constexpr size_t MAX_METRIC_THREADS = 32;  // Threads with a private block, later ones share one
+            constexpr size_t HISTOGRAM_BUCKETS = 64;   // Power-of-two buckets, bucket i holds values < 2^i
+        } // namespace constants
+
+        // Monotonic event counts, summed over threads
+        enum class Counter : common::u8
+        {
+            PACKETS_RECEIVED,
+            BYTES_RECEIVED,
+            MESSAGES_I010,
+            MESSAGES_TRADE,
+            MESSAGES_QUOTE,
+            MESSAGES_OTHER,
+            RESYNCS,
+            RESYNC_BYTES,
+            CHECKSUM_FAILURES,
+            COMPACTIONS,
+            SHARD_BACKPRESSURE,
+            TICK_STORE_DROPS,
+            QUOTE_SNAPSHOT_OVERFLOWS,
+            CONFLATION_OVERFLOWS,
+            COUNT
+        };
+
+        // Last value set, from any thread
+        enum class Gauge : common::u8
+        {
+            BUFFER_QUEUED_BYTES,
+            BUFFER_CAPACITY_BYTES,
+            SHARD_QUEUE_DEPTH,
+            FANOUT_LAG,
+            COUNT
+        };
+
+        // Value distributions, summed over threads
+        enum class Histogram : common::u8
+        {
+            DATAGRAM_BYTES,
+            BATCH_MESSAGES,
+            COUNT
+        };
+
+        constexpr size_t COUNTER_COUNT = static_cast<size_t>(Counter::COUNT);
+        constexpr size_t GAUGE_COUNT = static_cast<size_t>(Gauge::COUNT);
+        constexpr size_t HISTOGRAM_COUNT = static_cast<size_t>(Histogram::COUNT);
+
+        // Names used by the stats endpoint
+        const char *GetMetricName(Counter counter);
+        const char *GetMetricName(Gauge gauge);
+        const char *GetMetricName(Histogram histogram);
+
+        /**
+         * @brief Aggregated histogram
+         */
+        struct HistogramSnapshot
+        {
+            common::u64 count = 0;
+            common::u64 sum = 0;
+            common::u64 buckets[constants::HISTOGRAM_BUCKETS] = {};
+
+            /**
+             * @brief Upper bound of the bucket holding the given fraction of values
+             * @param quantile Fraction between 0 and 1
+             */
+            common::u64 GetQuantile(double quantile) const;
+        };
+
+        /**
+         * @brief Every metric at one point in time
+         */
+        struct MetricsSnapshot
+        {
+            common::u64 counters[COUNTER_COUNT] = {};
+            common::i64 gauges[GAUGE_COUNT] = {};
+            HistogramSnapshot histograms[HISTOGRAM_COUNT];
+
+            common::u64 Get(Counter counter) const { return counters[static_cast<size_t>(counter)]; }
+            common::i64 Get(Gauge gauge) const { return gauges[static_cast<size_t>(gauge)]; }
+            const HistogramSnapshot &Get(Histogram histogram) const
+            {
+                return histograms[static_cast<size_t>(histogram)];
+            }
+
+            /**
+             * @brief One "<kind> <name> <value>" line per metric, as served by the stats endpoint
+             */
+            std::string Format() const;
+        };
+
+        /**
+         * @brief Counters, gauges and histograms for the whole process
+         *
+         * Every thread that records gets its own block, padded on both sides
+         * so no two threads write the same cache line. Recording is a relaxed
+         * load and store on that block, without a locked instruction;
+         * Snapshot() sums the blocks when asked. Threads beyond
+         * MAX_METRIC_THREADS share one block and pay for an atomic add.
+         */
+        class MetricsRegistry
+        {
+        public:
+            MetricsRegistry();
+            ~MetricsRegistry();
+
+            // Prevent copying
+            MetricsRegistry(const MetricsRegistry &) = delete;
+            MetricsRegistry &operator=(const MetricsRegistry &) = delete;
+
+            void Add(Counter counter, common::u64 value = 1)
+            {
+                ThreadBlock &block = GetBlock();
+                Bump(block, block.counters[static_cast<size_t>(counter)], value);
+            }
+
+            void Set(Gauge gauge, common::i64 value)
+            {
+                gauges_[static_cast<size_t>(gauge)].value.store(value, std::memory_order_relaxed);
+            }
+
+            void Record(Histogram histogram, common::u64 value)
+            {
+                ThreadBlock &block = GetBlock();
+                ThreadHistogram &target = block.histograms[static_cast<size_t>(histogram)];
+                Bump(block, target.buckets[GetBucket(value)], 1);
+                Bump(block, target.count, 1);
+                Bump(block, target.sum, value);
+            }
+
+            // Sum of every thread's block
+            MetricsSnapshot Snapshot() const;
+
+            // Index of the bucket holding value
+            static size_t GetBucket(common::u64 value)
+            {
+                size_t bucket = value == 0 ? 0 : 64 - static_cast<size_t>(__builtin_clzll(value));
+                return bucket < constants::HISTOGRAM_BUCKETS ? bucket : constants::HISTOGRAM_BUCKETS - 1;
+            }
+
+        private:
+            struct ThreadHistogram
+            {
+                std::atomic<common::u64> count;
+                std::atomic<common::u64> sum;
+                std::atomic<common::u64> buckets[constants::HISTOGRAM_BUCKETS];
+            };
+
+            struct ThreadBlock
+            {
+                char leading_pad[common::constants::CACHE_LINE_SIZE];
+                std::atomic<common::u64> counters[COUNTER_COUNT];
+                ThreadHistogram histograms[HISTOGRAM_COUNT];
+                bool shared;
+                char trailing_pad[common::constants::CACHE_LINE_SIZE];
+            };
+
+            struct PaddedGauge
+            {
+                std::atomic<common::i64> value;
+                char pad[common::constants::CACHE_LINE_SIZE - sizeof(std::atomic<common::i64>)];
+            };
+
+            // Only the owning thread writes a private block
+            static void Bump(const ThreadBlock &block, std::atomic<common::u64> &cell, common::u64 value)
+            {
+                if (block.shared)
+                {
+                    cell.fetch_add(value, std::memory_order_relaxed);
+                    return;
+                }
+                cell.store(cell.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+            }
+
+            ThreadBlock &GetBlock()
+            {
+                // Each thread caches its block for one registry, the process-wide one in practice
+                static thread_local common::u64 cached_id = 0;
+                static thread_local ThreadBlock *cached_block = nullptr;
+                if (cached_id != id_)
+                {
+                    cached_block = ClaimBlock();
+                    cached_id = id_;
+                }
+                return *cached_block;
+            }
+
+            ThreadBlock *ClaimBlock();
+
+            common::u64 id_; // Unique per registry, never 0
+            std::unique_ptr<ThreadBlock[]> blocks_; // Last one is shared
+            std::atomic<size_t> claimed_blocks_;
+            PaddedGauge gauges_[GAUGE_COUNT];
+        };
+
+        /**
+         * @brief The process-wide registry served by the stats endpoint
+         */
+        MetricsRegistry &GetMetrics();
+
+    } // namespace utils
+} // namespace stream_buffer
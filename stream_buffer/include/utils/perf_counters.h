@@ -0,0 +1,185 @@
+#pragma once
+
+#include "common/types.h"
+#include <atomic>
+#include <string>
+
+namespace stream_buffer
+{
+    namespace utils
+    {
+        // Events counted together for one thread; only the task clock is required
+        enum class PerfEvent : common::u8
+        {
+            TASK_CLOCK,    // Nanoseconds on the CPU (software event)
+            CYCLES,        // User-space core cycles
+            INSTRUCTIONS,  // User-space instructions retired
+            CACHE_MISSES,  // Last-level cache misses
+            BRANCH_MISSES, // Mispredicted branches
+            COUNT
+        };
+
+        // Where the counted work is attributed
+        enum class PerfScope : common::u8
+        {
+            RECEIVE, // One receive loop iteration, per datagram
+            I010,
+            TRADE,
+            QUOTE,
+            OTHER,   // Packets dispatched to OnUnknown
+            SKIPPED, // Filtered packets, resyncs and checksum failures
+            COUNT
+        };
+
+        constexpr size_t PERF_EVENT_COUNT = static_cast<size_t>(PerfEvent::COUNT);
+        constexpr size_t PERF_SCOPE_COUNT = static_cast<size_t>(PerfScope::COUNT);
+
+        // Names used by the stats endpoint
+        const char *GetPerfEventName(PerfEvent event);
+        const char *GetPerfScopeName(PerfScope scope);
+
+        /**
+         * @brief Event values, running totals or the difference of two readings
+         */
+        struct PerfSample
+        {
+            common::u64 values[PERF_EVENT_COUNT] = {};
+
+            common::u64 Get(PerfEvent event) const { return values[static_cast<size_t>(event)]; }
+        };
+
+        /**
+         * @brief A perf_event_open group counting the calling thread in user space
+         *
+         * The events are scheduled together, so their ratios (IPC, misses per
+         * instruction) describe the same stretch of code. Hardware events the
+         * kernel or hypervisor does not expose are left out; Open() only fails
+         * when not even the task clock can be counted.
+         */
+        class PerfCounterGroup
+        {
+        public:
+            PerfCounterGroup();
+            ~PerfCounterGroup();
+
+            // Prevent copying
+            PerfCounterGroup(const PerfCounterGroup &) = delete;
+            PerfCounterGroup &operator=(const PerfCounterGroup &) = delete;
+
+            /**
+             * @brief Start counting the calling thread
+             * @return true if at least the task clock is counted
+             */
+            bool Open();
+
+            void Close();
+
+            bool IsOpen() const { return leader_fd_ >= 0; }
+
+            // Whether the event is part of the group
+            bool HasEvent(PerfEvent event) const { return fds_[static_cast<size_t>(event)] >= 0; }
+
+            // Bit i set when PerfEvent i is counted
+            common::u32 GetEventMask() const;
+
+            /**
+             * @brief Read the running totals, scaled up if the group was multiplexed
+             * @param sample Output totals; events not in the group read 0
+             * @return true on success
+             */
+            bool Read(PerfSample *sample) const;
+
+        private:
+            int fds_[PERF_EVENT_COUNT];
+            size_t positions_[PERF_EVENT_COUNT]; // Index in the group read
+            size_t member_count_;
+            int leader_fd_;
+        };
+
+        /**
+         * @brief Event totals for one scope
+         */
+        struct PerfScopeStats
+        {
+            common::u64 count = 0; // Datagrams or packets measured
+            common::u64 bytes = 0;
+            PerfSample events;
+        };
+
+        /**
+         * @brief Per-scope event totals from every recording thread
+         */
+        class PerfProfiler
+        {
+        public:
+            PerfProfiler();
+
+            // Prevent copying
+            PerfProfiler(const PerfProfiler &) = delete;
+            PerfProfiler &operator=(const PerfProfiler &) = delete;
+
+            /**
+             * @brief Attribute counted work to a scope
+             * @param scope Where the work was done
+             * @param delta Events counted for it
+             * @param bytes Bytes it covered
+             * @param event_mask Events the recording group counts
+             */
+            void Add(PerfScope scope, const PerfSample &delta, common::u64 bytes, common::u32 event_mask);
+
+            PerfScopeStats GetStats(PerfScope scope) const;
+
+            // Events counted by every recording thread so far, 0 before the first
+            common::u32 GetEventMask() const;
+
+            /**
+             * @brief Three "perf <scope> ..." lines per measured scope: totals,
+             *        per message and per byte, as served by the stats endpoint
+             */
+            std::string Format() const;
+
+        private:
+            struct ScopeCell
+            {
+                std::atomic<common::u64> count;
+                std::atomic<common::u64> bytes;
+                std::atomic<common::u64> events[PERF_EVENT_COUNT];
+            };
+
+            ScopeCell cells_[PERF_SCOPE_COUNT];
+            std::atomic<common::u32> event_mask_;
+            std::atomic<bool> recorded_;
+        };
+
+        /**
+         * @brief Counts one thread and feeds the differences between checkpoints to a profiler
+         *
+         * Construct it on the thread to be measured. Every checkpoint costs a
+         * read() system call; kernel time is not counted by the hardware events
+         * but is included in the task clock.
+         */
+        class PerfRecorder
+        {
+        public:
+            explicit PerfRecorder(PerfProfiler &profiler);
+
+            // Prevent copying
+            PerfRecorder(const PerfRecorder &) = delete;
+            PerfRecorder &operator=(const PerfRecorder &) = delete;
+
+            bool IsActive() const { return group_.IsOpen(); }
+
+            // Start a new measurement without attributing what ran since the last one
+            void Restart();
+
+            // Attribute everything since the last checkpoint or restart to scope
+            void Checkpoint(PerfScope scope, common::u64 bytes);
+
+        private:
+            PerfProfiler &profiler_;
+            PerfCounterGroup group_;
+            PerfSample last_;
+        };
+
+    } // namespace utils
+} // namespace stream_buffer
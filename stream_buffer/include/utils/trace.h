@@ -0,0 +1,137 @@
+#pragma once
+
+#include "common/types.h"
+#include "utils/tsc_clock.h"
+#include <atomic>
+#include <string>
+
+// Tracing mode, build with -DTRACE_MODE=0 to compile every trace point out
+#ifndef TRACE_MODE
+#define TRACE_MODE 1
+#endif
+
+// Declare a scope named var that records one event from here to the end of the block
+#if TRACE_MODE
+#define TRACE_SCOPE(var, event) ::stream_buffer::utils::TraceScope var(event)
+#else
+#define TRACE_SCOPE(var, event) ::stream_buffer::utils::NullTraceScope var(event)
+#endif
+
+namespace stream_buffer
+{
+    namespace utils
+    {
+        namespace constants
+        {
+            constexpr size_t TRACE_RING_CAPACITY = 1 << 16; // Events kept per thread, oldest overwritten
+            constexpr size_t MAX_TRACE_THREADS = 32;        // Threads with a ring, later ones are not traced
+            constexpr size_t MAX_TRACE_THREAD_NAME = 16;
+        } // namespace constants
+
+        // Traced pipeline stages
+        enum class TraceEvent : common::u8
+        {
+            RECEIVE,  // recvfrom/recvmsg system call
+            APPEND,   // Publishing a received datagram to the buffer
+            LOCK,     // Waiting for the buffer mutex
+            COMPACT,  // Moving queued data to the buffer start
+            DECODE,   // One batch or slot run through the TFE decoder
+            DISPATCH, // One packet through the handler callbacks
+            COUNT
+        };
+
+        constexpr size_t TRACE_EVENT_COUNT = static_cast<size_t>(TraceEvent::COUNT);
+
+        // Names shown in the trace viewer
+        const char *GetTraceEventName(TraceEvent event);
+
+        /**
+         * @brief Process-wide begin/end event recorder
+         *
+         * Each thread writes complete events (begin, end, one argument) into
+         * its own ring without locks; a ring keeps the most recent
+         * TRACE_RING_CAPACITY events so a dump after a latency spike shows
+         * the burst around it. Timestamps are raw TscClock ticks, converted
+         * to microseconds only when dumping.
+         */
+        class Tracer
+        {
+        public:
+            /**
+             * @brief Switch recording on or off at run time
+             *
+             * The first enable may wait for the clock calibration.
+             */
+            static void Enable(bool enabled);
+
+            static bool IsEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+            // Record a complete event on the calling thread's ring
+            static void Record(TraceEvent event, common::u64 begin, common::u64 end, common::u64 arg);
+
+            // Label the calling thread in the dump; ignored while tracing is off
+            static void SetThreadName(const char *name);
+
+            // Events recorded so far, including overwritten ones
+            static common::u64 GetRecordedCount();
+
+            // Forget every recorded event, only while no thread records
+            static void Clear();
+
+            /**
+             * @brief Write every ring as Chrome trace JSON (chrome://tracing, Perfetto)
+             *
+             * Dump while the traced threads are idle or stopped; events being
+             * overwritten during the dump may appear torn.
+             *
+             * @param path Output file
+             * @return true on success
+             */
+            static bool DumpChromeTrace(const std::string &path);
+
+        private:
+            static std::atomic<bool> enabled_;
+        };
+
+        /**
+         * @brief Records one event over its lifetime when tracing is enabled
+         */
+        class TraceScope
+        {
+        public:
+            explicit TraceScope(TraceEvent event)
+                : event_(event), arg_(0), begin_(Tracer::IsEnabled() ? GetClock().ReadTicks() : 0) {}
+
+            ~TraceScope()
+            {
+                if (begin_ != 0)
+                {
+                    Tracer::Record(event_, begin_, GetClock().ReadTicksOrdered(), arg_);
+                }
+            }
+
+            // Prevent copying
+            TraceScope(const TraceScope &) = delete;
+            TraceScope &operator=(const TraceScope &) = delete;
+
+            // Value shown with the event, usually a byte count
+            void SetArg(common::u64 arg) { arg_ = arg; }
+
+        private:
+            TraceEvent event_;
+            common::u64 arg_;
+            common::u64 begin_; // 0 when tracing was off at the start
+        };
+
+        /**
+         * @brief Stand-in for TraceScope when TRACE_MODE is 0
+         */
+        class NullTraceScope
+        {
+        public:
+            explicit NullTraceScope(TraceEvent) {}
+            void SetArg(common::u64) {}
+        };
+
+    } // namespace utils
+} // namespace stream_buffer
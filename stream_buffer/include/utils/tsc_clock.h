@@ -0,0 +1,193 @@
+#pragma once
+
+#include "common/types.h"
+#include "core/seqlock.h"
+#include <atomic>
+#include <ctime>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace stream_buffer
+{
+    namespace utils
+    {
+        namespace constants
+        {
+            constexpr int TSC_CALIBRATION_MS = 20;      // Startup measurement of the TSC frequency
+            constexpr int TSC_RESYNC_INTERVAL_MS = 1000; // Re-anchor against clock_gettime this often
+            constexpr unsigned TSC_SHIFT = 32;          // Fixed-point fraction bits of the ns-per-tick factor
+        } // namespace constants
+
+        /**
+         * @brief Cheap monotonic and wall-clock timestamps from the TSC
+         *
+         * Hot paths read ticks with one rdtsc and convert them to nanoseconds
+         * with a multiply and a shift. The factor is measured against
+         * CLOCK_MONOTONIC at construction and the anchor is refreshed every
+         * TSC_RESYNC_INTERVAL_MS by whichever thread reads the time first,
+         * which also refines the frequency over the longer baseline. Without
+         * an invariant TSC (or off x86) ticks are CLOCK_MONOTONIC nanoseconds.
+         */
+        class TscClock
+        {
+        public:
+            TscClock();
+
+            // Prevent copying
+            TscClock(const TscClock &) = delete;
+            TscClock &operator=(const TscClock &) = delete;
+
+            // Whether the CPU advertises a TSC that runs at a constant rate in every P- and C-state
+            static bool HasInvariantTsc();
+
+            bool IsUsingTsc() const { return use_tsc_; }
+
+            /**
+             * @brief Current ticks, not ordered with surrounding instructions
+             */
+            common::u64 ReadTicks() const
+            {
+#if defined(__x86_64__) || defined(__i386__)
+                if (use_tsc_)
+                {
+                    return __rdtsc();
+                }
+#endif
+                return ReadMonotonicNs();
+            }
+
+            /**
+             * @brief Current ticks, read after every earlier instruction has completed
+             *
+             * Use at the end of a timed region so the work is not reordered past the read.
+             */
+            common::u64 ReadTicksOrdered() const
+            {
+#if defined(__x86_64__) || defined(__i386__)
+                if (use_tsc_ && has_rdtscp_)
+                {
+                    unsigned int cpu;
+                    return __rdtscp(&cpu);
+                }
+#endif
+                return ReadTicks();
+            }
+
+            // CLOCK_MONOTONIC nanoseconds at the given ticks
+            common::i64 ToMonotonicNs(common::u64 ticks) const
+            {
+                Anchor anchor;
+                anchor_.Load(&anchor);
+                return Convert(anchor, ticks);
+            }
+
+            // CLOCK_REALTIME nanoseconds at the given ticks
+            common::i64 ToRealtimeNs(common::u64 ticks) const
+            {
+                Anchor anchor;
+                anchor_.Load(&anchor);
+                return Convert(anchor, ticks) + anchor.realtime_offset_ns;
+            }
+
+            // Nanoseconds covered by a tick difference
+            common::i64 ToDurationNs(common::u64 ticks) const
+            {
+                Anchor anchor;
+                anchor_.Load(&anchor);
+                return Scale(static_cast<common::i64>(ticks), anchor.ns_per_tick);
+            }
+
+            common::i64 NowMonotonicNs()
+            {
+                common::u64 ticks = ReadTicks();
+                MaybeResync(ticks);
+                return ToMonotonicNs(ticks);
+            }
+
+            common::i64 NowRealtimeNs()
+            {
+                common::u64 ticks = ReadTicks();
+                MaybeResync(ticks);
+                return ToRealtimeNs(ticks);
+            }
+
+            /**
+             * @brief Re-anchor to clock_gettime now and refine the frequency
+             * @return false if another thread is already doing it
+             */
+            bool Resync();
+
+            // Ticks per second
+            double GetFrequency() const;
+
+            // Largest gap between a converted and a clock_gettime reading seen at a resync
+            common::i64 GetMaxErrorNs() const { return max_error_ns_.load(std::memory_order_relaxed); }
+
+            common::u64 GetResyncCount() const { return resync_count_.load(std::memory_order_relaxed); }
+
+            static common::i64 ReadMonotonicNs()
+            {
+                timespec now;
+                clock_gettime(CLOCK_MONOTONIC, &now);
+                return static_cast<common::i64>(now.tv_sec) * 1000000000LL + now.tv_nsec;
+            }
+
+        private:
+            // Conversion parameters, replaced as a whole under the seqlock
+            struct Anchor
+            {
+                common::u64 ticks;
+                common::i64 monotonic_ns;
+                common::i64 realtime_offset_ns; // CLOCK_REALTIME - CLOCK_MONOTONIC
+                common::u64 ns_per_tick;        // Fixed point, TSC_SHIFT fraction bits
+            };
+
+            static common::i64 Scale(common::i64 ticks, common::u64 ns_per_tick)
+            {
+                __extension__ typedef __int128 i128;
+                return static_cast<common::i64>((static_cast<i128>(ticks) * static_cast<i128>(ns_per_tick)) >>
+                                                constants::TSC_SHIFT);
+            }
+
+            static common::i64 Convert(const Anchor &anchor, common::u64 ticks)
+            {
+                // Ticks read just before a re-anchor are behind it
+                common::i64 delta = static_cast<common::i64>(ticks - anchor.ticks);
+                return anchor.monotonic_ns + Scale(delta, anchor.ns_per_tick);
+            }
+
+            void MaybeResync(common::u64 ticks)
+            {
+                if (static_cast<common::i64>(ticks - next_resync_ticks_.load(std::memory_order_relaxed)) >= 0)
+                {
+                    Resync();
+                }
+            }
+
+            // Ticks and both clocks read as close together as possible
+            void Sample(common::u64 *ticks, common::i64 *monotonic_ns, common::i64 *realtime_ns) const;
+
+            bool use_tsc_;
+            bool has_rdtscp_;
+            core::SeqLock<Anchor> anchor_;
+            common::u64 first_ticks_; // Start of the frequency baseline
+            common::i64 first_monotonic_ns_;
+            common::u64 resync_interval_ticks_; // Only touched by the thread resyncing
+            std::atomic<common::u64> next_resync_ticks_;
+            std::atomic<bool> resyncing_;
+            std::atomic<common::i64> max_error_ns_;
+            std::atomic<common::u64> resync_count_;
+        };
+
+        /**
+         * @brief The process-wide clock, calibrated on first use
+         */
+        inline TscClock &GetClock()
+        {
+            static TscClock clock;
+            return clock;
+        }
+
+    } // namespace utils
+} // namespace stream_buffer
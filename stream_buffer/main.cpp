@@ -1,5 +1,6 @@
 #include "core/buffer_processor.h"
 #include "common/types.h"
+#include "processing/message_filter.h"
 #include <string>
 #include <iostream>
 #include <memory>
@@ -9,6 +10,7 @@
 #include <arpa/inet.h>
 #include <fstream>
 #include <sstream>
+#include <vector>
 
 using namespace stream_buffer;
 
@@ -65,13 +67,61 @@ std::string extractJsonString(const std::string &json, const std::string &key)
     return "";
 }
 
+// Extract a boolean value from a JSON string, leaving the output unchanged if absent
+bool extractJsonBool(const std::string &json, const std::string &key, bool &value)
+{
+    std::string searchKey = "\"" + key + "\"";
+    size_t pos = json.find(searchKey);
+    if (pos == std::string::npos)
+        return false;
+
+    pos = json.find(':', pos);
+    if (pos == std::string::npos)
+        return false;
+
+    pos = json.find_first_not_of(" \t\n\r", pos + 1);
+    if (pos == std::string::npos)
+        return false;
+
+    if (json.compare(pos, 4, "true") == 0)
+    {
+        value = true;
+        return true;
+    }
+    if (json.compare(pos, 5, "false") == 0)
+    {
+        value = false;
+        return true;
+    }
+    return false;
+}
+
+// Parse an overflow policy name: block, drop, spill or grow
+bool parseOverflowPolicy(const std::string &text, common::OverflowPolicy &policy)
+{
+    const common::OverflowPolicy policies[] = {common::OverflowPolicy::BLOCK, common::OverflowPolicy::DROP_NEWEST,
+                                               common::OverflowPolicy::SPILL, common::OverflowPolicy::GROW};
+    for (size_t i = 0; i < sizeof(policies) / sizeof(policies[0]); ++i)
+    {
+        if (text == core::OverflowPolicyName(policies[i]))
+        {
+            policy = policies[i];
+            return true;
+        }
+    }
+    std::cerr << "Error: Invalid overflow policy '" << text << "', expected block, drop, spill or grow" << std::endl;
+    return false;
+}
+
 // Load configuration from JSON file
 bool loadConfigFromJson(const std::string &filename,
                         std::string &groupIp,
                         std::string &interface,
                         std::string &localIp,
                         int &port,
-                        size_t &bufferSizeMB)
+                        size_t &bufferSizeMB,
+                        common::ProcessingConfig &processingConfig,
+                        bool &socketFilter)
 {
     try
     {
@@ -109,6 +159,94 @@ bool loadConfigFromJson(const std::string &filename,
         if (!value.empty())
             bufferSizeMB = std::stoul(value);
 
+        value = extractJsonString(jsonContent, "buffer_chunk_mb");
+        if (!value.empty())
+            processingConfig.buffer_chunk_size = std::stoul(value) * common::constants::MEGA_BYTE;
+
+        extractJsonBool(jsonContent, "datagram_slots", processingConfig.datagram_slots);
+
+        value = extractJsonString(jsonContent, "reference_snapshot");
+        if (!value.empty())
+            processingConfig.reference_snapshot_path = value;
+
+        value = extractJsonString(jsonContent, "subscribe_messages");
+        if (!value.empty() && !processing::ParseMessageTypes(value, &processingConfig.subscription.message_types))
+        {
+            std::cerr << "Error: Invalid subscribe_messages '" << value << "', expected <trans>:<kind> pairs" << std::endl;
+            return false;
+        }
+
+        value = extractJsonString(jsonContent, "subscribe_products");
+        if (!value.empty() && !processing::ParseProductList(value, &processingConfig.subscription.products))
+        {
+            std::cerr << "Error: Invalid subscribe_products '" << value << "', product ids are at most "
+                      << processing::constants::PRODUCT_ID_SIZE << " characters" << std::endl;
+            return false;
+        }
+
+        extractJsonBool(jsonContent, "socket_filter", socketFilter);
+        extractJsonBool(jsonContent, "validate_checksum", processingConfig.validate_checksum);
+
+        value = extractJsonString(jsonContent, "shm_name");
+        if (!value.empty())
+            processingConfig.shm_name = value;
+
+        value = extractJsonString(jsonContent, "shm_capacity");
+        if (!value.empty())
+            processingConfig.shm_capacity = std::stoul(value);
+
+        value = extractJsonString(jsonContent, "quote_snapshot");
+        if (!value.empty())
+            processingConfig.quote_snapshot_path = value;
+
+        value = extractJsonString(jsonContent, "stats_socket");
+        if (!value.empty())
+            processingConfig.stats_socket_path = value;
+
+        extractJsonBool(jsonContent, "perf_profile", processingConfig.perf_profile);
+
+        value = extractJsonString(jsonContent, "trace_path");
+        if (!value.empty())
+            processingConfig.trace_path = value;
+
+        extractJsonBool(jsonContent, "track_latency", processingConfig.track_latency);
+
+        value = extractJsonString(jsonContent, "exchange_utc_offset_min");
+        if (!value.empty())
+            processingConfig.exchange_utc_offset_min = std::stoi(value);
+
+        value = extractJsonString(jsonContent, "tick_store");
+        if (!value.empty())
+            processingConfig.tick_store_path = value;
+
+        value = extractJsonString(jsonContent, "checkpoint_path");
+        if (!value.empty())
+            processingConfig.checkpoint_path = value;
+
+        value = extractJsonString(jsonContent, "checkpoint_interval_ms");
+        if (!value.empty())
+            processingConfig.checkpoint_interval_ms = std::stoi(value);
+
+        value = extractJsonString(jsonContent, "overflow_policy");
+        if (!value.empty() && !parseOverflowPolicy(value, processingConfig.overflow.policy))
+            return false;
+
+        value = extractJsonString(jsonContent, "overflow_block_ms");
+        if (!value.empty())
+            processingConfig.overflow.block_timeout_ms = std::stoi(value);
+
+        value = extractJsonString(jsonContent, "overflow_spill_path");
+        if (!value.empty())
+            processingConfig.overflow.spill_path = value;
+
+        value = extractJsonString(jsonContent, "overflow_grow_mb");
+        if (!value.empty())
+            processingConfig.overflow.grow_size = std::stoul(value) * common::constants::MEGA_BYTE;
+
+        value = extractJsonString(jsonContent, "overflow_max_grow");
+        if (!value.empty())
+            processingConfig.overflow.max_grow_count = std::stoul(value);
+
         return true;
     }
     catch (const std::exception &e)
@@ -119,7 +257,8 @@ bool loadConfigFromJson(const std::string &filename,
 }
 
 // Parse command line arguments and create configuration
-common::MulticastConfig ParseCommandLine(int argc, char *argv[], size_t &bufferSizeMB)
+common::MulticastConfig ParseCommandLine(int argc, char *argv[], size_t &bufferSizeMB,
+                                         common::ProcessingConfig &processingConfig)
 {
     if (argc < 2)
     {
@@ -134,6 +273,7 @@ common::MulticastConfig ParseCommandLine(int argc, char *argv[], size_t &bufferS
     int port = 10000;
     bufferSizeMB = 100;
     std::string jsonFile;
+    bool socketFilter = false;
 
     // Parse command line options
     int opt;
@@ -172,7 +312,7 @@ common::MulticastConfig ParseCommandLine(int argc, char *argv[], size_t &bufferS
     // If JSON file was specified, load config from it
     if (!jsonFile.empty())
     {
-        if (!loadConfigFromJson(jsonFile, groupIp, interface, localIp, port, bufferSizeMB))
+        if (!loadConfigFromJson(jsonFile, groupIp, interface, localIp, port, bufferSizeMB, processingConfig, socketFilter))
         {
             exit(1);
         }
@@ -209,7 +349,7 @@ common::MulticastConfig ParseCommandLine(int argc, char *argv[], size_t &bufferS
     }
 
     // Create configuration with proper types
-    return common::MulticastConfig(
+    common::MulticastConfig config(
         common::SocketDomain::IPV4,
         common::SocketType::UDP,
         0,
@@ -218,6 +358,21 @@ common::MulticastConfig ParseCommandLine(int argc, char *argv[], size_t &bufferS
         interface,
         localIp,
         8 * common::constants::MEGA_BYTE); // 8MB receive buffer
+
+    // Let the kernel drop the message types the subscription filter would skip
+    if (socketFilter)
+    {
+        if (processingConfig.subscription.message_types.empty())
+        {
+            std::cerr << "Warning: socket_filter needs subscribe_messages, socket filter disabled" << std::endl;
+        }
+        else
+        {
+            config.socket_filter_message_types = processingConfig.subscription.message_types;
+        }
+    }
+
+    return config;
 }
 
 int main(int argc, char *argv[])
@@ -229,7 +384,8 @@ int main(int argc, char *argv[])
 
         // Parse command line and get config
         size_t bufferSizeMB = 0;
-        common::MulticastConfig config = ParseCommandLine(argc, argv, bufferSizeMB);
+        common::ProcessingConfig processingConfig;
+        common::MulticastConfig config = ParseCommandLine(argc, argv, bufferSizeMB, processingConfig);
 
         // Display configuration
         std::cout << "Configuration:\n"
@@ -238,12 +394,31 @@ int main(int argc, char *argv[])
                   << "  Local IP:     " << config.interface_ip << "\n"
                   << "  Port:         " << config.port << "\n"
                   << "  Buffer Size:  " << bufferSizeMB << "MB\n"
+                  << "  Chunk Size:   " << (processingConfig.buffer_chunk_size == 0 ? std::string("contiguous") : std::to_string(processingConfig.buffer_chunk_size / common::constants::MEGA_BYTE) + "MB") << "\n"
+                  << "  Ref Snapshot: " << (processingConfig.reference_snapshot_path.empty() ? "disabled" : processingConfig.reference_snapshot_path) << "\n"
+                  << "  Subscribed:   " << processingConfig.subscription.message_types.size() << " message types, "
+                  << processingConfig.subscription.products.size() << " products\n"
+                  << "  BPF Filter:   " << (config.socket_filter_message_types.empty() ? "off" : "on") << "\n"
+                  << "  Checksum:     " << (processingConfig.validate_checksum ? "validated" : "trusted") << "\n"
+                  << "  Shared Mem:   " << (processingConfig.shm_name.empty() ? "disabled" : processingConfig.shm_name) << "\n"
+                  << "  Quote Table:  " << (processingConfig.quote_snapshot_path.empty() ? "disabled" : processingConfig.quote_snapshot_path) << "\n"
+                  << "  Framing:      " << (processingConfig.datagram_slots ? "datagram slots" : "byte stream") << "\n"
+                  << "  Stats Socket: " << (processingConfig.stats_socket_path.empty() ? "disabled" : processingConfig.stats_socket_path) << "\n"
+                  << "  Profiling:    " << (processingConfig.perf_profile ? "perf counters" : "off") << "\n"
+                  << "  Trace File:   " << (processingConfig.trace_path.empty() ? "disabled" : processingConfig.trace_path) << "\n"
+                  << "  Latency:      " << (processingConfig.track_latency ? "on, exchange at UTC offset " + std::to_string(processingConfig.exchange_utc_offset_min) + " min" : std::string("off")) << "\n"
+                  << "  Tick Store:   " << (processingConfig.tick_store_path.empty() ? "disabled" : processingConfig.tick_store_path) << "\n"
+                  << "  Checkpoint:   " << (processingConfig.checkpoint_path.empty() ? "disabled" : processingConfig.checkpoint_path + " every " + std::to_string(processingConfig.checkpoint_interval_ms) + " ms") << "\n"
+                  << "  Overflow:     " << core::OverflowPolicyName(processingConfig.overflow.policy) << "\n"
                   << "----------------------------------------" << std::endl;
 
         // Create and run the buffer processor
         core::BufferProcessor processor(
             config,
-            bufferSizeMB * common::constants::MEGA_BYTE);
+            bufferSizeMB * common::constants::MEGA_BYTE,
+            nullptr,
+            nullptr,
+            processingConfig);
 
         processor.Run();
 
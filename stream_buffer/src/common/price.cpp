@@ -0,0 +1,78 @@
+#include "common/price.h"
+#include "utils/debug.h"
+
+namespace stream_buffer
+{
+    namespace common
+    {
+
+        bool Price::FromBcd(const void *data, size_t length, u8 scale, Price *price)
+        {
+            if (!price || scale > constants::MAX_PRICE_SCALE)
+            {
+                return false;
+            }
+
+            long long mantissa = utils::decode_bcd(data, length);
+            if (mantissa < 0)
+            {
+                return false;
+            }
+
+            *price = Price(mantissa, scale);
+            return true;
+        }
+
+        size_t Price::Format(char *out, size_t size) const
+        {
+            // Digits are produced in reverse order into a scratch buffer
+            char digits[32];
+            size_t count = 0;
+
+            // Work on the magnitude as unsigned to handle INT64_MIN
+            u64 magnitude = mantissa_ < 0 ? static_cast<u64>(-(mantissa_ + 1)) + 1 : static_cast<u64>(mantissa_);
+
+            do
+            {
+                digits[count++] = static_cast<char>('0' + magnitude % 10);
+                magnitude /= 10;
+            } while (magnitude != 0);
+
+            // Pad with zeros so there is at least one integer digit
+            while (count <= scale_)
+            {
+                digits[count++] = '0';
+            }
+
+            size_t needed = count + (scale_ > 0 ? 1 : 0) + (mantissa_ < 0 ? 1 : 0);
+            if (!out || size <= needed)
+            {
+                return 0;
+            }
+
+            size_t pos = 0;
+            if (mantissa_ < 0)
+            {
+                out[pos++] = '-';
+            }
+            for (size_t i = count; i > 0; --i)
+            {
+                if (i == scale_ && scale_ > 0)
+                {
+                    out[pos++] = '.';
+                }
+                out[pos++] = digits[i - 1];
+            }
+            out[pos] = '\0';
+            return pos;
+        }
+
+        std::string Price::ToString() const
+        {
+            char text[40];
+            size_t length = Format(text, sizeof(text));
+            return std::string(text, length);
+        }
+
+    } // namespace common
+} // namespace stream_buffer
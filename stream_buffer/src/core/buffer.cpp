@@ -1,12 +1,44 @@
 #include "core/buffer.h"
 #include "utils/debug.h"
 #include <cstring>
+#include <new>
 
 namespace stream_buffer
 {
     namespace core
     {
 
+        BatchResult IBufferProcessor::ProcessBatch(const char *data, size_t length)
+        {
+            BatchResult result;
+            while (result.bytes_consumed < length)
+            {
+                size_t processed = ProcessMessage(data + result.bytes_consumed, length - result.bytes_consumed);
+                if (processed == 0)
+                {
+                    break;
+                }
+                result.bytes_consumed += processed;
+                result.message_count++;
+            }
+            return result;
+        }
+
+        BatchResult IBufferProcessor::ProcessDatagram(const DatagramSlot &slot)
+        {
+            return ProcessBatch(slot.GetPayload(), slot.length);
+        }
+
+        BatchResult IBufferProcessor::ProcessSlots(const char *data, size_t length)
+        {
+            BatchResult result;
+            result.bytes_consumed = ForEachSlot(data, length, [this, &result](const DatagramSlot &slot)
+            {
+                result.message_count += ProcessDatagram(slot).message_count;
+            });
+            return result;
+        }
+
         Buffer::Buffer(size_t buffer_size, std::unique_ptr<IBufferProcessor> processor)
             : capacity_(buffer_size), processor_(std::move(processor))
         {
@@ -118,12 +150,42 @@ namespace stream_buffer
             size_t queued = GetQueuedSize();
             FMT_PRINT("Buffer::CompactBuffer() top=%zu end=%zu queued=%zu\n", top_, end_, queued);
 
+            // Nothing queued: rewind, nothing to move
             if (top_ > 0 && queued > 0)
             {
                 std::memmove(&buffer_[0], &buffer_[top_], queued);
-                end_ = queued;
-                top_ = 0;
             }
+            end_ = queued;
+            top_ = 0;
+        }
+
+        size_t Buffer::Reserve(size_t min_size)
+        {
+            (void)min_size; // The buffer cannot make room by itself
+
+            return GetAvailableSize();
+        }
+
+        bool Buffer::Grow(size_t additional_size)
+        {
+            size_t queued = GetQueuedSize();
+            std::unique_ptr<char[]> grown(new (std::nothrow) char[capacity_ + additional_size]);
+            if (!grown)
+            {
+                FMT_PRINT("Failed to grow buffer by %zu bytes\n", additional_size);
+                return false;
+            }
+
+            if (queued > 0)
+            {
+                std::memcpy(grown.get(), &buffer_[top_], queued);
+            }
+            buffer_ = std::move(grown);
+            capacity_ += additional_size;
+            top_ = 0;
+            end_ = queued;
+            FMT_PRINT("Buffer grown to %zu bytes\n", capacity_);
+            return true;
         }
 
         void Buffer::AppendData(size_t data_size)
@@ -146,5 +208,25 @@ namespace stream_buffer
             return processor_->ProcessMessage(GetBufferTopPtr(), GetQueuedSize());
         }
 
+        BatchResult Buffer::ProcessPendingBatch(size_t length)
+        {
+            if (!processor_)
+            {
+                return BatchResult();
+            }
+
+            return processor_->ProcessBatch(GetBufferTopPtr(), length);
+        }
+
+        BatchResult Buffer::ProcessPendingSlots(size_t length)
+        {
+            if (!processor_)
+            {
+                return BatchResult();
+            }
+
+            return processor_->ProcessSlots(GetBufferTopPtr(), length);
+        }
+
     } // namespace core
 } // namespace stream_buffer
\ No newline at end of file
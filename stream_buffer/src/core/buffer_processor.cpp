@@ -1,8 +1,15 @@
 #include "core/buffer_processor.h"
 #include "utils/debug.h"
 #include "processing/tfe_processor.h"
+#include "utils/metrics.h"
+#include "utils/trace.h"
+#include "utils/tsc_clock.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <iostream>
 #include <cstring>
+#include <poll.h>
 
 namespace stream_buffer
 {
@@ -13,7 +20,8 @@ namespace stream_buffer
         class TFEMessageProcessor : public core::IMessageProcessor
         {
         public:
-            explicit TFEMessageProcessor(Buffer *buffer) : buffer_(buffer) {}
+            TFEMessageProcessor(IBuffer *buffer, bool datagram_slots)
+                : buffer_(buffer), datagram_slots_(datagram_slots) {}
 
             bool ProcessMessage(char *data, size_t length) override
             {
@@ -24,18 +32,47 @@ namespace stream_buffer
                 return processed != static_cast<size_t>(common::constants::PROCESS_FAILED);
             }
 
+            bool ProcessBatch(char *data, size_t length, BatchResult *result) override
+            {
+                (void)data; // Same span as the buffer top
+
+                *result = datagram_slots_ ? buffer_->ProcessPendingSlots(length)
+                                          : buffer_->ProcessPendingBatch(length);
+                return true;
+            }
+
         private:
-            Buffer *buffer_;
+            IBuffer *buffer_;
+            bool datagram_slots_;
         };
 
+        IBuffer *BufferProcessor::MakeBuffer(size_t buffer_size, const common::ProcessingConfig &processing_config,
+                                             std::unique_ptr<IBufferProcessor> processor)
+        {
+            if (processing_config.buffer_chunk_size > 0)
+            {
+                return new ChunkedBuffer(buffer_size, processing_config.buffer_chunk_size, std::move(processor));
+            }
+            return new Buffer(buffer_size, std::move(processor));
+        }
+
         BufferProcessor::BufferProcessor(
             const common::MulticastConfig &config,
             size_t buffer_size,
             std::unique_ptr<network::INetworkReceiver> network_receiver,
-            std::unique_ptr<core::IMessageProcessor> message_processor)
-            : buffer_(new Buffer(buffer_size, std::unique_ptr<processing::TFEProcessor>(new processing::TFEProcessor()))),
+            std::unique_ptr<core::IMessageProcessor> message_processor,
+            const common::ProcessingConfig &processing_config)
+            : reference_data_(new processing::ReferenceDataStore()),
+              message_filter_(new processing::MessageFilter(processing_config.subscription)),
+              tfe_processor_(new processing::TFEProcessor(reference_data_.get(),
+                                                          message_filter_.get(),
+                                                          processing_config.validate_checksum)),
+              buffer_(MakeBuffer(buffer_size, processing_config,
+                                 std::unique_ptr<processing::TFEProcessor>(tfe_processor_))),
               sync_(new ThreadSync()),
-              config_(config)
+              scratch_(new char[constants::MAX_SLOT_SIZE]),
+              config_(config),
+              processing_config_(processing_config)
         {
             // Create default implementations if not provided
             if (!network_receiver)
@@ -50,12 +87,98 @@ namespace stream_buffer
 
             if (!message_processor)
             {
-                message_processor_.reset(new TFEMessageProcessor(buffer_.get()));
+                message_processor_.reset(new TFEMessageProcessor(buffer_.get(), processing_config_.datagram_slots));
             }
             else
             {
                 message_processor_ = std::move(message_processor);
             }
+
+            // Publish decoded messages to local processes
+            if (!processing_config_.shm_name.empty())
+            {
+                shm_publisher_.reset(new ipc::ShmPublisher());
+                if (shm_publisher_->Open(processing_config_.shm_name, processing_config_.shm_capacity))
+                {
+                    tfe_processor_->AddSink(shm_publisher_.get());
+                }
+                else
+                {
+                    shm_publisher_.reset();
+                }
+            }
+
+            // Keep the latest quote and trade per product for polling readers
+            if (!processing_config_.quote_snapshot_path.empty())
+            {
+                quote_snapshots_.reset(new processing::QuoteSnapshotTable(
+                    processing::constants::DEFAULT_MAX_SYMBOLS, processing_config_.quote_snapshot_path));
+                tfe_processor_->AddSink(quote_snapshots_.get());
+            }
+
+            // Checkpoint reference data, books and sequence numbers for a restart mid-session
+            if (!processing_config_.checkpoint_path.empty())
+            {
+                // Books are kept in private memory when no table file is configured
+                if (!quote_snapshots_)
+                {
+                    quote_snapshots_.reset(new processing::QuoteSnapshotTable());
+                    tfe_processor_->AddSink(quote_snapshots_.get());
+                }
+                checkpointer_.reset(new processing::StateCheckpointer(
+                    processing_config_.checkpoint_path, reference_data_.get(), quote_snapshots_.get(),
+                    processing_config_.checkpoint_interval_ms));
+                if (checkpointer_->Open())
+                {
+                    // After the tables, so a saved sequence is never ahead of the saved state
+                    tfe_processor_->AddSink(checkpointer_.get());
+                }
+                else
+                {
+                    FMT_PRINT("Checkpoints unavailable, state will not survive a restart\n");
+                    checkpointer_.reset();
+                }
+            }
+
+            // Record decoded messages to columnar files on a writer thread of their own
+            if (!processing_config_.tick_store_path.empty())
+            {
+                tick_store_.reset(new processing::TickStoreSink(processing_config_.tick_store_path));
+                if (tick_store_->Start())
+                {
+                    tfe_processor_->AddSink(tick_store_.get());
+                }
+                else
+                {
+                    FMT_PRINT("Tick store unavailable, messages will not be recorded\n");
+                    tick_store_.reset();
+                }
+            }
+
+            // Hardware counters around the receive loop and every decoded packet
+            if (processing_config_.perf_profile)
+            {
+                profiler_.reset(new utils::PerfProfiler());
+                tfe_processor_->EnableProfiling(profiler_.get());
+            }
+
+            // Exchange-to-receive latency of every decoded message
+            if (processing_config_.track_latency)
+            {
+                latency_tracker_.reset(new processing::LatencyTracker(processing_config_.exchange_utc_offset_min));
+                tfe_processor_->SetLatencyTracker(latency_tracker_.get());
+            }
+
+            // Overflow file for datagrams that arrive while the buffer is full
+            if (processing_config_.overflow.policy == common::OverflowPolicy::SPILL)
+            {
+                spill_.reset(new SpillSegment());
+                if (!spill_->Open(processing_config_.overflow.spill_path))
+                {
+                    FMT_PRINT("Spill file unavailable, datagrams will be dropped on overflow\n");
+                    spill_.reset();
+                }
+            }
         }
 
         BufferProcessor::~BufferProcessor()
@@ -63,57 +186,220 @@ namespace stream_buffer
             Stop();
         }
 
-        void BufferProcessor::Run()
+        void BufferProcessor::AddSink(processing::IMessageSink *sink)
         {
-            // Create socket
-            socket_id_ = network::CreateSocket(config_);
+            tfe_processor_->AddSink(sink);
+        }
 
-            if (socket_id_ < 0)
+        void BufferProcessor::Run()
+        {
+            if (!Start())
             {
-                FMT_PRINT("Failed to create socket\n");
                 return;
             }
 
-            // Join multicast group
-            if (network::JoinMulticastGroup(
-                    socket_id_,
-                    config_.group_ip,
-                    config_.port,
-                    config_.interface_name,
-                    config_.interface_ip) < 0)
+            // Wait for user input to stop
+            FMT_PRINT("Running... press Enter to exit\n");
+            std::cin.get();
+
+            // Clean up
+            Stop();
+        }
+
+        bool BufferProcessor::Start()
+        {
+            if (started_)
             {
+                return true;
+            }
 
-                FMT_PRINT("Failed to join multicast group\n");
-                close(socket_id_);
-                return;
+            // Restore reference data from the last session before any I010 arrives
+            if (!processing_config_.reference_snapshot_path.empty())
+            {
+                reference_data_->LoadSnapshot(processing_config_.reference_snapshot_path);
+            }
+
+            // A checkpoint from earlier in the session is newer than the snapshot
+            if (checkpointer_)
+            {
+                checkpointer_->Restore();
+                checkpointer_->Start();
             }
 
-            // Create network receiver with socket
-            network_receiver_.reset(new network::MulticastReceiver(socket_id_));
+            // An injected receiver replaces the multicast socket
+            if (!network_receiver_)
+            {
+                // Create socket
+                socket_id_ = network::CreateSocket(config_);
+
+                if (socket_id_ < 0)
+                {
+                    FMT_PRINT("Failed to create socket\n");
+                    return false;
+                }
+
+                // Join multicast group; the socket is closed on failure
+                if (network::JoinMulticastGroup(
+                        socket_id_,
+                        config_.group_ip,
+                        config_.port,
+                        config_.interface_name,
+                        config_.interface_ip) < 0)
+                {
+
+                    FMT_PRINT("Failed to join multicast group\n");
+                    socket_id_ = -1;
+                    return false;
+                }
+
+                // Kernel arrival times are recorded in every slot
+                if (processing_config_.datagram_slots)
+                {
+                    network::EnableReceiveTimestamps(socket_id_);
+                }
+
+                // Let the receive thread notice Stop() on a quiet feed
+                network::SetReceiveTimeout(socket_id_, network::constants::RECEIVE_TIMEOUT_MS);
+
+                // Create network receiver with socket
+                network_receiver_.reset(new network::MulticastReceiver(socket_id_));
+            }
+
+            // Serve metric snapshots to stream_buffer-stat
+            if (!processing_config_.stats_socket_path.empty())
+            {
+                stats_server_.reset(new ipc::StatsServer());
+                if (profiler_)
+                {
+                    utils::PerfProfiler *profiler = profiler_.get();
+                    stats_server_->AddSection([profiler]() { return profiler->Format(); });
+                }
+                if (latency_tracker_)
+                {
+                    processing::LatencyTracker *tracker = latency_tracker_.get();
+                    stats_server_->AddSection([tracker]() { return tracker->Format(); });
+                }
+                if (checkpointer_)
+                {
+                    processing::StateCheckpointer *checkpointer = checkpointer_.get();
+                    stats_server_->AddSection([checkpointer]() { return checkpointer->Format(); });
+                }
+                const OverflowCounters *overflow = &overflow_counters_;
+                stats_server_->AddSection([overflow]() { return overflow->Snapshot().Format(); });
+                if (!stats_server_->Start(processing_config_.stats_socket_path))
+                {
+                    stats_server_.reset();
+                }
+            }
+            UpdateBufferGauges();
+
+            // Record pipeline events from the start, dumped by Stop
+            if (!processing_config_.trace_path.empty())
+            {
+                utils::Tracer::Enable(true);
+            }
+
+            // Calibrate the TSC here, not inside the first timestamp on the hot path
+            utils::GetClock();
 
             // Start processing
             running_ = true;
+            started_ = true;
             StartThreads();
-
-            // Wait for user input to stop
-            FMT_PRINT("Running... press Enter to exit\n");
-            std::cin.get();
-
-            // Clean up
-            Stop();
+            return true;
         }
 
         void BufferProcessor::Stop()
         {
-            if (running_)
+            // Either thread may already have stopped on an error
+            if (started_)
             {
+                started_ = false;
                 running_ = false;
+
+                // Wake the processing thread if it is waiting for data and
+                // the receive thread if it is waiting for space
+                sync_->Lock();
+                sync_->Broadcast();
+                sync_->Unlock();
+
                 JoinThreads();
+                if (!processing_config_.trace_path.empty())
+                {
+                    utils::Tracer::Enable(false);
+                    if (utils::Tracer::DumpChromeTrace(processing_config_.trace_path))
+                    {
+                        FMT_PRINT("Trace written to %s\n", processing_config_.trace_path.c_str());
+                    }
+                }
+                if (stats_server_)
+                {
+                    stats_server_->Stop();
+                }
                 if (socket_id_ >= 0)
                 {
                     close(socket_id_);
                     socket_id_ = -1;
                 }
+                if (shm_publisher_)
+                {
+                    FMT_PRINT("Messages published to shared memory: %llu\n",
+                              static_cast<unsigned long long>(shm_publisher_->GetPublishedCount()));
+                    shm_publisher_->Close();
+                }
+                if (checkpointer_)
+                {
+                    checkpointer_->Stop();
+                    FMT_PRINT("State checkpoints written: %llu, latest generation %llu\n",
+                              static_cast<unsigned long long>(checkpointer_->GetCheckpointCount()),
+                              static_cast<unsigned long long>(checkpointer_->GetGeneration()));
+                }
+                if (tick_store_)
+                {
+                    tick_store_->Stop();
+                    FMT_PRINT("Messages written to tick store: %llu, dropped: %llu\n",
+                              static_cast<unsigned long long>(tick_store_->GetWrittenCount()),
+                              static_cast<unsigned long long>(tick_store_->GetDroppedCount()));
+                }
+                OverflowStats overflow = overflow_counters_.Snapshot();
+                if (overflow.full_events > 0)
+                {
+                    FMT_PRINT("Buffer overflow (%s): %llu episodes, %llu datagrams dropped (%llu bytes), "
+                              "%llu bytes spilled, %llu bytes replayed, %llu growths\n",
+                              OverflowPolicyName(processing_config_.overflow.policy),
+                              static_cast<unsigned long long>(overflow.full_events),
+                              static_cast<unsigned long long>(overflow.dropped_datagrams),
+                              static_cast<unsigned long long>(overflow.dropped_bytes),
+                              static_cast<unsigned long long>(overflow.spilled_bytes),
+                              static_cast<unsigned long long>(overflow.replayed_bytes),
+                              static_cast<unsigned long long>(overflow.grow_count));
+                }
+                if (spill_)
+                {
+                    spill_->Close();
+                }
+                if (processing_config_.datagram_slots)
+                {
+                    FMT_PRINT("Datagrams received: %u, damaged: %llu\n", datagram_sequence_,
+                              static_cast<unsigned long long>(tfe_processor_->GetDamagedDatagramCount()));
+                }
+                if (profiler_)
+                {
+                    FMT_PRINT("Hardware counters:\n%s", profiler_->Format().c_str());
+                }
+                if (latency_tracker_)
+                {
+                    FMT_PRINT("Feed latency:\n%s", latency_tracker_->Format().c_str());
+                }
+                if (message_filter_->IsEnabled())
+                {
+                    FMT_PRINT("Messages skipped by subscription filter: %llu\n",
+                              static_cast<unsigned long long>(message_filter_->GetSkippedCount()));
+                }
+                if (!processing_config_.reference_snapshot_path.empty())
+                {
+                    reference_data_->SaveSnapshot(processing_config_.reference_snapshot_path);
+                }
             }
         }
 
@@ -133,56 +419,86 @@ namespace stream_buffer
         {
             auto *processor = static_cast<BufferProcessor *>(arg);
 
+            utils::Tracer::SetThreadName("receive");
+
+            // Counters are per thread, so they are opened here
+            std::unique_ptr<utils::PerfRecorder> recorder;
+            if (processor->profiler_)
+            {
+                recorder.reset(new utils::PerfRecorder(*processor->profiler_));
+            }
+
             while (processor->running_)
             {
+                if (recorder)
+                {
+                    recorder->Restart();
+                }
+
                 processor->sync_->Lock();
 
-                // Check if buffer needs to be reset or compacted
+                // Check if buffer needs to be reset or compacted; data must
+                // not move while the processing thread is reading it
                 if (processor->buffer_->IsEmpty())
                 {
                     processor->buffer_->Reset();
                 }
-                else if (processor->buffer_->ShouldCompact())
+                else if (!processor->processing_ && processor->buffer_->ShouldCompact())
                 {
-                    processor->buffer_->CompactBuffer();
+                    processor->CompactBuffer();
                 }
 
-                // Get available space
-                size_t avail = processor->buffer_->GetAvailableSize();
+                // Get contiguous space for the next datagram
+                size_t avail = processor->buffer_->Reserve(processor->GetRequiredSpace());
 
                 processor->sync_->Unlock();
 
-                // Receive data if space available
-                if (avail > 0)
+                // A datagram is never received into less space than it may need,
+                // the kernel would truncate it
+                if (avail < processor->GetRequiredSpace())
                 {
-                    int received = processor->network_receiver_->ReceiveData(
-                        processor->buffer_->GetBufferEndPtr(), avail);
-
-                    if (received > 0)
+                    if (!processor->HandleBufferFull())
                     {
-                        processor->sync_->Lock();
-                        processor->buffer_->AppendData(received);
-                        processor->sync_->Signal();
-                        processor->sync_->Unlock();
+                        break;
                     }
-                    else if (errno == EINTR || errno == EAGAIN)
+                    continue;
+                }
+
+                // Spilled datagrams go back into the buffer before any new one
+                if (processor->spill_ && !processor->spill_->IsEmpty())
+                {
+                    processor->ReplaySpill(avail);
+
+                    // Keep the socket drained meanwhile; new datagrams queue behind the spilled ones
+                    pollfd socket_poll = {processor->socket_id_, POLLIN, 0};
+                    if (processor->socket_id_ >= 0 && poll(&socket_poll, 1, 0) > 0 &&
+                        !processor->SpillDatagram())
                     {
-                        // Handle temporary errors with select
-                        timeval timeout;
-                        timeout.tv_sec = 1;
-                        timeout.tv_usec = 0;
-                        fd_set read_set;
-                        FD_ZERO(&read_set);
-                        FD_SET(processor->socket_id_, &read_set);
-                        select(processor->socket_id_ + 1, &read_set, nullptr, nullptr, &timeout);
-                        continue;
+                        break;
                     }
-                    else if (received < 0)
+                    continue;
+                }
+                processor->overflow_active_ = false;
+
+                size_t frame_size = 0;
+                if (!processor->ReceiveFrame(processor->buffer_->GetBufferEndPtr(), avail, &frame_size))
+                {
+                    break;
+                }
+
+                if (frame_size > 0)
+                {
+                    TRACE_SCOPE(trace, utils::TraceEvent::APPEND);
+                    trace.SetArg(frame_size);
+                    processor->sync_->Lock();
+                    processor->buffer_->AppendData(frame_size);
+                    processor->UpdateBufferGauges();
+                    processor->sync_->Signal();
+                    processor->sync_->Unlock();
+
+                    if (recorder)
                     {
-                        // Fatal error
-                        FMT_PRINT("Socket error: %s\n", strerror(errno));
-                        processor->running_ = false;
-                        break;
+                        recorder->Checkpoint(utils::PerfScope::RECEIVE, frame_size);
                     }
                 }
             }
@@ -190,9 +506,362 @@ namespace stream_buffer
             return nullptr;
         }
 
+        bool BufferProcessor::ReceiveInto(char *data, size_t size, int *received, network::DatagramInfo *info)
+        {
+            {
+                TRACE_SCOPE(trace, utils::TraceEvent::RECEIVE);
+                *received = info ? network_receiver_->ReceiveDatagram(data, size, info)
+                                 : network_receiver_->ReceiveData(data, size);
+                trace.SetArg(*received > 0 ? static_cast<common::u64>(*received) : 0);
+            }
+            if (*received > 0)
+            {
+                utils::MetricsRegistry &metrics = utils::GetMetrics();
+                metrics.Add(utils::Counter::PACKETS_RECEIVED);
+                metrics.Add(utils::Counter::BYTES_RECEIVED, static_cast<common::u64>(*received));
+                metrics.Record(utils::Histogram::DATAGRAM_BYTES, static_cast<common::u64>(*received));
+                return true;
+            }
+
+            if (errno == EINTR || errno == EAGAIN)
+            {
+                // Handle temporary errors with select
+                if (socket_id_ >= 0)
+                {
+                    timeval timeout;
+                    timeout.tv_sec = network::constants::RECEIVE_TIMEOUT_MS / 1000;
+                    timeout.tv_usec = (network::constants::RECEIVE_TIMEOUT_MS % 1000) * 1000;
+                    fd_set read_set;
+                    FD_ZERO(&read_set);
+                    FD_SET(socket_id_, &read_set);
+                    select(socket_id_ + 1, &read_set, nullptr, nullptr, &timeout);
+                }
+                *received = 0;
+                return true;
+            }
+
+            if (*received < 0)
+            {
+                // Fatal error
+                FMT_PRINT("Socket error: %s\n", strerror(errno));
+                running_ = false;
+                return false;
+            }
+            return true;
+        }
+
+        bool BufferProcessor::ReceiveFrame(char *data, size_t size, size_t *frame_size)
+        {
+            *frame_size = 0;
+            int received = 0;
+            if (!processing_config_.datagram_slots)
+            {
+                if (!ReceiveInto(data, size, &received))
+                {
+                    return false;
+                }
+                *frame_size = received > 0 ? static_cast<size_t>(received) : 0;
+                return true;
+            }
+
+            // The payload goes right behind the header, which is filled in afterwards
+            network::DatagramInfo info;
+            if (!ReceiveInto(data + sizeof(DatagramSlot), size - sizeof(DatagramSlot), &received, &info))
+            {
+                return false;
+            }
+            if (received <= 0)
+            {
+                return true;
+            }
+
+            DatagramSlot *slot = reinterpret_cast<DatagramSlot *>(data);
+            slot->length = static_cast<common::u32>(received);
+            slot->source_port = info.source_port;
+            slot->flags = info.truncated ? constants::SLOT_TRUNCATED : 0;
+            slot->reserved = 0;
+            slot->source_ip = info.source_ip;
+            slot->sequence = datagram_sequence_++;
+            slot->receive_time_ns = info.receive_time_ns != 0 ? info.receive_time_ns : utils::GetClock().NowRealtimeNs();
+            *frame_size = GetSlotSize(slot->length);
+            return true;
+        }
+
+        void BufferProcessor::CompactBuffer()
+        {
+            TRACE_SCOPE(trace, utils::TraceEvent::COMPACT);
+            trace.SetArg(buffer_->GetQueuedSize());
+            buffer_->CompactBuffer();
+            utils::GetMetrics().Add(utils::Counter::COMPACTIONS);
+        }
+
+        void BufferProcessor::UpdateBufferGauges()
+        {
+            utils::MetricsRegistry &metrics = utils::GetMetrics();
+            metrics.Set(utils::Gauge::BUFFER_QUEUED_BYTES, static_cast<common::i64>(buffer_->GetTotalQueuedSize()));
+            metrics.Set(utils::Gauge::BUFFER_CAPACITY_BYTES, static_cast<common::i64>(buffer_->GetTotalCapacity()));
+        }
+
+        size_t BufferProcessor::GetRequiredSpace() const
+        {
+            size_t frame_size = processing_config_.datagram_slots ? constants::MAX_SLOT_SIZE
+                                                                  : common::constants::MAX_DATAGRAM_SIZE;
+            return std::min(frame_size, buffer_->GetTotalCapacity());
+        }
+
+        bool BufferProcessor::HandleBufferFull()
+        {
+            if (!overflow_active_)
+            {
+                overflow_active_ = true;
+                OverflowCounters::Add(overflow_counters_.full_events, 1);
+                RaiseOverflowAlert("buffer full");
+            }
+
+            switch (processing_config_.overflow.policy)
+            {
+            case common::OverflowPolicy::DROP_NEWEST:
+                return DropDatagram();
+            case common::OverflowPolicy::SPILL:
+                return SpillDatagram();
+            case common::OverflowPolicy::GROW:
+                return GrowBuffer();
+            case common::OverflowPolicy::BLOCK:
+            default:
+                return WaitForSpace();
+            }
+        }
+
+        bool BufferProcessor::WaitForSpace()
+        {
+            OverflowCounters::Add(overflow_counters_.block_waits, 1);
+            std::chrono::steady_clock::time_point deadline =
+                std::chrono::steady_clock::now() +
+                std::chrono::milliseconds(processing_config_.overflow.block_timeout_ms);
+            bool has_space = false;
+
+            sync_->Lock();
+            while (running_)
+            {
+                // The processing thread broadcasts whenever it releases a span
+                if (!processing_ && buffer_->ShouldCompact())
+                {
+                    CompactBuffer();
+                }
+                if (buffer_->Reserve(GetRequiredSpace()) >= GetRequiredSpace())
+                {
+                    has_space = true;
+                    break;
+                }
+
+                long long remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                          deadline - std::chrono::steady_clock::now())
+                                          .count();
+                if (remaining <= 0)
+                {
+                    break;
+                }
+                sync_->TimedWait(static_cast<int>(remaining));
+            }
+            sync_->Unlock();
+
+            if (has_space || !running_)
+            {
+                return true;
+            }
+
+            // Waited long enough: keep the socket moving at the cost of one datagram
+            OverflowCounters::Add(overflow_counters_.block_timeouts, 1);
+            if (overflow_counters_.block_timeouts.load(std::memory_order_relaxed) == 1)
+            {
+                RaiseOverflowAlert("block timeout, dropping");
+            }
+            return DropDatagram();
+        }
+
+        bool BufferProcessor::GrowBuffer()
+        {
+            const common::OverflowConfig &overflow = processing_config_.overflow;
+            if (grow_disabled_ || overflow_counters_.grow_count.load(std::memory_order_relaxed) >= overflow.max_grow_count)
+            {
+                if (overflow_counters_.dropped_datagrams.load(std::memory_order_relaxed) == 0)
+                {
+                    RaiseOverflowAlert("grow limit reached, dropping");
+                }
+                return DropDatagram();
+            }
+
+            size_t grow_size = overflow.grow_size > 0 ? overflow.grow_size : buffer_->GetTotalCapacity();
+            bool has_space = false;
+            bool grown = false;
+
+            // The buffer may only move while the processing thread holds no span
+            sync_->Lock();
+            while (processing_ && running_)
+            {
+                sync_->TimedWait(overflow.block_timeout_ms);
+            }
+            if (running_)
+            {
+                if (buffer_->ShouldCompact())
+                {
+                    CompactBuffer();
+                }
+                has_space = buffer_->Reserve(GetRequiredSpace()) >= GetRequiredSpace();
+                if (!has_space)
+                {
+                    grown = buffer_->Grow(grow_size);
+                    UpdateBufferGauges();
+                }
+            }
+            sync_->Unlock();
+
+            if (grown)
+            {
+                OverflowCounters::Add(overflow_counters_.grow_count, 1);
+                OverflowCounters::Add(overflow_counters_.grown_bytes, grow_size);
+                RaiseOverflowAlert("buffer grown");
+                return true;
+            }
+            if (has_space || !running_)
+            {
+                return true;
+            }
+
+            // Out of memory: stop trying to grow
+            grow_disabled_ = true;
+            RaiseOverflowAlert("grow failed, dropping");
+            return DropDatagram();
+        }
+
+        bool BufferProcessor::DropDatagram()
+        {
+            int received = 0;
+            if (!ReceiveInto(scratch_.get(), common::constants::MAX_DATAGRAM_SIZE, &received))
+            {
+                return false;
+            }
+
+            if (received > 0)
+            {
+                OverflowCounters::Add(overflow_counters_.dropped_datagrams, 1);
+                OverflowCounters::Add(overflow_counters_.dropped_bytes, static_cast<common::u64>(received));
+            }
+            return true;
+        }
+
+        bool BufferProcessor::SpillDatagram()
+        {
+            if (!spill_)
+            {
+                return DropDatagram();
+            }
+
+            // Spilled exactly as it would have been queued; a byte-stream datagram
+            // goes behind its length so that replay puts it back whole
+            size_t prefix = processing_config_.datagram_slots ? 0 : sizeof(common::u32);
+            size_t frame_size = 0;
+            if (!ReceiveFrame(scratch_.get() + prefix, constants::MAX_SLOT_SIZE - prefix, &frame_size))
+            {
+                return false;
+            }
+            if (frame_size == 0)
+            {
+                return true;
+            }
+            if (prefix > 0)
+            {
+                common::u32 length = static_cast<common::u32>(frame_size);
+                std::memcpy(scratch_.get(), &length, sizeof(length));
+            }
+
+            if (spill_->Append(scratch_.get(), prefix + frame_size))
+            {
+                OverflowCounters::Add(overflow_counters_.spilled_bytes, frame_size);
+                return true;
+            }
+
+            // Disk full or failing: account the datagram as dropped
+            OverflowCounters::Add(overflow_counters_.spill_errors, 1);
+            OverflowCounters::Add(overflow_counters_.dropped_datagrams, 1);
+            OverflowCounters::Add(overflow_counters_.dropped_bytes, frame_size);
+            if (overflow_counters_.spill_errors.load(std::memory_order_relaxed) == 1)
+            {
+                RaiseOverflowAlert("spill failed, dropping");
+            }
+            return true;
+        }
+
+        void BufferProcessor::ReplaySpill(size_t avail)
+        {
+            // Only this thread writes past the buffer end
+            char *end = buffer_->GetBufferEndPtr();
+            size_t replayed = 0;
+            if (processing_config_.datagram_slots)
+            {
+                // Slots go back one at a time, whole
+                if (spill_->Read(end, sizeof(DatagramSlot)) == sizeof(DatagramSlot))
+                {
+                    size_t slot_size = GetSlotSize(reinterpret_cast<DatagramSlot *>(end)->length);
+                    size_t payload = slot_size - sizeof(DatagramSlot);
+                    if (slot_size <= avail && spill_->Read(end + sizeof(DatagramSlot), payload) == payload)
+                    {
+                        replayed = slot_size;
+                    }
+                }
+            }
+            else
+            {
+                // So do datagrams: one cut short at the end of a chunk would never complete
+                common::u32 length = 0;
+                if (spill_->Read(reinterpret_cast<char *>(&length), sizeof(length)) == sizeof(length) &&
+                    length > 0 && length <= avail && spill_->Read(end, length) == length)
+                {
+                    replayed = length;
+                }
+            }
+
+            if (replayed == 0)
+            {
+                // Unreadable spill file: discard it rather than stall the feed
+                OverflowCounters::Add(overflow_counters_.spill_errors, 1);
+                OverflowCounters::Add(overflow_counters_.dropped_bytes, spill_->GetPendingSize());
+                RaiseOverflowAlert("spill unreadable, discarded");
+                if (!spill_->Open(processing_config_.overflow.spill_path))
+                {
+                    spill_.reset();
+                }
+                return;
+            }
+
+            OverflowCounters::Add(overflow_counters_.replayed_bytes, replayed);
+            sync_->Lock();
+            buffer_->AppendData(replayed);
+            UpdateBufferGauges();
+            sync_->Signal();
+            sync_->Unlock();
+        }
+
+        void BufferProcessor::RaiseOverflowAlert(const char *reason)
+        {
+            OverflowStats stats = overflow_counters_.Snapshot();
+            if (overflow_alert_)
+            {
+                overflow_alert_(processing_config_.overflow.policy, reason, stats);
+                return;
+            }
+
+            // Data loss must be visible in release builds too, where FMT_PRINT is compiled out
+            std::fprintf(stderr, "Buffer overflow (%s): %s, dropped %llu datagrams, spilled %llu bytes\n",
+                         OverflowPolicyName(processing_config_.overflow.policy), reason,
+                         static_cast<unsigned long long>(stats.dropped_datagrams),
+                         static_cast<unsigned long long>(stats.spilled_bytes));
+        }
+
         void *BufferProcessor::ProcessThreadFunction(void *arg)
         {
             auto *processor = static_cast<BufferProcessor *>(arg);
+            utils::Tracer::SetThreadName("process");
 
             while (processor->running_)
             {
@@ -200,38 +869,60 @@ namespace stream_buffer
 
                 while (processor->buffer_->HasPendingData() && processor->running_)
                 {
-                    // Get data to process
+                    // Take everything queued so far as one batch
                     size_t queued = processor->buffer_->GetQueuedSize();
                     char *data = processor->buffer_->GetBufferTopPtr();
+                    processor->processing_ = true;
 
                     // Unlock during processing
                     processor->sync_->Unlock();
 
-                    // Process message
-                    bool success = processor->message_processor_->ProcessMessage(data, queued);
+                    BatchResult batch;
+                    bool success = processor->message_processor_->ProcessBatch(data, queued, &batch);
 
-                    // Relock for buffer updates
+                    // Relock once per batch for the buffer update
                     processor->sync_->Lock();
+                    processor->processing_ = false;
 
-                    if (success)
-                    {
-                        size_t processed = processor->buffer_->GetQueuedSize() - queued;
-                        if (processed > 0)
-                        {
-                            processor->buffer_->RemoveProcessedData(processed);
-                            FMT_PRINT("Processed bytes: %zu, Top=%zu, End=%zu, Queued=%zu\n",
-                                      processed,
-                                      processor->buffer_->GetBufferTop(),
-                                      processor->buffer_->GetBufferEnd(),
-                                      processor->buffer_->GetQueuedSize());
-                        }
-                    }
-                    else
+                    // Wake the receive thread if it is waiting for space
+                    processor->sync_->Broadcast();
+
+                    if (!success)
                     {
                         FMT_PRINT("Processing error\n");
                         processor->running_ = false;
                         break;
                     }
+
+                    // Nothing more will be appended behind a partial packet in a
+                    // sealed segment, so it can never complete
+                    if (batch.bytes_consumed < queued && processor->buffer_->IsTopSegmentComplete() &&
+                        processor->buffer_->GetQueuedSize() == queued)
+                    {
+                        FMT_PRINT("Discarding %zu trailing bytes\n", queued - batch.bytes_consumed);
+                        batch.bytes_consumed = queued;
+                    }
+
+                    if (batch.bytes_consumed == 0)
+                    {
+                        // Only a partial packet was queued; retry at once if more
+                        // data arrived meanwhile, otherwise wait for it
+                        if (processor->buffer_->GetQueuedSize() > queued)
+                        {
+                            continue;
+                        }
+                        break;
+                    }
+
+                    processor->buffer_->RemoveProcessedData(batch.bytes_consumed);
+                    processor->UpdateBufferGauges();
+                    utils::GetMetrics().Record(utils::Histogram::BATCH_MESSAGES, batch.message_count);
+                    FMT_PRINT("Processed bytes: %zu, Messages: %zu, Top=%zu, End=%zu, Queued=%zu\n",
+                              batch.bytes_consumed,
+                              batch.message_count,
+                              processor->buffer_->GetBufferTop(),
+                              processor->buffer_->GetBufferEnd(),
+                              processor->buffer_->GetQueuedSize());
                 }
 
                 // Wait for more data if none available
@@ -0,0 +1,212 @@
+#include "core/chunked_buffer.h"
+#include "utils/debug.h"
+#include <new>
+
+namespace stream_buffer
+{
+    namespace core
+    {
+
+        ChunkedBuffer::ChunkedBuffer(size_t max_size, size_t chunk_size,
+                                     std::unique_ptr<IBufferProcessor> processor)
+            : chunk_size_(chunk_size < common::constants::MAX_DATAGRAM_SIZE
+                              ? common::constants::MAX_DATAGRAM_SIZE
+                              : chunk_size),
+              max_chunks_(max_size / chunk_size_ > 0 ? max_size / chunk_size_ : 1),
+              processor_(std::move(processor))
+        {
+            chunks_.push_back(std::unique_ptr<Chunk>(new Chunk(new char[chunk_size_])));
+            peak_allocated_ = 1;
+            FMT_PRINT("Chunked Buffer: %zu x %zu bytes\n", max_chunks_, chunk_size_);
+        }
+
+        ChunkedBuffer::~ChunkedBuffer() = default;
+
+        size_t ChunkedBuffer::GetQueuedSize() const
+        {
+            return Head().end - Head().top;
+        }
+
+        size_t ChunkedBuffer::GetTotalQueuedSize() const
+        {
+            size_t queued = 0;
+            for (size_t i = 0; i < chunks_.size(); ++i)
+            {
+                queued += chunks_[i]->end - chunks_[i]->top;
+            }
+            return queued;
+        }
+
+        size_t ChunkedBuffer::GetAvailableSize() const
+        {
+            return chunk_size_ - Tail().end;
+        }
+
+        size_t ChunkedBuffer::GetTotalCapacity() const
+        {
+            return max_chunks_ * chunk_size_;
+        }
+
+        char *ChunkedBuffer::GetBufferEndPtr() const
+        {
+            return &Tail().data[Tail().end];
+        }
+
+        char *ChunkedBuffer::GetBufferTopPtr() const
+        {
+            return &Head().data[Head().top];
+        }
+
+        size_t ChunkedBuffer::GetBufferTop() const
+        {
+            return Head().top;
+        }
+
+        size_t ChunkedBuffer::GetBufferEnd() const
+        {
+            return Tail().end;
+        }
+
+        bool ChunkedBuffer::IsEmpty() const
+        {
+            return chunks_.size() == 1 && Head().end == Head().top;
+        }
+
+        bool ChunkedBuffer::HasPendingData() const
+        {
+            return Head().end > Head().top;
+        }
+
+        void ChunkedBuffer::AppendData(size_t data_size)
+        {
+            Tail().end += data_size;
+        }
+
+        void ChunkedBuffer::RemoveProcessedData(size_t bytes_processed)
+        {
+            Head().top += bytes_processed;
+
+            // The receive thread only writes to the last chunk, so an earlier
+            // one can be recycled as soon as it has been read
+            while (chunks_.size() > 1 && Head().top == Head().end)
+            {
+                std::unique_ptr<Chunk> consumed = std::move(chunks_.front());
+                chunks_.pop_front();
+                ReleaseChunk(std::move(consumed));
+            }
+        }
+
+        size_t ChunkedBuffer::ProcessPendingData()
+        {
+            if (!processor_)
+            {
+                return 0;
+            }
+
+            return processor_->ProcessMessage(GetBufferTopPtr(), GetQueuedSize());
+        }
+
+        BatchResult ChunkedBuffer::ProcessPendingBatch(size_t length)
+        {
+            if (!processor_)
+            {
+                return BatchResult();
+            }
+
+            return processor_->ProcessBatch(GetBufferTopPtr(), length);
+        }
+
+        BatchResult ChunkedBuffer::ProcessPendingSlots(size_t length)
+        {
+            if (!processor_)
+            {
+                return BatchResult();
+            }
+
+            return processor_->ProcessSlots(GetBufferTopPtr(), length);
+        }
+
+        void ChunkedBuffer::Reset()
+        {
+            Tail().top = 0;
+            Tail().end = 0;
+        }
+
+        size_t ChunkedBuffer::Reserve(size_t min_size)
+        {
+            if (GetAvailableSize() >= min_size)
+            {
+                return GetAvailableSize();
+            }
+
+            // A drained last chunk is simply rewound
+            if (Tail().top == Tail().end)
+            {
+                Reset();
+                return GetAvailableSize();
+            }
+
+            std::unique_ptr<Chunk> chunk = AcquireChunk();
+            if (!chunk)
+            {
+                return GetAvailableSize();
+            }
+
+            // The previous chunk is sealed; the processing thread drains it first
+            chunks_.push_back(std::move(chunk));
+            return GetAvailableSize();
+        }
+
+        bool ChunkedBuffer::Grow(size_t additional_size)
+        {
+            size_t additional_chunks = (additional_size + chunk_size_ - 1) / chunk_size_;
+            max_chunks_ += additional_chunks > 0 ? additional_chunks : 1;
+            FMT_PRINT("Chunked buffer cap raised to %zu chunks\n", max_chunks_);
+            return true;
+        }
+
+        std::unique_ptr<ChunkedBuffer::Chunk> ChunkedBuffer::AcquireChunk()
+        {
+            std::unique_ptr<Chunk> chunk;
+            if (!free_chunks_.empty())
+            {
+                chunk = std::move(free_chunks_.back());
+                free_chunks_.pop_back();
+            }
+            else if (GetAllocatedCount() < max_chunks_)
+            {
+                char *data = new (std::nothrow) char[chunk_size_];
+                if (!data)
+                {
+                    FMT_PRINT("Failed to allocate a %zu byte chunk\n", chunk_size_);
+                    return chunk;
+                }
+                chunk.reset(new Chunk(data));
+
+                size_t allocated = GetAllocatedCount() + 1;
+                if (allocated > peak_allocated_)
+                {
+                    peak_allocated_ = allocated;
+                }
+            }
+            else
+            {
+                return chunk;
+            }
+
+            chunk->top = 0;
+            chunk->end = 0;
+            return chunk;
+        }
+
+        void ChunkedBuffer::ReleaseChunk(std::unique_ptr<Chunk> chunk)
+        {
+            // Keep a few chunks for the next burst, return the rest to the allocator
+            if (free_chunks_.size() < constants::MAX_SPARE_CHUNKS)
+            {
+                free_chunks_.push_back(std::move(chunk));
+            }
+        }
+
+    } // namespace core
+} // namespace stream_buffer
@@ -0,0 +1,178 @@
+#include "core/overflow.h"
+#include "utils/debug.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+namespace stream_buffer
+{
+    namespace core
+    {
+
+        OverflowStats OverflowCounters::Snapshot() const
+        {
+            OverflowStats stats;
+            stats.full_events = full_events.load(std::memory_order_relaxed);
+            stats.block_waits = block_waits.load(std::memory_order_relaxed);
+            stats.block_timeouts = block_timeouts.load(std::memory_order_relaxed);
+            stats.dropped_datagrams = dropped_datagrams.load(std::memory_order_relaxed);
+            stats.dropped_bytes = dropped_bytes.load(std::memory_order_relaxed);
+            stats.spilled_bytes = spilled_bytes.load(std::memory_order_relaxed);
+            stats.replayed_bytes = replayed_bytes.load(std::memory_order_relaxed);
+            stats.spill_errors = spill_errors.load(std::memory_order_relaxed);
+            stats.grow_count = grow_count.load(std::memory_order_relaxed);
+            stats.grown_bytes = grown_bytes.load(std::memory_order_relaxed);
+            return stats;
+        }
+
+        std::string OverflowStats::Format() const
+        {
+            const struct
+            {
+                const char *name;
+                common::u64 value;
+            } fields[] = {
+                {"full_events", full_events},
+                {"block_waits", block_waits},
+                {"block_timeouts", block_timeouts},
+                {"dropped_datagrams", dropped_datagrams},
+                {"dropped_bytes", dropped_bytes},
+                {"spilled_bytes", spilled_bytes},
+                {"replayed_bytes", replayed_bytes},
+                {"spill_errors", spill_errors},
+                {"grow_count", grow_count},
+                {"grown_bytes", grown_bytes}};
+
+            std::string text;
+            char line[96];
+            for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); ++i)
+            {
+                std::snprintf(line, sizeof(line), "counter overflow_%s %llu\n", fields[i].name,
+                              static_cast<unsigned long long>(fields[i].value));
+                text += line;
+            }
+            return text;
+        }
+
+        const char *OverflowPolicyName(common::OverflowPolicy policy)
+        {
+            switch (policy)
+            {
+            case common::OverflowPolicy::BLOCK:
+                return "block";
+            case common::OverflowPolicy::DROP_NEWEST:
+                return "drop";
+            case common::OverflowPolicy::SPILL:
+                return "spill";
+            case common::OverflowPolicy::GROW:
+                return "grow";
+            }
+            return "unknown";
+        }
+
+        SpillSegment::SpillSegment() : fd_(-1), read_offset_(0), write_offset_(0)
+        {
+        }
+
+        SpillSegment::~SpillSegment()
+        {
+            Close();
+        }
+
+        bool SpillSegment::Open(const std::string &path)
+        {
+            Close();
+
+            fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+            if (fd_ < 0)
+            {
+                FMT_PRINT("Failed to open spill file %s: %s\n", path.c_str(), strerror(errno));
+                return false;
+            }
+
+            path_ = path;
+            read_offset_ = 0;
+            write_offset_ = 0;
+            return true;
+        }
+
+        void SpillSegment::Close()
+        {
+            if (fd_ < 0)
+            {
+                return;
+            }
+
+            close(fd_);
+            unlink(path_.c_str());
+            fd_ = -1;
+            read_offset_ = 0;
+            write_offset_ = 0;
+        }
+
+        bool SpillSegment::Append(const char *data, size_t length)
+        {
+            if (fd_ < 0)
+            {
+                return false;
+            }
+
+            size_t written = 0;
+            while (written < length)
+            {
+                ssize_t result = pwrite(fd_, data + written, length - written,
+                                        static_cast<off_t>(write_offset_ + written));
+                if (result < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    FMT_PRINT("Failed to write spill file %s: %s\n", path_.c_str(), strerror(errno));
+                    return false;
+                }
+                written += static_cast<size_t>(result);
+            }
+
+            write_offset_ += length;
+            return true;
+        }
+
+        size_t SpillSegment::Read(char *data, size_t max_length)
+        {
+            size_t length = GetPendingSize() < max_length ? GetPendingSize() : max_length;
+            if (fd_ < 0 || length == 0)
+            {
+                return 0;
+            }
+
+            ssize_t result;
+            do
+            {
+                result = pread(fd_, data, length, static_cast<off_t>(read_offset_));
+            } while (result < 0 && errno == EINTR);
+
+            if (result <= 0)
+            {
+                FMT_PRINT("Failed to read spill file %s: %s\n", path_.c_str(), strerror(errno));
+                return 0;
+            }
+
+            read_offset_ += static_cast<size_t>(result);
+            if (read_offset_ == write_offset_)
+            {
+                // Fully replayed: start over so the file does not keep growing
+                read_offset_ = 0;
+                write_offset_ = 0;
+                if (ftruncate(fd_, 0) < 0)
+                {
+                    FMT_PRINT("Failed to truncate spill file %s: %s\n", path_.c_str(), strerror(errno));
+                }
+            }
+            return static_cast<size_t>(result);
+        }
+
+    } // namespace core
+} // namespace stream_buffer
@@ -1,4 +1,7 @@
 #include "core/thread_sync.h"
+#include "utils/trace.h"
+#include <cerrno>
+#include <ctime>
 #include <stdexcept>
 
 namespace stream_buffer
@@ -13,7 +16,13 @@ namespace stream_buffer
                 throw std::runtime_error("Failed to initialize mutex");
             }
 
-            if (pthread_cond_init(&condition_, nullptr) != 0)
+            // Timed waits measure against the monotonic clock, immune to clock changes
+            pthread_condattr_t attr;
+            pthread_condattr_init(&attr);
+            pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+            int result = pthread_cond_init(&condition_, &attr);
+            pthread_condattr_destroy(&attr);
+            if (result != 0)
             {
                 pthread_mutex_destroy(&mutex_);
                 throw std::runtime_error("Failed to initialize condition variable");
@@ -28,6 +37,7 @@ namespace stream_buffer
 
         void ThreadSync::Lock()
         {
+            TRACE_SCOPE(trace, utils::TraceEvent::LOCK);
             pthread_mutex_lock(&mutex_);
         }
 
@@ -41,11 +51,30 @@ namespace stream_buffer
             pthread_cond_signal(&condition_);
         }
 
+        void ThreadSync::Broadcast()
+        {
+            pthread_cond_broadcast(&condition_);
+        }
+
         void ThreadSync::Wait()
         {
             pthread_cond_wait(&condition_, &mutex_);
         }
 
+        bool ThreadSync::TimedWait(int timeout_ms)
+        {
+            struct timespec deadline;
+            clock_gettime(CLOCK_MONOTONIC, &deadline);
+            deadline.tv_sec += timeout_ms / 1000;
+            deadline.tv_nsec += static_cast<long>(timeout_ms % 1000) * 1000000L;
+            if (deadline.tv_nsec >= 1000000000L)
+            {
+                deadline.tv_sec++;
+                deadline.tv_nsec -= 1000000000L;
+            }
+            return pthread_cond_timedwait(&condition_, &mutex_, &deadline) != ETIMEDOUT;
+        }
+
         // ScopedLock implementation
         ScopedLock::ScopedLock(ThreadSync &sync) : sync_(sync)
         {
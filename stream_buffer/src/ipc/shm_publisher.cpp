@@ -0,0 +1,118 @@
+#include "ipc/shm_publisher.h"
+#include "utils/debug.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace stream_buffer
+{
+    namespace ipc
+    {
+
+        ShmPublisher::ShmPublisher()
+            : mapping_(nullptr), mapping_size_(0), header_(nullptr), slots_(nullptr), mask_(0), next_(1)
+        {
+        }
+
+        ShmPublisher::~ShmPublisher()
+        {
+            Close();
+        }
+
+        bool ShmPublisher::Open(const std::string &name, size_t capacity)
+        {
+            Close();
+
+            size_t slots = 1;
+            while (slots < capacity)
+            {
+                slots <<= 1;
+            }
+
+            // A ring left behind by a crashed writer is replaced, readers still
+            // mapping it keep their copy until they reopen
+            shm_unlink(name.c_str());
+            int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+            if (fd < 0)
+            {
+                FMT_PRINT("Failed to create shared memory %s: %s\n", name.c_str(), strerror(errno));
+                return false;
+            }
+
+            size_t size = ShmRingSize(slots);
+            if (ftruncate(fd, static_cast<off_t>(size)) < 0)
+            {
+                FMT_PRINT("Failed to size shared memory %s: %s\n", name.c_str(), strerror(errno));
+                close(fd);
+                shm_unlink(name.c_str());
+                return false;
+            }
+
+            void *mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            close(fd);
+            if (mapping == MAP_FAILED)
+            {
+                FMT_PRINT("Failed to map shared memory %s: %s\n", name.c_str(), strerror(errno));
+                shm_unlink(name.c_str());
+                return false;
+            }
+
+            // The new object is zero-filled, so every slot sequence starts at 0
+            header_ = static_cast<ShmRingHeader *>(mapping);
+            std::memcpy(header_->magic, constants::SHM_RING_MAGIC, sizeof(header_->magic));
+            header_->version = constants::SHM_RING_VERSION;
+            header_->slot_size = sizeof(ShmRingSlot);
+            header_->capacity = slots;
+            header_->writer_pid = static_cast<common::i32>(getpid());
+            header_->write_sequence.store(0, std::memory_order_relaxed);
+            header_->state.store(constants::SHM_RING_ACTIVE, std::memory_order_release);
+
+            name_ = name;
+            mapping_ = mapping;
+            mapping_size_ = size;
+            slots_ = reinterpret_cast<ShmRingSlot *>(header_ + 1);
+            mask_ = slots - 1;
+            next_ = 1;
+
+            FMT_PRINT("Publishing to shared memory %s (%zu slots)\n", name.c_str(), slots);
+            return true;
+        }
+
+        void ShmPublisher::Close()
+        {
+            if (!header_)
+            {
+                return;
+            }
+
+            header_->state.store(constants::SHM_RING_CLOSED, std::memory_order_release);
+            munmap(mapping_, mapping_size_);
+            shm_unlink(name_.c_str());
+
+            mapping_ = nullptr;
+            mapping_size_ = 0;
+            header_ = nullptr;
+            slots_ = nullptr;
+        }
+
+        void ShmPublisher::OnMessage(const processing::NormalizedMessage &message)
+        {
+            if (!header_)
+            {
+                return;
+            }
+
+            ShmRingSlot &slot = slots_[(next_ - 1) & mask_];
+            slot.sequence.store(2 * next_ - 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            std::memcpy(&slot.message, &message, sizeof(message));
+            slot.sequence.store(2 * next_, std::memory_order_release);
+            header_->write_sequence.store(next_, std::memory_order_release);
+            next_++;
+        }
+
+    } // namespace ipc
+} // namespace stream_buffer
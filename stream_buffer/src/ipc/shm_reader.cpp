@@ -0,0 +1,169 @@
+#include "ipc/shm_reader.h"
+#include "utils/debug.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace stream_buffer
+{
+    namespace ipc
+    {
+
+        ShmReader::ShmReader()
+            : mapping_(nullptr), mapping_size_(0), header_(nullptr), slots_(nullptr),
+              capacity_(0), mask_(0), next_(1), lost_(0)
+        {
+        }
+
+        ShmReader::~ShmReader()
+        {
+            Close();
+        }
+
+        bool ShmReader::Open(const std::string &name, StartPosition start)
+        {
+            Close();
+
+            int fd = shm_open(name.c_str(), O_RDONLY, 0);
+            if (fd < 0)
+            {
+                FMT_PRINT("Failed to open shared memory %s: %s\n", name.c_str(), strerror(errno));
+                return false;
+            }
+
+            struct stat shm_stat;
+            if (fstat(fd, &shm_stat) < 0 || static_cast<size_t>(shm_stat.st_size) < sizeof(ShmRingHeader))
+            {
+                FMT_PRINT("Shared memory %s is not a ring\n", name.c_str());
+                close(fd);
+                return false;
+            }
+
+            size_t size = static_cast<size_t>(shm_stat.st_size);
+            void *mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+            close(fd);
+            if (mapping == MAP_FAILED)
+            {
+                FMT_PRINT("Failed to map shared memory %s: %s\n", name.c_str(), strerror(errno));
+                return false;
+            }
+
+            const ShmRingHeader *header = static_cast<const ShmRingHeader *>(mapping);
+            common::u64 capacity = header->capacity;
+            if (header->state.load(std::memory_order_acquire) == 0 ||
+                std::memcmp(header->magic, constants::SHM_RING_MAGIC, sizeof(header->magic)) != 0 ||
+                header->version != constants::SHM_RING_VERSION ||
+                header->slot_size != sizeof(ShmRingSlot) ||
+                capacity == 0 || (capacity & (capacity - 1)) != 0 ||
+                ShmRingSize(capacity) > size)
+            {
+                FMT_PRINT("Shared memory %s has an incompatible format\n", name.c_str());
+                munmap(mapping, size);
+                return false;
+            }
+
+            mapping_ = mapping;
+            mapping_size_ = size;
+            header_ = header;
+            slots_ = reinterpret_cast<const ShmRingSlot *>(header + 1);
+            capacity_ = capacity;
+            mask_ = capacity - 1;
+            lost_ = 0;
+
+            common::u64 written = header_->write_sequence.load(std::memory_order_acquire);
+            if (start == StartPosition::LATEST)
+            {
+                next_ = written + 1;
+            }
+            else
+            {
+                next_ = written > capacity_ ? written - capacity_ + 1 : 1;
+            }
+            return true;
+        }
+
+        void ShmReader::Close()
+        {
+            if (!header_)
+            {
+                return;
+            }
+
+            munmap(mapping_, mapping_size_);
+            mapping_ = nullptr;
+            mapping_size_ = 0;
+            header_ = nullptr;
+            slots_ = nullptr;
+        }
+
+        bool ShmReader::TryRead(processing::NormalizedMessage *message)
+        {
+            if (!header_)
+            {
+                return false;
+            }
+
+            while (true)
+            {
+                const ShmRingSlot &slot = slots_[(next_ - 1) & mask_];
+                common::u64 expected = 2 * next_;
+                common::u64 before = slot.sequence.load(std::memory_order_acquire);
+                if (before < expected)
+                {
+                    return false; // Not published yet, or still being written
+                }
+
+                if (before == expected)
+                {
+                    std::memcpy(message, &slot.message, sizeof(*message));
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (slot.sequence.load(std::memory_order_relaxed) == expected)
+                    {
+                        next_++;
+                        return true;
+                    }
+                }
+
+                // The writer lapped us while we were not looking
+                SkipOverrun();
+            }
+        }
+
+        void ShmReader::SkipOverrun()
+        {
+            common::u64 written = header_->write_sequence.load(std::memory_order_acquire);
+            // Leave one slot of margin for the message being written right now
+            common::u64 oldest = written + 2 > capacity_ ? written + 2 - capacity_ : 1;
+            if (oldest > next_)
+            {
+                lost_ += oldest - next_;
+                next_ = oldest;
+            }
+            else
+            {
+                // Only the current slot was overwritten
+                lost_++;
+                next_++;
+            }
+        }
+
+        common::u64 ShmReader::GetBacklog() const
+        {
+            if (!header_)
+            {
+                return 0;
+            }
+            common::u64 written = header_->write_sequence.load(std::memory_order_acquire);
+            return written >= next_ ? written - next_ + 1 : 0;
+        }
+
+        bool ShmReader::IsWriterClosed() const
+        {
+            return !header_ || header_->state.load(std::memory_order_acquire) == constants::SHM_RING_CLOSED;
+        }
+
+    } // namespace ipc
+} // namespace stream_buffer
@@ -0,0 +1,191 @@
+#include "ipc/stats_server.h"
+#include "utils/debug.h"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace stream_buffer
+{
+    namespace ipc
+    {
+        namespace
+        {
+            bool MakeAddress(const std::string &path, sockaddr_un *address)
+            {
+                std::memset(address, 0, sizeof(*address));
+                address->sun_family = AF_UNIX;
+                if (path.empty() || path.size() >= sizeof(address->sun_path))
+                {
+                    FMT_PRINT("Invalid stats socket path: %s\n", path.c_str());
+                    return false;
+                }
+                std::memcpy(address->sun_path, path.c_str(), path.size());
+                return true;
+            }
+
+            bool WriteAll(int fd, const char *data, size_t length)
+            {
+                while (length > 0)
+                {
+                    ssize_t written = send(fd, data, length, MSG_NOSIGNAL);
+                    if (written < 0)
+                    {
+                        if (errno == EINTR)
+                        {
+                            continue;
+                        }
+                        return false;
+                    }
+                    data += written;
+                    length -= static_cast<size_t>(written);
+                }
+                return true;
+            }
+        } // anonymous namespace
+
+        StatsServer::StatsServer(const utils::MetricsRegistry &registry)
+            : registry_(registry), listen_fd_(-1)
+        {
+        }
+
+        StatsServer::~StatsServer()
+        {
+            Stop();
+        }
+
+        bool StatsServer::Start(const std::string &path)
+        {
+            Stop();
+
+            sockaddr_un address;
+            if (!MakeAddress(path, &address))
+            {
+                return false;
+            }
+
+            listen_fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (listen_fd_ < 0)
+            {
+                FMT_PRINT("Failed to create stats socket: %s\n", strerror(errno));
+                return false;
+            }
+
+            // A previous run may have left its socket behind
+            unlink(path.c_str());
+            if (bind(listen_fd_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 ||
+                listen(listen_fd_, 8) < 0)
+            {
+                FMT_PRINT("Failed to listen on stats socket %s: %s\n", path.c_str(), strerror(errno));
+                close(listen_fd_);
+                listen_fd_ = -1;
+                return false;
+            }
+
+            path_ = path;
+            running_ = true;
+            if (pthread_create(&thread_id_, nullptr, ServerThreadFunction, this) != 0)
+            {
+                FMT_PRINT("Failed to start stats server thread\n");
+                running_ = false;
+                close(listen_fd_);
+                listen_fd_ = -1;
+                unlink(path_.c_str());
+                return false;
+            }
+            return true;
+        }
+
+        void StatsServer::Stop()
+        {
+            if (!running_)
+            {
+                return;
+            }
+
+            running_ = false;
+            pthread_join(thread_id_, nullptr);
+            close(listen_fd_);
+            listen_fd_ = -1;
+            unlink(path_.c_str());
+        }
+
+        void *StatsServer::ServerThreadFunction(void *arg)
+        {
+            static_cast<StatsServer *>(arg)->Serve();
+            return nullptr;
+        }
+
+        void StatsServer::Serve()
+        {
+            while (running_)
+            {
+                pollfd listen_poll = {listen_fd_, POLLIN, 0};
+                if (poll(&listen_poll, 1, constants::STATS_POLL_INTERVAL_MS) <= 0)
+                {
+                    continue;
+                }
+
+                int client_fd = accept(listen_fd_, nullptr, nullptr);
+                if (client_fd < 0)
+                {
+                    continue;
+                }
+
+                std::string text = registry_.Snapshot().Format();
+                for (size_t i = 0; i < sections_.size(); ++i)
+                {
+                    text += sections_[i]();
+                }
+                if (WriteAll(client_fd, text.data(), text.size()))
+                {
+                    served_.fetch_add(1, std::memory_order_relaxed);
+                }
+                close(client_fd);
+            }
+        }
+
+        bool QueryStats(const std::string &path, std::string *text)
+        {
+            sockaddr_un address;
+            if (!MakeAddress(path, &address))
+            {
+                return false;
+            }
+
+            int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd < 0)
+            {
+                return false;
+            }
+            if (connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0)
+            {
+                close(fd);
+                return false;
+            }
+
+            // The server closes the connection after one snapshot
+            text->clear();
+            char chunk[4096];
+            ssize_t received;
+            while ((received = recv(fd, chunk, sizeof(chunk), 0)) != 0)
+            {
+                if (received < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    close(fd);
+                    return false;
+                }
+                text->append(chunk, static_cast<size_t>(received));
+            }
+            close(fd);
+            return true;
+        }
+
+    } // namespace ipc
+} // namespace stream_buffer
@@ -1,4 +1,5 @@
 #include "network/multicast.h"
+#include "network/socket_filter.h"
 #include "utils/debug.h"
 #include <arpa/inet.h>
 #include <net/if.h>
@@ -6,6 +7,8 @@
 #include <cstring>
 #include <iostream>
 #include <cerrno>
+#include <ctime>
+#include <sys/time.h>
 
 namespace stream_buffer
 {
@@ -74,8 +77,25 @@ namespace stream_buffer
                 return true;
             }
 
+            bool IsSocketBound(int socket_id)
+            {
+                struct sockaddr_in bound_addr = {};
+                socklen_t addr_len = sizeof(bound_addr);
+                if (getsockname(socket_id, reinterpret_cast<sockaddr *>(&bound_addr), &addr_len) < 0)
+                {
+                    return false;
+                }
+                return bound_addr.sin_port != 0;
+            }
+
             bool BindSocket(int socket_id, int port)
             {
+                // CreateSocket() already binds; binding twice fails with EINVAL
+                if (IsSocketBound(socket_id))
+                {
+                    return true;
+                }
+
                 struct sockaddr_in server_addr = {};
                 server_addr.sin_family = AF_INET;
                 server_addr.sin_port = htons(port);
@@ -159,6 +179,14 @@ namespace stream_buffer
                 }
             }
 
+            // Drop unsubscribed message types in the kernel before they are queued
+            if (!config.socket_filter_message_types.empty() &&
+                AttachMessageTypeFilter(socket_fd, config.socket_filter_message_types) < 0)
+            {
+                close(socket_fd);
+                return -1;
+            }
+
             // Bind socket to address and port
             struct sockaddr_in addr;
             std::memset(&addr, 0, sizeof(addr));
@@ -176,6 +204,30 @@ namespace stream_buffer
             return socket_fd;
         }
 
+        int EnableReceiveTimestamps(int socket_fd)
+        {
+            const int enable = 1;
+            if (setsockopt(socket_fd, SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable)) < 0)
+            {
+                FMT_PRINT("Failed to set SO_TIMESTAMPNS: %s\n", strerror(errno));
+                return -1;
+            }
+            return 0;
+        }
+
+        int SetReceiveTimeout(int socket_fd, int timeout_ms)
+        {
+            timeval timeout;
+            timeout.tv_sec = timeout_ms / 1000;
+            timeout.tv_usec = (timeout_ms % 1000) * 1000;
+            if (setsockopt(socket_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) < 0)
+            {
+                FMT_PRINT("Failed to set SO_RCVTIMEO: %s\n", strerror(errno));
+                return -1;
+            }
+            return 0;
+        }
+
         // MulticastReceiver implementation
         MulticastReceiver::MulticastReceiver(int socket_fd)
             : socket_fd_(socket_fd), addr_len_(sizeof(src_addr_))
@@ -235,6 +287,59 @@ namespace stream_buffer
             return bytes_received;
         }
 
+        int MulticastReceiver::ReceiveDatagram(char *buffer, size_t buffer_size, DatagramInfo *info)
+        {
+            *info = DatagramInfo();
+            if (!buffer || buffer_size == 0 || socket_fd_ < 0)
+            {
+                FMT_PRINT("Invalid buffer or socket descriptor\n");
+                return -1;
+            }
+
+            struct iovec iov;
+            iov.iov_base = buffer;
+            iov.iov_len = buffer_size;
+
+            // Room for the SO_TIMESTAMPNS control message
+            char control[CMSG_SPACE(sizeof(struct timespec))];
+            struct msghdr message;
+            std::memset(&message, 0, sizeof(message));
+            message.msg_name = &src_addr_;
+            message.msg_namelen = sizeof(src_addr_);
+            message.msg_iov = &iov;
+            message.msg_iovlen = 1;
+            message.msg_control = control;
+            message.msg_controllen = sizeof(control);
+
+            int bytes_received = static_cast<int>(recvmsg(socket_fd_, &message, 0));
+            if (bytes_received < 0)
+            {
+                if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+                {
+                    // Timeout or signal, not an error
+                    return 0;
+                }
+                FMT_PRINT("Failed to receive data: %s\n", strerror(errno));
+                return -1;
+            }
+            addr_len_ = message.msg_namelen;
+
+            for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&message); cmsg; cmsg = CMSG_NXTHDR(&message, cmsg))
+            {
+                if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS)
+                {
+                    struct timespec stamp;
+                    std::memcpy(&stamp, CMSG_DATA(cmsg), sizeof(stamp));
+                    info->receive_time_ns = static_cast<common::i64>(stamp.tv_sec) * 1000000000LL + stamp.tv_nsec;
+                }
+            }
+
+            info->source_ip = src_addr_.sin_addr.s_addr;
+            info->source_port = ntohs(src_addr_.sin_port);
+            info->truncated = (message.msg_flags & MSG_TRUNC) != 0;
+            return bytes_received;
+        }
+
         std::string MulticastReceiver::GetSourceIP() const
         {
             char ip_str[INET_ADDRSTRLEN];
@@ -0,0 +1,74 @@
+#include "network/socket_filter.h"
+#include "utils/debug.h"
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+
+namespace stream_buffer
+{
+    namespace network
+    {
+
+        bool BuildMessageTypeFilter(
+            const std::vector<std::pair<char, char>> &message_types,
+            std::vector<struct sock_filter> *program)
+        {
+            if (!program || message_types.empty() ||
+                message_types.size() > constants::MAX_FILTER_MESSAGE_TYPES)
+            {
+                return false;
+            }
+
+            size_t count = message_types.size();
+            program->clear();
+            program->reserve(count + 3);
+
+            // A = (transmission_code << 8) | message_kind
+            struct sock_filter load = BPF_STMT(BPF_LD | BPF_H | BPF_ABS, constants::TFE_TRANSMISSION_CODE_OFFSET);
+            program->push_back(load);
+
+            // One compare per subscribed type, jumping to the accept return on a match
+            for (size_t i = 0; i < count; ++i)
+            {
+                common::u32 key = (static_cast<common::u32>(static_cast<common::u8>(message_types[i].first)) << 8) |
+                                  static_cast<common::u8>(message_types[i].second);
+                common::u8 jump_to_accept = static_cast<common::u8>(count - i);
+                struct sock_filter compare = BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, key, jump_to_accept, 0);
+                program->push_back(compare);
+            }
+
+            struct sock_filter drop = BPF_STMT(BPF_RET | BPF_K, 0);
+            struct sock_filter accept = BPF_STMT(BPF_RET | BPF_K, 0xFFFFFFFF);
+            program->push_back(drop);
+            program->push_back(accept);
+
+            return true;
+        }
+
+        int AttachMessageTypeFilter(
+            int socket_fd,
+            const std::vector<std::pair<char, char>> &message_types)
+        {
+            std::vector<struct sock_filter> program;
+            if (!BuildMessageTypeFilter(message_types, &program))
+            {
+                FMT_PRINT("Invalid socket filter: %zu message types\n", message_types.size());
+                return -1;
+            }
+
+            struct sock_fprog filter;
+            filter.len = static_cast<unsigned short>(program.size());
+            filter.filter = program.data();
+
+            if (setsockopt(socket_fd, SOL_SOCKET, SO_ATTACH_FILTER, &filter, sizeof(filter)) < 0)
+            {
+                FMT_PRINT("Failed to set socket option SO_ATTACH_FILTER: %s\n", strerror(errno));
+                return -1;
+            }
+
+            FMT_PRINT("Attached socket filter for %zu message types\n", message_types.size());
+            return 0;
+        }
+
+    } // namespace network
+} // namespace stream_buffer
@@ -0,0 +1,193 @@
+#include "processing/conflating_sink.h"
+#include "core/backoff.h"
+#include "utils/debug.h"
+#include "utils/metrics.h"
+
+namespace stream_buffer
+{
+    namespace processing
+    {
+
+        namespace
+        {
+            constexpr size_t BITS_PER_WORD = 64;
+
+            // Index of the lowest set bit, word must be non-zero
+            inline size_t LowestBit(common::u64 word)
+            {
+                return static_cast<size_t>(__builtin_ctzll(word));
+            }
+        } // anonymous namespace
+
+        ConflatingSink::ConflatingSink(std::unique_ptr<IMessageSink> consumer, common::u32 max_symbols)
+            : symbols_(max_symbols),
+              key_count_(static_cast<size_t>(max_symbols) * constants::MESSAGE_TYPE_COUNT),
+              slots_(new core::SeqLock<NormalizedMessage>[key_count_]),
+              dirty_words_((key_count_ + BITS_PER_WORD - 1) / BITS_PER_WORD),
+              summary_words_((dirty_words_ + BITS_PER_WORD - 1) / BITS_PER_WORD),
+              consumer_(std::move(consumer)),
+              drain_thread_(),
+              running_(false),
+              started_(false),
+              update_count_(0),
+              conflated_count_(0),
+              delivered_count_(0),
+              overflow_count_(0)
+        {
+            dirty_.reset(new std::atomic<common::u64>[dirty_words_]);
+            summary_.reset(new std::atomic<common::u64>[summary_words_]);
+            for (size_t i = 0; i < dirty_words_; ++i)
+            {
+                dirty_[i].store(0, std::memory_order_relaxed);
+            }
+            for (size_t i = 0; i < summary_words_; ++i)
+            {
+                summary_[i].store(0, std::memory_order_relaxed);
+            }
+        }
+
+        ConflatingSink::~ConflatingSink()
+        {
+            Stop();
+        }
+
+        inline bool ConflatingSink::MarkDirty(size_t key)
+        {
+            size_t word = key / BITS_PER_WORD;
+            common::u64 bit = 1ULL << (key % BITS_PER_WORD);
+            common::u64 previous = dirty_[word].fetch_or(bit, std::memory_order_release);
+            if (previous & bit)
+            {
+                return false;
+            }
+
+            // Set after the key bit so a drain that clears the summary first still finds the key
+            if (previous == 0)
+            {
+                summary_[word / BITS_PER_WORD].fetch_or(1ULL << (word % BITS_PER_WORD), std::memory_order_release);
+            }
+            return true;
+        }
+
+        void ConflatingSink::OnMessage(const NormalizedMessage &message)
+        {
+            update_count_.fetch_add(1, std::memory_order_relaxed);
+
+            common::u32 symbol = symbols_.Find(message.product_id);
+            if (symbol == constants::INVALID_SYMBOL)
+            {
+                symbol = symbols_.Insert(message.product_id);
+                if (symbol == constants::INVALID_SYMBOL)
+                {
+                    overflow_count_.fetch_add(1, std::memory_order_relaxed);
+                    utils::GetMetrics().Add(utils::Counter::CONFLATION_OVERFLOWS);
+                    return;
+                }
+            }
+
+            size_t key = static_cast<size_t>(symbol) * constants::MESSAGE_TYPE_COUNT + static_cast<size_t>(message.type);
+            slots_[key].Store(message);
+            if (!MarkDirty(key))
+            {
+                conflated_count_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        size_t ConflatingSink::Drain(IMessageSink *consumer, size_t max_messages)
+        {
+            size_t delivered = 0;
+            NormalizedMessage message;
+
+            for (size_t s = 0; s < summary_words_ && delivered < max_messages; ++s)
+            {
+                common::u64 summary = summary_[s].exchange(0, std::memory_order_acquire);
+                while (summary)
+                {
+                    size_t word = s * BITS_PER_WORD + LowestBit(summary);
+                    summary &= summary - 1;
+
+                    common::u64 dirty = dirty_[word].exchange(0, std::memory_order_acquire);
+                    while (dirty && delivered < max_messages)
+                    {
+                        size_t key = word * BITS_PER_WORD + LowestBit(dirty);
+                        dirty &= dirty - 1;
+                        slots_[key].Load(&message);
+                        consumer->OnMessage(message);
+                        delivered++;
+                    }
+
+                    // Out of budget: hand back what was not delivered
+                    if (dirty)
+                    {
+                        if (dirty_[word].fetch_or(dirty, std::memory_order_release) == 0)
+                        {
+                            summary |= 1ULL << (word % BITS_PER_WORD);
+                        }
+                    }
+                    if (delivered >= max_messages && summary)
+                    {
+                        summary_[s].fetch_or(summary, std::memory_order_release);
+                        break;
+                    }
+                }
+            }
+
+            delivered_count_.fetch_add(delivered, std::memory_order_relaxed);
+            return delivered;
+        }
+
+        bool ConflatingSink::Start()
+        {
+            if (started_ || !consumer_)
+            {
+                return started_;
+            }
+
+            running_.store(true, std::memory_order_release);
+            if (pthread_create(&drain_thread_, nullptr, DrainThreadFunction, this) != 0)
+            {
+                FMT_PRINT("Failed to start conflation drain thread\n");
+                running_.store(false, std::memory_order_release);
+                return false;
+            }
+            started_ = true;
+            return true;
+        }
+
+        void ConflatingSink::Stop()
+        {
+            if (!started_)
+            {
+                return;
+            }
+
+            running_.store(false, std::memory_order_release);
+            pthread_join(drain_thread_, nullptr);
+            started_ = false;
+        }
+
+        void *ConflatingSink::DrainThreadFunction(void *arg)
+        {
+            ConflatingSink *sink = static_cast<ConflatingSink *>(arg);
+            core::Backoff backoff;
+
+            while (true)
+            {
+                bool running = sink->running_.load(std::memory_order_acquire);
+                if (sink->Drain(sink->consumer_.get()) > 0)
+                {
+                    sink->consumer_->Flush();
+                    backoff.Reset();
+                    continue;
+                }
+                if (!running)
+                {
+                    break; // Final drain found nothing left
+                }
+                backoff.Pause();
+            }
+            return nullptr;
+        }
+
+    } // namespace processing
+} // namespace stream_buffer
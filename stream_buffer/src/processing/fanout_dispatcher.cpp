@@ -0,0 +1,196 @@
+#include "processing/fanout_dispatcher.h"
+#include "core/backoff.h"
+#include "utils/debug.h"
+#include "utils/metrics.h"
+
+namespace stream_buffer
+{
+    namespace processing
+    {
+
+        struct FanOutDispatcher::Consumer
+        {
+            Consumer(std::unique_ptr<IMessageSink> consumer_sink, size_t id, FanOutDispatcher *owner)
+                : sink(std::move(consumer_sink)), id(id), owner(owner), thread() {}
+
+            std::unique_ptr<IMessageSink> sink;
+            size_t id; // Consumer id in the ring
+            FanOutDispatcher *owner;
+            pthread_t thread;
+        };
+
+        FanOutDispatcher::FanOutDispatcher(size_t capacity)
+            : ring_(capacity), running_(false), peak_lag_(0), started_(false)
+        {
+        }
+
+        FanOutDispatcher::~FanOutDispatcher()
+        {
+            Stop();
+        }
+
+        size_t FanOutDispatcher::AddConsumer(std::unique_ptr<IMessageSink> sink, const std::vector<size_t> &dependencies)
+        {
+            size_t id = ring_.AddConsumer(dependencies);
+            consumers_.emplace_back(new Consumer(std::move(sink), id, this));
+            return id;
+        }
+
+        bool FanOutDispatcher::Start()
+        {
+            if (started_)
+            {
+                return true;
+            }
+
+            running_.store(true, std::memory_order_release);
+            for (size_t i = 0; i < consumers_.size(); ++i)
+            {
+                if (pthread_create(&consumers_[i]->thread, nullptr, ConsumerThreadFunction, consumers_[i].get()) != 0)
+                {
+                    FMT_PRINT("Failed to start fan-out consumer %zu\n", i);
+                    running_.store(false, std::memory_order_release);
+                    for (size_t j = 0; j < i; ++j)
+                    {
+                        pthread_join(consumers_[j]->thread, nullptr);
+                    }
+                    return false;
+                }
+            }
+
+            started_ = true;
+            return true;
+        }
+
+        void FanOutDispatcher::Stop()
+        {
+            if (!started_)
+            {
+                return;
+            }
+
+            // Consumers catch up with the cursor before exiting
+            running_.store(false, std::memory_order_release);
+            for (size_t i = 0; i < consumers_.size(); ++i)
+            {
+                pthread_join(consumers_[i]->thread, nullptr);
+            }
+            started_ = false;
+        }
+
+        void FanOutDispatcher::OnMessage(const NormalizedMessage &message)
+        {
+            if (consumers_.empty())
+            {
+                return;
+            }
+
+            common::i64 sequence = ring_.Next();
+            ring_.Get(sequence) = message;
+            ring_.Publish(sequence);
+
+            if (!started_)
+            {
+                // Inline mode: every consumer handles the slot right away
+                for (size_t i = 0; i < consumers_.size(); ++i)
+                {
+                    consumers_[i]->sink->OnMessage(ring_.Get(sequence));
+                    ring_.Release(consumers_[i]->id, sequence);
+                }
+                return;
+            }
+
+            // Sampled: reading every consumer's sequence costs a cache miss each
+            if ((static_cast<size_t>(sequence) & (constants::FANOUT_LAG_SAMPLE_INTERVAL - 1)) != 0)
+            {
+                return;
+            }
+
+            common::i64 lag = ring_.GetMaxLag();
+            utils::GetMetrics().Set(utils::Gauge::FANOUT_LAG, lag);
+            if (lag > peak_lag_.load(std::memory_order_relaxed))
+            {
+                peak_lag_.store(lag, std::memory_order_relaxed);
+            }
+        }
+
+        void FanOutDispatcher::Flush()
+        {
+            if (started_)
+            {
+                return;
+            }
+
+            for (size_t i = 0; i < consumers_.size(); ++i)
+            {
+                consumers_[i]->sink->Flush();
+            }
+        }
+
+        void FanOutDispatcher::Drain()
+        {
+            if (!started_)
+            {
+                Flush();
+                return;
+            }
+
+            core::Backoff backoff;
+            while (ring_.GetMaxLag() > 0)
+            {
+                backoff.Pause();
+            }
+        }
+
+        void *FanOutDispatcher::ConsumerThreadFunction(void *arg)
+        {
+            Consumer *consumer = static_cast<Consumer *>(arg);
+            consumer->owner->RunConsumer(*consumer);
+            return nullptr;
+        }
+
+        void FanOutDispatcher::RunConsumer(Consumer &consumer)
+        {
+            common::i64 next = ring_.GetConsumerSequence(consumer.id) + 1;
+            core::Backoff backoff;
+            bool pending_flush = false;
+
+            while (true)
+            {
+                common::i64 available = ring_.GetAvailable(consumer.id);
+                if (available >= next)
+                {
+                    // Handle the whole run in place, then release it at once
+                    for (common::i64 sequence = next; sequence <= available; ++sequence)
+                    {
+                        consumer.sink->OnMessage(ring_.Get(sequence));
+                    }
+                    ring_.Release(consumer.id, available);
+                    next = available + 1;
+                    pending_flush = true;
+                    backoff.Reset();
+                    continue;
+                }
+
+                if (pending_flush)
+                {
+                    consumer.sink->Flush();
+                    pending_flush = false;
+                }
+
+                // The producer has stopped: exit once caught up with the cursor
+                if (!running_.load(std::memory_order_acquire))
+                {
+                    if (next > ring_.GetCursor())
+                    {
+                        break;
+                    }
+                    continue;
+                }
+
+                backoff.Pause();
+            }
+        }
+
+    } // namespace processing
+} // namespace stream_buffer
@@ -0,0 +1,179 @@
+#include "processing/latency_tracker.h"
+#include <cstdio>
+
+namespace stream_buffer
+{
+    namespace processing
+    {
+        namespace
+        {
+            const char *const KIND_NAMES[LATENCY_KIND_COUNT] = {
+                "i010",
+                "trade",
+                "quote",
+                "other"};
+
+            double ToMicroseconds(common::i64 ns)
+            {
+                return static_cast<double>(ns) / 1000.0;
+            }
+
+            void AppendLine(std::string *text, const char *line_name, const char *kind_name,
+                            const LatencySnapshot &snapshot)
+            {
+                char line[320];
+                std::snprintf(line, sizeof(line),
+                              "latency %s %s count=%llu p50_us=%.1f p99_us=%.1f p999_us=%.1f min_us=%.1f max_us=%.1f "
+                              "negative=%llu invalid=%llu\n",
+                              line_name, kind_name,
+                              static_cast<unsigned long long>(snapshot.count),
+                              ToMicroseconds(snapshot.GetPercentile(0.50)),
+                              ToMicroseconds(snapshot.GetPercentile(0.99)),
+                              ToMicroseconds(snapshot.GetPercentile(0.999)),
+                              ToMicroseconds(snapshot.min_ns),
+                              ToMicroseconds(snapshot.max_ns),
+                              static_cast<unsigned long long>(snapshot.negative),
+                              static_cast<unsigned long long>(snapshot.invalid));
+                *text += line;
+            }
+        } // anonymous namespace
+
+        const char *GetLatencyKindName(LatencyKind kind)
+        {
+            return KIND_NAMES[static_cast<size_t>(kind)];
+        }
+
+        common::i64 LatencySnapshot::GetPercentile(double quantile) const
+        {
+            if (count == 0)
+            {
+                return 0;
+            }
+
+            // Negative latencies rank below every bucket
+            common::u64 rank = static_cast<common::u64>(quantile * static_cast<double>(count));
+            common::u64 seen = negative;
+            if (seen > rank)
+            {
+                return min_ns;
+            }
+            for (size_t i = 0; i < constants::LATENCY_BUCKETS; ++i)
+            {
+                seen += buckets[i];
+                if (seen > rank || seen == count)
+                {
+                    common::i64 bound = static_cast<common::i64>(LatencyTracker::GetBucketUpperBound(i));
+                    return bound < max_ns ? bound : max_ns;
+                }
+            }
+            return max_ns;
+        }
+
+        void LatencySnapshot::Merge(const LatencySnapshot &other)
+        {
+            if (other.count > 0)
+            {
+                min_ns = (count == 0 || other.min_ns < min_ns) ? other.min_ns : min_ns;
+                max_ns = (count == 0 || other.max_ns > max_ns) ? other.max_ns : max_ns;
+            }
+            count += other.count;
+            sum_ns += other.sum_ns;
+            negative += other.negative;
+            invalid += other.invalid;
+            for (size_t i = 0; i < constants::LATENCY_BUCKETS; ++i)
+            {
+                buckets[i] += other.buckets[i];
+            }
+        }
+
+        LatencyTracker::LatencyTracker(int utc_offset_minutes)
+            : utc_offset_ns_(static_cast<common::i64>(utc_offset_minutes) * 60 * 1000000000LL),
+              cells_(new Cell[constants::LATENCY_LINES * LATENCY_KIND_COUNT])
+        {
+            for (size_t c = 0; c < constants::LATENCY_LINES * LATENCY_KIND_COUNT; ++c)
+            {
+                Cell &cell = cells_[c];
+                cell.count.store(0, std::memory_order_relaxed);
+                cell.sum_ns.store(0, std::memory_order_relaxed);
+                cell.min_ns.store(0, std::memory_order_relaxed);
+                cell.max_ns.store(0, std::memory_order_relaxed);
+                cell.negative.store(0, std::memory_order_relaxed);
+                cell.invalid.store(0, std::memory_order_relaxed);
+                for (size_t i = 0; i < constants::LATENCY_BUCKETS; ++i)
+                {
+                    cell.buckets[i].store(0, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        common::u64 LatencyTracker::GetBucketUpperBound(size_t bucket)
+        {
+            if (bucket < 2 * constants::LATENCY_SUB_BUCKETS)
+            {
+                return bucket;
+            }
+            // Bucket = shift * SUB_BUCKETS + mantissa, with the mantissa in [SUB_BUCKETS, 2 * SUB_BUCKETS)
+            size_t shift = (bucket >> constants::LATENCY_SUB_BUCKET_BITS) - 1;
+            common::u64 mantissa = bucket - (shift << constants::LATENCY_SUB_BUCKET_BITS);
+            return ((mantissa + 1) << shift) - 1;
+        }
+
+        void LatencyTracker::Read(const Cell &cell, LatencySnapshot *snapshot)
+        {
+            snapshot->count = cell.count.load(std::memory_order_relaxed);
+            snapshot->sum_ns = cell.sum_ns.load(std::memory_order_relaxed);
+            snapshot->min_ns = cell.min_ns.load(std::memory_order_relaxed);
+            snapshot->max_ns = cell.max_ns.load(std::memory_order_relaxed);
+            snapshot->negative = cell.negative.load(std::memory_order_relaxed);
+            snapshot->invalid = cell.invalid.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < constants::LATENCY_BUCKETS; ++i)
+            {
+                snapshot->buckets[i] = cell.buckets[i].load(std::memory_order_relaxed);
+            }
+        }
+
+        LatencySnapshot LatencyTracker::Snapshot(char transmission_code, LatencyKind kind) const
+        {
+            LatencySnapshot snapshot;
+            Read(GetCell(transmission_code, kind), &snapshot);
+            return snapshot;
+        }
+
+        LatencySnapshot LatencyTracker::SnapshotAll() const
+        {
+            LatencySnapshot total;
+            for (size_t c = 0; c < constants::LATENCY_LINES * LATENCY_KIND_COUNT; ++c)
+            {
+                LatencySnapshot snapshot;
+                Read(cells_[c], &snapshot);
+                total.Merge(snapshot);
+            }
+            return total;
+        }
+
+        std::string LatencyTracker::Format() const
+        {
+            std::string text;
+            LatencySnapshot total;
+            for (size_t line = 0; line < constants::LATENCY_LINES; ++line)
+            {
+                char line_name[8];
+                std::snprintf(line_name, sizeof(line_name), "line%zu", line);
+                for (size_t k = 0; k < LATENCY_KIND_COUNT; ++k)
+                {
+                    LatencySnapshot snapshot;
+                    Read(cells_[line * LATENCY_KIND_COUNT + k], &snapshot);
+                    if (snapshot.count == 0 && snapshot.invalid == 0)
+                    {
+                        continue;
+                    }
+                    AppendLine(&text, line_name, KIND_NAMES[k], snapshot);
+                    total.Merge(snapshot);
+                }
+            }
+            AppendLine(&text, "all", "all", total);
+            return text;
+        }
+
+    } // namespace processing
+} // namespace stream_buffer
@@ -0,0 +1,104 @@
+#include "processing/message_filter.h"
+#include "utils/debug.h"
+#include <cstring>
+#include <sstream>
+
+namespace stream_buffer
+{
+    namespace processing
+    {
+        namespace
+        {
+            // Message types whose body starts with the product id
+            const char PRODUCT_KEYED_TYPES[][2] = {
+                {'1', '1'}, // I010 futures product definition
+                {'4', '1'}, // I010 options product definition
+                {'2', '1'}, // I020 futures match
+                {'2', '2'}, // I080 futures best quotes
+                {'5', '1'}, // I020 options match
+                {'5', '2'}, // I080 options best quotes
+            };
+
+            // Split a comma separated list, dropping blanks around items and empty items
+            std::vector<std::string> SplitList(const std::string &text)
+            {
+                std::vector<std::string> items;
+                std::stringstream stream(text);
+                std::string item;
+                while (std::getline(stream, item, ','))
+                {
+                    size_t first = item.find_first_not_of(" \t");
+                    size_t last = item.find_last_not_of(" \t");
+                    if (first != std::string::npos)
+                    {
+                        items.push_back(item.substr(first, last - first + 1));
+                    }
+                }
+                return items;
+            }
+        } // anonymous namespace
+
+        MessageFilter::MessageFilter(const common::SubscriptionConfig &config)
+            : enabled_(config.IsEnabled()),
+              filter_products_(!config.products.empty()),
+              skipped_(0)
+        {
+            // With no message types configured every type passes the type check
+            std::memset(type_bits_, config.message_types.empty() ? 0xFF : 0x00, sizeof(type_bits_));
+            std::memset(product_keyed_bits_, 0, sizeof(product_keyed_bits_));
+            std::memset(product_bits_, 0, sizeof(product_bits_));
+
+            for (size_t i = 0; i < config.message_types.size(); ++i)
+            {
+                SetBit(type_bits_, MessageTypeKey(config.message_types[i].first, config.message_types[i].second));
+                FMT_PRINT("Subscribed message type: Trans=%c Kind=%c\n",
+                          config.message_types[i].first, config.message_types[i].second);
+            }
+
+            for (size_t i = 0; i < sizeof(PRODUCT_KEYED_TYPES) / sizeof(PRODUCT_KEYED_TYPES[0]); ++i)
+            {
+                SetBit(product_keyed_bits_, MessageTypeKey(PRODUCT_KEYED_TYPES[i][0], PRODUCT_KEYED_TYPES[i][1]));
+            }
+
+            for (size_t i = 0; i < config.products.size(); ++i)
+            {
+                // Product ids are space padded to their fixed width on the wire
+                char product_id[constants::PRODUCT_ID_SIZE];
+                std::memset(product_id, ' ', sizeof(product_id));
+                std::memcpy(product_id, config.products[i].data(),
+                            config.products[i].size() < sizeof(product_id) ? config.products[i].size() : sizeof(product_id));
+                SetBit(product_bits_, ProductKey(product_id));
+                FMT_PRINT("Subscribed product: %.10s\n", product_id);
+            }
+        }
+
+        bool ParseMessageTypes(const std::string &text, std::vector<std::pair<char, char>> *message_types)
+        {
+            std::vector<std::string> items = SplitList(text);
+            for (size_t i = 0; i < items.size(); ++i)
+            {
+                if (items[i].size() != 3 || items[i][1] != ':')
+                {
+                    return false;
+                }
+                message_types->push_back(std::make_pair(items[i][0], items[i][2]));
+            }
+            return true;
+        }
+
+        bool ParseProductList(const std::string &text, std::vector<std::string> *products)
+        {
+            std::vector<std::string> items = SplitList(text);
+            for (size_t i = 0; i < items.size(); ++i)
+            {
+                if (items[i].size() > constants::PRODUCT_ID_SIZE)
+                {
+                    return false;
+                }
+                products->push_back(items[i]);
+            }
+            return true;
+        }
+
+    } // namespace processing
+} // namespace stream_buffer
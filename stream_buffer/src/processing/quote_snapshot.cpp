@@ -0,0 +1,290 @@
+#include "processing/quote_snapshot.h"
+#include "utils/debug.h"
+#include "utils/metrics.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace stream_buffer
+{
+    namespace processing
+    {
+
+        namespace
+        {
+            constexpr char SNAPSHOT_TABLE_MAGIC[8] = {'S', 'B', 'Q', 'U', 'O', 'T', 'E', 'S'};
+            constexpr common::u32 SNAPSHOT_TABLE_VERSION = 1;
+
+            size_t TableSize(common::u32 max_symbols)
+            {
+                return sizeof(QuoteSnapshotHeader) + static_cast<size_t>(max_symbols) * sizeof(QuoteSnapshotSlot);
+            }
+
+            // Map a zero-filled table, backed by a file when a path is given
+            void *MapTable(const std::string &path, size_t size)
+            {
+                if (path.empty())
+                {
+                    void *mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                    return mapping == MAP_FAILED ? nullptr : mapping;
+                }
+
+                int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+                if (fd < 0)
+                {
+                    FMT_PRINT("Failed to open snapshot table %s: %s\n", path.c_str(), strerror(errno));
+                    return nullptr;
+                }
+                if (ftruncate(fd, static_cast<off_t>(size)) < 0)
+                {
+                    FMT_PRINT("Failed to size snapshot table %s: %s\n", path.c_str(), strerror(errno));
+                    close(fd);
+                    return nullptr;
+                }
+
+                void *mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                close(fd);
+                if (mapping == MAP_FAILED)
+                {
+                    FMT_PRINT("Failed to map snapshot table %s: %s\n", path.c_str(), strerror(errno));
+                    return nullptr;
+                }
+                return mapping;
+            }
+        } // anonymous namespace
+
+        QuoteSnapshotTable::QuoteSnapshotTable(common::u32 max_symbols, const std::string &path)
+            : symbols_(max_symbols), path_(path), mapping_(nullptr), mapping_size_(TableSize(max_symbols)),
+              header_(nullptr), slots_(nullptr), overflow_count_(0)
+        {
+            mapping_ = MapTable(path_, mapping_size_);
+            if (!mapping_ && !path_.empty())
+            {
+                // Keep serving in-process readers
+                FMT_PRINT("Snapshot table falls back to private memory\n");
+                path_.clear();
+                mapping_ = MapTable(path_, mapping_size_);
+            }
+            if (!mapping_)
+            {
+                FMT_PRINT("Failed to allocate snapshot table\n");
+                mapping_size_ = 0;
+                return;
+            }
+
+            header_ = static_cast<QuoteSnapshotHeader *>(mapping_);
+            std::memcpy(header_->magic, SNAPSHOT_TABLE_MAGIC, sizeof(header_->magic));
+            header_->version = SNAPSHOT_TABLE_VERSION;
+            header_->slot_size = sizeof(QuoteSnapshotSlot);
+            header_->max_symbols = max_symbols;
+            header_->symbol_count.store(0, std::memory_order_release);
+            slots_ = reinterpret_cast<QuoteSnapshotSlot *>(header_ + 1);
+        }
+
+        QuoteSnapshotTable::~QuoteSnapshotTable()
+        {
+            if (mapping_)
+            {
+                munmap(mapping_, mapping_size_);
+            }
+        }
+
+        void QuoteSnapshotTable::OnMessage(const NormalizedMessage &message)
+        {
+            if (!slots_)
+            {
+                return;
+            }
+
+            common::u32 slot = symbols_.Find(message.product_id);
+            if (slot == constants::INVALID_SYMBOL)
+            {
+                slot = symbols_.Insert(message.product_id);
+                if (slot == constants::INVALID_SYMBOL)
+                {
+                    overflow_count_.fetch_add(1, std::memory_order_relaxed);
+                    utils::GetMetrics().Add(utils::Counter::QUOTE_SNAPSHOT_OVERFLOWS);
+                    return;
+                }
+
+                // Slots are handed out in order, so the count covers every used slot
+                QuoteSnapshot initial;
+                std::memset(&initial, 0, sizeof(initial));
+                std::memcpy(initial.product_id, message.product_id, sizeof(initial.product_id));
+                slots_[slot].snapshot.Store(initial);
+                header_->symbol_count.store(slot + 1, std::memory_order_release);
+            }
+
+            // Single writer: update a private copy and publish it in one store
+            QuoteSnapshot snapshot = slots_[slot].snapshot.Peek();
+            snapshot.price_scale = message.price_scale;
+            snapshot.update_count++;
+            switch (message.type)
+            {
+            case MessageType::PRODUCT_INFO:
+                snapshot.reference_price = message.price;
+                snapshot.flags |= constants::SNAPSHOT_HAS_REFERENCE;
+                break;
+            case MessageType::TRADE:
+                // A sweep arrives one match at a time in order, so this ends on its last match
+                snapshot.last_price = message.price;
+                snapshot.last_quantity = message.quantity;
+                snapshot.trade_time = message.information_time;
+                snapshot.flags |= constants::SNAPSHOT_HAS_TRADE;
+                break;
+            case MessageType::QUOTE:
+                snapshot.bid_price = message.bid_price;
+                snapshot.bid_quantity = message.bid_quantity;
+                snapshot.ask_price = message.ask_price;
+                snapshot.ask_quantity = message.ask_quantity;
+                snapshot.quote_time = message.information_time;
+                snapshot.flags |= constants::SNAPSHOT_HAS_QUOTE;
+                break;
+            }
+            slots_[slot].snapshot.Store(snapshot);
+        }
+
+        bool QuoteSnapshotTable::Restore(const QuoteSnapshot &snapshot)
+        {
+            if (!slots_)
+            {
+                return false;
+            }
+
+            common::u32 slot = symbols_.Insert(snapshot.product_id);
+            if (slot == constants::INVALID_SYMBOL)
+            {
+                overflow_count_.fetch_add(1, std::memory_order_relaxed);
+                utils::GetMetrics().Add(utils::Counter::QUOTE_SNAPSHOT_OVERFLOWS);
+                return false;
+            }
+            slots_[slot].snapshot.Store(snapshot);
+            if (slot + 1 > header_->symbol_count.load(std::memory_order_relaxed))
+            {
+                header_->symbol_count.store(slot + 1, std::memory_order_release);
+            }
+            return true;
+        }
+
+        bool QuoteSnapshotTable::Read(common::u32 slot, QuoteSnapshot *snapshot) const
+        {
+            if (!slots_ || slot >= header_->symbol_count.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+            slots_[slot].snapshot.Load(snapshot);
+            return true;
+        }
+
+        QuoteSnapshotReader::QuoteSnapshotReader()
+            : mapping_(nullptr), mapping_size_(0), header_(nullptr), slots_(nullptr), scanned_(0)
+        {
+        }
+
+        QuoteSnapshotReader::~QuoteSnapshotReader()
+        {
+            Close();
+        }
+
+        bool QuoteSnapshotReader::Open(const std::string &path)
+        {
+            Close();
+
+            int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                FMT_PRINT("Failed to open snapshot table %s: %s\n", path.c_str(), strerror(errno));
+                return false;
+            }
+
+            struct stat file_stat;
+            if (fstat(fd, &file_stat) < 0 || static_cast<size_t>(file_stat.st_size) < sizeof(QuoteSnapshotHeader))
+            {
+                FMT_PRINT("Snapshot table %s is truncated\n", path.c_str());
+                close(fd);
+                return false;
+            }
+
+            size_t size = static_cast<size_t>(file_stat.st_size);
+            void *mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+            close(fd);
+            if (mapping == MAP_FAILED)
+            {
+                FMT_PRINT("Failed to map snapshot table %s: %s\n", path.c_str(), strerror(errno));
+                return false;
+            }
+
+            const QuoteSnapshotHeader *header = static_cast<const QuoteSnapshotHeader *>(mapping);
+            if (std::memcmp(header->magic, SNAPSHOT_TABLE_MAGIC, sizeof(header->magic)) != 0 ||
+                header->version != SNAPSHOT_TABLE_VERSION ||
+                header->slot_size != sizeof(QuoteSnapshotSlot) ||
+                TableSize(header->max_symbols) > size)
+            {
+                FMT_PRINT("Snapshot table %s has an incompatible format\n", path.c_str());
+                munmap(mapping, size);
+                return false;
+            }
+
+            mapping_ = mapping;
+            mapping_size_ = size;
+            header_ = header;
+            slots_ = reinterpret_cast<const QuoteSnapshotSlot *>(header + 1);
+            return true;
+        }
+
+        void QuoteSnapshotReader::Close()
+        {
+            if (mapping_)
+            {
+                munmap(mapping_, mapping_size_);
+            }
+            mapping_ = nullptr;
+            mapping_size_ = 0;
+            header_ = nullptr;
+            slots_ = nullptr;
+            scanned_ = 0;
+            index_.clear();
+        }
+
+        common::u32 QuoteSnapshotReader::GetSize() const
+        {
+            return header_ ? header_->symbol_count.load(std::memory_order_acquire) : 0;
+        }
+
+        common::u32 QuoteSnapshotReader::Find(const char *product_id)
+        {
+            std::string key(product_id, constants::PRODUCT_ID_SIZE);
+            std::unordered_map<std::string, common::u32>::const_iterator it = index_.find(key);
+            if (it != index_.end())
+            {
+                return it->second;
+            }
+
+            // Product ids never change once a slot is in use
+            common::u32 count = GetSize();
+            QuoteSnapshot snapshot;
+            for (; scanned_ < count; ++scanned_)
+            {
+                slots_[scanned_].snapshot.Load(&snapshot);
+                index_[std::string(snapshot.product_id, constants::PRODUCT_ID_SIZE)] = scanned_;
+            }
+
+            it = index_.find(key);
+            return it != index_.end() ? it->second : constants::INVALID_SYMBOL;
+        }
+
+        bool QuoteSnapshotReader::Read(common::u32 slot, QuoteSnapshot *snapshot) const
+        {
+            if (!header_ || slot >= GetSize())
+            {
+                return false;
+            }
+            slots_[slot].snapshot.Load(snapshot);
+            return true;
+        }
+
+    } // namespace processing
+} // namespace stream_buffer
@@ -0,0 +1,245 @@
+#include "processing/reference_data.h"
+#include "utils/debug.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace stream_buffer
+{
+    namespace processing
+    {
+        namespace
+        {
+            constexpr char SNAPSHOT_MAGIC[8] = {'S', 'B', 'R', 'E', 'F', 'D', 'A', 'T'};
+            constexpr common::u32 SNAPSHOT_VERSION = 1;
+
+            // On-disk snapshot header, followed by record_count records
+            struct SnapshotHeader
+            {
+                char magic[8];
+                common::u32 version;
+                common::u32 record_size;
+                common::u32 record_count;
+                common::u32 reserved;
+            };
+
+            common::u32 DecodeDate(const uint8_t *data, size_t length)
+            {
+                long long date = utils::decode_bcd(data, length);
+                return date < 0 ? 0 : static_cast<common::u32>(date);
+            }
+        } // anonymous namespace
+
+        ReferenceDataStore::ReferenceDataStore(common::u32 max_products)
+            : symbols_(max_products),
+              records_(new core::SeqLock<ReferenceRecord>[max_products]),
+              decimal_locators_(new std::atomic<common::u8>[max_products])
+        {
+            for (common::u32 i = 0; i < max_products; ++i)
+            {
+                decimal_locators_[i].store(0, std::memory_order_relaxed);
+            }
+        }
+
+        common::u32 ReferenceDataStore::Update(char transmission_code, const tfe::BodyI010 &body)
+        {
+            ReferenceRecord record;
+            std::memset(&record, 0, sizeof(record));
+            std::memcpy(record.product_id, body.prod_id_s, constants::PRODUCT_ID_SIZE);
+            record.transmission_code = transmission_code;
+            record.prod_kind = body.prod_kind;
+            record.dynamic_banding = body.dynamic_banding;
+            record.decimal_locator = body.GetDecimalLocator();
+            record.strike_price_decimal_locator = body.GetStrikePriceDecimalLocator();
+
+            long long flow_group = utils::decode_bcd(&body.flow_group, sizeof(body.flow_group));
+            record.flow_group = flow_group < 0 ? 0 : static_cast<common::u8>(flow_group);
+
+            common::Price reference_price;
+            if (!body.GetReferencePrice(&reference_price))
+            {
+                FMT_PRINT("Invalid reference price for product %.10s\n", body.prod_id_s);
+                return constants::INVALID_SYMBOL;
+            }
+            record.reference_price = reference_price.GetMantissa();
+            record.begin_date = DecodeDate(body.begin_date, sizeof(body.begin_date));
+            record.end_date = DecodeDate(body.end_date, sizeof(body.end_date));
+            record.delivery_date = DecodeDate(body.delivery_date, sizeof(body.delivery_date));
+
+            return Update(record);
+        }
+
+        common::u32 ReferenceDataStore::Update(const ReferenceRecord &record)
+        {
+            return Write(record, true);
+        }
+
+        common::u32 ReferenceDataStore::Restore(const ReferenceRecord &record)
+        {
+            return Write(record, false);
+        }
+
+        common::u32 ReferenceDataStore::Write(const ReferenceRecord &record, bool count_update)
+        {
+            ReferenceRecord updated = record;
+            common::u32 symbol = symbols_.Find(record.product_id);
+            if (symbol != constants::INVALID_SYMBOL)
+            {
+                if (count_update)
+                {
+                    // The writer owns the slot, so this read never retries
+                    ReferenceRecord previous;
+                    records_[symbol].Load(&previous);
+                    updated.update_count = previous.update_count + 1;
+                }
+                decimal_locators_[symbol].store(updated.decimal_locator, std::memory_order_relaxed);
+                records_[symbol].Store(updated);
+                return symbol;
+            }
+
+            // Symbols are handed out in order: fill the next slot before the
+            // index publishes it, so a reader never sees an empty record
+            symbol = symbols_.GetSize();
+            if (symbol >= symbols_.GetCapacity())
+            {
+                FMT_PRINT("Reference data store full, dropping product %.10s\n", record.product_id);
+                return constants::INVALID_SYMBOL;
+            }
+            if (count_update)
+            {
+                updated.update_count = 1;
+            }
+            decimal_locators_[symbol].store(updated.decimal_locator, std::memory_order_relaxed);
+            records_[symbol].Store(updated);
+            symbols_.Insert(record.product_id);
+
+            return symbol;
+        }
+
+        bool ReferenceDataStore::Lookup(const char *product_id, ReferenceRecord *record) const
+        {
+            return GetRecord(symbols_.Find(product_id), record);
+        }
+
+        bool ReferenceDataStore::GetRecord(common::u32 symbol, ReferenceRecord *record) const
+        {
+            if (!record || symbol >= symbols_.GetSize())
+            {
+                return false;
+            }
+            records_[symbol].Load(record);
+            return true;
+        }
+
+        bool ReferenceDataStore::SaveSnapshot(const std::string &path) const
+        {
+            common::u32 count = symbols_.GetSize();
+            size_t file_size = sizeof(SnapshotHeader) + static_cast<size_t>(count) * sizeof(ReferenceRecord);
+            std::string temp_path = path + ".tmp";
+
+            int fd = open(temp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0)
+            {
+                FMT_PRINT("Failed to open snapshot %s: %s\n", temp_path.c_str(), strerror(errno));
+                return false;
+            }
+
+            if (ftruncate(fd, static_cast<off_t>(file_size)) < 0)
+            {
+                FMT_PRINT("Failed to size snapshot %s: %s\n", temp_path.c_str(), strerror(errno));
+                close(fd);
+                return false;
+            }
+
+            void *mapping = mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            close(fd);
+            if (mapping == MAP_FAILED)
+            {
+                FMT_PRINT("Failed to map snapshot %s: %s\n", temp_path.c_str(), strerror(errno));
+                return false;
+            }
+
+            SnapshotHeader *header = static_cast<SnapshotHeader *>(mapping);
+            std::memcpy(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic));
+            header->version = SNAPSHOT_VERSION;
+            header->record_size = sizeof(ReferenceRecord);
+            header->record_count = count;
+            header->reserved = 0;
+
+            ReferenceRecord *records = reinterpret_cast<ReferenceRecord *>(header + 1);
+            for (common::u32 i = 0; i < count; ++i)
+            {
+                records_[i].Load(&records[i]);
+            }
+
+            bool synced = msync(mapping, file_size, MS_SYNC) == 0;
+            munmap(mapping, file_size);
+
+            if (!synced || std::rename(temp_path.c_str(), path.c_str()) != 0)
+            {
+                FMT_PRINT("Failed to write snapshot %s: %s\n", path.c_str(), strerror(errno));
+                return false;
+            }
+
+            FMT_PRINT("Saved %u reference records to %s\n", count, path.c_str());
+            return true;
+        }
+
+        int ReferenceDataStore::LoadSnapshot(const std::string &path)
+        {
+            int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                FMT_PRINT("No reference snapshot at %s: %s\n", path.c_str(), strerror(errno));
+                return -1;
+            }
+
+            struct stat file_stat;
+            if (fstat(fd, &file_stat) < 0 || static_cast<size_t>(file_stat.st_size) < sizeof(SnapshotHeader))
+            {
+                FMT_PRINT("Reference snapshot %s is truncated\n", path.c_str());
+                close(fd);
+                return -1;
+            }
+
+            size_t file_size = static_cast<size_t>(file_stat.st_size);
+            void *mapping = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            close(fd);
+            if (mapping == MAP_FAILED)
+            {
+                FMT_PRINT("Failed to map snapshot %s: %s\n", path.c_str(), strerror(errno));
+                return -1;
+            }
+
+            const SnapshotHeader *header = static_cast<const SnapshotHeader *>(mapping);
+            if (std::memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0 ||
+                header->version != SNAPSHOT_VERSION ||
+                header->record_size != sizeof(ReferenceRecord) ||
+                sizeof(SnapshotHeader) + static_cast<size_t>(header->record_count) * sizeof(ReferenceRecord) > file_size)
+            {
+                FMT_PRINT("Reference snapshot %s has an incompatible format\n", path.c_str());
+                munmap(mapping, file_size);
+                return -1;
+            }
+
+            const ReferenceRecord *records = reinterpret_cast<const ReferenceRecord *>(header + 1);
+            int loaded = 0;
+            for (common::u32 i = 0; i < header->record_count; ++i)
+            {
+                if (Restore(records[i]) != constants::INVALID_SYMBOL)
+                {
+                    ++loaded;
+                }
+            }
+
+            munmap(mapping, file_size);
+            FMT_PRINT("Loaded %d reference records from %s\n", loaded, path.c_str());
+            return loaded;
+        }
+
+    } // namespace processing
+} // namespace stream_buffer
@@ -0,0 +1,215 @@
+#include "processing/sharded_dispatcher.h"
+#include "core/backoff.h"
+#include "processing/symbol_index.h"
+#include "utils/debug.h"
+#include "utils/metrics.h"
+
+namespace stream_buffer
+{
+    namespace processing
+    {
+
+        struct ShardedDispatcher::Worker
+        {
+            Worker(std::unique_ptr<IMessageSink> worker_sink, size_t queue_capacity, ShardedDispatcher *owner)
+                : queue(queue_capacity), sink(std::move(worker_sink)), owner(owner), thread(),
+                  pushed(0), processed(0) {}
+
+            core::SpscQueue<NormalizedMessage> queue;
+            std::unique_ptr<IMessageSink> sink;
+            ShardedDispatcher *owner;
+            pthread_t thread;
+            common::u64 pushed;                 // Producer side only
+            std::atomic<common::u64> processed; // Written by the worker
+        };
+
+        ShardedDispatcher::ShardedDispatcher(std::vector<std::unique_ptr<IMessageSink>> worker_sinks,
+                                             size_t queue_capacity)
+            : running_(false), started_(false), backpressure_count_(0)
+        {
+            if (worker_sinks.size() > constants::MAX_SHARD_WORKERS)
+            {
+                FMT_PRINT("Too many shard workers (%zu), limiting to %zu\n",
+                          worker_sinks.size(), constants::MAX_SHARD_WORKERS);
+                worker_sinks.resize(constants::MAX_SHARD_WORKERS);
+            }
+
+            for (size_t i = 0; i < worker_sinks.size(); ++i)
+            {
+                workers_.emplace_back(new Worker(std::move(worker_sinks[i]), queue_capacity, this));
+            }
+        }
+
+        ShardedDispatcher::~ShardedDispatcher()
+        {
+            Stop();
+        }
+
+        bool ShardedDispatcher::Start()
+        {
+            if (started_)
+            {
+                return true;
+            }
+
+            running_.store(true, std::memory_order_release);
+            for (size_t i = 0; i < workers_.size(); ++i)
+            {
+                if (pthread_create(&workers_[i]->thread, nullptr, WorkerThreadFunction, workers_[i].get()) != 0)
+                {
+                    FMT_PRINT("Failed to start shard worker %zu\n", i);
+                    running_.store(false, std::memory_order_release);
+                    for (size_t j = 0; j < i; ++j)
+                    {
+                        pthread_join(workers_[j]->thread, nullptr);
+                    }
+                    return false;
+                }
+            }
+
+            started_ = true;
+            return true;
+        }
+
+        void ShardedDispatcher::Stop()
+        {
+            if (!started_)
+            {
+                return;
+            }
+
+            // Workers drain their queues before exiting
+            running_.store(false, std::memory_order_release);
+            for (size_t i = 0; i < workers_.size(); ++i)
+            {
+                pthread_join(workers_[i]->thread, nullptr);
+            }
+            started_ = false;
+        }
+
+        size_t ShardedDispatcher::GetShard(const char *product_id) const
+        {
+            return workers_.empty() ? 0 : static_cast<size_t>(HashProductId(product_id) % workers_.size());
+        }
+
+        common::u64 ShardedDispatcher::GetProcessedCount(size_t worker) const
+        {
+            return worker < workers_.size() ? workers_[worker]->processed.load(std::memory_order_relaxed) : 0;
+        }
+
+        void ShardedDispatcher::OnMessage(const NormalizedMessage &message)
+        {
+            if (workers_.empty())
+            {
+                return;
+            }
+
+            Worker &worker = *workers_[GetShard(message.product_id)];
+            if (!started_)
+            {
+                worker.sink->OnMessage(message);
+                worker.pushed++;
+                worker.processed.store(worker.pushed, std::memory_order_relaxed);
+                return;
+            }
+
+            if (!worker.queue.TryPush(message))
+            {
+                backpressure_count_++;
+                utils::GetMetrics().Add(utils::Counter::SHARD_BACKPRESSURE);
+                core::Backoff backoff;
+                while (!worker.queue.TryPush(message))
+                {
+                    backoff.Pause();
+                }
+            }
+            worker.pushed++;
+
+            // Sampled: reading the consumer's counter costs a cache miss
+            if ((worker.pushed & (constants::QUEUE_DEPTH_SAMPLE_INTERVAL - 1)) == 0)
+            {
+                utils::GetMetrics().Set(utils::Gauge::SHARD_QUEUE_DEPTH,
+                                        static_cast<common::i64>(worker.pushed -
+                                                                 worker.processed.load(std::memory_order_relaxed)));
+            }
+        }
+
+        void ShardedDispatcher::Flush()
+        {
+            if (started_)
+            {
+                return;
+            }
+
+            for (size_t i = 0; i < workers_.size(); ++i)
+            {
+                workers_[i]->sink->Flush();
+            }
+        }
+
+        void ShardedDispatcher::Drain()
+        {
+            if (!started_)
+            {
+                Flush();
+                return;
+            }
+
+            for (size_t i = 0; i < workers_.size(); ++i)
+            {
+                Worker &worker = *workers_[i];
+                core::Backoff backoff;
+                while (worker.processed.load(std::memory_order_acquire) < worker.pushed)
+                {
+                    backoff.Pause();
+                }
+            }
+        }
+
+        void *ShardedDispatcher::WorkerThreadFunction(void *arg)
+        {
+            Worker *worker = static_cast<Worker *>(arg);
+            worker->owner->RunWorker(*worker);
+            return nullptr;
+        }
+
+        void ShardedDispatcher::RunWorker(Worker &worker)
+        {
+            NormalizedMessage message;
+            core::Backoff backoff;
+            bool pending_flush = false;
+
+            while (true)
+            {
+                if (worker.queue.TryPop(&message))
+                {
+                    worker.sink->OnMessage(message);
+                    worker.processed.fetch_add(1, std::memory_order_release);
+                    pending_flush = true;
+                    backoff.Reset();
+                    continue;
+                }
+
+                // Queue drained: let the sink publish what it batched
+                if (pending_flush)
+                {
+                    worker.sink->Flush();
+                    pending_flush = false;
+                }
+
+                if (!running_.load(std::memory_order_acquire))
+                {
+                    // Pick up anything pushed between the last pop and the stop request
+                    if (worker.queue.IsEmpty())
+                    {
+                        break;
+                    }
+                    continue;
+                }
+
+                backoff.Pause();
+            }
+        }
+
+    } // namespace processing
+} // namespace stream_buffer
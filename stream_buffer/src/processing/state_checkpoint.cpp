@@ -0,0 +1,400 @@
+#include "processing/state_checkpoint.h"
+#include "utils/debug.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+namespace stream_buffer
+{
+    namespace processing
+    {
+
+        namespace
+        {
+            constexpr char CHECKPOINT_MAGIC[8] = {'S', 'B', 'C', 'K', 'P', 'O', 'I', 'N'};
+            constexpr long CHECKPOINT_POLL_MS = 50; // Longest sleep before noticing Stop()
+
+            size_t RoundUpToPage(size_t size)
+            {
+                size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+                return (size + page - 1) / page * page;
+            }
+
+            common::i64 NowNs(clockid_t clock)
+            {
+                struct timespec now;
+                clock_gettime(clock, &now);
+                return static_cast<common::i64>(now.tv_sec) * 1000000000LL + now.tv_nsec;
+            }
+
+            // FNV-1a over 64-bit words, then the tail bytes
+            common::u64 Hash(common::u64 hash, const void *data, size_t length)
+            {
+                const char *bytes = static_cast<const char *>(data);
+                size_t words = length / sizeof(common::u64);
+                for (size_t i = 0; i < words; ++i)
+                {
+                    common::u64 word;
+                    std::memcpy(&word, bytes + i * sizeof(word), sizeof(word));
+                    hash = (hash ^ word) * 0x100000001B3ULL;
+                }
+                for (size_t i = words * sizeof(common::u64); i < length; ++i)
+                {
+                    hash = (hash ^ static_cast<unsigned char>(bytes[i])) * 0x100000001B3ULL;
+                }
+                return hash;
+            }
+
+            // Copy a slot into the region only when it changed, so untouched pages stay clean
+            template <typename T>
+            bool Write(T *slot, const T &value)
+            {
+                if (std::memcmp(slot, &value, sizeof(T)) == 0)
+                {
+                    return false;
+                }
+                std::memcpy(slot, &value, sizeof(T));
+                return true;
+            }
+        } // anonymous namespace
+
+        StateCheckpointer::StateCheckpointer(const std::string &path, ReferenceDataStore *reference,
+                                             QuoteSnapshotTable *quotes, int interval_ms, common::u32 max_symbols)
+            : path_(path), reference_(reference), quotes_(quotes), interval_ms_(interval_ms > 0 ? interval_ms : 1),
+              max_symbols_(max_symbols), mapping_(nullptr), mapping_size_(0),
+              region_size_(RoundUpToPage(sizeof(CheckpointRegionHeader) +
+                                         static_cast<size_t>(max_symbols) * (sizeof(ReferenceRecord) + sizeof(QuoteSnapshot)))),
+              generation_(0), saved_time_ns_(0), saved_message_count_(0), changed_slots_(0),
+              restored_generation_(0), restored_age_ns_(0), restore_duration_ns_(0),
+              message_count_(0), checkpoint_count_(0), thread_(), running_(false), started_(false)
+        {
+            for (size_t i = 0; i < constants::CHECKPOINT_LINES * constants::MESSAGE_TYPE_COUNT; ++i)
+            {
+                sequences_[i].store(0, std::memory_order_relaxed);
+            }
+        }
+
+        StateCheckpointer::~StateCheckpointer()
+        {
+            Stop();
+            if (mapping_)
+            {
+                munmap(mapping_, mapping_size_);
+            }
+        }
+
+        bool StateCheckpointer::Open()
+        {
+            if (mapping_)
+            {
+                return true;
+            }
+
+            CheckpointFileHeader expected;
+            std::memset(&expected, 0, sizeof(expected));
+            std::memcpy(expected.magic, CHECKPOINT_MAGIC, sizeof(expected.magic));
+            expected.version = constants::CHECKPOINT_VERSION;
+            expected.max_symbols = max_symbols_;
+            expected.reference_size = sizeof(ReferenceRecord);
+            expected.quote_size = sizeof(QuoteSnapshot);
+            expected.lines = constants::CHECKPOINT_LINES;
+            expected.message_types = constants::MESSAGE_TYPE_COUNT;
+            expected.region_offset = RoundUpToPage(sizeof(CheckpointFileHeader));
+            expected.region_size = region_size_;
+            size_t file_size = expected.region_offset + 2 * region_size_;
+
+            int fd = open(path_.c_str(), O_RDWR | O_CREAT, 0644);
+            if (fd < 0)
+            {
+                FMT_PRINT("Failed to open checkpoint %s: %s\n", path_.c_str(), strerror(errno));
+                return false;
+            }
+
+            // A file of another layout, or none, starts empty
+            CheckpointFileHeader existing;
+            struct stat file_stat;
+            bool reuse = fstat(fd, &file_stat) == 0 && static_cast<size_t>(file_stat.st_size) == file_size &&
+                         pread(fd, &existing, sizeof(existing), 0) == static_cast<ssize_t>(sizeof(existing)) &&
+                         std::memcmp(&existing, &expected, sizeof(expected)) == 0;
+            if (!reuse)
+            {
+                if (ftruncate(fd, 0) < 0 || ftruncate(fd, static_cast<off_t>(file_size)) < 0 ||
+                    pwrite(fd, &expected, sizeof(expected), 0) != static_cast<ssize_t>(sizeof(expected)))
+                {
+                    FMT_PRINT("Failed to size checkpoint %s: %s\n", path_.c_str(), strerror(errno));
+                    close(fd);
+                    return false;
+                }
+            }
+
+            void *mapping = mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            close(fd);
+            if (mapping == MAP_FAILED)
+            {
+                FMT_PRINT("Failed to map checkpoint %s: %s\n", path_.c_str(), strerror(errno));
+                return false;
+            }
+            mapping_ = static_cast<char *>(mapping);
+            mapping_size_ = file_size;
+
+            for (size_t r = 0; r < 2; ++r)
+            {
+                CheckpointRegionHeader *region = GetRegion(r);
+                if (IsValid(region) && region->generation > generation_.load(std::memory_order_relaxed))
+                {
+                    generation_.store(region->generation, std::memory_order_relaxed);
+                    saved_time_ns_.store(region->saved_time_ns, std::memory_order_relaxed);
+                }
+            }
+            return true;
+        }
+
+        CheckpointRegionHeader *StateCheckpointer::GetRegion(size_t region) const
+        {
+            return reinterpret_cast<CheckpointRegionHeader *>(mapping_ + RoundUpToPage(sizeof(CheckpointFileHeader)) +
+                                                              region * region_size_);
+        }
+
+        ReferenceRecord *StateCheckpointer::GetReferenceSlots(CheckpointRegionHeader *region) const
+        {
+            return reinterpret_cast<ReferenceRecord *>(region + 1);
+        }
+
+        QuoteSnapshot *StateCheckpointer::GetQuoteSlots(CheckpointRegionHeader *region) const
+        {
+            return reinterpret_cast<QuoteSnapshot *>(GetReferenceSlots(region) + max_symbols_);
+        }
+
+        common::u64 StateCheckpointer::ComputeChecksum(CheckpointRegionHeader *region) const
+        {
+            const char *fields = reinterpret_cast<const char *>(region) + offsetof(CheckpointRegionHeader, generation);
+            common::u64 hash = Hash(0xCBF29CE484222325ULL, fields,
+                                    sizeof(CheckpointRegionHeader) - offsetof(CheckpointRegionHeader, generation));
+            hash = Hash(hash, GetReferenceSlots(region), region->reference_count * sizeof(ReferenceRecord));
+            return Hash(hash, GetQuoteSlots(region), region->quote_count * sizeof(QuoteSnapshot));
+        }
+
+        bool StateCheckpointer::IsValid(CheckpointRegionHeader *region) const
+        {
+            return region->generation != 0 &&
+                   region->reference_count <= max_symbols_ &&
+                   region->quote_count <= max_symbols_ &&
+                   region->checksum == ComputeChecksum(region);
+        }
+
+        common::u64 StateCheckpointer::Restore()
+        {
+            common::u64 generation = generation_.load(std::memory_order_relaxed);
+            if (!mapping_ || generation == 0)
+            {
+                return 0;
+            }
+
+            common::i64 start_ns = NowNs(CLOCK_MONOTONIC);
+            CheckpointRegionHeader *region = GetRegion(generation % 2);
+            for (size_t i = 0; i < constants::CHECKPOINT_LINES * constants::MESSAGE_TYPE_COUNT; ++i)
+            {
+                sequences_[i].store(region->sequences[i], std::memory_order_relaxed);
+            }
+
+            common::u32 references = 0;
+            if (reference_)
+            {
+                const ReferenceRecord *records = GetReferenceSlots(region);
+                for (common::u32 i = 0; i < region->reference_count; ++i)
+                {
+                    references += reference_->Restore(records[i]) != constants::INVALID_SYMBOL ? 1 : 0;
+                }
+            }
+
+            common::u32 quotes = 0;
+            if (quotes_)
+            {
+                const QuoteSnapshot *snapshots = GetQuoteSlots(region);
+                for (common::u32 i = 0; i < region->quote_count; ++i)
+                {
+                    quotes += quotes_->Restore(snapshots[i]) ? 1 : 0;
+                }
+            }
+
+            restored_generation_ = generation;
+            restored_age_ns_ = NowNs(CLOCK_REALTIME) - region->saved_time_ns;
+            restore_duration_ns_ = NowNs(CLOCK_MONOTONIC) - start_ns;
+            FMT_PRINT("Restored checkpoint %llu from %.1f s ago: %u reference records, %u books in %.3f ms\n",
+                      static_cast<unsigned long long>(generation), static_cast<double>(restored_age_ns_) / 1e9,
+                      references, quotes, static_cast<double>(restore_duration_ns_) / 1e6);
+            return generation;
+        }
+
+        bool StateCheckpointer::Start()
+        {
+            if (started_)
+            {
+                return true;
+            }
+            if (!mapping_)
+            {
+                return false;
+            }
+
+            running_.store(true, std::memory_order_release);
+            if (pthread_create(&thread_, nullptr, CheckpointThreadFunction, this) != 0)
+            {
+                FMT_PRINT("Failed to start checkpoint thread\n");
+                running_.store(false, std::memory_order_release);
+                return false;
+            }
+            started_ = true;
+            return true;
+        }
+
+        void StateCheckpointer::Stop()
+        {
+            if (!started_)
+            {
+                return;
+            }
+
+            running_.store(false, std::memory_order_release);
+            pthread_join(thread_, nullptr);
+            started_ = false;
+
+            // The processing thread has stopped, so this captures its final state
+            Checkpoint();
+        }
+
+        bool StateCheckpointer::Checkpoint()
+        {
+            if (!mapping_)
+            {
+                return false;
+            }
+
+            common::u64 message_count = message_count_.load(std::memory_order_relaxed);
+            common::u64 generation = generation_.load(std::memory_order_relaxed);
+            if (generation != 0 && message_count == saved_message_count_)
+            {
+                return false;
+            }
+
+            // The region not holding the newest checkpoint
+            ++generation;
+            CheckpointRegionHeader *region = GetRegion(generation % 2);
+            common::u64 changed = 0;
+
+            // Sequences first: the processing thread stores one only after updating the tables,
+            // so the tables copied below are at least as new as the sequences saved with them
+            for (size_t i = 0; i < constants::CHECKPOINT_LINES * constants::MESSAGE_TYPE_COUNT; ++i)
+            {
+                region->sequences[i] = sequences_[i].load(std::memory_order_acquire);
+            }
+
+            common::u32 reference_count = 0;
+            if (reference_)
+            {
+                reference_count = reference_->GetSize() < max_symbols_ ? reference_->GetSize() : max_symbols_;
+                ReferenceRecord *slots = GetReferenceSlots(region);
+                ReferenceRecord record;
+                for (common::u32 i = 0; i < reference_count; ++i)
+                {
+                    reference_->GetRecord(i, &record);
+                    changed += Write(&slots[i], record) ? 1 : 0;
+                }
+            }
+
+            common::u32 quote_count = 0;
+            if (quotes_)
+            {
+                quote_count = quotes_->GetSize() < max_symbols_ ? quotes_->GetSize() : max_symbols_;
+                QuoteSnapshot *slots = GetQuoteSlots(region);
+                QuoteSnapshot snapshot;
+                for (common::u32 i = 0; i < quote_count; ++i)
+                {
+                    quotes_->Read(i, &snapshot);
+                    changed += Write(&slots[i], snapshot) ? 1 : 0;
+                }
+            }
+
+            region->generation = generation;
+            region->saved_time_ns = NowNs(CLOCK_REALTIME);
+            region->message_count = message_count;
+            region->reference_count = reference_count;
+            region->quote_count = quote_count;
+            region->checksum = ComputeChecksum(region);
+
+            if (msync(region, region_size_, MS_SYNC) != 0)
+            {
+                FMT_PRINT("Failed to write checkpoint %s: %s\n", path_.c_str(), strerror(errno));
+                return false;
+            }
+
+            generation_.store(generation, std::memory_order_relaxed);
+            saved_time_ns_.store(region->saved_time_ns, std::memory_order_relaxed);
+            saved_message_count_ = message_count;
+            changed_slots_ = changed;
+            checkpoint_count_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        std::string StateCheckpointer::Format() const
+        {
+            common::i64 saved_time_ns = saved_time_ns_.load(std::memory_order_relaxed);
+            common::i64 age_ns = saved_time_ns != 0 ? NowNs(CLOCK_REALTIME) - saved_time_ns : 0;
+            char line[256];
+            std::snprintf(line, sizeof(line),
+                          "checkpoint generation=%llu written=%llu age_ms=%.1f restored_generation=%llu "
+                          "restored_age_ms=%.1f restore_ms=%.3f\n",
+                          static_cast<unsigned long long>(generation_.load(std::memory_order_relaxed)),
+                          static_cast<unsigned long long>(checkpoint_count_.load(std::memory_order_relaxed)),
+                          static_cast<double>(age_ns) / 1e6,
+                          static_cast<unsigned long long>(restored_generation_),
+                          static_cast<double>(restored_age_ns_) / 1e6,
+                          static_cast<double>(restore_duration_ns_) / 1e6);
+            return line;
+        }
+
+        common::u32 StateCheckpointer::GetLastSequence(char transmission_code, MessageType type) const
+        {
+            size_t slot = GetSequenceSlot(transmission_code, type);
+            return slot < constants::CHECKPOINT_LINES * constants::MESSAGE_TYPE_COUNT
+                       ? sequences_[slot].load(std::memory_order_relaxed)
+                       : 0;
+        }
+
+        void *StateCheckpointer::CheckpointThreadFunction(void *arg)
+        {
+            static_cast<StateCheckpointer *>(arg)->RunCheckpoints();
+            return nullptr;
+        }
+
+        void StateCheckpointer::RunCheckpoints()
+        {
+            common::i64 interval_ns = static_cast<common::i64>(interval_ms_) * 1000000LL;
+            common::i64 next_ns = NowNs(CLOCK_MONOTONIC) + interval_ns;
+            while (running_.load(std::memory_order_acquire))
+            {
+                common::i64 wait_ns = next_ns - NowNs(CLOCK_MONOTONIC);
+                if (wait_ns > 0)
+                {
+                    common::i64 poll_ns = CHECKPOINT_POLL_MS * 1000000LL;
+                    common::i64 sleep_ns = wait_ns < poll_ns ? wait_ns : poll_ns;
+                    struct timespec delay = {static_cast<time_t>(sleep_ns / 1000000000LL),
+                                             static_cast<long>(sleep_ns % 1000000000LL)};
+                    nanosleep(&delay, nullptr);
+                    continue;
+                }
+
+                // A slow disk stretches the interval rather than queuing checkpoints
+                Checkpoint();
+                next_ns = NowNs(CLOCK_MONOTONIC) + interval_ns;
+            }
+        }
+
+    } // namespace processing
+} // namespace stream_buffer
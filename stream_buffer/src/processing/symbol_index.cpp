@@ -0,0 +1,95 @@
+#include "processing/symbol_index.h"
+#include <cstring>
+
+namespace stream_buffer
+{
+    namespace processing
+    {
+
+        SymbolIndex::SymbolIndex(common::u32 max_symbols)
+            : max_symbols_(max_symbols), mask_(0), size_(0)
+        {
+            // Keep the table at most half full so probe sequences stay short
+            common::u32 table_size = 16;
+            while (table_size < max_symbols * 2)
+            {
+                table_size <<= 1;
+            }
+            mask_ = table_size - 1;
+
+            entries_.reset(new Entry[table_size]);
+            for (common::u32 i = 0; i < table_size; ++i)
+            {
+                entries_[i].symbol_plus_one.store(0, std::memory_order_relaxed);
+                std::memset(entries_[i].product_id, 0, sizeof(entries_[i].product_id));
+            }
+            entry_of_symbol_.reset(new common::u32[max_symbols]);
+        }
+
+        common::u32 SymbolIndex::Find(const char *product_id) const
+        {
+            common::u32 position = static_cast<common::u32>(HashProductId(product_id)) & mask_;
+
+            while (true)
+            {
+                const Entry &entry = entries_[position];
+                common::u32 symbol_plus_one = entry.symbol_plus_one.load(std::memory_order_acquire);
+                if (symbol_plus_one == 0)
+                {
+                    return constants::INVALID_SYMBOL;
+                }
+                if (std::memcmp(entry.product_id, product_id, constants::PRODUCT_ID_SIZE) == 0)
+                {
+                    return symbol_plus_one - 1;
+                }
+                position = (position + 1) & mask_;
+            }
+        }
+
+        common::u32 SymbolIndex::Insert(const char *product_id)
+        {
+            common::u32 position = static_cast<common::u32>(HashProductId(product_id)) & mask_;
+
+            while (true)
+            {
+                Entry &entry = entries_[position];
+                common::u32 symbol_plus_one = entry.symbol_plus_one.load(std::memory_order_relaxed);
+                if (symbol_plus_one == 0)
+                {
+                    break;
+                }
+                if (std::memcmp(entry.product_id, product_id, constants::PRODUCT_ID_SIZE) == 0)
+                {
+                    return symbol_plus_one - 1;
+                }
+                position = (position + 1) & mask_;
+            }
+
+            common::u32 symbol = size_.load(std::memory_order_relaxed);
+            if (symbol >= max_symbols_)
+            {
+                return constants::INVALID_SYMBOL;
+            }
+
+            // Fill the key before publishing the entry to readers
+            Entry &entry = entries_[position];
+            std::memcpy(entry.product_id, product_id, constants::PRODUCT_ID_SIZE);
+            entry_of_symbol_[symbol] = position;
+            entry.symbol_plus_one.store(symbol + 1, std::memory_order_release);
+            size_.store(symbol + 1, std::memory_order_release);
+
+            return symbol;
+        }
+
+        bool SymbolIndex::GetProductId(common::u32 symbol, char *product_id) const
+        {
+            if (symbol >= size_.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+            std::memcpy(product_id, entries_[entry_of_symbol_[symbol]].product_id, constants::PRODUCT_ID_SIZE);
+            return true;
+        }
+
+    } // namespace processing
+} // namespace stream_buffer
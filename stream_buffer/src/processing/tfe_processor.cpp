@@ -1,5 +1,8 @@
 #include "processing/tfe_processor.h"
+#include "processing/normalizer.h"
 #include "utils/debug.h"
+#include "utils/metrics.h"
+#include "utils/trace.h"
 #include "common/types.h"
 
 namespace stream_buffer
@@ -7,6 +10,16 @@ namespace stream_buffer
     namespace processing
     {
 
+        DecoderOptions TFEProcessor::MakeOptions(ReferenceDataStore *reference_data, MessageFilter *filter,
+                                                 bool validate_checksum)
+        {
+            DecoderOptions options;
+            options.filter = filter;
+            options.validate_checksum = validate_checksum;
+            options.reference_data = reference_data;
+            return options;
+        }
+
         // Process a TFE message from the buffer
         size_t TFEProcessor::ProcessMessage(const char *message, size_t length)
         {
@@ -16,114 +29,247 @@ namespace stream_buffer
                 return 0;
             }
 
-            const auto *header = reinterpret_cast<const tfe::Header *>(message);
+            StampReceiveTime();
+            bool handled = false;
+            size_t processed = decoder_.DecodePacket(message, length, &handled);
+            if (handled)
+            {
+                handler_.FlushSinks();
+            }
+            return processed;
+        }
 
-            // Use new header validation function
-            if (!header->IsValid())
+        inline core::BatchResult TFEProcessor::Decode(const char *data, size_t length)
+        {
+            if (profiler_)
             {
-                FMT_PRINT("Invalid TFE header\n");
-                size_t new_header_pos = FindNextHeader(message, length);
-                FMT_PRINT("Skipping data, next potential header at offset: %zu\n", new_header_pos);
-                return new_header_pos;
+                return DecodeProfiled(data, length);
             }
+            return decoder_.Decode(data, length);
+        }
 
-            // Get body size using the new GetBodyLength method
-            uint32_t body_size = header->GetBodyLength();
-            if (body_size == 0)
+        core::BatchResult TFEProcessor::DecodeProfiled(const char *data, size_t length)
+        {
+            if (!recorder_)
             {
-                FMT_PRINT("Invalid body length in TFE header\n");
-                size_t new_header_pos = FindNextHeader(message, length);
-                return new_header_pos;
+                recorder_.reset(new utils::PerfRecorder(*profiler_));
+            }
+            if (!data || !recorder_->IsActive())
+            {
+                return decoder_.Decode(data, length);
             }
 
-            // Calculate total packet size using the utility function
-            size_t total_size = tfe::CalculatePacketSize(body_size);
+            // Same loop as Decoder::Decode, with a checkpoint after every packet;
+            // time spent between batches is not attributed
+            core::BatchResult result;
+            recorder_->Restart();
+            while (length - result.bytes_consumed >= sizeof(tfe::Header))
+            {
+                bool handled = false;
+                handler_.ResetScope();
+                size_t processed = decoder_.DecodePacket(data + result.bytes_consumed,
+                                                         length - result.bytes_consumed, &handled);
+                if (processed == 0)
+                {
+                    break;
+                }
+                recorder_->Checkpoint(handler_.GetScope(), processed);
+                result.bytes_consumed += processed;
+                if (handled)
+                {
+                    result.message_count++;
+                }
+            }
+            return result;
+        }
 
-            // Check if we have enough data for the complete packet
-            if (length < total_size)
+        // Process every complete packet in the span without virtual dispatch
+        core::BatchResult TFEProcessor::ProcessBatch(const char *data, size_t length)
+        {
+            TRACE_SCOPE(trace, utils::TraceEvent::DECODE);
+            trace.SetArg(length);
+            StampReceiveTime();
+            core::BatchResult result = Decode(data, length);
+            if (result.message_count > 0)
             {
-                FMT_PRINT("Incomplete packet: expected %zu bytes, got %zu\n", total_size, length);
-                return 0; // Not enough data yet, wait for more
+                handler_.FlushSinks();
             }
+            return result;
+        }
 
-            // Validate checksum if needed
-            if (!tfe::ValidateChecksum(message, total_size - tfe::TERMINAL_CODE_SIZE))
+        inline core::BatchResult TFEProcessor::DecodeDatagram(const core::DatagramSlot &slot)
+        {
+            // Packets never span datagrams, so skipped bytes or a partial packet
+            // at the end are damage confined to this datagram
+            size_t resync_bytes = handler_.GetResyncBytes();
+            handler_.SetReceiveTime(slot.receive_time_ns);
+            core::BatchResult result = Decode(slot.GetPayload(), slot.length);
+            if (slot.IsTruncated() || result.bytes_consumed < slot.length ||
+                handler_.GetResyncBytes() != resync_bytes)
             {
-                FMT_PRINT("Invalid checksum\n");
-                // Try to recover by finding the next valid header
-                size_t new_header_pos = FindNextHeader(message, length);
-                return new_header_pos;
+                damaged_datagrams_++;
+                FMT_PRINT("Damaged datagram #%u: %zu of %u bytes decoded%s\n", slot.sequence,
+                          result.bytes_consumed, slot.length, slot.IsTruncated() ? " (truncated)" : "");
             }
+            return result;
+        }
 
-            // Print header information
-            header->Print();
+        core::BatchResult TFEProcessor::ProcessDatagram(const core::DatagramSlot &slot)
+        {
+            TRACE_SCOPE(trace, utils::TraceEvent::DECODE);
+            trace.SetArg(slot.length);
+            core::BatchResult result = DecodeDatagram(slot);
+            if (result.message_count > 0)
+            {
+                handler_.FlushSinks();
+            }
+            return result;
+        }
 
-            // Process specific message types
-            if (header->transmission_code == '1' &&
-                header->message_kind == '1')
+        core::BatchResult TFEProcessor::ProcessSlots(const char *data, size_t length)
+        {
+            TRACE_SCOPE(trace, utils::TraceEvent::DECODE);
+            trace.SetArg(length);
+            core::BatchResult result;
+            result.bytes_consumed = core::ForEachSlot(data, length, [this, &result](const core::DatagramSlot &slot)
             {
-                // Future products I010
-                if (body_size >= sizeof(tfe::BodyI010))
-                {
-                    const auto *body = reinterpret_cast<const tfe::BodyI010 *>(message + sizeof(tfe::Header));
+                result.message_count += DecodeDatagram(slot).message_count;
+            });
+            if (result.message_count > 0)
+            {
+                handler_.FlushSinks();
+            }
+            return result;
+        }
 
-                    // Directly process the body since IsValid() is always true
-                    body->Print();
+        template <typename View>
+        inline void TFEProcessor::Handler::Forward(const View &view)
+        {
+            if (sinks_.empty())
+            {
+                return;
+            }
 
-                    // Here you would add more processing logic for the specific message type
-                    FMT_PRINT("Processing product: %s\n", body->GetProductId().c_str());
-                }
-                else
+            NormalizedMessage message;
+            if (Normalize(view, &message))
+            {
+                Publish(message);
+            }
+        }
+
+        void TFEProcessor::Handler::Forward(const TradeView &view)
+        {
+            if (sinks_.empty())
+            {
+                return;
+            }
+
+            // A sweep carries several matches; each reaches the sinks in order
+            NormalizedMessage message;
+            for (size_t i = 0; i < view.GetMatchCount(); ++i)
+            {
+                if (Normalize(view, i, &message))
                 {
-                    FMT_PRINT("Body size too small for I010: %u bytes\n", body_size);
+                    Publish(message);
                 }
             }
-            else
+        }
+
+        inline void TFEProcessor::Handler::Publish(const NormalizedMessage &message)
+        {
+            for (size_t i = 0; i < sinks_.size(); ++i)
             {
-                FMT_PRINT("Unhandled message type: Trans=%c Kind=%c\n",
-                          header->transmission_code, header->message_kind);
+                sinks_[i]->OnMessage(message);
             }
+        }
+
+        void TFEProcessor::Handler::FlushSinks()
+        {
+            for (size_t i = 0; i < sinks_.size(); ++i)
+            {
+                sinks_[i]->Flush();
+            }
+        }
+
+        void TFEProcessor::Handler::OnMessage(const MessageView &view)
+        {
+            // Print header information
+            view.GetHeader().Print();
+        }
+
+        void TFEProcessor::Handler::OnI010(const I010View &view)
+        {
+            scope_ = utils::PerfScope::I010;
+            RecordLatency(view, LatencyKind::I010);
+            const tfe::BodyI010 &body = view.GetBody();
+            body.Print();
 
-            // Return total bytes processed
-            return total_size;
+            FMT_PRINT("Processing product: %s\n", body.GetProductId().c_str());
+            utils::GetMetrics().Add(utils::Counter::MESSAGES_I010);
+
+            // Keep the latest definition of the product
+            if (reference_data_)
+            {
+                reference_data_->Update(view.GetHeader().transmission_code, body);
+            }
+            Forward(view);
         }
 
-        // Find the next packet header in the buffer
-        size_t TFEProcessor::FindNextHeader(const char *data, size_t length)
+        void TFEProcessor::Handler::OnTrade(const TradeView &view)
         {
-            if (!data || length == 0)
+            scope_ = utils::PerfScope::TRADE;
+            RecordLatency(view, LatencyKind::TRADE);
+            utils::GetMetrics().Add(utils::Counter::MESSAGES_TRADE);
+            common::Price price;
+            common::i64 quantity = 0;
+            if (view.GetPrice(&price, &quantity))
             {
-                return 0;
+                FMT_PRINT("Trade %.10s: %s x %lld (%zu matches)\n", view.GetProductId(),
+                          price.ToString().c_str(), static_cast<long long>(quantity), view.GetMatchCount());
             }
+            Forward(view);
+        }
 
-            for (size_t i = 0; i < length; ++i)
+        void TFEProcessor::Handler::OnQuote(const QuoteView &view)
+        {
+            scope_ = utils::PerfScope::QUOTE;
+            RecordLatency(view, LatencyKind::QUOTE);
+            utils::GetMetrics().Add(utils::Counter::MESSAGES_QUOTE);
+            common::Price bid, ask;
+            common::i64 bid_qty = 0, ask_qty = 0;
+            if (view.GetBid(0, &bid, &bid_qty) && view.GetAsk(0, &ask, &ask_qty))
             {
-                if (static_cast<uint8_t>(data[i]) == tfe::ESC_CODE)
-                {
-                    // Check if we have enough data for a potential header
-                    if (i + sizeof(tfe::Header) <= length)
-                    {
-                        const auto *possible_header = reinterpret_cast<const tfe::Header *>(data + i);
-                        // Do a quick validation of key fields
-                        if (possible_header->transmission_code == '1' ||
-                            possible_header->transmission_code == '4')
-                        {
-                            FMT_PRINT("Found potential header at offset %zu\n", i);
-                            return i;
-                        }
-                    }
-                    else
-                    {
-                        // Found ESC but not enough data to validate header
-                        FMT_PRINT("Found ESC code at offset %zu but not enough data for header\n", i);
-                        return i;
-                    }
-                }
+                FMT_PRINT("Quote %.10s: %lld @ %s / %s @ %lld\n", view.GetProductId(),
+                          static_cast<long long>(bid_qty), bid.ToString().c_str(),
+                          ask.ToString().c_str(), static_cast<long long>(ask_qty));
             }
+            Forward(view);
+        }
+
+        void TFEProcessor::Handler::OnResync(const char *data, size_t skipped)
+        {
+            (void)data;
+            scope_ = utils::PerfScope::SKIPPED;
+            resync_bytes_ += skipped;
+            utils::GetMetrics().Add(utils::Counter::RESYNCS);
+            utils::GetMetrics().Add(utils::Counter::RESYNC_BYTES, skipped);
+        }
 
-            // No potential header found
-            return length;
+        void TFEProcessor::Handler::OnChecksumError(const char *message, size_t length)
+        {
+            (void)message;
+            (void)length;
+            utils::GetMetrics().Add(utils::Counter::CHECKSUM_FAILURES);
+        }
+
+        void TFEProcessor::Handler::OnUnknown(const MessageView &view)
+        {
+            scope_ = utils::PerfScope::OTHER;
+            RecordLatency(view, LatencyKind::OTHER);
+            utils::GetMetrics().Add(utils::Counter::MESSAGES_OTHER);
+            FMT_PRINT("Unhandled message type: Trans=%c Kind=%c\n",
+                      view.GetHeader().transmission_code, view.GetHeader().message_kind);
         }
 
     } // namespace processing
-} // namespace stream_buffer
\ No newline at end of file
+} // namespace stream_buffer
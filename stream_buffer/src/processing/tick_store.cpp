@@ -0,0 +1,999 @@
+#include "processing/tick_store.h"
+#include "core/backoff.h"
+#include "utils/debug.h"
+#include "utils/metrics.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+namespace stream_buffer
+{
+    namespace processing
+    {
+
+        namespace
+        {
+            constexpr char TICK_FILE_MAGIC[8] = {'S', 'B', 'T', 'I', 'C', 'K', 'S', '\0'};
+
+            const char *const COLUMN_NAMES[TICK_COLUMN_COUNT] = {
+                "time",
+                "seq",
+                "symbol",
+                "price_scale",
+                "price",
+                "quantity",
+                "bid_price",
+                "bid_quantity",
+                "ask_price",
+                "ask_quantity"};
+
+            const char *const TYPE_NAMES[constants::MESSAGE_TYPE_COUNT] = {
+                "i010",
+                "trade",
+                "quote"};
+
+            common::u32 Bit(TickColumn column)
+            {
+                return 1u << static_cast<unsigned>(column);
+            }
+
+            size_t RoundUpToPage(size_t size)
+            {
+                size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+                return (size + page - 1) / page * page;
+            }
+
+            bool WriteAt(int fd, const void *data, size_t size, off_t offset)
+            {
+                return pwrite(fd, data, size, offset) == static_cast<ssize_t>(size);
+            }
+
+            // Map a whole file read-only; *size is 0 for an empty file
+            const char *MapFile(const std::string &path, size_t *size)
+            {
+                *size = 0;
+                int fd = open(path.c_str(), O_RDONLY);
+                if (fd < 0)
+                {
+                    FMT_PRINT("Failed to open tick file %s: %s\n", path.c_str(), strerror(errno));
+                    return nullptr;
+                }
+
+                struct stat file_stat;
+                if (fstat(fd, &file_stat) < 0 || file_stat.st_size == 0)
+                {
+                    close(fd);
+                    return nullptr;
+                }
+
+                void *mapping = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_SHARED, fd, 0);
+                close(fd);
+                if (mapping == MAP_FAILED)
+                {
+                    FMT_PRINT("Failed to map tick file %s: %s\n", path.c_str(), strerror(errno));
+                    return nullptr;
+                }
+                *size = static_cast<size_t>(file_stat.st_size);
+                return static_cast<const char *>(mapping);
+            }
+
+            template <typename T>
+            T Load(const char *data)
+            {
+                T value;
+                std::memcpy(&value, data, sizeof(T));
+                return value;
+            }
+
+            // Open for appending, creating the file if needed; existing contents are kept
+            int OpenFile(const std::string &path, size_t *size)
+            {
+                int fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+                struct stat file_stat;
+                if (fd < 0 || fstat(fd, &file_stat) < 0)
+                {
+                    FMT_PRINT("Failed to open tick file %s: %s\n", path.c_str(), strerror(errno));
+                    if (fd >= 0)
+                    {
+                        close(fd);
+                    }
+                    return -1;
+                }
+                *size = static_cast<size_t>(file_stat.st_size);
+                return fd;
+            }
+        } // anonymous namespace
+
+        size_t GetTickColumnWidth(TickColumn column)
+        {
+            switch (column)
+            {
+            case TickColumn::SEQ:
+            case TickColumn::SYMBOL:
+                return sizeof(common::u32);
+            case TickColumn::PRICE_SCALE:
+                return sizeof(common::u8);
+            default:
+                return sizeof(common::i64);
+            }
+        }
+
+        const char *GetTickColumnName(TickColumn column)
+        {
+            return COLUMN_NAMES[static_cast<size_t>(column)];
+        }
+
+        common::u32 GetTickColumnMask(MessageType type)
+        {
+            common::u32 mask = Bit(TickColumn::TIME) | Bit(TickColumn::SEQ) | Bit(TickColumn::SYMBOL) |
+                               Bit(TickColumn::PRICE_SCALE);
+            switch (type)
+            {
+            case MessageType::PRODUCT_INFO:
+                return mask | Bit(TickColumn::PRICE);
+            case MessageType::TRADE:
+                return mask | Bit(TickColumn::PRICE) | Bit(TickColumn::QUANTITY);
+            case MessageType::QUOTE:
+                return mask | Bit(TickColumn::BID_PRICE) | Bit(TickColumn::BID_QUANTITY) |
+                       Bit(TickColumn::ASK_PRICE) | Bit(TickColumn::ASK_QUANTITY);
+            }
+            return mask;
+        }
+
+        std::string GetTickFileName(MessageType type)
+        {
+            return std::string(TYPE_NAMES[static_cast<size_t>(type)]) + ".ticks";
+        }
+
+        std::string GetTickIndexName(MessageType type)
+        {
+            return std::string(TYPE_NAMES[static_cast<size_t>(type)]) + ".index";
+        }
+
+        size_t GetTickColumnOffset(common::u32 column_mask, common::u32 block_rows, TickColumn column)
+        {
+            size_t offset = sizeof(TickBlockHeader);
+            for (size_t c = 0; c < static_cast<size_t>(column); ++c)
+            {
+                if (column_mask & (1u << c))
+                {
+                    offset += GetTickColumnWidth(static_cast<TickColumn>(c)) * block_rows;
+                }
+            }
+            return offset;
+        }
+
+        // One message type: the tick file, its index and the block being filled
+        class TickStoreWriter::ColumnFile
+        {
+        public:
+            ColumnFile(MessageType type, common::u32 block_rows)
+                : type_(type), column_mask_(GetTickColumnMask(type)), block_rows_(block_rows),
+                  block_size_(RoundUpToPage(GetTickColumnOffset(column_mask_, block_rows, TickColumn::COUNT))),
+                  data_offset_(RoundUpToPage(sizeof(TickFileHeader))),
+                  fd_(-1), index_fd_(-1), block_(nullptr), block_count_(0),
+                  rows_in_block_(0), published_in_block_(0), row_count_(0)
+            {
+                for (size_t c = 0; c < TICK_COLUMN_COUNT; ++c)
+                {
+                    column_offsets_[c] = GetTickColumnOffset(column_mask_, block_rows_, static_cast<TickColumn>(c));
+                }
+            }
+
+            ~ColumnFile()
+            {
+                Close();
+            }
+
+            // Start a new file, or continue after the rows an earlier writer published
+            bool Open(const std::string &directory)
+            {
+                size_t file_size = 0;
+                size_t index_size = 0;
+                fd_ = OpenFile(directory + "/" + GetTickFileName(type_), &file_size);
+                index_fd_ = OpenFile(directory + "/" + GetTickIndexName(type_), &index_size);
+                if (fd_ < 0 || index_fd_ < 0)
+                {
+                    Close();
+                    return false;
+                }
+
+                if (file_size == 0)
+                {
+                    if (ftruncate(fd_, static_cast<off_t>(data_offset_)) < 0 || ftruncate(index_fd_, 0) < 0)
+                    {
+                        Close();
+                        return false;
+                    }
+                    return WriteHeader();
+                }
+
+                if (!Resume(file_size, index_size))
+                {
+                    Close();
+                    return false;
+                }
+                return true;
+            }
+
+            bool Append(const NormalizedMessage &message, common::u32 symbol)
+            {
+                if ((!block_ || rows_in_block_ == block_rows_) && !NextBlock())
+                {
+                    return false;
+                }
+
+                common::i64 time_ns = message.information_time_ns;
+                TickBlockHeader *header = reinterpret_cast<TickBlockHeader *>(block_);
+                if (rows_in_block_ == 0 || time_ns < header->min_time_ns)
+                {
+                    header->min_time_ns = time_ns;
+                }
+                if (rows_in_block_ == 0 || time_ns > header->max_time_ns)
+                {
+                    header->max_time_ns = time_ns;
+                }
+
+                Store(TickColumn::TIME, time_ns);
+                Store(TickColumn::SEQ, message.information_seq);
+                Store(TickColumn::SYMBOL, symbol);
+                Store(TickColumn::PRICE_SCALE, message.price_scale);
+                Store(TickColumn::PRICE, message.price);
+                Store(TickColumn::QUANTITY, message.quantity);
+                Store(TickColumn::BID_PRICE, message.bid_price);
+                Store(TickColumn::BID_QUANTITY, message.bid_quantity);
+                Store(TickColumn::ASK_PRICE, message.ask_price);
+                Store(TickColumn::ASK_QUANTITY, message.ask_quantity);
+                rows_in_block_++;
+                row_count_++;
+                return true;
+            }
+
+            // Publish the current block's rows: block header, index entry, then file header
+            void Flush()
+            {
+                if (!block_ || rows_in_block_ == published_in_block_)
+                {
+                    return;
+                }
+
+                TickBlockHeader *header = reinterpret_cast<TickBlockHeader *>(block_);
+                header->row_count = rows_in_block_;
+
+                TickIndexEntry entry;
+                entry.min_time_ns = header->min_time_ns;
+                entry.max_time_ns = header->max_time_ns;
+                entry.first_row = header->first_row;
+                entry.row_count = rows_in_block_;
+                entry.block = static_cast<common::u32>(block_count_ - 1);
+                if (!WriteAt(index_fd_, &entry, sizeof(entry), static_cast<off_t>(entry.block * sizeof(entry))))
+                {
+                    FMT_PRINT("Failed to write %s: %s\n", GetTickIndexName(type_).c_str(), strerror(errno));
+                }
+
+                published_in_block_ = rows_in_block_;
+                WriteHeader();
+            }
+
+            void Close()
+            {
+                Flush();
+                if (block_)
+                {
+                    munmap(block_, block_size_);
+                    block_ = nullptr;
+                }
+                if (fd_ >= 0)
+                {
+                    close(fd_);
+                    fd_ = -1;
+                }
+                if (index_fd_ >= 0)
+                {
+                    close(index_fd_);
+                    index_fd_ = -1;
+                }
+            }
+
+            common::u64 GetRowCount() const { return row_count_; }
+
+        private:
+            // Pick up the published rows of an existing file and remap its last block
+            bool Resume(size_t file_size, size_t index_size)
+            {
+                std::string name = GetTickFileName(type_);
+                TickFileHeader header;
+                if (file_size < sizeof(header) ||
+                    pread(fd_, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+                    std::memcmp(header.magic, TICK_FILE_MAGIC, sizeof(header.magic)) != 0 ||
+                    header.version != constants::TICK_STORE_VERSION ||
+                    header.message_type != static_cast<common::u8>(type_) || header.column_mask != column_mask_ ||
+                    header.data_offset != data_offset_)
+                {
+                    FMT_PRINT("%s is not a tick file this writer can append to\n", name.c_str());
+                    return false;
+                }
+                if (header.block_rows != block_rows_ || header.block_size != block_size_)
+                {
+                    FMT_PRINT("%s has %u-row blocks, not %u\n", name.c_str(), header.block_rows, block_rows_);
+                    return false;
+                }
+                if (file_size < data_offset_ + header.block_count * block_size_ ||
+                    index_size < header.block_count * sizeof(TickIndexEntry) ||
+                    header.row_count > header.block_count * block_rows_)
+                {
+                    FMT_PRINT("%s is shorter than its header says\n", name.c_str());
+                    return false;
+                }
+
+                // Rows and blocks the last writer never published are dropped
+                block_count_ = header.block_count;
+                row_count_ = header.row_count;
+                if (ftruncate(fd_, static_cast<off_t>(data_offset_ + block_count_ * block_size_)) < 0 ||
+                    ftruncate(index_fd_, static_cast<off_t>(block_count_ * sizeof(TickIndexEntry))) < 0)
+                {
+                    FMT_PRINT("Failed to trim %s: %s\n", name.c_str(), strerror(errno));
+                    return false;
+                }
+                if (block_count_ == 0)
+                {
+                    return WriteHeader();
+                }
+
+                off_t offset = static_cast<off_t>(data_offset_ + (block_count_ - 1) * block_size_);
+                void *mapping = mmap(nullptr, block_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, offset);
+                if (mapping == MAP_FAILED)
+                {
+                    FMT_PRINT("Failed to map %s: %s\n", name.c_str(), strerror(errno));
+                    return false;
+                }
+                block_ = static_cast<char *>(mapping);
+
+                TickBlockHeader *block = reinterpret_cast<TickBlockHeader *>(block_);
+                if (block->first_row > row_count_ || row_count_ - block->first_row > block_rows_)
+                {
+                    FMT_PRINT("%s has an inconsistent last block\n", name.c_str());
+                    return false;
+                }
+                rows_in_block_ = static_cast<common::u32>(row_count_ - block->first_row);
+                published_in_block_ = rows_in_block_;
+                block->row_count = rows_in_block_;
+
+                // The header's range may include rows that were never published
+                const char *times = block_ + column_offsets_[static_cast<size_t>(TickColumn::TIME)];
+                for (common::u32 row = 0; row < rows_in_block_; ++row)
+                {
+                    common::i64 time_ns = Load<common::i64>(times + row * sizeof(common::i64));
+                    if (row == 0 || time_ns < block->min_time_ns)
+                    {
+                        block->min_time_ns = time_ns;
+                    }
+                    if (row == 0 || time_ns > block->max_time_ns)
+                    {
+                        block->max_time_ns = time_ns;
+                    }
+                }
+                return true;
+            }
+
+            template <typename T>
+            void Store(TickColumn column, T value)
+            {
+                size_t c = static_cast<size_t>(column);
+                if (column_mask_ & (1u << c))
+                {
+                    std::memcpy(block_ + column_offsets_[c] + rows_in_block_ * sizeof(T), &value, sizeof(T));
+                }
+            }
+
+            // Extend the file by one block and map it in place of the full one
+            bool NextBlock()
+            {
+                if (block_)
+                {
+                    Flush();
+                    munmap(block_, block_size_);
+                    block_ = nullptr;
+                }
+
+                off_t offset = static_cast<off_t>(data_offset_ + block_count_ * block_size_);
+                if (ftruncate(fd_, offset + static_cast<off_t>(block_size_)) < 0)
+                {
+                    FMT_PRINT("Failed to extend %s: %s\n", GetTickFileName(type_).c_str(), strerror(errno));
+                    return false;
+                }
+                void *mapping = mmap(nullptr, block_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, offset);
+                if (mapping == MAP_FAILED)
+                {
+                    FMT_PRINT("Failed to map %s: %s\n", GetTickFileName(type_).c_str(), strerror(errno));
+                    return false;
+                }
+
+                // The new pages read as zero; only first_row needs setting
+                block_ = static_cast<char *>(mapping);
+                reinterpret_cast<TickBlockHeader *>(block_)->first_row = row_count_;
+                block_count_++;
+                rows_in_block_ = 0;
+                published_in_block_ = 0;
+                return true;
+            }
+
+            bool WriteHeader()
+            {
+                TickFileHeader header;
+                std::memset(&header, 0, sizeof(header));
+                std::memcpy(header.magic, TICK_FILE_MAGIC, sizeof(header.magic));
+                header.version = constants::TICK_STORE_VERSION;
+                header.message_type = static_cast<common::u8>(type_);
+                header.column_mask = column_mask_;
+                header.block_rows = block_rows_;
+                header.block_size = block_size_;
+                header.data_offset = data_offset_;
+                header.block_count = block_count_;
+                header.row_count = row_count_ - (rows_in_block_ - published_in_block_);
+                if (!WriteAt(fd_, &header, sizeof(header), 0))
+                {
+                    FMT_PRINT("Failed to write %s: %s\n", GetTickFileName(type_).c_str(), strerror(errno));
+                    return false;
+                }
+                return true;
+            }
+
+            MessageType type_;
+            common::u32 column_mask_;
+            common::u32 block_rows_;
+            size_t block_size_;
+            size_t data_offset_;
+            size_t column_offsets_[TICK_COLUMN_COUNT];
+            int fd_;
+            int index_fd_;
+            char *block_;
+            common::u64 block_count_;
+            common::u32 rows_in_block_;
+            common::u32 published_in_block_;
+            common::u64 row_count_;
+        };
+
+        TickStoreWriter::TickStoreWriter(common::u32 block_rows)
+            : block_rows_(block_rows < 8 ? 8 : (block_rows + 7) / 8 * 8), open_(false), symbols_fd_(-1)
+        {
+        }
+
+        TickStoreWriter::~TickStoreWriter()
+        {
+            Close();
+        }
+
+        bool TickStoreWriter::Open(const std::string &directory)
+        {
+            Close();
+
+            if (mkdir(directory.c_str(), 0755) < 0 && errno != EEXIST)
+            {
+                FMT_PRINT("Failed to create tick store %s: %s\n", directory.c_str(), strerror(errno));
+                return false;
+            }
+
+            // Symbols are numbered per store: start from the ones already in it
+            if (!LoadSymbols(directory))
+            {
+                Close();
+                return false;
+            }
+
+            for (size_t t = 0; t < constants::MESSAGE_TYPE_COUNT; ++t)
+            {
+                files_[t].reset(new ColumnFile(static_cast<MessageType>(t), block_rows_));
+                if (!files_[t]->Open(directory))
+                {
+                    Close();
+                    return false;
+                }
+            }
+
+            open_ = true;
+            return true;
+        }
+
+        bool TickStoreWriter::LoadSymbols(const std::string &directory)
+        {
+            symbols_.reset(new SymbolIndex());
+            size_t size = 0;
+            symbols_fd_ = OpenFile(directory + "/" + TICK_SYMBOLS_FILE, &size);
+            if (symbols_fd_ < 0)
+            {
+                return false;
+            }
+
+            // A product id cut short by a crash was never referenced by a published row
+            std::vector<char> ids(size / constants::PRODUCT_ID_SIZE * constants::PRODUCT_ID_SIZE);
+            if (!ids.empty() && pread(symbols_fd_, ids.data(), ids.size(), 0) != static_cast<ssize_t>(ids.size()))
+            {
+                FMT_PRINT("Failed to read tick store symbols: %s\n", strerror(errno));
+                return false;
+            }
+            for (size_t offset = 0; offset < ids.size(); offset += constants::PRODUCT_ID_SIZE)
+            {
+                if (symbols_->Insert(&ids[offset]) != offset / constants::PRODUCT_ID_SIZE)
+                {
+                    FMT_PRINT("Tick store symbols are duplicated or too many\n");
+                    return false;
+                }
+            }
+            return ids.size() == size || ftruncate(symbols_fd_, static_cast<off_t>(ids.size())) == 0;
+        }
+
+        common::u32 TickStoreWriter::GetSymbol(const char *product_id)
+        {
+            common::u32 symbol = symbols_->Find(product_id);
+            if (symbol != constants::INVALID_SYMBOL)
+            {
+                return symbol;
+            }
+
+            symbol = symbols_->Insert(product_id);
+            if (symbol == constants::INVALID_SYMBOL)
+            {
+                return symbol;
+            }
+
+            // Written before any row refers to it
+            if (!WriteAt(symbols_fd_, product_id, constants::PRODUCT_ID_SIZE,
+                         static_cast<off_t>(symbol) * static_cast<off_t>(constants::PRODUCT_ID_SIZE)))
+            {
+                FMT_PRINT("Failed to write tick store symbol: %s\n", strerror(errno));
+            }
+            return symbol;
+        }
+
+        bool TickStoreWriter::Append(const NormalizedMessage &message)
+        {
+            size_t type = static_cast<size_t>(message.type);
+            if (!open_ || type >= constants::MESSAGE_TYPE_COUNT)
+            {
+                return false;
+            }
+
+            common::u32 symbol = GetSymbol(message.product_id);
+            if (symbol == constants::INVALID_SYMBOL)
+            {
+                return false;
+            }
+            return files_[type]->Append(message, symbol);
+        }
+
+        void TickStoreWriter::Flush()
+        {
+            if (!open_)
+            {
+                return;
+            }
+            for (size_t t = 0; t < constants::MESSAGE_TYPE_COUNT; ++t)
+            {
+                files_[t]->Flush();
+            }
+        }
+
+        void TickStoreWriter::Close()
+        {
+            for (size_t t = 0; t < constants::MESSAGE_TYPE_COUNT; ++t)
+            {
+                files_[t].reset();
+            }
+            if (symbols_fd_ >= 0)
+            {
+                close(symbols_fd_);
+                symbols_fd_ = -1;
+            }
+            open_ = false;
+        }
+
+        common::u64 TickStoreWriter::GetRowCount(MessageType type) const
+        {
+            size_t t = static_cast<size_t>(type);
+            return t < constants::MESSAGE_TYPE_COUNT && files_[t] ? files_[t]->GetRowCount() : 0;
+        }
+
+        TickStoreSink::TickStoreSink(const std::string &directory, size_t queue_capacity, common::u32 block_rows)
+            : directory_(directory), queue_(queue_capacity), writer_(block_rows), thread_(),
+              running_(false), started_(false), written_(0), dropped_(0)
+        {
+        }
+
+        TickStoreSink::~TickStoreSink()
+        {
+            Stop();
+        }
+
+        bool TickStoreSink::Start()
+        {
+            if (started_)
+            {
+                return true;
+            }
+
+            if (!writer_.Open(directory_))
+            {
+                return false;
+            }
+
+            running_.store(true, std::memory_order_release);
+            if (pthread_create(&thread_, nullptr, WriterThreadFunction, this) != 0)
+            {
+                FMT_PRINT("Failed to start tick store writer\n");
+                running_.store(false, std::memory_order_release);
+                writer_.Close();
+                return false;
+            }
+
+            started_ = true;
+            return true;
+        }
+
+        void TickStoreSink::Stop()
+        {
+            if (!started_)
+            {
+                return;
+            }
+
+            // The writer drains the queue before exiting
+            running_.store(false, std::memory_order_release);
+            pthread_join(thread_, nullptr);
+            writer_.Close();
+            started_ = false;
+        }
+
+        void TickStoreSink::OnMessage(const NormalizedMessage &message)
+        {
+            // Never wait for the disk: a full queue costs the message, not latency
+            if (!queue_.TryPush(message))
+            {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                utils::GetMetrics().Add(utils::Counter::TICK_STORE_DROPS);
+            }
+        }
+
+        void *TickStoreSink::WriterThreadFunction(void *arg)
+        {
+            static_cast<TickStoreSink *>(arg)->RunWriter();
+            return nullptr;
+        }
+
+        void TickStoreSink::RunWriter()
+        {
+            NormalizedMessage message;
+            core::Backoff backoff;
+            bool pending_flush = false;
+
+            while (true)
+            {
+                if (queue_.TryPop(&message))
+                {
+                    if (writer_.Append(message))
+                    {
+                        written_.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    else
+                    {
+                        dropped_.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    pending_flush = true;
+                    backoff.Reset();
+                    continue;
+                }
+
+                // Queue drained: publish the rows to readers
+                if (pending_flush)
+                {
+                    writer_.Flush();
+                    pending_flush = false;
+                }
+
+                if (!running_.load(std::memory_order_acquire))
+                {
+                    // Pick up anything pushed between the last pop and the stop request
+                    if (queue_.IsEmpty())
+                    {
+                        break;
+                    }
+                    continue;
+                }
+
+                backoff.Pause();
+            }
+        }
+
+        TickStoreReader::TickStoreReader()
+        {
+        }
+
+        TickStoreReader::~TickStoreReader()
+        {
+            Close();
+        }
+
+        bool TickStoreReader::Open(const std::string &directory)
+        {
+            Close();
+
+            if (!LoadSymbols(directory))
+            {
+                return false;
+            }
+            for (size_t t = 0; t < constants::MESSAGE_TYPE_COUNT; ++t)
+            {
+                if (!OpenType(directory, static_cast<MessageType>(t)))
+                {
+                    Close();
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool TickStoreReader::LoadSymbols(const std::string &directory)
+        {
+            std::string path = directory + "/" + TICK_SYMBOLS_FILE;
+            int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                FMT_PRINT("Failed to open tick store %s: %s\n", directory.c_str(), strerror(errno));
+                return false;
+            }
+
+            // Symbols are small and written one by one, so a copy is simpler than a mapping
+            char product_id[constants::PRODUCT_ID_SIZE];
+            off_t offset = 0;
+            while (pread(fd, product_id, sizeof(product_id), offset) == static_cast<ssize_t>(sizeof(product_id)))
+            {
+                std::string key(product_id, sizeof(product_id));
+                symbols_[key] = static_cast<common::u32>(product_ids_.size());
+                product_ids_.push_back(key);
+                offset += static_cast<off_t>(sizeof(product_id));
+            }
+            close(fd);
+            return true;
+        }
+
+        bool TickStoreReader::OpenType(const std::string &directory, MessageType type)
+        {
+            TypeFile &file = files_[static_cast<size_t>(type)];
+            std::string path = directory + "/" + GetTickFileName(type);
+            file.mapping = MapFile(path, &file.mapping_size);
+            if (!file.mapping || file.mapping_size < sizeof(TickFileHeader))
+            {
+                FMT_PRINT("Tick file %s is missing or truncated\n", path.c_str());
+                return false;
+            }
+
+            std::memcpy(&file.header, file.mapping, sizeof(file.header));
+            const TickFileHeader &header = file.header;
+            if (std::memcmp(header.magic, TICK_FILE_MAGIC, sizeof(header.magic)) != 0 ||
+                header.version != constants::TICK_STORE_VERSION ||
+                header.message_type != static_cast<common::u8>(type) ||
+                header.column_mask != GetTickColumnMask(type) ||
+                header.block_rows == 0 ||
+                header.block_size < GetTickColumnOffset(header.column_mask, header.block_rows, TickColumn::COUNT))
+            {
+                FMT_PRINT("Tick file %s has an incompatible format\n", path.c_str());
+                return false;
+            }
+
+            // The header is written after the index, so every block it counts has an entry
+            size_t index_size = 0;
+            const char *index = MapFile(directory + "/" + GetTickIndexName(type), &index_size);
+            size_t blocks = std::min<size_t>(index_size / sizeof(TickIndexEntry), header.block_count);
+            if (header.data_offset < file.mapping_size)
+            {
+                blocks = std::min<size_t>(blocks, (file.mapping_size - header.data_offset) / header.block_size);
+            }
+            else
+            {
+                blocks = 0;
+            }
+
+            file.index.reserve(blocks);
+            for (size_t b = 0; b < blocks; ++b)
+            {
+                TickIndexEntry entry = Load<TickIndexEntry>(index + b * sizeof(TickIndexEntry));
+                if (entry.first_row >= header.row_count)
+                {
+                    break;
+                }
+
+                // Rows published after the header was read are left out
+                entry.row_count = static_cast<common::u32>(
+                    std::min<common::u64>(entry.row_count, header.row_count - entry.first_row));
+                entry.row_count = std::min(entry.row_count, header.block_rows);
+                file.index.push_back(entry);
+            }
+            if (index)
+            {
+                munmap(const_cast<char *>(index), index_size);
+            }
+
+            // Both are monotonic, so the blocks a time range can touch are found by binary search
+            file.running_max.resize(file.index.size());
+            file.remaining_min.resize(file.index.size());
+            for (size_t b = 0; b < file.index.size(); ++b)
+            {
+                file.running_max[b] = b == 0 ? file.index[b].max_time_ns
+                                             : std::max(file.running_max[b - 1], file.index[b].max_time_ns);
+            }
+            for (size_t b = file.index.size(); b-- > 0;)
+            {
+                file.remaining_min[b] = b + 1 == file.index.size()
+                                            ? file.index[b].min_time_ns
+                                            : std::min(file.remaining_min[b + 1], file.index[b].min_time_ns);
+            }
+            return true;
+        }
+
+        void TickStoreReader::Close()
+        {
+            for (size_t t = 0; t < constants::MESSAGE_TYPE_COUNT; ++t)
+            {
+                TypeFile &file = files_[t];
+                if (file.mapping)
+                {
+                    munmap(const_cast<char *>(file.mapping), file.mapping_size);
+                }
+                file = TypeFile();
+            }
+            product_ids_.clear();
+            symbols_.clear();
+        }
+
+        common::u32 TickStoreReader::Find(const char *product_id) const
+        {
+            std::unordered_map<std::string, common::u32>::const_iterator it =
+                symbols_.find(std::string(product_id, constants::PRODUCT_ID_SIZE));
+            return it != symbols_.end() ? it->second : constants::INVALID_SYMBOL;
+        }
+
+        std::vector<common::u32> TickStoreReader::FindPrefix(const std::string &prefix) const
+        {
+            std::vector<common::u32> symbols;
+            for (size_t s = 0; s < product_ids_.size(); ++s)
+            {
+                if (product_ids_[s].compare(0, prefix.size(), prefix) == 0)
+                {
+                    symbols.push_back(static_cast<common::u32>(s));
+                }
+            }
+            return symbols;
+        }
+
+        bool TickStoreReader::GetProductId(common::u32 symbol, char *product_id) const
+        {
+            if (symbol >= product_ids_.size())
+            {
+                return false;
+            }
+            std::memcpy(product_id, product_ids_[symbol].data(), constants::PRODUCT_ID_SIZE);
+            return true;
+        }
+
+        common::u64 TickStoreReader::GetRowCount(MessageType type) const
+        {
+            size_t t = static_cast<size_t>(type);
+            return t < constants::MESSAGE_TYPE_COUNT ? files_[t].header.row_count : 0;
+        }
+
+        size_t TickStoreReader::Query(const TickQuery &query, std::vector<NormalizedMessage> *messages,
+                                      TickQueryStats *stats) const
+        {
+            TickQueryStats local;
+            TickQueryStats &work = stats ? *stats : local;
+            work = TickQueryStats();
+
+            size_t t = static_cast<size_t>(query.type);
+            if (t >= constants::MESSAGE_TYPE_COUNT || !files_[t].mapping || query.begin_ns >= query.end_ns)
+            {
+                return 0;
+            }
+            const TypeFile &file = files_[t];
+            const TickFileHeader &header = file.header;
+            work.blocks = file.index.size();
+
+            // Symbols to keep, by store symbol
+            bool all_symbols = query.symbols.empty();
+            std::vector<bool> wanted(all_symbols ? 0 : product_ids_.size(), false);
+            for (size_t i = 0; i < query.symbols.size(); ++i)
+            {
+                if (query.symbols[i] < wanted.size())
+                {
+                    wanted[query.symbols[i]] = true;
+                }
+            }
+
+            // Blocks before first end before the range, blocks from last on start after it
+            size_t first = static_cast<size_t>(
+                std::lower_bound(file.running_max.begin(), file.running_max.end(), query.begin_ns) -
+                file.running_max.begin());
+            size_t last = static_cast<size_t>(
+                std::lower_bound(file.remaining_min.begin(), file.remaining_min.end(), query.end_ns) -
+                file.remaining_min.begin());
+
+            size_t time_offset = GetTickColumnOffset(header.column_mask, header.block_rows, TickColumn::TIME);
+            size_t symbol_offset = GetTickColumnOffset(header.column_mask, header.block_rows, TickColumn::SYMBOL);
+            size_t offsets[TICK_COLUMN_COUNT];
+            for (size_t c = 0; c < TICK_COLUMN_COUNT; ++c)
+            {
+                offsets[c] = GetTickColumnOffset(header.column_mask, header.block_rows, static_cast<TickColumn>(c));
+            }
+            bool has_price = (header.column_mask & Bit(TickColumn::PRICE)) != 0;
+            bool has_quantity = (header.column_mask & Bit(TickColumn::QUANTITY)) != 0;
+            bool has_book = (header.column_mask & Bit(TickColumn::BID_PRICE)) != 0;
+
+            size_t matched = 0;
+            for (size_t b = first; b < last; ++b)
+            {
+                const TickIndexEntry &entry = file.index[b];
+                if (entry.max_time_ns < query.begin_ns || entry.min_time_ns >= query.end_ns)
+                {
+                    continue;
+                }
+                work.blocks_read++;
+                work.rows_read += entry.row_count;
+
+                const char *block = file.mapping + header.data_offset + static_cast<size_t>(entry.block) * header.block_size;
+                const char *times = block + time_offset;
+                const char *symbols = block + symbol_offset;
+                for (size_t r = 0; r < entry.row_count; ++r)
+                {
+                    common::i64 time_ns = Load<common::i64>(times + r * sizeof(common::i64));
+                    if (time_ns < query.begin_ns || time_ns >= query.end_ns)
+                    {
+                        continue;
+                    }
+                    common::u32 symbol = Load<common::u32>(symbols + r * sizeof(common::u32));
+                    if (!all_symbols && (symbol >= wanted.size() || !wanted[symbol]))
+                    {
+                        continue;
+                    }
+
+                    NormalizedMessage message;
+                    std::memset(&message, 0, sizeof(message));
+                    message.information_time = NsToInformationTime(time_ns);
+                    message.information_time_ns = time_ns;
+                    message.information_seq = Load<common::u32>(block + offsets[static_cast<size_t>(TickColumn::SEQ)] +
+                                                                r * sizeof(common::u32));
+                    message.symbol = symbol;
+                    GetProductId(symbol, message.product_id);
+                    message.type = query.type;
+                    message.price_scale = Load<common::u8>(block + offsets[static_cast<size_t>(TickColumn::PRICE_SCALE)] + r);
+                    if (has_price)
+                    {
+                        message.price = Load<common::i64>(block + offsets[static_cast<size_t>(TickColumn::PRICE)] +
+                                                          r * sizeof(common::i64));
+                    }
+                    if (has_quantity)
+                    {
+                        message.quantity = Load<common::i64>(block + offsets[static_cast<size_t>(TickColumn::QUANTITY)] +
+                                                             r * sizeof(common::i64));
+                    }
+                    if (has_book)
+                    {
+                        size_t row = r * sizeof(common::i64);
+                        message.bid_price = Load<common::i64>(block + offsets[static_cast<size_t>(TickColumn::BID_PRICE)] + row);
+                        message.bid_quantity = Load<common::i64>(block + offsets[static_cast<size_t>(TickColumn::BID_QUANTITY)] + row);
+                        message.ask_price = Load<common::i64>(block + offsets[static_cast<size_t>(TickColumn::ASK_PRICE)] + row);
+                        message.ask_quantity = Load<common::i64>(block + offsets[static_cast<size_t>(TickColumn::ASK_QUANTITY)] + row);
+                    }
+                    messages->push_back(message);
+                    matched++;
+                }
+            }
+            work.rows_matched = matched;
+            return matched;
+        }
+
+    } // namespace processing
+} // namespace stream_buffer
@@ -0,0 +1,106 @@
+#include "utils/checksum.h"
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace stream_buffer
+{
+    namespace utils
+    {
+        namespace
+        {
+            constexpr size_t BLOCK_SIZE = 64; // Bytes consumed per vector loop iteration
+
+            // Fold a 64-bit word down to the XOR of its bytes
+            inline uint8_t fold_word(uint64_t word)
+            {
+                word ^= word >> 32;
+                word ^= word >> 16;
+                word ^= word >> 8;
+                return static_cast<uint8_t>(word);
+            }
+
+#if defined(__AVX2__)
+            uint64_t xor_blocks(const uint8_t *bytes, size_t blocks)
+            {
+                __m256i acc0 = _mm256_setzero_si256();
+                __m256i acc1 = _mm256_setzero_si256();
+                for (size_t i = 0; i < blocks; ++i)
+                {
+                    const uint8_t *block = bytes + i * BLOCK_SIZE;
+                    acc0 = _mm256_xor_si256(acc0, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block)));
+                    acc1 = _mm256_xor_si256(acc1, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + 32)));
+                }
+                __m256i acc = _mm256_xor_si256(acc0, acc1);
+                __m128i half = _mm_xor_si128(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+                half = _mm_xor_si128(half, _mm_srli_si128(half, 8));
+                return static_cast<uint64_t>(_mm_cvtsi128_si64(half));
+            }
+#elif defined(__SSE2__)
+            uint64_t xor_blocks(const uint8_t *bytes, size_t blocks)
+            {
+                __m128i acc0 = _mm_setzero_si128();
+                __m128i acc1 = _mm_setzero_si128();
+                __m128i acc2 = _mm_setzero_si128();
+                __m128i acc3 = _mm_setzero_si128();
+                for (size_t i = 0; i < blocks; ++i)
+                {
+                    const __m128i *block = reinterpret_cast<const __m128i *>(bytes + i * BLOCK_SIZE);
+                    acc0 = _mm_xor_si128(acc0, _mm_loadu_si128(block));
+                    acc1 = _mm_xor_si128(acc1, _mm_loadu_si128(block + 1));
+                    acc2 = _mm_xor_si128(acc2, _mm_loadu_si128(block + 2));
+                    acc3 = _mm_xor_si128(acc3, _mm_loadu_si128(block + 3));
+                }
+                __m128i acc = _mm_xor_si128(_mm_xor_si128(acc0, acc1), _mm_xor_si128(acc2, acc3));
+                acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 8));
+                return static_cast<uint64_t>(_mm_cvtsi128_si64(acc));
+            }
+#else
+            uint64_t xor_blocks(const uint8_t *bytes, size_t blocks)
+            {
+                uint64_t acc = 0;
+                for (size_t i = 0; i < blocks * BLOCK_SIZE; i += sizeof(uint64_t))
+                {
+                    uint64_t word;
+                    std::memcpy(&word, bytes + i, sizeof(word));
+                    acc ^= word;
+                }
+                return acc;
+            }
+#endif
+        } // anonymous namespace
+
+        uint8_t xor_checksum(const void *data, size_t length)
+        {
+            if (!data || length == 0)
+            {
+                return 0;
+            }
+
+            const uint8_t *bytes = static_cast<const uint8_t *>(data);
+            size_t blocks = length / BLOCK_SIZE;
+            uint64_t acc = blocks > 0 ? xor_blocks(bytes, blocks) : 0;
+
+            // Scalar tail: whole words, then the last few bytes
+            size_t pos = blocks * BLOCK_SIZE;
+            for (; pos + sizeof(uint64_t) <= length; pos += sizeof(uint64_t))
+            {
+                uint64_t word;
+                std::memcpy(&word, bytes + pos, sizeof(word));
+                acc ^= word;
+            }
+
+            uint8_t checksum = fold_word(acc);
+            for (; pos < length; ++pos)
+            {
+                checksum ^= bytes[pos];
+            }
+            return checksum;
+        }
+
+    } // namespace utils
+} // namespace stream_buffer
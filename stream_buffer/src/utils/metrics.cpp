@@ -0,0 +1,182 @@
+#include "utils/metrics.h"
+#include <cstdio>
+
+namespace stream_buffer
+{
+    namespace utils
+    {
+        namespace
+        {
+            const char *const COUNTER_NAMES[COUNTER_COUNT] = {
+                "packets_received",
+                "bytes_received",
+                "messages_i010",
+                "messages_trade",
+                "messages_quote",
+                "messages_other",
+                "resyncs",
+                "resync_bytes",
+                "checksum_failures",
+                "compactions",
+                "shard_backpressure",
+                "tick_store_drops",
+                "quote_snapshot_overflows",
+                "conflation_overflows"};
+
+            const char *const GAUGE_NAMES[GAUGE_COUNT] = {
+                "buffer_queued_bytes",
+                "buffer_capacity_bytes",
+                "shard_queue_depth",
+                "fanout_lag"};
+
+            const char *const HISTOGRAM_NAMES[HISTOGRAM_COUNT] = {
+                "datagram_bytes",
+                "batch_messages"};
+
+            std::atomic<common::u64> next_registry_id(1);
+        } // anonymous namespace
+
+        const char *GetMetricName(Counter counter)
+        {
+            return COUNTER_NAMES[static_cast<size_t>(counter)];
+        }
+
+        const char *GetMetricName(Gauge gauge)
+        {
+            return GAUGE_NAMES[static_cast<size_t>(gauge)];
+        }
+
+        const char *GetMetricName(Histogram histogram)
+        {
+            return HISTOGRAM_NAMES[static_cast<size_t>(histogram)];
+        }
+
+        common::u64 HistogramSnapshot::GetQuantile(double quantile) const
+        {
+            if (count == 0)
+            {
+                return 0;
+            }
+
+            common::u64 rank = static_cast<common::u64>(quantile * static_cast<double>(count));
+            common::u64 seen = 0;
+            for (size_t i = 0; i < constants::HISTOGRAM_BUCKETS; ++i)
+            {
+                seen += buckets[i];
+                if (seen > rank || seen == count)
+                {
+                    // Bucket i holds values below 2^i
+                    return i == 0 ? 0 : (1ULL << i) - 1;
+                }
+            }
+            return ~0ULL;
+        }
+
+        std::string MetricsSnapshot::Format() const
+        {
+            std::string text;
+            char line[256];
+            for (size_t i = 0; i < COUNTER_COUNT; ++i)
+            {
+                std::snprintf(line, sizeof(line), "counter %s %llu\n", COUNTER_NAMES[i],
+                              static_cast<unsigned long long>(counters[i]));
+                text += line;
+            }
+            for (size_t i = 0; i < GAUGE_COUNT; ++i)
+            {
+                std::snprintf(line, sizeof(line), "gauge %s %lld\n", GAUGE_NAMES[i],
+                              static_cast<long long>(gauges[i]));
+                text += line;
+            }
+            for (size_t i = 0; i < HISTOGRAM_COUNT; ++i)
+            {
+                const HistogramSnapshot &histogram = histograms[i];
+                std::snprintf(line, sizeof(line), "histogram %s count=%llu sum=%llu p50=%llu p99=%llu max=%llu\n",
+                              HISTOGRAM_NAMES[i],
+                              static_cast<unsigned long long>(histogram.count),
+                              static_cast<unsigned long long>(histogram.sum),
+                              static_cast<unsigned long long>(histogram.GetQuantile(0.50)),
+                              static_cast<unsigned long long>(histogram.GetQuantile(0.99)),
+                              static_cast<unsigned long long>(histogram.GetQuantile(1.0)));
+                text += line;
+            }
+            return text;
+        }
+
+        MetricsRegistry::MetricsRegistry()
+            : id_(next_registry_id.fetch_add(1, std::memory_order_relaxed)),
+              blocks_(new ThreadBlock[constants::MAX_METRIC_THREADS]),
+              claimed_blocks_(0)
+        {
+            for (size_t b = 0; b < constants::MAX_METRIC_THREADS; ++b)
+            {
+                ThreadBlock &block = blocks_[b];
+                for (size_t i = 0; i < COUNTER_COUNT; ++i)
+                {
+                    block.counters[i].store(0, std::memory_order_relaxed);
+                }
+                for (size_t h = 0; h < HISTOGRAM_COUNT; ++h)
+                {
+                    block.histograms[h].count.store(0, std::memory_order_relaxed);
+                    block.histograms[h].sum.store(0, std::memory_order_relaxed);
+                    for (size_t i = 0; i < constants::HISTOGRAM_BUCKETS; ++i)
+                    {
+                        block.histograms[h].buckets[i].store(0, std::memory_order_relaxed);
+                    }
+                }
+                block.shared = b == constants::MAX_METRIC_THREADS - 1;
+            }
+            for (size_t i = 0; i < GAUGE_COUNT; ++i)
+            {
+                gauges_[i].value.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        MetricsRegistry::~MetricsRegistry() = default;
+
+        MetricsRegistry::ThreadBlock *MetricsRegistry::ClaimBlock()
+        {
+            size_t index = claimed_blocks_.fetch_add(1, std::memory_order_relaxed);
+            if (index >= constants::MAX_METRIC_THREADS - 1)
+            {
+                return &blocks_[constants::MAX_METRIC_THREADS - 1];
+            }
+            return &blocks_[index];
+        }
+
+        MetricsSnapshot MetricsRegistry::Snapshot() const
+        {
+            MetricsSnapshot snapshot;
+            for (size_t b = 0; b < constants::MAX_METRIC_THREADS; ++b)
+            {
+                const ThreadBlock &block = blocks_[b];
+                for (size_t i = 0; i < COUNTER_COUNT; ++i)
+                {
+                    snapshot.counters[i] += block.counters[i].load(std::memory_order_relaxed);
+                }
+                for (size_t h = 0; h < HISTOGRAM_COUNT; ++h)
+                {
+                    HistogramSnapshot &target = snapshot.histograms[h];
+                    target.count += block.histograms[h].count.load(std::memory_order_relaxed);
+                    target.sum += block.histograms[h].sum.load(std::memory_order_relaxed);
+                    for (size_t i = 0; i < constants::HISTOGRAM_BUCKETS; ++i)
+                    {
+                        target.buckets[i] += block.histograms[h].buckets[i].load(std::memory_order_relaxed);
+                    }
+                }
+            }
+            for (size_t i = 0; i < GAUGE_COUNT; ++i)
+            {
+                snapshot.gauges[i] = gauges_[i].value.load(std::memory_order_relaxed);
+            }
+            return snapshot;
+        }
+
+        MetricsRegistry &GetMetrics()
+        {
+            static MetricsRegistry registry;
+            return registry;
+        }
+
+    } // namespace utils
+} // namespace stream_buffer
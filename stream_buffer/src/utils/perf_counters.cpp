@@ -0,0 +1,304 @@
+#include "utils/perf_counters.h"
+#include "utils/debug.h"
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+namespace stream_buffer
+{
+    namespace utils
+    {
+        namespace
+        {
+            const char *const EVENT_NAMES[PERF_EVENT_COUNT] = {
+                "task_ns",
+                "cycles",
+                "instructions",
+                "cache_misses",
+                "branch_misses"};
+
+            const char *const SCOPE_NAMES[PERF_SCOPE_COUNT] = {
+                "receive",
+                "i010",
+                "trade",
+                "quote",
+                "other",
+                "skipped"};
+
+            const common::u32 ALL_EVENTS = (1U << PERF_EVENT_COUNT) - 1;
+
+            int OpenEvent(common::u32 type, common::u64 config, int group_fd)
+            {
+                perf_event_attr attr;
+                std::memset(&attr, 0, sizeof(attr));
+                attr.size = sizeof(attr);
+                attr.type = type;
+                attr.config = config;
+                attr.exclude_kernel = 1; // Allowed with perf_event_paranoid up to 2
+                attr.exclude_hv = 1;
+                attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                                   PERF_FORMAT_TOTAL_TIME_RUNNING;
+                attr.disabled = group_fd < 0 ? 1 : 0; // The leader starts the whole group
+
+                // Calling thread, any CPU
+                return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0));
+            }
+
+            double Ratio(common::u64 value, common::u64 per)
+            {
+                return per == 0 ? 0.0 : static_cast<double>(value) / static_cast<double>(per);
+            }
+        } // anonymous namespace
+
+        const char *GetPerfEventName(PerfEvent event)
+        {
+            return EVENT_NAMES[static_cast<size_t>(event)];
+        }
+
+        const char *GetPerfScopeName(PerfScope scope)
+        {
+            return SCOPE_NAMES[static_cast<size_t>(scope)];
+        }
+
+        PerfCounterGroup::PerfCounterGroup()
+            : member_count_(0), leader_fd_(-1)
+        {
+            for (size_t i = 0; i < PERF_EVENT_COUNT; ++i)
+            {
+                fds_[i] = -1;
+                positions_[i] = 0;
+            }
+        }
+
+        PerfCounterGroup::~PerfCounterGroup()
+        {
+            Close();
+        }
+
+        bool PerfCounterGroup::Open()
+        {
+            Close();
+
+            static const common::u32 TYPES[PERF_EVENT_COUNT] = {
+                PERF_TYPE_SOFTWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+                PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE};
+            static const common::u64 CONFIGS[PERF_EVENT_COUNT] = {
+                PERF_COUNT_SW_TASK_CLOCK, PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+            leader_fd_ = OpenEvent(TYPES[0], CONFIGS[0], -1);
+            if (leader_fd_ < 0)
+            {
+                FMT_PRINT("perf_event_open failed: %s\n", strerror(errno));
+                return false;
+            }
+            fds_[0] = leader_fd_;
+            positions_[0] = 0;
+            member_count_ = 1;
+
+            // Virtual machines often expose no hardware counters at all
+            for (size_t i = 1; i < PERF_EVENT_COUNT; ++i)
+            {
+                fds_[i] = OpenEvent(TYPES[i], CONFIGS[i], leader_fd_);
+                if (fds_[i] >= 0)
+                {
+                    positions_[i] = member_count_++;
+                }
+            }
+
+            ioctl(leader_fd_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(leader_fd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+            return true;
+        }
+
+        void PerfCounterGroup::Close()
+        {
+            for (size_t i = 0; i < PERF_EVENT_COUNT; ++i)
+            {
+                if (fds_[i] >= 0)
+                {
+                    close(fds_[i]);
+                    fds_[i] = -1;
+                }
+            }
+            member_count_ = 0;
+            leader_fd_ = -1;
+        }
+
+        common::u32 PerfCounterGroup::GetEventMask() const
+        {
+            common::u32 mask = 0;
+            for (size_t i = 0; i < PERF_EVENT_COUNT; ++i)
+            {
+                if (fds_[i] >= 0)
+                {
+                    mask |= 1U << i;
+                }
+            }
+            return mask;
+        }
+
+        bool PerfCounterGroup::Read(PerfSample *sample) const
+        {
+            if (leader_fd_ < 0)
+            {
+                return false;
+            }
+
+            // PERF_FORMAT_GROUP layout: nr, time_enabled, time_running, values[nr]
+            common::u64 buffer[3 + PERF_EVENT_COUNT];
+            ssize_t size = read(leader_fd_, buffer, sizeof(buffer));
+            if (size < static_cast<ssize_t>(3 * sizeof(common::u64)) || buffer[0] != member_count_)
+            {
+                return false;
+            }
+
+            // Extrapolate when other groups shared the counters
+            common::u64 enabled = buffer[1];
+            common::u64 running = buffer[2];
+            double scale = running > 0 && running < enabled ? Ratio(enabled, running) : 1.0;
+            for (size_t i = 0; i < PERF_EVENT_COUNT; ++i)
+            {
+                common::u64 value = fds_[i] >= 0 ? buffer[3 + positions_[i]] : 0;
+                sample->values[i] = scale == 1.0 ? value : static_cast<common::u64>(value * scale);
+            }
+            return true;
+        }
+
+        PerfProfiler::PerfProfiler()
+            : event_mask_(ALL_EVENTS), recorded_(false)
+        {
+            for (size_t i = 0; i < PERF_SCOPE_COUNT; ++i)
+            {
+                cells_[i].count.store(0, std::memory_order_relaxed);
+                cells_[i].bytes.store(0, std::memory_order_relaxed);
+                for (size_t j = 0; j < PERF_EVENT_COUNT; ++j)
+                {
+                    cells_[i].events[j].store(0, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        void PerfProfiler::Add(PerfScope scope, const PerfSample &delta, common::u64 bytes, common::u32 event_mask)
+        {
+            // Only events every thread counts are comparable across scopes
+            recorded_.store(true, std::memory_order_relaxed);
+            event_mask_.fetch_and(event_mask, std::memory_order_relaxed);
+
+            ScopeCell &cell = cells_[static_cast<size_t>(scope)];
+            cell.count.fetch_add(1, std::memory_order_relaxed);
+            cell.bytes.fetch_add(bytes, std::memory_order_relaxed);
+            for (size_t i = 0; i < PERF_EVENT_COUNT; ++i)
+            {
+                cell.events[i].fetch_add(delta.values[i], std::memory_order_relaxed);
+            }
+        }
+
+        PerfScopeStats PerfProfiler::GetStats(PerfScope scope) const
+        {
+            const ScopeCell &cell = cells_[static_cast<size_t>(scope)];
+            PerfScopeStats stats;
+            stats.count = cell.count.load(std::memory_order_relaxed);
+            stats.bytes = cell.bytes.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < PERF_EVENT_COUNT; ++i)
+            {
+                stats.events.values[i] = cell.events[i].load(std::memory_order_relaxed);
+            }
+            return stats;
+        }
+
+        common::u32 PerfProfiler::GetEventMask() const
+        {
+            return recorded_.load(std::memory_order_relaxed) ? event_mask_.load(std::memory_order_relaxed) : 0;
+        }
+
+        std::string PerfProfiler::Format() const
+        {
+            std::string text;
+            char line[512];
+            common::u32 mask = GetEventMask();
+
+            for (size_t i = 0; i < PERF_SCOPE_COUNT; ++i)
+            {
+                PerfScopeStats stats = GetStats(static_cast<PerfScope>(i));
+                if (stats.count == 0)
+                {
+                    continue;
+                }
+
+                std::string totals, per_message, per_byte;
+                for (size_t j = 0; j < PERF_EVENT_COUNT; ++j)
+                {
+                    if (!(mask & (1U << j)))
+                    {
+                        continue;
+                    }
+                    common::u64 value = stats.events.values[j];
+                    std::snprintf(line, sizeof(line), " %s=%llu", EVENT_NAMES[j],
+                                  static_cast<unsigned long long>(value));
+                    totals += line;
+                    std::snprintf(line, sizeof(line), " %s=%.1f", EVENT_NAMES[j], Ratio(value, stats.count));
+                    per_message += line;
+                    std::snprintf(line, sizeof(line), " %s=%.3f", EVENT_NAMES[j], Ratio(value, stats.bytes));
+                    per_byte += line;
+                }
+
+                // Instructions per cycle tells compute-bound from stalled code
+                if (mask & (1U << static_cast<size_t>(PerfEvent::CYCLES)) &&
+                    mask & (1U << static_cast<size_t>(PerfEvent::INSTRUCTIONS)))
+                {
+                    std::snprintf(line, sizeof(line), " ipc=%.2f",
+                                  Ratio(stats.events.Get(PerfEvent::INSTRUCTIONS), stats.events.Get(PerfEvent::CYCLES)));
+                    totals += line;
+                }
+
+                std::snprintf(line, sizeof(line), "perf %s count=%llu bytes=%llu%s\n", SCOPE_NAMES[i],
+                              static_cast<unsigned long long>(stats.count),
+                              static_cast<unsigned long long>(stats.bytes), totals.c_str());
+                text += line;
+                std::snprintf(line, sizeof(line), "perf %s per_message%s\n", SCOPE_NAMES[i], per_message.c_str());
+                text += line;
+                std::snprintf(line, sizeof(line), "perf %s per_byte%s\n", SCOPE_NAMES[i], per_byte.c_str());
+                text += line;
+            }
+            return text;
+        }
+
+        PerfRecorder::PerfRecorder(PerfProfiler &profiler)
+            : profiler_(profiler)
+        {
+            if (group_.Open())
+            {
+                Restart();
+            }
+        }
+
+        void PerfRecorder::Restart()
+        {
+            group_.Read(&last_);
+        }
+
+        void PerfRecorder::Checkpoint(PerfScope scope, common::u64 bytes)
+        {
+            PerfSample now;
+            if (!group_.Read(&now))
+            {
+                return;
+            }
+
+            PerfSample delta;
+            for (size_t i = 0; i < PERF_EVENT_COUNT; ++i)
+            {
+                // Multiplexing estimates can step back slightly
+                delta.values[i] = now.values[i] > last_.values[i] ? now.values[i] - last_.values[i] : 0;
+            }
+            profiler_.Add(scope, delta, bytes, group_.GetEventMask());
+            last_ = now;
+        }
+
+    } // namespace utils
+} // namespace stream_buffer
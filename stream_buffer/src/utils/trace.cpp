@@ -0,0 +1,237 @@
+#include "utils/trace.h"
+#include "utils/debug.h"
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+namespace stream_buffer
+{
+    namespace utils
+    {
+        namespace
+        {
+            const char *const EVENT_NAMES[TRACE_EVENT_COUNT] = {
+                "receive",
+                "append",
+                "lock",
+                "compact",
+                "decode",
+                "dispatch"};
+
+            // Argument label per event, nullptr when it has none
+            const char *const ARG_NAMES[TRACE_EVENT_COUNT] = {
+                "bytes",
+                "bytes",
+                nullptr,
+                "bytes",
+                "bytes",
+                "bytes"};
+
+            struct TraceRecord
+            {
+                common::u64 begin;
+                common::u64 end;
+                common::u64 arg;
+                TraceEvent event;
+            };
+
+            struct TraceRing
+            {
+                char name[constants::MAX_TRACE_THREAD_NAME];
+                long thread_id;
+                std::atomic<common::u64> head; // Events ever recorded; only the owner writes
+                TraceRecord records[constants::TRACE_RING_CAPACITY];
+            };
+
+            std::atomic<TraceRing *> rings[constants::MAX_TRACE_THREADS];
+            std::atomic<size_t> claimed_rings(0);
+
+            thread_local TraceRing *current_ring = nullptr;
+            thread_local bool ring_refused = false;
+
+            // The calling thread's ring, claimed on first use
+            TraceRing *GetRing()
+            {
+                if (current_ring || ring_refused)
+                {
+                    return current_ring;
+                }
+
+                size_t index = claimed_rings.fetch_add(1, std::memory_order_relaxed);
+                if (index >= constants::MAX_TRACE_THREADS)
+                {
+                    ring_refused = true;
+                    return nullptr;
+                }
+
+                TraceRing *ring = new TraceRing();
+                std::snprintf(ring->name, sizeof(ring->name), "thread-%zu", index);
+                ring->thread_id = static_cast<long>(syscall(SYS_gettid));
+                ring->head.store(0, std::memory_order_relaxed);
+                rings[index].store(ring, std::memory_order_release);
+                current_ring = ring;
+                return ring;
+            }
+
+            // Rings ever claimed and published
+            size_t GetRingCount()
+            {
+                size_t count = claimed_rings.load(std::memory_order_acquire);
+                return count < constants::MAX_TRACE_THREADS ? count : constants::MAX_TRACE_THREADS;
+            }
+        } // anonymous namespace
+
+        std::atomic<bool> Tracer::enabled_(false);
+
+        const char *GetTraceEventName(TraceEvent event)
+        {
+            return EVENT_NAMES[static_cast<size_t>(event)];
+        }
+
+        void Tracer::Enable(bool enabled)
+        {
+            if (enabled)
+            {
+                GetClock(); // Calibrate before the first event
+            }
+            enabled_.store(enabled, std::memory_order_relaxed);
+        }
+
+        void Tracer::Record(TraceEvent event, common::u64 begin, common::u64 end, common::u64 arg)
+        {
+            TraceRing *ring = GetRing();
+            if (!ring)
+            {
+                return;
+            }
+
+            common::u64 head = ring->head.load(std::memory_order_relaxed);
+            TraceRecord &record = ring->records[head & (constants::TRACE_RING_CAPACITY - 1)];
+            record.begin = begin;
+            record.end = end;
+            record.arg = arg;
+            record.event = event;
+            ring->head.store(head + 1, std::memory_order_release);
+        }
+
+        void Tracer::SetThreadName(const char *name)
+        {
+            // Threads that never record while tracing is on get no ring
+            if (!IsEnabled())
+            {
+                return;
+            }
+
+            TraceRing *ring = GetRing();
+            if (ring)
+            {
+                std::snprintf(ring->name, sizeof(ring->name), "%s", name);
+            }
+        }
+
+        common::u64 Tracer::GetRecordedCount()
+        {
+            common::u64 count = 0;
+            for (size_t i = 0; i < GetRingCount(); ++i)
+            {
+                TraceRing *ring = rings[i].load(std::memory_order_acquire);
+                if (ring)
+                {
+                    count += ring->head.load(std::memory_order_acquire);
+                }
+            }
+            return count;
+        }
+
+        void Tracer::Clear()
+        {
+            for (size_t i = 0; i < GetRingCount(); ++i)
+            {
+                TraceRing *ring = rings[i].load(std::memory_order_acquire);
+                if (ring)
+                {
+                    ring->head.store(0, std::memory_order_release);
+                }
+            }
+        }
+
+        bool Tracer::DumpChromeTrace(const std::string &path)
+        {
+            FILE *file = std::fopen(path.c_str(), "w");
+            if (!file)
+            {
+                FMT_PRINT("Failed to open trace file %s: %s\n", path.c_str(), strerror(errno));
+                return false;
+            }
+
+            // Timestamps are shown relative to the oldest event still held
+            size_t ring_count = GetRingCount();
+            common::u64 origin = ~0ULL;
+            for (size_t i = 0; i < ring_count; ++i)
+            {
+                TraceRing *ring = rings[i].load(std::memory_order_acquire);
+                common::u64 head = ring ? ring->head.load(std::memory_order_acquire) : 0;
+                common::u64 first = head > constants::TRACE_RING_CAPACITY ? head - constants::TRACE_RING_CAPACITY : 0;
+                for (common::u64 j = first; j < head; ++j)
+                {
+                    common::u64 begin = ring->records[j & (constants::TRACE_RING_CAPACITY - 1)].begin;
+                    origin = begin < origin ? begin : origin;
+                }
+            }
+
+            const TscClock &clock = GetClock();
+            common::i64 origin_ns = clock.ToMonotonicNs(origin);
+            long pid = static_cast<long>(getpid());
+            const char *separator = "";
+            std::fprintf(file, "{\"traceEvents\":[\n");
+            for (size_t i = 0; i < ring_count; ++i)
+            {
+                TraceRing *ring = rings[i].load(std::memory_order_acquire);
+                if (!ring)
+                {
+                    continue;
+                }
+
+                std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%ld,\"tid\":%ld,"
+                                   "\"args\":{\"name\":\"%s\"}}",
+                             separator, pid, ring->thread_id, ring->name);
+                separator = ",\n";
+
+                common::u64 head = ring->head.load(std::memory_order_acquire);
+                common::u64 first = head > constants::TRACE_RING_CAPACITY ? head - constants::TRACE_RING_CAPACITY : 0;
+                for (common::u64 j = first; j < head; ++j)
+                {
+                    const TraceRecord &record = ring->records[j & (constants::TRACE_RING_CAPACITY - 1)];
+                    size_t event = static_cast<size_t>(record.event);
+                    if (event >= TRACE_EVENT_COUNT || record.end < record.begin)
+                    {
+                        continue; // Torn by a concurrent write
+                    }
+
+                    std::fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"pipeline\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                                       "\"pid\":%ld,\"tid\":%ld",
+                                 EVENT_NAMES[event], (clock.ToMonotonicNs(record.begin) - origin_ns) / 1000.0,
+                                 clock.ToDurationNs(record.end - record.begin) / 1000.0, pid, ring->thread_id);
+                    if (ARG_NAMES[event])
+                    {
+                        std::fprintf(file, ",\"args\":{\"%s\":%llu}", ARG_NAMES[event],
+                                     static_cast<unsigned long long>(record.arg));
+                    }
+                    std::fprintf(file, "}");
+                }
+            }
+            std::fprintf(file, "\n]}\n");
+
+            bool written = std::ferror(file) == 0;
+            if (std::fclose(file) != 0 || !written)
+            {
+                FMT_PRINT("Failed to write trace file %s\n", path.c_str());
+                return false;
+            }
+            return true;
+        }
+
+    } // namespace utils
+} // namespace stream_buffer
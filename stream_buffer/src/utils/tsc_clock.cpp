@@ -0,0 +1,178 @@
+#include "utils/tsc_clock.h"
+#include "utils/debug.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace stream_buffer
+{
+    namespace utils
+    {
+        namespace
+        {
+            const int SAMPLE_ATTEMPTS = 5;
+            const common::i64 NANOSECONDS_PER_MILLISECOND = 1000000;
+            const common::u64 ONE = 1ULL << constants::TSC_SHIFT; // 1.0 in fixed point
+
+            // Plausible TSC rates, 10 MHz to 100 GHz, as fixed-point ns per tick
+            const common::u64 MIN_NS_PER_TICK = ONE / 100;
+            const common::u64 MAX_NS_PER_TICK = ONE * 100;
+
+            bool HasRdtscp()
+            {
+#if defined(__x86_64__) || defined(__i386__)
+                unsigned int eax, ebx, ecx, edx;
+                return __get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx) && (edx & (1U << 27));
+#else
+                return false;
+#endif
+            }
+
+            common::u64 GetNsPerTick(common::i64 elapsed_ns, common::u64 elapsed_ticks)
+            {
+                __extension__ typedef unsigned __int128 u128;
+                if (elapsed_ns <= 0 || elapsed_ticks == 0)
+                {
+                    return 0;
+                }
+                return static_cast<common::u64>((static_cast<u128>(elapsed_ns) << constants::TSC_SHIFT) / elapsed_ticks);
+            }
+
+            common::u64 GetTicksIn(common::i64 ns, common::u64 ns_per_tick)
+            {
+                __extension__ typedef unsigned __int128 u128;
+                return static_cast<common::u64>((static_cast<u128>(ns) << constants::TSC_SHIFT) / ns_per_tick);
+            }
+        } // anonymous namespace
+
+        bool TscClock::HasInvariantTsc()
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            unsigned int eax, ebx, ecx, edx;
+            return __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) && (edx & (1U << 8));
+#else
+            return false;
+#endif
+        }
+
+        TscClock::TscClock()
+            : use_tsc_(HasInvariantTsc()), has_rdtscp_(HasRdtscp()),
+              first_ticks_(0), first_monotonic_ns_(0), resync_interval_ticks_(0),
+              next_resync_ticks_(0), resyncing_(false), max_error_ns_(0), resync_count_(0)
+        {
+            common::i64 realtime_ns = 0;
+            Sample(&first_ticks_, &first_monotonic_ns_, &realtime_ns);
+
+            Anchor anchor;
+            anchor.ticks = first_ticks_;
+            anchor.monotonic_ns = first_monotonic_ns_;
+            anchor.realtime_offset_ns = realtime_ns - first_monotonic_ns_;
+            anchor.ns_per_tick = ONE;
+
+            if (use_tsc_)
+            {
+                timespec pause = {0, constants::TSC_CALIBRATION_MS * NANOSECONDS_PER_MILLISECOND};
+                nanosleep(&pause, nullptr);
+
+                common::u64 ticks;
+                common::i64 monotonic_ns;
+                Sample(&ticks, &monotonic_ns, &realtime_ns);
+                common::u64 ns_per_tick = GetNsPerTick(monotonic_ns - first_monotonic_ns_, ticks - first_ticks_);
+                if (ns_per_tick >= MIN_NS_PER_TICK && ns_per_tick <= MAX_NS_PER_TICK)
+                {
+                    anchor.ticks = ticks;
+                    anchor.monotonic_ns = monotonic_ns;
+                    anchor.realtime_offset_ns = realtime_ns - monotonic_ns;
+                    anchor.ns_per_tick = ns_per_tick;
+                }
+                else
+                {
+                    FMT_PRINT("TSC calibration failed, using clock_gettime\n");
+                    use_tsc_ = false;
+                    Sample(&first_ticks_, &first_monotonic_ns_, &realtime_ns);
+                    anchor.ticks = first_ticks_;
+                    anchor.monotonic_ns = first_monotonic_ns_;
+                    anchor.realtime_offset_ns = realtime_ns - first_monotonic_ns_;
+                }
+            }
+
+            anchor_.Store(anchor);
+            resync_interval_ticks_ = GetTicksIn(constants::TSC_RESYNC_INTERVAL_MS * NANOSECONDS_PER_MILLISECOND,
+                                                anchor.ns_per_tick);
+            next_resync_ticks_.store(anchor.ticks + resync_interval_ticks_, std::memory_order_relaxed);
+        }
+
+        void TscClock::Sample(common::u64 *ticks, common::i64 *monotonic_ns, common::i64 *realtime_ns) const
+        {
+            // Keep the attempt with the shortest window around clock_gettime
+            common::u64 best_window = ~0ULL;
+            for (int i = 0; i < SAMPLE_ATTEMPTS; ++i)
+            {
+                common::u64 before = ReadTicks();
+                common::i64 monotonic = ReadMonotonicNs();
+                timespec realtime;
+                clock_gettime(CLOCK_REALTIME, &realtime);
+                common::u64 after = ReadTicksOrdered();
+
+                if (after - before < best_window)
+                {
+                    best_window = after - before;
+                    *ticks = before + (after - before) / 2;
+                    *monotonic_ns = monotonic;
+                    *realtime_ns = static_cast<common::i64>(realtime.tv_sec) * 1000000000LL + realtime.tv_nsec;
+                }
+            }
+        }
+
+        bool TscClock::Resync()
+        {
+            bool expected = false;
+            if (!resyncing_.compare_exchange_strong(expected, true, std::memory_order_acquire))
+            {
+                return false;
+            }
+
+            common::u64 ticks;
+            common::i64 monotonic_ns, realtime_ns;
+            Sample(&ticks, &monotonic_ns, &realtime_ns);
+
+            // Only the resyncing thread stores, so it may read the anchor directly
+            Anchor anchor = anchor_.Peek();
+            common::i64 error = Convert(anchor, ticks) - monotonic_ns;
+            error = error < 0 ? -error : error;
+            if (error > max_error_ns_.load(std::memory_order_relaxed))
+            {
+                max_error_ns_.store(error, std::memory_order_relaxed);
+            }
+
+            // The frequency estimate improves with the length of the baseline
+            if (use_tsc_)
+            {
+                common::u64 ns_per_tick = GetNsPerTick(monotonic_ns - first_monotonic_ns_, ticks - first_ticks_);
+                if (ns_per_tick >= MIN_NS_PER_TICK && ns_per_tick <= MAX_NS_PER_TICK)
+                {
+                    anchor.ns_per_tick = ns_per_tick;
+                    resync_interval_ticks_ = GetTicksIn(constants::TSC_RESYNC_INTERVAL_MS * NANOSECONDS_PER_MILLISECOND,
+                                                        ns_per_tick);
+                }
+            }
+            anchor.ticks = ticks;
+            anchor.monotonic_ns = monotonic_ns;
+            anchor.realtime_offset_ns = realtime_ns - monotonic_ns; // Follows wall clock steps
+            anchor_.Store(anchor);
+
+            next_resync_ticks_.store(ticks + resync_interval_ticks_, std::memory_order_relaxed);
+            resync_count_.fetch_add(1, std::memory_order_relaxed);
+            resyncing_.store(false, std::memory_order_release);
+            return true;
+        }
+
+        double TscClock::GetFrequency() const
+        {
+            Anchor anchor;
+            anchor_.Load(&anchor);
+            return 1e9 * static_cast<double>(ONE) / static_cast<double>(anchor.ns_per_tick);
+        }
+
+    } // namespace utils
+} // namespace stream_buffer
@@ -0,0 +1,301 @@
+#include "core/buffer_processor.h"
+#include "processing/tfe_processor.h"
+#include "tfe_test_packets.h"
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace stream_buffer;
+using namespace stream_buffer::core;
+using namespace stream_buffer::testing;
+
+// Unit test framework structure
+struct TestCase
+{
+    const char *name;
+    bool (*test_func)();
+};
+
+namespace
+{
+    const size_t RECORD_SIZE = 100;
+    const size_t BUFFER_SIZE = 4 * common::constants::MAX_DATAGRAM_SIZE;
+
+    // Hands out prepared datagrams as the test allows, otherwise behaves like a quiet socket
+    class GatedReceiver : public network::INetworkReceiver
+    {
+    public:
+        explicit GatedReceiver(const std::vector<std::vector<char>> &datagrams)
+            : datagrams_(datagrams), allowed_(0), next_(0) {}
+
+        int ReceiveData(char *buffer, size_t buffer_size) override
+        {
+            size_t next = next_.load(std::memory_order_relaxed);
+            if (next >= allowed_.load(std::memory_order_acquire) || datagrams_[next].size() > buffer_size)
+            {
+                usleep(1000);
+                errno = EAGAIN;
+                return -1;
+            }
+            std::memcpy(buffer, datagrams_[next].data(), datagrams_[next].size());
+            next_.store(next + 1, std::memory_order_release);
+            return static_cast<int>(datagrams_[next].size());
+        }
+
+        void Allow(size_t count) { allowed_.store(count, std::memory_order_release); }
+        size_t GetReceived() const { return next_.load(std::memory_order_acquire); }
+
+    private:
+        const std::vector<std::vector<char>> &datagrams_;
+        std::atomic<size_t> allowed_;
+        std::atomic<size_t> next_;
+    };
+
+    // Consumes whole records numbered from 0, and can hold one batch until released
+    class RecordProcessor : public IMessageProcessor
+    {
+    public:
+        explicit RecordProcessor(size_t hold_call)
+            : hold_call_(hold_call), calls_(0), records_(0), held_(false), released_(false),
+              out_of_order_(0), moved_(false) {}
+
+        bool ProcessMessage(char *, size_t) override { return true; }
+
+        bool ProcessBatch(char *data, size_t length, BatchResult *result) override
+        {
+            size_t call = calls_.load(std::memory_order_relaxed) + 1;
+            calls_.store(call, std::memory_order_release);
+            if (call == hold_call_)
+            {
+                // The span must stay where it is while this thread reads it
+                std::vector<char> copy(data, data + length);
+                held_.store(true, std::memory_order_release);
+                while (!released_.load(std::memory_order_acquire))
+                {
+                    usleep(1000);
+                }
+                moved_ = std::memcmp(data, copy.data(), length) != 0;
+            }
+
+            size_t records = length / RECORD_SIZE;
+            for (size_t i = 0; i < records; ++i)
+            {
+                common::u32 id = 0;
+                std::memcpy(&id, data + i * RECORD_SIZE, sizeof(id));
+                out_of_order_ += id != records_.load(std::memory_order_relaxed) + i ? 1 : 0;
+            }
+            records_.store(records_.load(std::memory_order_relaxed) + records, std::memory_order_release);
+            result->bytes_consumed = records * RECORD_SIZE;
+            result->message_count = records;
+            return true;
+        }
+
+        void Release() { released_.store(true, std::memory_order_release); }
+        bool IsHeld() const { return held_.load(std::memory_order_acquire); }
+        size_t GetCalls() const { return calls_.load(std::memory_order_acquire); }
+        size_t GetRecords() const { return records_.load(std::memory_order_acquire); }
+        size_t GetOutOfOrder() const { return out_of_order_; }
+        bool HasMoved() const { return moved_; }
+
+    private:
+        size_t hold_call_;
+        std::atomic<size_t> calls_;
+        std::atomic<size_t> records_;
+        std::atomic<bool> held_;
+        std::atomic<bool> released_;
+        size_t out_of_order_;
+        bool moved_;
+    };
+
+    // Counts messages and checks their sequence numbers
+    class SequenceSink : public processing::IMessageSink
+    {
+    public:
+        SequenceSink() : count_(0), out_of_order_(0) {}
+
+        void OnMessage(const processing::NormalizedMessage &message) override
+        {
+            size_t count = count_.load(std::memory_order_relaxed);
+            out_of_order_ += message.information_seq != count + 1 ? 1 : 0;
+            count_.store(count + 1, std::memory_order_release);
+        }
+
+        size_t GetCount() const { return count_.load(std::memory_order_acquire); }
+        size_t GetOutOfOrder() const { return out_of_order_; }
+
+    private:
+        std::atomic<size_t> count_;
+        size_t out_of_order_;
+    };
+
+    // Numbered records cut into datagrams that split records across them
+    std::vector<std::vector<char>> MakeRecordDatagrams(size_t count, size_t datagram_size)
+    {
+        std::vector<char> stream(count * datagram_size);
+        for (size_t offset = 0; offset + RECORD_SIZE <= stream.size(); offset += RECORD_SIZE)
+        {
+            common::u32 id = static_cast<common::u32>(offset / RECORD_SIZE);
+            std::memcpy(&stream[offset], &id, sizeof(id));
+        }
+
+        std::vector<std::vector<char>> datagrams;
+        for (size_t i = 0; i < count; ++i)
+        {
+            datagrams.push_back(std::vector<char>(stream.begin() + i * datagram_size,
+                                                  stream.begin() + (i + 1) * datagram_size));
+        }
+        return datagrams;
+    }
+
+    template <typename Condition>
+    bool WaitFor(Condition condition)
+    {
+        for (int i = 0; i < 500 && !condition(); ++i)
+        {
+            usleep(10000);
+        }
+        return condition();
+    }
+} // anonymous namespace
+
+// A batch stops before a partial packet, which completes in the next one
+bool test_partial_tail()
+{
+    std::vector<char> stream;
+    for (common::u64 seq = 1; seq <= 3; ++seq)
+    {
+        std::vector<char> packet = MakeI080Packet(90000000000ULL, seq);
+        stream.insert(stream.end(), packet.begin(), packet.end());
+    }
+    size_t packet_size = stream.size() / 3;
+    size_t cut = 2 * packet_size + packet_size / 2;
+
+    processing::TFEProcessor processor;
+    SequenceSink sink;
+    processor.AddSink(&sink);
+    BatchResult first = processor.ProcessBatch(stream.data(), cut);
+    bool passed = first.bytes_consumed == 2 * packet_size && first.message_count == 2;
+
+    // Only the partial packet is left
+    BatchResult partial = processor.ProcessBatch(stream.data() + first.bytes_consumed, cut - first.bytes_consumed);
+    passed = passed && partial.bytes_consumed == 0 && partial.message_count == 0;
+
+    BatchResult rest = processor.ProcessBatch(stream.data() + first.bytes_consumed, stream.size() - first.bytes_consumed);
+    passed = passed && rest.bytes_consumed == packet_size && rest.message_count == 1;
+    passed = passed && sink.GetCount() == 3 && sink.GetOutOfOrder() == 0;
+
+    std::cout << "Partial tail test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Packets cut across datagrams reach the sinks whole through the processing thread
+bool test_split_packets()
+{
+    std::vector<char> stream;
+    for (common::u64 seq = 1; seq <= 200; ++seq)
+    {
+        std::vector<char> packet = MakeI080Packet(90000000000ULL, seq);
+        stream.insert(stream.end(), packet.begin(), packet.end());
+    }
+
+    // An odd datagram size cuts packets at varying offsets
+    std::vector<std::vector<char>> datagrams;
+    for (size_t offset = 0; offset < stream.size(); offset += 997)
+    {
+        size_t end = offset + 997 < stream.size() ? offset + 997 : stream.size();
+        datagrams.push_back(std::vector<char>(stream.begin() + offset, stream.begin() + end));
+    }
+
+    GatedReceiver *receiver = new GatedReceiver(datagrams);
+    SequenceSink sink;
+    BufferProcessor processor(common::MulticastConfig(), BUFFER_SIZE,
+                              std::unique_ptr<network::INetworkReceiver>(receiver));
+    processor.AddSink(&sink);
+    bool passed = processor.Start();
+
+    // One datagram at a time, so every batch but the last ends in a partial packet
+    for (size_t i = 1; passed && i <= datagrams.size(); ++i)
+    {
+        receiver->Allow(i);
+        passed = WaitFor([&]() { return receiver->GetReceived() == i; });
+    }
+    passed = passed && WaitFor([&]() { return sink.GetCount() == 200; });
+    processor.Stop();
+
+    passed = passed && sink.GetCount() == 200 && sink.GetOutOfOrder() == 0;
+    std::cout << "Split packets test: " << (passed ? "PASSED" : "FAILED")
+              << " (" << sink.GetCount() << "/200 messages)" << std::endl;
+    return passed;
+}
+
+// While a batch is in flight its span does not move, and data queued meanwhile
+// is picked up at once even though its wake-up found nobody waiting
+bool test_held_batch()
+{
+    std::vector<std::vector<char>> datagrams = MakeRecordDatagrams(6, 1050);
+    GatedReceiver *receiver = new GatedReceiver(datagrams);
+
+    // The first batch takes ten records, the second is held on the partial one left
+    RecordProcessor *records = new RecordProcessor(2);
+    BufferProcessor processor(common::MulticastConfig(), BUFFER_SIZE,
+                              std::unique_ptr<network::INetworkReceiver>(receiver),
+                              std::unique_ptr<IMessageProcessor>(records));
+    bool passed = processor.Start();
+
+    receiver->Allow(1);
+    passed = passed && WaitFor([&]() { return records->IsHeld(); });
+    passed = passed && records->GetRecords() == 10;
+
+    // The receive thread keeps going with a consumed prefix it must not compact away
+    receiver->Allow(datagrams.size());
+    passed = passed && WaitFor([&]() { return receiver->GetReceived() == datagrams.size(); });
+    usleep(20000);
+    records->Release();
+
+    // No more datagrams, so no more wake-ups: only the retry can process the rest
+    passed = passed && WaitFor([&]() { return records->GetRecords() == 63; });
+    processor.Stop();
+
+    passed = passed && !records->HasMoved() && records->GetOutOfOrder() == 0;
+    passed = passed && records->GetRecords() == 63;
+    std::cout << "Held batch test: " << (passed ? "PASSED" : "FAILED")
+              << " (" << records->GetRecords() << "/63 records in " << records->GetCalls() << " batches"
+              << (records->HasMoved() ? ", span moved" : "") << ")" << std::endl;
+    return passed;
+}
+
+int main()
+{
+    std::cout << "==== Batch Processing Unit Tests ====\n"
+              << std::endl;
+
+    // Define all test cases
+    TestCase test_cases[] = {
+        {"Partial Tail", test_partial_tail},
+        {"Split Packets", test_split_packets},
+        {"Held Batch", test_held_batch}};
+
+    // Run all tests and count failures
+    size_t num_tests = sizeof(test_cases) / sizeof(TestCase);
+    size_t passed_tests = 0;
+
+    for (size_t i = 0; i < num_tests; ++i)
+    {
+        std::cout << "\nRunning test: " << test_cases[i].name << std::endl;
+        if (test_cases[i].test_func())
+        {
+            passed_tests++;
+        }
+    }
+
+    // Print summary
+    std::cout << "\n==== Test Results ====\n";
+    std::cout << "Passed: " << passed_tests << "/" << num_tests
+              << " (" << (passed_tests * 100 / num_tests) << "%)" << std::endl;
+
+    // Return 0 if all tests passed, otherwise return the number of failures
+    return (passed_tests == num_tests) ? 0 : (num_tests - passed_tests);
+}
@@ -0,0 +1,287 @@
+#include "core/buffer_processor.h"
+#include "core/chunked_buffer.h"
+#include "tfe_test_packets.h"
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace stream_buffer;
+using namespace stream_buffer::core;
+using namespace stream_buffer::testing;
+
+// Unit test framework structure
+struct TestCase
+{
+    const char *name;
+    bool (*test_func)();
+};
+
+namespace
+{
+    const size_t CHUNK_SIZE = common::constants::MAX_DATAGRAM_SIZE;
+    const size_t DATAGRAM_SIZE = 30000;
+
+    // Write one datagram of a repeated byte, as the receive thread would
+    bool WriteDatagram(ChunkedBuffer &buffer, char value)
+    {
+        if (buffer.Reserve(DATAGRAM_SIZE) < DATAGRAM_SIZE)
+        {
+            return false;
+        }
+        std::memset(buffer.GetBufferEndPtr(), value, DATAGRAM_SIZE);
+        buffer.AppendData(DATAGRAM_SIZE);
+        return true;
+    }
+
+    // Consumes whole 1000 byte records
+    class RecordProcessor : public IBufferProcessor
+    {
+    public:
+        size_t ProcessMessage(const char *message, size_t length) override
+        {
+            (void)message;
+            return length >= 1000 ? 1000 : 0;
+        }
+    };
+
+    // Hands out prepared datagrams, then behaves like a quiet socket
+    class ReplayReceiver : public network::INetworkReceiver
+    {
+    public:
+        explicit ReplayReceiver(const std::vector<std::vector<char>> &datagrams) : datagrams_(datagrams), next_(0) {}
+
+        int ReceiveData(char *buffer, size_t buffer_size) override
+        {
+            size_t next = next_.load(std::memory_order_relaxed);
+            if (next == datagrams_.size() || datagrams_[next].size() > buffer_size)
+            {
+                usleep(1000);
+                errno = EAGAIN;
+                return -1;
+            }
+            std::memcpy(buffer, datagrams_[next].data(), datagrams_[next].size());
+            next_.store(next + 1, std::memory_order_release);
+            return static_cast<int>(datagrams_[next].size());
+        }
+
+        size_t GetReceived() const { return next_.load(std::memory_order_acquire); }
+
+    private:
+        const std::vector<std::vector<char>> &datagrams_;
+        std::atomic<size_t> next_;
+    };
+
+    // Holds the processing thread on the first message until released, then checks the sequence
+    class HeldSink : public processing::IMessageSink
+    {
+    public:
+        HeldSink() : held_(true), count_(0), out_of_order_(0) {}
+
+        void OnMessage(const processing::NormalizedMessage &message) override
+        {
+            while (held_.load(std::memory_order_acquire))
+            {
+                usleep(1000);
+            }
+            size_t count = count_.load(std::memory_order_relaxed);
+            out_of_order_ += message.information_seq != count + 1 ? 1 : 0;
+            count_.store(count + 1, std::memory_order_release);
+        }
+
+        void Release() { held_.store(false, std::memory_order_release); }
+        size_t GetCount() const { return count_.load(std::memory_order_acquire); }
+        size_t GetOutOfOrder() const { return out_of_order_; }
+
+    private:
+        std::atomic<bool> held_;
+        std::atomic<size_t> count_;
+        size_t out_of_order_;
+    };
+} // namespace
+
+// Datagrams stay whole and chunks are read in order
+bool test_chain_order()
+{
+    ChunkedBuffer buffer(4 * CHUNK_SIZE, CHUNK_SIZE);
+
+    // Two datagrams fit the first chunk, the third starts a new one
+    bool passed = WriteDatagram(buffer, 'a') && WriteDatagram(buffer, 'b') && WriteDatagram(buffer, 'c');
+    passed = passed && buffer.GetChunkCount() == 2;
+    passed = passed && buffer.GetQueuedSize() == 2 * DATAGRAM_SIZE;
+    passed = passed && buffer.GetTotalQueuedSize() == 3 * DATAGRAM_SIZE;
+    passed = passed && buffer.IsTopSegmentComplete();
+    passed = passed && buffer.GetBufferTopPtr()[DATAGRAM_SIZE] == 'b';
+
+    // Reading the first chunk moves on to the second
+    buffer.RemoveProcessedData(2 * DATAGRAM_SIZE);
+    passed = passed && buffer.GetChunkCount() == 1 && !buffer.IsTopSegmentComplete();
+    passed = passed && buffer.GetQueuedSize() == DATAGRAM_SIZE && buffer.GetBufferTopPtr()[0] == 'c';
+
+    buffer.RemoveProcessedData(DATAGRAM_SIZE);
+    passed = passed && buffer.IsEmpty() && !buffer.HasPendingData();
+
+    std::cout << "Chain order test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// A burst is absorbed up to the cap and memory shrinks back afterwards
+bool test_bounded_memory()
+{
+    ChunkedBuffer buffer(6 * CHUNK_SIZE, CHUNK_SIZE);
+
+    size_t written = 0;
+    while (WriteDatagram(buffer, 'x'))
+    {
+        written++;
+    }
+    bool passed = buffer.GetChunkCount() == 6 && written == 12;
+    passed = passed && buffer.GetTotalCapacity() == 6 * CHUNK_SIZE;
+    passed = passed && buffer.Reserve(DATAGRAM_SIZE) < DATAGRAM_SIZE;
+
+    while (buffer.HasPendingData())
+    {
+        buffer.RemoveProcessedData(buffer.GetQueuedSize());
+    }
+    passed = passed && buffer.GetChunkCount() == 1;
+    passed = passed && buffer.GetAllocatedCount() == 1 + constants::MAX_SPARE_CHUNKS;
+    passed = passed && buffer.GetPeakAllocatedCount() == 6;
+
+    // Growing raises the cap without allocating
+    passed = passed && buffer.Grow(2 * CHUNK_SIZE) && buffer.GetMaxChunkCount() == 8;
+    passed = passed && buffer.GetAllocatedCount() == 1 + constants::MAX_SPARE_CHUNKS;
+
+    std::cout << "Bounded memory test: " << (passed ? "PASSED" : "FAILED")
+              << " (peak " << buffer.GetPeakAllocatedCount() << " chunks)" << std::endl;
+    return passed;
+}
+
+// The last chunk is rewound in place once drained
+bool test_rewind()
+{
+    ChunkedBuffer buffer(CHUNK_SIZE, CHUNK_SIZE);
+
+    bool passed = WriteDatagram(buffer, 'a') && WriteDatagram(buffer, 'b');
+    passed = passed && buffer.Reserve(DATAGRAM_SIZE) < DATAGRAM_SIZE;
+    buffer.RemoveProcessedData(DATAGRAM_SIZE);
+    passed = passed && buffer.Reserve(DATAGRAM_SIZE) < DATAGRAM_SIZE;
+    buffer.RemoveProcessedData(DATAGRAM_SIZE);
+    passed = passed && buffer.Reserve(DATAGRAM_SIZE) == CHUNK_SIZE;
+    passed = passed && buffer.GetBufferEnd() == 0 && buffer.GetAllocatedCount() == 1;
+
+    // Chunks smaller than a datagram are raised to fit one
+    ChunkedBuffer small(1024, 1024);
+    passed = passed && small.GetChunkSize() == CHUNK_SIZE && small.GetMaxChunkCount() == 1;
+
+    std::cout << "Rewind test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Batches run over the first chunk only
+bool test_process_batch()
+{
+    ChunkedBuffer buffer(4 * CHUNK_SIZE, CHUNK_SIZE, std::unique_ptr<IBufferProcessor>(new RecordProcessor()));
+
+    bool passed = WriteDatagram(buffer, 'a') && WriteDatagram(buffer, 'b') && WriteDatagram(buffer, 'c');
+    BatchResult result = buffer.ProcessPendingBatch(buffer.GetQueuedSize());
+    passed = passed && result.message_count == 60 && result.bytes_consumed == 2 * DATAGRAM_SIZE;
+
+    buffer.RemoveProcessedData(result.bytes_consumed);
+    result = buffer.ProcessPendingBatch(buffer.GetQueuedSize());
+    passed = passed && result.message_count == 30;
+
+    std::cout << "Process batch test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Datagrams spilled while every chunk is full come back whole and in order
+bool test_spill_replay()
+{
+    const size_t datagram_count = 500;
+    const size_t packets_per_datagram = 10;
+    std::vector<std::vector<char>> datagrams(datagram_count);
+    common::u64 seq = 0;
+    for (size_t i = 0; i < datagram_count; ++i)
+    {
+        for (size_t j = 0; j < packets_per_datagram; ++j)
+        {
+            std::vector<char> packet = MakeI080Packet(90000000000ULL, ++seq);
+            datagrams[i].insert(datagrams[i].end(), packet.begin(), packet.end());
+        }
+    }
+
+    std::string spill_path = "/tmp/stream_buffer_chunked_spill_" + std::to_string(getpid());
+    common::ProcessingConfig processing;
+    processing.buffer_chunk_size = CHUNK_SIZE;
+    processing.overflow.policy = common::OverflowPolicy::SPILL;
+    processing.overflow.spill_path = spill_path;
+
+    ReplayReceiver *receiver = new ReplayReceiver(datagrams);
+    HeldSink sink;
+    BufferProcessor processor(common::MulticastConfig(), 4 * CHUNK_SIZE,
+                              std::unique_ptr<network::INetworkReceiver>(receiver), nullptr, processing);
+    processor.AddSink(&sink);
+    bool passed = processor.Start();
+
+    // What does not fit the chunks while the sink is held goes to the spill file
+    for (int i = 0; i < 500 && receiver->GetReceived() < datagram_count; ++i)
+    {
+        usleep(10000);
+    }
+    sink.Release();
+    for (int i = 0; i < 500 && sink.GetCount() < seq; ++i)
+    {
+        usleep(10000);
+    }
+    processor.Stop();
+
+    OverflowStats stats = processor.GetOverflowStats();
+    passed = passed && receiver->GetReceived() == datagram_count;
+    passed = passed && sink.GetCount() == seq && sink.GetOutOfOrder() == 0;
+    passed = passed && stats.spilled_bytes > 0 && stats.replayed_bytes == stats.spilled_bytes;
+    passed = passed && stats.dropped_datagrams == 0 && stats.spill_errors == 0;
+
+    unlink(spill_path.c_str());
+    std::cout << "Spill replay test: " << (passed ? "PASSED" : "FAILED")
+              << " (" << sink.GetCount() << "/" << seq << " messages, "
+              << stats.spilled_bytes << " bytes spilled, " << stats.replayed_bytes << " replayed)" << std::endl;
+    return passed;
+}
+
+int main()
+{
+    std::cout << "==== Chunked Buffer Unit Tests ====\n"
+              << std::endl;
+
+    // Define all test cases
+    TestCase test_cases[] = {
+        {"Chain Order", test_chain_order},
+        {"Bounded Memory", test_bounded_memory},
+        {"Rewind", test_rewind},
+        {"Process Batch", test_process_batch},
+        {"Spill Replay", test_spill_replay}};
+
+    // Run all tests and count failures
+    size_t num_tests = sizeof(test_cases) / sizeof(TestCase);
+    size_t passed_tests = 0;
+
+    for (size_t i = 0; i < num_tests; ++i)
+    {
+        std::cout << "\nRunning test: " << test_cases[i].name << std::endl;
+        if (test_cases[i].test_func())
+        {
+            passed_tests++;
+        }
+    }
+
+    // Print summary
+    std::cout << "\n==== Test Results ====\n";
+    std::cout << "Passed: " << passed_tests << "/" << num_tests
+              << " (" << (passed_tests * 100 / num_tests) << "%)" << std::endl;
+
+    // Return 0 if all tests passed, otherwise return the number of failures
+    return (passed_tests == num_tests) ? 0 : (num_tests - passed_tests);
+}
@@ -0,0 +1,161 @@
+#include "processing/conflating_sink.h"
+#include "tfe_test_messages.h"
+#include <time.h>
+#include <iostream>
+#include <map>
+#include <string>
+
+using namespace stream_buffer;
+using namespace stream_buffer::processing;
+using namespace stream_buffer::testing;
+
+// Unit test framework structure
+struct TestCase
+{
+    const char *name;
+    bool (*test_func)();
+};
+
+namespace
+{
+    NormalizedMessage MakeMessage(size_t product, MessageType type, common::u32 seq)
+    {
+        return testing::MakeMessage(MakeProductId('C', product), type, seq);
+    }
+
+    // Records the last message per key, optionally slowly
+    class RecordingSink : public IMessageSink
+    {
+    public:
+        explicit RecordingSink(long delay_ns = 0) : delay_ns_(delay_ns), received(0) {}
+
+        void OnMessage(const NormalizedMessage &message) override
+        {
+            std::string key(message.product_id, sizeof(message.product_id));
+            key += static_cast<char>('0' + static_cast<int>(message.type));
+            std::map<std::string, common::u32>::iterator it = latest.find(key);
+            if (it != latest.end() && message.information_seq < it->second)
+            {
+                went_backwards++;
+            }
+            latest[key] = message.information_seq;
+            received++;
+
+            if (delay_ns_ > 0)
+            {
+                struct timespec delay = {0, delay_ns_};
+                nanosleep(&delay, nullptr);
+            }
+        }
+
+        long delay_ns_;
+        size_t received;
+        size_t went_backwards = 0;
+        std::map<std::string, common::u32> latest;
+    };
+} // anonymous namespace
+
+// Test that repeated updates of a key collapse into the latest one
+bool test_conflation()
+{
+    ConflatingSink sink(nullptr, 64);
+    for (common::u32 seq = 1; seq <= 10; ++seq)
+    {
+        sink.OnMessage(MakeMessage(1, MessageType::QUOTE, seq));
+        sink.OnMessage(MakeMessage(1, MessageType::TRADE, 100 + seq));
+        sink.OnMessage(MakeMessage(2, MessageType::QUOTE, 200 + seq));
+    }
+
+    RecordingSink consumer;
+    size_t delivered = sink.Drain(&consumer);
+    bool passed = delivered == 3 && consumer.latest.size() == 3 &&
+                  consumer.latest["C000000001" "2"] == 10 && consumer.latest["C000000001" "1"] == 110 &&
+                  consumer.latest["C000000002" "2"] == 210 &&
+                  sink.GetUpdateCount() == 30 && sink.GetConflatedCount() == 27 && sink.GetDeliveredCount() == 3 &&
+                  sink.Drain(&consumer) == 0;
+
+    std::cout << "Conflation test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Test that a bounded drain leaves the rest dirty for the next call
+bool test_bounded_drain()
+{
+    ConflatingSink sink(nullptr, 256);
+    for (size_t product = 0; product < 200; ++product)
+    {
+        sink.OnMessage(MakeMessage(product, MessageType::TRADE, static_cast<common::u32>(product)));
+    }
+
+    RecordingSink consumer;
+    size_t first = sink.Drain(&consumer, 70);
+    size_t second = sink.Drain(&consumer, 70);
+    size_t rest = sink.Drain(&consumer);
+    bool passed = first == 70 && second == 70 && rest == 60 && consumer.latest.size() == 200 &&
+                  sink.GetConflatedCount() == 0;
+
+    std::cout << "Bounded drain test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Test a slow consumer thread: the producer never waits and the final state is the freshest
+bool test_slow_consumer()
+{
+    RecordingSink *consumer = new RecordingSink(20000);
+    ConflatingSink sink(std::unique_ptr<IMessageSink>(consumer), 64);
+    bool passed = sink.Start();
+
+    const common::u32 updates = 200000;
+    for (common::u32 seq = 1; seq <= updates; ++seq)
+    {
+        sink.OnMessage(MakeMessage(seq % 8, MessageType::QUOTE, seq));
+    }
+    sink.Stop();
+
+    passed = passed && consumer->latest.size() == 8 && consumer->went_backwards == 0 &&
+             sink.GetConflatedCount() > 0 &&
+             sink.GetDeliveredCount() + sink.GetConflatedCount() >= updates;
+    for (size_t product = 0; product < 8 && passed; ++product)
+    {
+        common::u32 expected = updates - ((updates - static_cast<common::u32>(product)) % 8);
+        passed = consumer->latest[MakeProductId('C', product) + '2'] == expected;
+    }
+
+    std::cout << "Slow consumer test: " << (passed ? "PASSED" : "FAILED")
+              << " (" << sink.GetDeliveredCount() << " delivered, "
+              << sink.GetConflatedCount() << " conflated)" << std::endl;
+    return passed;
+}
+
+int main()
+{
+    std::cout << "==== Conflating Sink Unit Tests ====\n"
+              << std::endl;
+
+    // Define all test cases
+    TestCase test_cases[] = {
+        {"Conflation", test_conflation},
+        {"Bounded Drain", test_bounded_drain},
+        {"Slow Consumer", test_slow_consumer}};
+
+    // Run all tests and count failures
+    size_t num_tests = sizeof(test_cases) / sizeof(TestCase);
+    size_t passed_tests = 0;
+
+    for (size_t i = 0; i < num_tests; ++i)
+    {
+        std::cout << "\nRunning test: " << test_cases[i].name << std::endl;
+        if (test_cases[i].test_func())
+        {
+            passed_tests++;
+        }
+    }
+
+    // Print summary
+    std::cout << "\n==== Test Results ====\n";
+    std::cout << "Passed: " << passed_tests << "/" << num_tests
+              << " (" << (passed_tests * 100 / num_tests) << "%)" << std::endl;
+
+    // Return 0 if all tests passed, otherwise return the number of failures
+    return (passed_tests == num_tests) ? 0 : (num_tests - passed_tests);
+}
@@ -0,0 +1,211 @@
+#include "core/datagram_slot.h"
+#include "network/multicast.h"
+#include "processing/tfe_processor.h"
+#include "tfe_test_packets.h"
+#include <iostream>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#include <sys/time.h>
+
+using namespace stream_buffer;
+using namespace stream_buffer::processing;
+using namespace stream_buffer::testing;
+
+// Unit test framework structure
+struct TestCase
+{
+    const char *name;
+    bool (*test_func)();
+};
+
+namespace
+{
+    const char *TEST_GROUP_IP = "239.255.0.41";
+    const char *LOOPBACK_IP = "127.0.0.1";
+
+    // Queue a datagram the way the receive thread does
+    void AppendSlot(std::vector<char> *queue, const std::vector<char> &payload, common::u32 sequence)
+    {
+        size_t offset = queue->size();
+        queue->resize(offset + core::GetSlotSize(payload.size()), 0);
+        core::DatagramSlot *slot = reinterpret_cast<core::DatagramSlot *>(&(*queue)[offset]);
+        slot->length = static_cast<common::u32>(payload.size());
+        slot->sequence = sequence;
+        std::memcpy(&(*queue)[offset + sizeof(core::DatagramSlot)], payload.data(), payload.size());
+    }
+
+    // Counts every message it is given
+    class CountingSink : public IMessageSink
+    {
+    public:
+        size_t count = 0;
+        size_t flushes = 0;
+
+        void OnMessage(const NormalizedMessage &) override { count++; }
+        void Flush() override { flushes++; }
+    };
+} // anonymous namespace
+
+// Slots are padded to the alignment and a partial slot is left alone
+bool test_slot_layout()
+{
+    std::vector<char> queue;
+    AppendSlot(&queue, std::vector<char>(5, 'a'), 0);
+    AppendSlot(&queue, std::vector<char>(16, 'b'), 1);
+    size_t complete = queue.size();
+    AppendSlot(&queue, std::vector<char>(100, 'c'), 2);
+    queue.resize(queue.size() - 10);
+
+    std::vector<common::u32> lengths;
+    size_t covered = core::ForEachSlot(queue.data(), queue.size(), [&lengths](const core::DatagramSlot &slot)
+    {
+        lengths.push_back(slot.length);
+    });
+
+    bool passed = core::GetSlotSize(5) == 32 && core::GetSlotSize(16) == 40 && core::GetSlotSize(0) == 24;
+    passed = passed && covered == complete && lengths.size() == 2 && lengths[0] == 5 && lengths[1] == 16;
+    passed = passed && core::constants::MAX_SLOT_SIZE % core::constants::SLOT_ALIGNMENT == 0;
+
+    std::cout << "Slot layout test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// A damaged datagram loses only its own packets
+bool test_damage_isolation()
+{
+    std::vector<char> i010 = MakeI010Packet();
+    std::vector<char> i080 = MakeI080Packet();
+
+    std::vector<char> first(i010);
+    first.insert(first.end(), i080.begin(), i080.end());
+    std::vector<char> damaged(i010.begin(), i010.begin() + 20);
+    damaged.insert(damaged.end(), i080.begin(), i080.begin() + 10);
+
+    std::vector<char> queue;
+    AppendSlot(&queue, first, 0);
+    AppendSlot(&queue, damaged, 1);
+    AppendSlot(&queue, i080, 2);
+
+    TFEProcessor processor(nullptr, nullptr, true);
+    CountingSink sink;
+    processor.AddSink(&sink);
+    core::BatchResult result = processor.ProcessSlots(queue.data(), queue.size());
+
+    bool passed = result.bytes_consumed == queue.size() && result.message_count == 3;
+    passed = passed && processor.GetDamagedDatagramCount() == 1;
+    passed = passed && sink.count == 3 && sink.flushes == 1;
+
+    std::cout << "Damage isolation test: " << (passed ? "PASSED" : "FAILED")
+              << " (" << result.message_count << " packets, "
+              << processor.GetDamagedDatagramCount() << " damaged)" << std::endl;
+    return passed;
+}
+
+// The multicast receiver reports source, kernel time and truncation
+bool test_receive_datagram()
+{
+    common::MulticastConfig config(
+        common::SocketDomain::IPV4, common::SocketType::UDP, 0,
+        TEST_GROUP_IP, 0, "lo", LOOPBACK_IP, 0);
+    int receiver_fd = network::CreateSocket(config);
+    int sender_fd = socket(AF_INET, SOCK_DGRAM, 0);
+
+    int port = 0;
+    bool ready = receiver_fd >= 0 && sender_fd >= 0;
+    if (ready)
+    {
+        struct sockaddr_in bound_addr = {};
+        socklen_t addr_len = sizeof(bound_addr);
+        getsockname(receiver_fd, reinterpret_cast<sockaddr *>(&bound_addr), &addr_len);
+        port = ntohs(bound_addr.sin_port);
+
+        struct in_addr interface_addr;
+        interface_addr.s_addr = inet_addr(LOOPBACK_IP);
+        int loop = 1;
+        struct timeval timeout = {1, 0};
+        ready = network::JoinMulticastGroup(receiver_fd, TEST_GROUP_IP, port, "lo", LOOPBACK_IP) == 0 &&
+                network::EnableReceiveTimestamps(receiver_fd) == 0 &&
+                setsockopt(receiver_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) == 0 &&
+                setsockopt(sender_fd, IPPROTO_IP, IP_MULTICAST_IF, &interface_addr, sizeof(interface_addr)) == 0 &&
+                setsockopt(sender_fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) == 0;
+    }
+
+    struct sockaddr_in group_addr = {};
+    group_addr.sin_family = AF_INET;
+    group_addr.sin_port = htons(port);
+    group_addr.sin_addr.s_addr = inet_addr(TEST_GROUP_IP);
+    const char payload[] = "0123456789";
+    ready = ready &&
+            sendto(sender_fd, payload, sizeof(payload), 0, reinterpret_cast<sockaddr *>(&group_addr), sizeof(group_addr)) > 0 &&
+            sendto(sender_fd, payload, sizeof(payload), 0, reinterpret_cast<sockaddr *>(&group_addr), sizeof(group_addr)) > 0;
+    if (!ready)
+    {
+        std::cout << "Receive datagram test: SKIPPED (loopback multicast unavailable)" << std::endl;
+        if (receiver_fd >= 0)
+            close(receiver_fd);
+        if (sender_fd >= 0)
+            close(sender_fd);
+        return true;
+    }
+
+    struct sockaddr_in sender_addr = {};
+    socklen_t addr_len = sizeof(sender_addr);
+    getsockname(sender_fd, reinterpret_cast<sockaddr *>(&sender_addr), &addr_len);
+
+    network::MulticastReceiver receiver(receiver_fd);
+    network::DatagramInfo info;
+    char buffer[64];
+    int whole = receiver.ReceiveDatagram(buffer, sizeof(buffer), &info);
+
+    // Loopback delivery may run after sendto returns, so compare with the time after the receive
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    common::i64 now_ns = static_cast<common::i64>(now.tv_sec) * 1000000000LL + now.tv_nsec;
+    bool passed = whole == static_cast<int>(sizeof(payload)) && !info.truncated;
+    passed = passed && info.source_port == ntohs(sender_addr.sin_port);
+    passed = passed && info.receive_time_ns > 0 && info.receive_time_ns <= now_ns &&
+             now_ns - info.receive_time_ns < 5000000000LL;
+
+    int cut = receiver.ReceiveDatagram(buffer, 4, &info);
+    passed = passed && cut == 4 && info.truncated;
+
+    close(sender_fd);
+    close(receiver_fd);
+
+    std::cout << "Receive datagram test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+int main()
+{
+    std::cout << "==== Datagram Slot Unit Tests ====\n"
+              << std::endl;
+
+    // Define all test cases
+    TestCase test_cases[] = {
+        {"Slot Layout", test_slot_layout},
+        {"Damage Isolation", test_damage_isolation},
+        {"Receive Datagram", test_receive_datagram}};
+
+    // Run all tests and count failures
+    size_t num_tests = sizeof(test_cases) / sizeof(TestCase);
+    size_t passed_tests = 0;
+
+    for (size_t i = 0; i < num_tests; ++i)
+    {
+        std::cout << "\nRunning test: " << test_cases[i].name << std::endl;
+        if (test_cases[i].test_func())
+        {
+            passed_tests++;
+        }
+    }
+
+    // Print summary
+    std::cout << "\n==== Test Results ====\n";
+    std::cout << "Passed: " << passed_tests << "/" << num_tests
+              << " (" << (passed_tests * 100 / num_tests) << "%)" << std::endl;
+
+    // Return 0 if all tests passed, otherwise return the number of failures
+    return (passed_tests == num_tests) ? 0 : (num_tests - passed_tests);
+}
@@ -0,0 +1,178 @@
+#include "core/disruptor.h"
+#include "processing/fanout_dispatcher.h"
+#include <atomic>
+#include <cstring>
+#include <iostream>
+
+using namespace stream_buffer;
+using namespace stream_buffer::processing;
+
+// Unit test framework structure
+struct TestCase
+{
+    const char *name;
+    bool (*test_func)();
+};
+
+namespace
+{
+    constexpr size_t MESSAGE_COUNT = 200000;
+
+    // Sink checking sequence order and, optionally, that upstream sinks ran first
+    class SequenceSink : public IMessageSink
+    {
+    public:
+        SequenceSink() : handled(0), out_of_order(0), ahead_of_upstream(0), last_(0) {}
+
+        void OnMessage(const NormalizedMessage &message) override
+        {
+            if (message.information_seq != last_ + 1)
+            {
+                out_of_order++;
+            }
+            last_ = message.information_seq;
+
+            for (size_t i = 0; i < upstream.size(); ++i)
+            {
+                if (upstream[i]->handled.load(std::memory_order_acquire) < message.information_seq)
+                {
+                    ahead_of_upstream++;
+                }
+            }
+            handled.store(message.information_seq, std::memory_order_release);
+        }
+
+        std::atomic<common::u64> handled;
+        size_t out_of_order;
+        size_t ahead_of_upstream;
+        std::vector<const SequenceSink *> upstream;
+
+    private:
+        common::u32 last_;
+    };
+
+    bool Publish(FanOutDispatcher *dispatcher)
+    {
+        NormalizedMessage message;
+        std::memset(&message, 0, sizeof(message));
+        for (size_t i = 0; i < MESSAGE_COUNT; ++i)
+        {
+            message.information_seq = static_cast<common::u32>(i + 1);
+            dispatcher->OnMessage(message);
+        }
+        dispatcher->Drain();
+        return dispatcher->GetMaxLag() == 0;
+    }
+} // anonymous namespace
+
+// Test claim, publish and gating on a small ring
+bool test_disruptor_gating()
+{
+    core::Disruptor<int> ring(4);
+    size_t first = ring.AddConsumer();
+    size_t second = ring.AddConsumer(std::vector<size_t>(1, first));
+
+    common::i64 sequence = -1;
+    bool passed = ring.GetCapacity() == 4;
+    for (int i = 0; i < 4; ++i)
+    {
+        passed = passed && ring.TryNext(&sequence) && sequence == i;
+        ring.Get(sequence) = i * 10;
+        ring.Publish(sequence);
+    }
+
+    // Ring full until both consumers released slot 0
+    passed = passed && !ring.TryNext(&sequence) && ring.GetMaxLag() == 4;
+    passed = passed && ring.GetAvailable(first) == 3 && ring.GetAvailable(second) == -1;
+    ring.Release(first, 1);
+    passed = passed && ring.GetAvailable(second) == 1 && !ring.TryNext(&sequence);
+    ring.Release(second, 0);
+    passed = passed && ring.TryNext(&sequence) && sequence == 4 && ring.GetLag(second) == 3;
+    ring.Get(sequence) = 40;
+    ring.Publish(sequence);
+    passed = passed && ring.Get(4) == 40 && ring.GetMaxLag() == 4;
+
+    std::cout << "Disruptor gating test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Test that every consumer sees every message and dependencies hold
+bool test_fanout_dependencies()
+{
+    SequenceSink *book = new SequenceSink();
+    SequenceSink *stats = new SequenceSink();
+    SequenceSink *recorder = new SequenceSink();
+    recorder->upstream.push_back(book);
+    recorder->upstream.push_back(stats);
+
+    FanOutDispatcher dispatcher(1024);
+    size_t book_id = dispatcher.AddConsumer(std::unique_ptr<IMessageSink>(book));
+    size_t stats_id = dispatcher.AddConsumer(std::unique_ptr<IMessageSink>(stats));
+    std::vector<size_t> dependencies;
+    dependencies.push_back(book_id);
+    dependencies.push_back(stats_id);
+    dispatcher.AddConsumer(std::unique_ptr<IMessageSink>(recorder), dependencies);
+
+    bool passed = dispatcher.Start() && Publish(&dispatcher);
+    passed = passed &&
+             book->handled == MESSAGE_COUNT && stats->handled == MESSAGE_COUNT && recorder->handled == MESSAGE_COUNT &&
+             book->out_of_order == 0 && stats->out_of_order == 0 && recorder->out_of_order == 0 &&
+             recorder->ahead_of_upstream == 0 && dispatcher.GetPeakLag() <= 1024;
+
+    std::cout << "Fan-out dependencies test: " << (passed ? "PASSED" : "FAILED")
+              << " (peak lag " << dispatcher.GetPeakLag() << ")" << std::endl;
+    dispatcher.Stop();
+    return passed;
+}
+
+// Test delivery on the caller thread before Start
+bool test_fanout_inline()
+{
+    SequenceSink *first = new SequenceSink();
+    SequenceSink *second = new SequenceSink();
+    second->upstream.push_back(first);
+
+    FanOutDispatcher dispatcher(16);
+    size_t first_id = dispatcher.AddConsumer(std::unique_ptr<IMessageSink>(first));
+    dispatcher.AddConsumer(std::unique_ptr<IMessageSink>(second), std::vector<size_t>(1, first_id));
+
+    bool passed = Publish(&dispatcher) &&
+                  first->handled == MESSAGE_COUNT && second->handled == MESSAGE_COUNT &&
+                  second->ahead_of_upstream == 0;
+
+    std::cout << "Fan-out inline test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+int main()
+{
+    std::cout << "==== Fan-out Dispatcher Unit Tests ====\n"
+              << std::endl;
+
+    // Define all test cases
+    TestCase test_cases[] = {
+        {"Disruptor Gating", test_disruptor_gating},
+        {"Fan-out Dependencies", test_fanout_dependencies},
+        {"Fan-out Inline", test_fanout_inline}};
+
+    // Run all tests and count failures
+    size_t num_tests = sizeof(test_cases) / sizeof(TestCase);
+    size_t passed_tests = 0;
+
+    for (size_t i = 0; i < num_tests; ++i)
+    {
+        std::cout << "\nRunning test: " << test_cases[i].name << std::endl;
+        if (test_cases[i].test_func())
+        {
+            passed_tests++;
+        }
+    }
+
+    // Print summary
+    std::cout << "\n==== Test Results ====\n";
+    std::cout << "Passed: " << passed_tests << "/" << num_tests
+              << " (" << (passed_tests * 100 / num_tests) << "%)" << std::endl;
+
+    // Return 0 if all tests passed, otherwise return the number of failures
+    return (passed_tests == num_tests) ? 0 : (num_tests - passed_tests);
+}
@@ -0,0 +1,186 @@
+#include "processing/latency_tracker.h"
+#include "processing/tfe_processor.h"
+#include "tfe_test_packets.h"
+#include <iostream>
+#include <cstring>
+#include <vector>
+
+using namespace stream_buffer;
+using namespace stream_buffer::processing;
+using namespace stream_buffer::testing;
+
+// Unit test framework structure
+struct TestCase
+{
+    const char *name;
+    bool (*test_func)();
+};
+
+namespace
+{
+    const common::i64 NS_PER_US = 1000;
+    const common::i64 NS_PER_HOUR = 3600LL * 1000000000LL;
+
+    // CLOCK_REALTIME time at which a Taipei time of day falls, on 1 January 1970
+    common::i64 TaipeiToRealtime(common::i64 time_of_day_ns)
+    {
+        return time_of_day_ns - 8 * NS_PER_HOUR;
+    }
+
+    bool IsNear(common::i64 value, common::i64 expected)
+    {
+        // Bucket bounds are within 1/16 of the value
+        common::i64 distance = value > expected ? value - expected : expected - value;
+        return distance <= expected / 16 + 1;
+    }
+} // anonymous namespace
+
+// Every value lands in a bucket whose bound is just above it, in increasing order
+bool test_buckets()
+{
+    bool passed = true;
+    size_t previous = 0;
+    for (common::u64 value = 0; value < (1ULL << 40) && passed; value = value < 64 ? value + 1 : value + value / 7)
+    {
+        size_t bucket = LatencyTracker::GetBucket(value);
+        common::u64 bound = LatencyTracker::GetBucketUpperBound(bucket);
+        passed = bucket >= previous && bound >= value && bound - value <= value / 16;
+        passed = passed && (bucket == 0 || LatencyTracker::GetBucketUpperBound(bucket - 1) < value);
+        previous = bucket;
+    }
+    passed = passed && LatencyTracker::GetBucket(~0ULL) == constants::LATENCY_BUCKETS - 1;
+
+    std::cout << "Buckets test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Percentiles come from the line and kind recorded, within a bucket's width
+bool test_percentiles()
+{
+    LatencyTracker tracker;
+    common::i64 open = ((8 * 60 + 45) * 60) * 1000000000LL;
+    for (common::i64 i = 1; i <= 1000; ++i)
+    {
+        tracker.Record('2', LatencyKind::TRADE, open, TaipeiToRealtime(open + i * NS_PER_US));
+    }
+    tracker.Record('5', LatencyKind::QUOTE, open, TaipeiToRealtime(open + 7 * NS_PER_US));
+
+    LatencySnapshot trades = tracker.Snapshot('2', LatencyKind::TRADE);
+    bool passed = trades.count == 1000 && trades.negative == 0 && trades.invalid == 0;
+    passed = passed && IsNear(trades.GetPercentile(0.50), 500 * NS_PER_US);
+    passed = passed && IsNear(trades.GetPercentile(0.99), 990 * NS_PER_US);
+    passed = passed && trades.GetPercentile(1.0) == 1000 * NS_PER_US;
+    passed = passed && trades.min_ns == NS_PER_US && trades.max_ns == 1000 * NS_PER_US;
+    passed = passed && trades.sum_ns == 500500 * NS_PER_US;
+
+    // Other lines and kinds are kept apart, and merged in the total
+    passed = passed && tracker.Snapshot('2', LatencyKind::QUOTE).count == 0;
+    passed = passed && tracker.Snapshot('5', LatencyKind::QUOTE).max_ns == 7 * NS_PER_US;
+    LatencySnapshot all = tracker.SnapshotAll();
+    passed = passed && all.count == 1001 && all.min_ns == NS_PER_US;
+
+    std::string text = tracker.Format();
+    passed = passed && text.find("latency line2 trade count=1000 ") != std::string::npos;
+    passed = passed && text.find("latency line5 quote count=1 ") != std::string::npos;
+    passed = passed && text.find("latency all all count=1001 ") != std::string::npos;
+    passed = passed && text.find("line1") == std::string::npos;
+
+    std::cout << "Percentiles test: " << (passed ? "PASSED" : "FAILED") << " (p50 "
+              << trades.GetPercentile(0.50) << " ns, p99 " << trades.GetPercentile(0.99) << " ns)" << std::endl;
+    return passed;
+}
+
+// Latency across midnight, clock skew and invalid timestamps
+bool test_midnight()
+{
+    LatencyTracker tracker;
+    common::i64 day = 24 * NS_PER_HOUR;
+
+    // Stamped a millisecond before midnight, received a millisecond after, days after the epoch
+    tracker.Record('2', LatencyKind::TRADE, day - 1000000, TaipeiToRealtime(20000 * day + 1000000));
+    LatencySnapshot wrapped = tracker.Snapshot('2', LatencyKind::TRADE);
+    bool passed = wrapped.count == 1 && wrapped.min_ns == 2000000;
+
+    // Our clock behind the exchange's across midnight
+    tracker.Record('2', LatencyKind::QUOTE, 500, TaipeiToRealtime(day - 500));
+    LatencySnapshot skewed = tracker.Snapshot('2', LatencyKind::QUOTE);
+    passed = passed && skewed.count == 1 && skewed.negative == 1 && skewed.min_ns == -1000;
+    passed = passed && skewed.GetPercentile(0.5) == -1000;
+
+    // Hour 25 is not a time of day
+    tracker.Record('2', LatencyKind::OTHER, 25 * NS_PER_HOUR, TaipeiToRealtime(NS_PER_HOUR));
+    LatencySnapshot invalid = tracker.Snapshot('2', LatencyKind::OTHER);
+    passed = passed && invalid.count == 0 && invalid.invalid == 1;
+
+    // Another offset moves the local midnight
+    LatencyTracker utc(0);
+    utc.Record('1', LatencyKind::I010, NS_PER_HOUR, NS_PER_HOUR + 5000);
+    passed = passed && utc.Snapshot('1', LatencyKind::I010).max_ns == 5000;
+
+    std::cout << "Midnight test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// The processor compares every packet with its datagram's kernel receive time
+bool test_processor()
+{
+    const uint64_t information_time = 93000123456ULL; // 09:30:00.123456
+    common::i64 information_ns = ((9 * 60 + 30) * 60) * 1000000000LL + 123456000LL;
+    std::vector<char> quote = MakeI080Packet(information_time);
+
+    std::vector<char> slot_data(core::GetSlotSize(2 * quote.size()), 0);
+    core::DatagramSlot *slot = reinterpret_cast<core::DatagramSlot *>(slot_data.data());
+    slot->length = static_cast<common::u32>(2 * quote.size());
+    slot->receive_time_ns = TaipeiToRealtime(information_ns + 250 * NS_PER_US);
+    std::memcpy(&slot_data[sizeof(core::DatagramSlot)], quote.data(), quote.size());
+    std::memcpy(&slot_data[sizeof(core::DatagramSlot) + quote.size()], quote.data(), quote.size());
+
+    LatencyTracker tracker;
+    TFEProcessor processor;
+    processor.SetLatencyTracker(&tracker);
+    core::BatchResult result = processor.ProcessDatagram(*slot);
+    LatencySnapshot quotes = tracker.Snapshot('2', LatencyKind::QUOTE);
+    bool passed = result.message_count == 2 && quotes.count == 2;
+    passed = passed && quotes.min_ns == 250 * NS_PER_US && quotes.max_ns == 250 * NS_PER_US;
+
+    // Byte-stream batches are stamped when decoded
+    result = processor.ProcessBatch(quote.data(), quote.size());
+    passed = passed && result.message_count == 1 && tracker.Snapshot('2', LatencyKind::QUOTE).count == 3;
+
+    std::cout << "Processor test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+int main()
+{
+    std::cout << "==== Latency Tracker Unit Tests ====\n"
+              << std::endl;
+
+    // Define all test cases
+    TestCase test_cases[] = {
+        {"Buckets", test_buckets},
+        {"Percentiles", test_percentiles},
+        {"Midnight", test_midnight},
+        {"Processor", test_processor}};
+
+    // Run all tests and count failures
+    size_t num_tests = sizeof(test_cases) / sizeof(TestCase);
+    size_t passed_tests = 0;
+
+    for (size_t i = 0; i < num_tests; ++i)
+    {
+        std::cout << "\nRunning test: " << test_cases[i].name << std::endl;
+        if (test_cases[i].test_func())
+        {
+            passed_tests++;
+        }
+    }
+
+    // Print summary
+    std::cout << "\n==== Test Results ====\n";
+    std::cout << "Passed: " << passed_tests << "/" << num_tests
+              << " (" << (passed_tests * 100 / num_tests) << "%)" << std::endl;
+
+    // Return 0 if all tests passed, otherwise return the number of failures
+    return (passed_tests == num_tests) ? 0 : (num_tests - passed_tests);
+}
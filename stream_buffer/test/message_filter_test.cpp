@@ -0,0 +1,223 @@
+#include "processing/message_filter.h"
+#include "processing/tfe_processor.h"
+#include "tfe_test_packets.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace stream_buffer;
+using namespace stream_buffer::processing;
+using namespace stream_buffer::testing;
+
+// Unit test framework structure
+struct TestCase
+{
+    const char *name;
+    bool (*test_func)();
+};
+
+namespace
+{
+    // Build an I080 packet for any product
+    std::vector<char> MakeQuote(const char *product_id)
+    {
+        tfe::BodyI080 body;
+        std::memset(&body, 0, sizeof(body));
+        std::memcpy(body.prod_id_s, product_id, sizeof(body.prod_id_s));
+        return MakePacket('2', '2', &body, sizeof(body));
+    }
+
+    bool Accept(MessageFilter &filter, const std::vector<char> &packet)
+    {
+        return filter.Accept(packet.data(), packet.size() - tfe::CalculatePacketSize(0));
+    }
+
+    void MakeOptionId(common::u32 strike, char month, char *product_id)
+    {
+        char text[constants::PRODUCT_ID_SIZE + 1];
+        std::snprintf(text, sizeof(text), "TXO%05u%c4", strike, month);
+        std::memcpy(product_id, text, constants::PRODUCT_ID_SIZE);
+    }
+
+    // Counts every message it is given
+    class CountingSink : public IMessageSink
+    {
+    public:
+        size_t count = 0;
+
+        void OnMessage(const NormalizedMessage &) override { count++; }
+    };
+} // anonymous namespace
+
+// Configuration lists parse into the subscription, bad items are refused
+bool test_parse()
+{
+    std::vector<std::pair<char, char>> types;
+    bool passed = ParseMessageTypes(" 1:1, 2:2,,5:2 ", &types) && types.size() == 3;
+    passed = passed && types[0] == std::make_pair('1', '1') && types[2] == std::make_pair('5', '2');
+    passed = passed && ParseMessageTypes("", &types) && types.size() == 3;
+    passed = passed && !ParseMessageTypes("12:1", &types) && !ParseMessageTypes("2-1", &types);
+
+    std::vector<std::string> products;
+    passed = passed && ParseProductList(" TXFL4 ,MXFL4,, TXO17000L4", &products) && products.size() == 3;
+    passed = passed && products[0] == "TXFL4" && products[2] == "TXO17000L4";
+    passed = passed && !ParseProductList("TXO17000L4X", &products);
+
+    std::cout << "Parse test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Only subscribed message types pass, and every rejection is counted
+bool test_message_types()
+{
+    MessageFilter all;
+    bool passed = !all.IsEnabled() && Accept(all, MakeI080Packet()) && Accept(all, MakePacket('3', '1', "\x00\x01", 2));
+
+    common::SubscriptionConfig config;
+    config.message_types.push_back(std::make_pair('1', '1'));
+    config.message_types.push_back(std::make_pair('2', '2'));
+    MessageFilter filter(config);
+    passed = passed && filter.IsEnabled();
+    passed = passed && Accept(filter, MakeI010Packet()) && Accept(filter, MakeI080Packet());
+    passed = passed && !Accept(filter, MakePacket('2', '1', "\x00\x01", 2));
+    passed = passed && !Accept(filter, MakePacket('5', '2', "\x00\x01", 2));
+    passed = passed && filter.GetSkippedCount() == 2 && all.GetSkippedCount() == 0;
+
+    std::cout << "Message Types test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// The product list applies to product-keyed types only
+bool test_products()
+{
+    common::SubscriptionConfig config;
+    config.products.push_back("TXFL4");
+    MessageFilter filter(config);
+
+    bool passed = Accept(filter, MakeQuote("TXFL4     ")) && !Accept(filter, MakeQuote("MXFL4     "));
+
+    // A type without a product id, or a body too short to hold one, is not product filtered
+    passed = passed && Accept(filter, MakePacket('3', '1', "MXFL4     ", 10));
+    passed = passed && Accept(filter, MakePacket('2', '2', "MXFL", 4));
+    passed = passed && filter.GetSkippedCount() == 1;
+
+    // Both checks apply when both lists are set
+    config.message_types.push_back(std::make_pair('2', '2'));
+    MessageFilter both(config);
+    passed = passed && Accept(both, MakeQuote("TXFL4     ")) && !Accept(both, MakeQuote("MXFL4     "));
+    passed = passed && !Accept(both, MakePacket('2', '1', "TXFL4     ", 10)) && both.GetSkippedCount() == 2;
+
+    std::cout << "Products test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// A subscribed product always passes; neighbouring series rarely collide
+bool test_product_hash()
+{
+    common::SubscriptionConfig config;
+    char product_id[constants::PRODUCT_ID_SIZE + 1] = {0};
+    for (common::u32 strike = 17000; strike < 18000; strike += 10)
+    {
+        MakeOptionId(strike, 'L', product_id);
+        config.products.push_back(product_id);
+    }
+    MessageFilter filter(config);
+
+    bool passed = true;
+    for (common::u32 strike = 17000; strike < 18000; strike += 10)
+    {
+        MakeOptionId(strike, 'L', product_id);
+        passed = passed && Accept(filter, MakeQuote(product_id));
+    }
+    passed = passed && filter.GetSkippedCount() == 0;
+
+    // Other strikes and months of the same chain
+    size_t tested = 0;
+    size_t collisions = 0;
+    for (char month = 'A'; month <= 'X'; ++month)
+    {
+        for (common::u32 strike = 15000; strike < 20000; strike += 5)
+        {
+            if (month == 'L' && strike >= 17000 && strike < 18000 && strike % 10 == 0)
+            {
+                continue;
+            }
+            MakeOptionId(strike, month, product_id);
+            collisions += Accept(filter, MakeQuote(product_id)) ? 1 : 0;
+            tested++;
+        }
+    }
+    passed = passed && collisions * 100 < tested;
+
+    std::cout << "Product Hash test: " << (passed ? "PASSED" : "FAILED")
+              << " (" << collisions << "/" << tested << " collisions)" << std::endl;
+    return passed;
+}
+
+// TFEProcessor skips unsubscribed packets whole, before the checksum is checked
+bool test_processor()
+{
+    common::SubscriptionConfig config;
+    config.message_types.push_back(std::make_pair('1', '1'));
+    config.message_types.push_back(std::make_pair('2', '2'));
+    config.products.push_back("TXFL4");
+    MessageFilter filter(config);
+    TFEProcessor processor(nullptr, &filter);
+    CountingSink sink;
+    processor.AddSink(&sink);
+
+    std::vector<char> bad_checksum = MakeQuote("MXFL4     ");
+    bad_checksum[bad_checksum.size() - 3] ^= 0x01;
+    std::vector<char> packets[] = {MakeI010Packet(), MakeQuote("MXFL4     "), MakePacket('3', '1', "\x00\x01", 2),
+                                   bad_checksum, MakeI080Packet()};
+    std::vector<char> stream;
+    for (size_t i = 0; i < sizeof(packets) / sizeof(packets[0]); ++i)
+    {
+        stream.insert(stream.end(), packets[i].begin(), packets[i].end());
+    }
+
+    core::BatchResult result = processor.ProcessBatch(stream.data(), stream.size());
+    bool passed = result.bytes_consumed == stream.size() && result.message_count == 2;
+    passed = passed && sink.count == 2 && filter.GetSkippedCount() == 3;
+
+    std::cout << "Processor test: " << (passed ? "PASSED" : "FAILED")
+              << " (" << sink.count << " delivered, " << filter.GetSkippedCount() << " skipped)" << std::endl;
+    return passed;
+}
+
+int main()
+{
+    std::cout << "==== Message Filter Unit Tests ====\n"
+              << std::endl;
+
+    // Define all test cases
+    TestCase test_cases[] = {
+        {"Parse", test_parse},
+        {"Message Types", test_message_types},
+        {"Products", test_products},
+        {"Product Hash", test_product_hash},
+        {"Processor", test_processor}};
+
+    // Run all tests and count failures
+    size_t num_tests = sizeof(test_cases) / sizeof(TestCase);
+    size_t passed_tests = 0;
+
+    for (size_t i = 0; i < num_tests; ++i)
+    {
+        std::cout << "\nRunning test: " << test_cases[i].name << std::endl;
+        if (test_cases[i].test_func())
+        {
+            passed_tests++;
+        }
+    }
+
+    // Print summary
+    std::cout << "\n==== Test Results ====\n";
+    std::cout << "Passed: " << passed_tests << "/" << num_tests
+              << " (" << (passed_tests * 100 / num_tests) << "%)" << std::endl;
+
+    // Return 0 if all tests passed, otherwise return the number of failures
+    return (passed_tests == num_tests) ? 0 : (num_tests - passed_tests);
+}
@@ -0,0 +1,169 @@
+#include "utils/metrics.h"
+#include "ipc/stats_server.h"
+#include <pthread.h>
+#include <unistd.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace stream_buffer;
+using namespace stream_buffer::utils;
+
+// Unit test framework structure
+struct TestCase
+{
+    const char *name;
+    bool (*test_func)();
+};
+
+namespace
+{
+    const size_t INCREMENTS_PER_THREAD = 100000;
+
+    void *CountPackets(void *arg)
+    {
+        MetricsRegistry *registry = static_cast<MetricsRegistry *>(arg);
+        for (size_t i = 0; i < INCREMENTS_PER_THREAD; ++i)
+        {
+            registry->Add(Counter::PACKETS_RECEIVED);
+            registry->Add(Counter::BYTES_RECEIVED, 3);
+        }
+        registry->Record(Histogram::DATAGRAM_BYTES, 100);
+        return nullptr;
+    }
+} // anonymous namespace
+
+// Per-thread blocks, including the shared one, add up in the snapshot
+bool test_thread_aggregation()
+{
+    MetricsRegistry registry;
+
+    // More threads than private blocks, so some share the last one
+    const size_t thread_count = constants::MAX_METRIC_THREADS + 8;
+    std::vector<pthread_t> threads(thread_count);
+    for (size_t i = 0; i < thread_count; ++i)
+    {
+        pthread_create(&threads[i], nullptr, CountPackets, &registry);
+    }
+    for (size_t i = 0; i < thread_count; ++i)
+    {
+        pthread_join(threads[i], nullptr);
+    }
+
+    MetricsSnapshot snapshot = registry.Snapshot();
+    bool passed = snapshot.Get(Counter::PACKETS_RECEIVED) == thread_count * INCREMENTS_PER_THREAD;
+    passed = passed && snapshot.Get(Counter::BYTES_RECEIVED) == 3 * thread_count * INCREMENTS_PER_THREAD;
+    passed = passed && snapshot.Get(Histogram::DATAGRAM_BYTES).count == thread_count;
+    passed = passed && snapshot.Get(Counter::RESYNCS) == 0;
+
+    std::cout << "Thread aggregation test: " << (passed ? "PASSED" : "FAILED")
+              << " (" << snapshot.Get(Counter::PACKETS_RECEIVED) << " packets)" << std::endl;
+    return passed;
+}
+
+// Values land in power-of-two buckets and quantiles report bucket bounds
+bool test_histogram()
+{
+    MetricsRegistry registry;
+    for (common::u64 value = 1; value <= 100; ++value)
+    {
+        registry.Record(Histogram::BATCH_MESSAGES, value);
+    }
+    registry.Record(Histogram::BATCH_MESSAGES, 5000);
+
+    MetricsSnapshot snapshot = registry.Snapshot();
+    const HistogramSnapshot &histogram = snapshot.Get(Histogram::BATCH_MESSAGES);
+    bool passed = MetricsRegistry::GetBucket(0) == 0 && MetricsRegistry::GetBucket(1) == 1 &&
+                  MetricsRegistry::GetBucket(7) == 3 && MetricsRegistry::GetBucket(8) == 4 &&
+                  MetricsRegistry::GetBucket(~0ULL) == constants::HISTOGRAM_BUCKETS - 1;
+    passed = passed && histogram.count == 101 && histogram.sum == 5050 + 5000;
+    passed = passed && histogram.GetQuantile(0.5) == 63;    // 51 lies in [32, 64)
+    passed = passed && histogram.GetQuantile(0.99) == 127;  // 100 lies in [64, 128)
+    passed = passed && histogram.GetQuantile(1.0) == 8191;  // 5000 lies in [4096, 8192)
+
+    std::cout << "Histogram test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Gauges keep the last value and every metric appears in the text format
+bool test_format()
+{
+    MetricsRegistry registry;
+    registry.Set(Gauge::BUFFER_QUEUED_BYTES, 10);
+    registry.Set(Gauge::BUFFER_QUEUED_BYTES, 42);
+    registry.Add(Counter::CHECKSUM_FAILURES, 2);
+
+    std::string text = registry.Snapshot().Format();
+    bool passed = text.find("gauge buffer_queued_bytes 42\n") != std::string::npos;
+    passed = passed && text.find("counter checksum_failures 2\n") != std::string::npos;
+    passed = passed && text.find("histogram datagram_bytes count=0") != std::string::npos;
+
+    size_t lines = 0;
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        lines += text[i] == '\n';
+    }
+    passed = passed && lines == COUNTER_COUNT + GAUGE_COUNT + HISTOGRAM_COUNT;
+
+    std::cout << "Format test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// A client reads the current snapshot over the Unix socket
+bool test_stats_server()
+{
+    MetricsRegistry registry;
+    registry.Add(Counter::MESSAGES_TRADE, 7);
+
+    std::string path = "/tmp/stream_buffer_metrics_test." + std::to_string(getpid());
+    ipc::StatsServer server(registry);
+    bool passed = server.Start(path);
+
+    std::string first, second;
+    passed = passed && ipc::QueryStats(path, &first);
+    registry.Add(Counter::MESSAGES_TRADE, 1);
+    passed = passed && ipc::QueryStats(path, &second);
+    passed = passed && first.find("counter messages_trade 7\n") != std::string::npos;
+    passed = passed && second.find("counter messages_trade 8\n") != std::string::npos;
+    passed = passed && server.GetServedCount() == 2;
+
+    server.Stop();
+    passed = passed && !ipc::QueryStats(path, &first) && access(path.c_str(), F_OK) != 0;
+
+    std::cout << "Stats server test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+int main()
+{
+    std::cout << "==== Metrics Unit Tests ====\n"
+              << std::endl;
+
+    // Define all test cases
+    TestCase test_cases[] = {
+        {"Thread Aggregation", test_thread_aggregation},
+        {"Histogram", test_histogram},
+        {"Format", test_format},
+        {"Stats Server", test_stats_server}};
+
+    // Run all tests and count failures
+    size_t num_tests = sizeof(test_cases) / sizeof(TestCase);
+    size_t passed_tests = 0;
+
+    for (size_t i = 0; i < num_tests; ++i)
+    {
+        std::cout << "\nRunning test: " << test_cases[i].name << std::endl;
+        if (test_cases[i].test_func())
+        {
+            passed_tests++;
+        }
+    }
+
+    // Print summary
+    std::cout << "\n==== Test Results ====\n";
+    std::cout << "Passed: " << passed_tests << "/" << num_tests
+              << " (" << (passed_tests * 100 / num_tests) << "%)" << std::endl;
+
+    // Return 0 if all tests passed, otherwise return the number of failures
+    return (passed_tests == num_tests) ? 0 : (num_tests - passed_tests);
+}
@@ -0,0 +1,206 @@
+#include "core/overflow.h"
+#include "core/buffer.h"
+#include "core/thread_sync.h"
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+using namespace stream_buffer;
+using namespace stream_buffer::core;
+
+// Unit test framework structure
+struct TestCase
+{
+    const char *name;
+    bool (*test_func)();
+};
+
+namespace
+{
+    std::string TempPath(const char *name)
+    {
+        return std::string("/tmp/stream_buffer_") + name + "_" + std::to_string(getpid());
+    }
+
+    struct SignalArgs
+    {
+        ThreadSync *sync;
+        bool *ready;
+    };
+
+    void *SignalLater(void *arg)
+    {
+        SignalArgs *args = static_cast<SignalArgs *>(arg);
+        struct timespec delay = {0, 20000000};
+        nanosleep(&delay, nullptr);
+
+        args->sync->Lock();
+        *args->ready = true;
+        args->sync->Broadcast();
+        args->sync->Unlock();
+        return nullptr;
+    }
+} // namespace
+
+// Spilled bytes come back in order and the file restarts once drained
+bool test_spill_segment()
+{
+    SpillSegment spill;
+    bool passed = spill.Open(TempPath("spill"));
+
+    const char first[] = "first datagram";
+    const char second[] = "second";
+    passed = passed && spill.Append(first, sizeof(first) - 1);
+    passed = passed && spill.Append(second, sizeof(second) - 1);
+    passed = passed && spill.GetPendingSize() == sizeof(first) - 1 + sizeof(second) - 1;
+
+    // Read in a smaller chunk than what was written
+    char data[64];
+    size_t read = spill.Read(data, 5);
+    passed = passed && read == 5 && std::memcmp(data, "first", 5) == 0;
+    read = spill.Read(data, sizeof(data));
+    passed = passed && read == sizeof(first) - 1 - 5 + sizeof(second) - 1;
+    passed = passed && std::memcmp(data, " datagramsecond", read) == 0;
+    passed = passed && spill.IsEmpty() && spill.Read(data, sizeof(data)) == 0;
+
+    // Writes after a full drain start at the front again
+    passed = passed && spill.Append(second, sizeof(second) - 1);
+    read = spill.Read(data, sizeof(data));
+    passed = passed && read == sizeof(second) - 1 && std::memcmp(data, second, read) == 0;
+
+    spill.Close();
+    passed = passed && !spill.IsOpen() && access(TempPath("spill").c_str(), F_OK) != 0;
+    passed = passed && !spill.Append(first, 1);
+
+    std::cout << "Spill segment test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Growing keeps the queued bytes and frees the consumed prefix
+bool test_buffer_grow()
+{
+    Buffer buffer(64);
+    std::memcpy(buffer.GetBufferEndPtr(), "0123456789abcdef", 16);
+    buffer.AppendData(16);
+    buffer.RemoveProcessedData(6);
+
+    bool passed = buffer.Grow(64);
+    passed = passed && buffer.GetTotalCapacity() == 128;
+    passed = passed && buffer.GetBufferTop() == 0 && buffer.GetQueuedSize() == 10;
+    passed = passed && std::memcmp(buffer.GetBufferTopPtr(), "6789abcdef", 10) == 0;
+    passed = passed && buffer.GetAvailableSize() == 118;
+
+    std::cout << "Buffer grow test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Compacting a drained buffer rewinds it, so a blocked receive gets its space back
+bool test_compact_drained()
+{
+    Buffer buffer(64);
+    buffer.AppendData(60);
+    buffer.RemoveProcessedData(60);
+
+    bool passed = buffer.ShouldCompact() && buffer.GetAvailableSize() == 4;
+    buffer.CompactBuffer();
+    passed = passed && buffer.GetBufferTop() == 0 && buffer.GetBufferEnd() == 0;
+    passed = passed && buffer.GetAvailableSize() == 64 && !buffer.ShouldCompact();
+
+    std::cout << "Compact drained test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// A timed wait returns false after the timeout and true when woken
+bool test_timed_wait()
+{
+    ThreadSync sync;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    sync.Lock();
+    bool woken = sync.TimedWait(30);
+    sync.Unlock();
+    long long waited = std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+    bool passed = !woken && waited >= 25;
+
+    bool ready = false;
+    SignalArgs args = {&sync, &ready};
+    pthread_t thread;
+    pthread_create(&thread, nullptr, SignalLater, &args);
+
+    sync.Lock();
+    while (!ready && sync.TimedWait(5000))
+    {
+    }
+    passed = passed && ready;
+    sync.Unlock();
+    pthread_join(thread, nullptr);
+
+    std::cout << "Timed wait test: " << (passed ? "PASSED" : "FAILED")
+              << " (timed out after " << waited << "ms)" << std::endl;
+    return passed;
+}
+
+// Counters snapshot and policy names used by the configuration file
+bool test_counters()
+{
+    OverflowCounters counters;
+    OverflowCounters::Add(counters.dropped_datagrams, 2);
+    OverflowCounters::Add(counters.dropped_bytes, 300);
+    OverflowCounters::Add(counters.grow_count, 1);
+    OverflowStats stats = counters.Snapshot();
+
+    bool passed = stats.dropped_datagrams == 2 && stats.dropped_bytes == 300 && stats.grow_count == 1;
+    passed = passed && stats.full_events == 0 && stats.spilled_bytes == 0;
+    std::string text = stats.Format();
+    passed = passed && text.find("counter overflow_dropped_datagrams 2\n") != std::string::npos;
+    passed = passed && text.find("counter overflow_grow_count 1\n") != std::string::npos;
+    passed = passed && text.find("counter overflow_spill_errors 0\n") != std::string::npos;
+    passed = passed && std::string(OverflowPolicyName(common::OverflowPolicy::BLOCK)) == "block";
+    passed = passed && std::string(OverflowPolicyName(common::OverflowPolicy::DROP_NEWEST)) == "drop";
+    passed = passed && std::string(OverflowPolicyName(common::OverflowPolicy::SPILL)) == "spill";
+    passed = passed && std::string(OverflowPolicyName(common::OverflowPolicy::GROW)) == "grow";
+
+    std::cout << "Overflow counters test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+int main()
+{
+    std::cout << "==== Overflow Policy Unit Tests ====\n"
+              << std::endl;
+
+    // Define all test cases
+    TestCase test_cases[] = {
+        {"Spill Segment", test_spill_segment},
+        {"Buffer Grow", test_buffer_grow},
+        {"Compact Drained", test_compact_drained},
+        {"Timed Wait", test_timed_wait},
+        {"Overflow Counters", test_counters}};
+
+    // Run all tests and count failures
+    size_t num_tests = sizeof(test_cases) / sizeof(TestCase);
+    size_t passed_tests = 0;
+
+    for (size_t i = 0; i < num_tests; ++i)
+    {
+        std::cout << "\nRunning test: " << test_cases[i].name << std::endl;
+        if (test_cases[i].test_func())
+        {
+            passed_tests++;
+        }
+    }
+
+    // Print summary
+    std::cout << "\n==== Test Results ====\n";
+    std::cout << "Passed: " << passed_tests << "/" << num_tests
+              << " (" << (passed_tests * 100 / num_tests) << "%)" << std::endl;
+
+    // Return 0 if all tests passed, otherwise return the number of failures
+    return (passed_tests == num_tests) ? 0 : (num_tests - passed_tests);
+}
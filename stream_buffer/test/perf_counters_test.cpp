@@ -0,0 +1,174 @@
+#include "utils/perf_counters.h"
+#include "processing/tfe_processor.h"
+#include "tfe_test_packets.h"
+#include <iostream>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace stream_buffer;
+using namespace stream_buffer::utils;
+using namespace stream_buffer::testing;
+
+// Unit test framework structure
+struct TestCase
+{
+    const char *name;
+    bool (*test_func)();
+};
+
+namespace
+{
+    const common::u32 ALL_EVENTS = (1U << PERF_EVENT_COUNT) - 1;
+
+    PerfSample MakeSample(common::u64 task_ns, common::u64 cycles, common::u64 instructions)
+    {
+        PerfSample sample;
+        sample.values[static_cast<size_t>(PerfEvent::TASK_CLOCK)] = task_ns;
+        sample.values[static_cast<size_t>(PerfEvent::CYCLES)] = cycles;
+        sample.values[static_cast<size_t>(PerfEvent::INSTRUCTIONS)] = instructions;
+        return sample;
+    }
+} // anonymous namespace
+
+// The group counts the calling thread; hardware events only where exposed
+bool test_counter_group()
+{
+    PerfCounterGroup group;
+    if (!group.Open())
+    {
+        std::cout << "Counter group test: SKIPPED (perf_event_open unavailable)" << std::endl;
+        return true;
+    }
+
+    PerfSample before, after;
+    bool passed = group.Read(&before);
+    volatile common::u64 sum = 0;
+    for (common::u64 i = 0; i < 1000000; ++i)
+    {
+        sum = sum + i;
+    }
+    passed = passed && group.Read(&after);
+    passed = passed && group.HasEvent(PerfEvent::TASK_CLOCK);
+    passed = passed && after.Get(PerfEvent::TASK_CLOCK) > before.Get(PerfEvent::TASK_CLOCK);
+
+    // At least one instruction per iteration
+    if (group.HasEvent(PerfEvent::INSTRUCTIONS))
+    {
+        passed = passed && after.Get(PerfEvent::INSTRUCTIONS) - before.Get(PerfEvent::INSTRUCTIONS) > 1000000;
+    }
+
+    group.Close();
+    passed = passed && !group.IsOpen() && !group.Read(&after);
+
+    std::cout << "Counter group test: " << (passed ? "PASSED" : "FAILED")
+              << " (events 0x" << std::hex << group.GetEventMask() << std::dec << ", "
+              << (after.Get(PerfEvent::TASK_CLOCK) - before.Get(PerfEvent::TASK_CLOCK)) << " ns)" << std::endl;
+    return passed;
+}
+
+// Totals are reported per scope, per message and per byte, for common events only
+bool test_profiler_format()
+{
+    PerfProfiler profiler;
+    bool passed = profiler.GetEventMask() == 0 && profiler.Format().empty();
+
+    profiler.Add(PerfScope::TRADE, MakeSample(100, 400, 800), 100, ALL_EVENTS);
+    profiler.Add(PerfScope::TRADE, MakeSample(300, 600, 1200), 300, ALL_EVENTS);
+
+    PerfScopeStats trade = profiler.GetStats(PerfScope::TRADE);
+    passed = passed && trade.count == 2 && trade.bytes == 400 && trade.events.Get(PerfEvent::CYCLES) == 1000;
+    passed = passed && profiler.GetStats(PerfScope::QUOTE).count == 0;
+
+    std::string text = profiler.Format();
+    passed = passed && text.find("perf trade count=2 bytes=400 task_ns=400 cycles=1000 instructions=2000") == 0;
+    passed = passed && text.find(" ipc=2.00\n") != std::string::npos;
+    passed = passed && text.find("perf trade per_message task_ns=200.0 cycles=500.0") != std::string::npos;
+    passed = passed && text.find("perf trade per_byte task_ns=1.000 cycles=2.500") != std::string::npos;
+    passed = passed && text.find("perf quote") == std::string::npos;
+
+    // A thread without hardware counters limits the report to the task clock
+    profiler.Add(PerfScope::RECEIVE, MakeSample(50, 0, 0), 60, 1U << static_cast<size_t>(PerfEvent::TASK_CLOCK));
+    text = profiler.Format();
+    passed = passed && text.find("perf receive count=1 bytes=60 task_ns=50\n") != std::string::npos;
+    passed = passed && text.find("cycles") == std::string::npos;
+
+    std::cout << "Profiler format test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Profiled decoding gives the same result and attributes every packet to its type
+bool test_profiled_decode()
+{
+    std::vector<char> i010 = MakeI010Packet();
+    std::vector<char> quote = MakeI080Packet();
+    std::vector<char> stream(i010);
+    stream.insert(stream.end(), quote.begin(), quote.end());
+    stream.insert(stream.end(), 7, 'x');
+    stream.insert(stream.end(), quote.begin(), quote.end());
+
+    processing::TFEProcessor plain;
+    core::BatchResult expected = plain.ProcessBatch(stream.data(), stream.size());
+
+    PerfProfiler profiler;
+    processing::TFEProcessor profiled;
+    profiled.EnableProfiling(&profiler);
+    core::BatchResult result = profiled.ProcessBatch(stream.data(), stream.size());
+
+    bool passed = result.bytes_consumed == expected.bytes_consumed && result.message_count == expected.message_count;
+    passed = passed && result.bytes_consumed == stream.size() && result.message_count == 3;
+
+    PerfCounterGroup probe;
+    if (!probe.Open())
+    {
+        std::cout << "Profiled decode test: " << (passed ? "PASSED" : "FAILED")
+                  << " (counts SKIPPED, perf_event_open unavailable)" << std::endl;
+        return passed;
+    }
+
+    PerfScopeStats i010_stats = profiler.GetStats(PerfScope::I010);
+    PerfScopeStats quote_stats = profiler.GetStats(PerfScope::QUOTE);
+    PerfScopeStats skipped_stats = profiler.GetStats(PerfScope::SKIPPED);
+    passed = passed && i010_stats.count == 1 && i010_stats.bytes == i010.size();
+    passed = passed && quote_stats.count == 2 && quote_stats.bytes == 2 * quote.size();
+    passed = passed && skipped_stats.count == 1 && skipped_stats.bytes == 7;
+    passed = passed && profiler.GetStats(PerfScope::TRADE).count == 0;
+    passed = passed && (profiler.GetEventMask() & (1U << static_cast<size_t>(PerfEvent::TASK_CLOCK))) != 0;
+
+    std::cout << "Profiled decode test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    std::cout << profiler.Format();
+    return passed;
+}
+
+int main()
+{
+    std::cout << "==== Perf Counter Unit Tests ====\n"
+              << std::endl;
+
+    // Define all test cases
+    TestCase test_cases[] = {
+        {"Counter Group", test_counter_group},
+        {"Profiler Format", test_profiler_format},
+        {"Profiled Decode", test_profiled_decode}};
+
+    // Run all tests and count failures
+    size_t num_tests = sizeof(test_cases) / sizeof(TestCase);
+    size_t passed_tests = 0;
+
+    for (size_t i = 0; i < num_tests; ++i)
+    {
+        std::cout << "\nRunning test: " << test_cases[i].name << std::endl;
+        if (test_cases[i].test_func())
+        {
+            passed_tests++;
+        }
+    }
+
+    // Print summary
+    std::cout << "\n==== Test Results ====\n";
+    std::cout << "Passed: " << passed_tests << "/" << num_tests
+              << " (" << (passed_tests * 100 / num_tests) << "%)" << std::endl;
+
+    // Return 0 if all tests passed, otherwise return the number of failures
+    return (passed_tests == num_tests) ? 0 : (num_tests - passed_tests);
+}
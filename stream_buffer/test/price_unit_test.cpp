@@ -0,0 +1,168 @@
+#include "common/price.h"
+#include "processing/tfe.h"
+#include <iostream>
+#include <cstring>
+
+using namespace stream_buffer;
+using common::Price;
+
+// Unit test framework structure
+struct TestCase
+{
+    const char *name;
+    bool (*test_func)();
+};
+
+// Test BCD construction with a decimal locator
+bool test_from_bcd()
+{
+    uint8_t bcd_data[] = {0x00, 0x01, 0x72, 0x50, 0x50}; // 172.5050 with scale 4
+    Price price;
+    bool decoded = Price::FromBcd(bcd_data, sizeof(bcd_data), 4, &price);
+    bool passed = decoded && price.GetMantissa() == 1725050 && price.GetScale() == 4;
+
+    std::cout << "Test from BCD: " << (passed ? "PASSED" : "FAILED")
+              << " (expected 1725050/4, got " << price.GetMantissa() << "/"
+              << static_cast<unsigned>(price.GetScale()) << ")" << std::endl;
+    return passed;
+}
+
+// Test that invalid BCD is rejected
+bool test_from_invalid_bcd()
+{
+    uint8_t bcd_data[] = {0x12, 0x3A};
+    Price price;
+    bool passed = !Price::FromBcd(bcd_data, sizeof(bcd_data), 2, &price);
+
+    std::cout << "Test from invalid BCD: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Test arithmetic on equal and mixed scales
+bool test_arithmetic()
+{
+    Price a(17250, 1); // 1725.0
+    Price b(5, 2);     // 0.05
+    Price sum = a + b;
+    Price diff = a - b;
+    Price notional = b * 3;
+
+    bool passed = sum.GetMantissa() == 172505 && sum.GetScale() == 2 &&
+                  diff.GetMantissa() == 172495 && diff.GetScale() == 2 &&
+                  notional.GetMantissa() == 15 && notional.GetScale() == 2;
+
+    std::cout << "Test arithmetic: " << (passed ? "PASSED" : "FAILED")
+              << " (sum " << sum.ToString() << ", diff " << diff.ToString()
+              << ", notional " << notional.ToString() << ")" << std::endl;
+    return passed;
+}
+
+// Test that scales past 10^18 are clamped instead of reading past the power table
+bool test_scale_clamp()
+{
+    Price price(12345, 40);
+    Price rescaled = Price(12, 2).Rescale(255);
+    bool passed = price.GetScale() == common::constants::MAX_PRICE_SCALE &&
+                  rescaled.GetScale() == common::constants::MAX_PRICE_SCALE &&
+                  rescaled.GetMantissa() == 12 * common::Pow10(16) &&
+                  common::Pow10(200) == common::Pow10(common::constants::MAX_PRICE_SCALE) &&
+                  price.ToString() == "0.000000000000012345";
+
+    std::cout << "Test scale clamp: " << (passed ? "PASSED" : "FAILED")
+              << " (got " << price.ToString() << ", rescaled " << rescaled.ToString() << ")" << std::endl;
+    return passed;
+}
+
+// Test comparison across scales
+bool test_comparison()
+{
+    bool passed = Price(150, 1) == Price(1500, 2) &&
+                  Price(149, 1) < Price(1500, 2) &&
+                  Price(1501, 2) > Price(150, 1) &&
+                  Price(-1, 0) < Price(0, 3) &&
+                  Price(150, 1) != Price(151, 1);
+
+    std::cout << "Test comparison: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Test string formatting
+bool test_to_string()
+{
+    bool passed = Price(1725050, 2).ToString() == "17250.50" &&
+                  Price(5, 3).ToString() == "0.005" &&
+                  Price(-42, 1).ToString() == "-4.2" &&
+                  Price(17250, 0).ToString() == "17250" &&
+                  Price(0, 2).ToString() == "0.00";
+
+    std::cout << "Test to string: " << (passed ? "PASSED" : "FAILED")
+              << " (got " << Price(1725050, 2).ToString() << ", "
+              << Price(5, 3).ToString() << ", " << Price(-42, 1).ToString() << ")" << std::endl;
+    return passed;
+}
+
+// Test formatting into a buffer that is too small
+bool test_format_small_buffer()
+{
+    char text[4];
+    bool passed = Price(1725050, 2).Format(text, sizeof(text)) == 0;
+
+    std::cout << "Test format small buffer: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Test I010 reference price is scaled by the decimal locator
+bool test_i010_reference_price()
+{
+    processing::tfe::BodyI010 body;
+    std::memset(&body, 0, sizeof(body));
+    const uint8_t reference_price[] = {0x00, 0x00, 0x17, 0x25, 0x05};
+    std::memcpy(body.reference_price, reference_price, sizeof(reference_price));
+    body.decimal_locator = 0x01;
+
+    Price price;
+    bool passed = body.GetReferencePrice(&price) && price == Price(172505, 1) &&
+                  price.ToString() == "17250.5";
+
+    std::cout << "Test I010 reference price: " << (passed ? "PASSED" : "FAILED")
+              << " (got " << price.ToString() << ")" << std::endl;
+    return passed;
+}
+
+int main()
+{
+    std::cout << "==== Price Unit Tests ====\n"
+              << std::endl;
+
+    // Define all test cases
+    TestCase test_cases[] = {
+        {"From BCD", test_from_bcd},
+        {"From Invalid BCD", test_from_invalid_bcd},
+        {"Arithmetic", test_arithmetic},
+        {"Scale Clamp", test_scale_clamp},
+        {"Comparison", test_comparison},
+        {"To String", test_to_string},
+        {"Format Small Buffer", test_format_small_buffer},
+        {"I010 Reference Price", test_i010_reference_price}};
+
+    // Run all tests and count failures
+    size_t num_tests = sizeof(test_cases) / sizeof(TestCase);
+    size_t passed_tests = 0;
+
+    for (size_t i = 0; i < num_tests; ++i)
+    {
+        std::cout << "\nRunning test: " << test_cases[i].name << std::endl;
+        if (test_cases[i].test_func())
+        {
+            passed_tests++;
+        }
+    }
+
+    // Print summary
+    std::cout << "\n==== Test Results ====\n";
+    std::cout << "Passed: " << passed_tests << "/" << num_tests
+              << " (" << (passed_tests * 100 / num_tests) << "%)" << std::endl;
+
+    // Return 0 if all tests passed, otherwise return the number of failures
+    return (passed_tests == num_tests) ? 0 : (num_tests - passed_tests);
+}
@@ -0,0 +1,197 @@
+#include "processing/quote_snapshot.h"
+#include "processing/tfe_processor.h"
+#include "tfe_test_messages.h"
+#include "tfe_test_packets.h"
+#include <pthread.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+using namespace stream_buffer;
+using namespace stream_buffer::processing;
+using namespace stream_buffer::testing;
+
+// Unit test framework structure
+struct TestCase
+{
+    const char *name;
+    bool (*test_func)();
+};
+
+namespace
+{
+    // Message whose time, prices and quantities all derive from one value
+    NormalizedMessage MakeFilled(const char *product_id, MessageType type, common::i64 value)
+    {
+        NormalizedMessage message = MakeMessage(product_id, type);
+        message.price_scale = 2;
+        message.information_time = static_cast<common::u64>(value);
+        message.price = value;
+        message.quantity = value;
+        message.bid_price = value;
+        message.bid_quantity = value;
+        message.ask_price = value + 1;
+        message.ask_quantity = value;
+        return message;
+    }
+
+    struct TornReadCheck
+    {
+        const QuoteSnapshotTable *table;
+        std::atomic<bool> done;
+        size_t reads;
+        size_t torn;
+    };
+
+    // Every quote has bid == ask - 1 == quantity, a torn copy breaks that
+    void *ReadLoop(void *arg)
+    {
+        TornReadCheck *check = static_cast<TornReadCheck *>(arg);
+        common::u32 slot = constants::INVALID_SYMBOL;
+        QuoteSnapshot snapshot;
+        while (!check->done.load(std::memory_order_acquire))
+        {
+            if (slot == constants::INVALID_SYMBOL)
+            {
+                slot = check->table->Find("TXFL4     ");
+                continue;
+            }
+            check->table->Read(slot, &snapshot);
+            if (snapshot.bid_price + 1 != snapshot.ask_price || snapshot.bid_quantity != snapshot.ask_quantity ||
+                static_cast<common::u64>(snapshot.bid_price) != snapshot.quote_time)
+            {
+                check->torn++;
+            }
+            check->reads++;
+        }
+        return nullptr;
+    }
+} // anonymous namespace
+
+// Test that quotes, trades and reference prices merge into one snapshot
+bool test_snapshot_merge()
+{
+    QuoteSnapshotTable table(16);
+    table.OnMessage(MakeFilled("TXFL4     ", MessageType::PRODUCT_INFO, 2200000));
+    table.OnMessage(MakeFilled("TXFL4     ", MessageType::QUOTE, 2250000));
+    table.OnMessage(MakeFilled("TXFL4     ", MessageType::TRADE, 2250050));
+    table.OnMessage(MakeFilled("MXFL4     ", MessageType::QUOTE, 100));
+
+    QuoteSnapshot snapshot;
+    bool passed = table.GetSize() == 2 && table.Read("TXFL4     ", &snapshot) &&
+                  snapshot.reference_price == 2200000 && snapshot.bid_price == 2250000 &&
+                  snapshot.ask_price == 2250001 && snapshot.last_price == 2250050 &&
+                  snapshot.update_count == 3 && snapshot.GetLastPrice().ToString() == "22500.50" &&
+                  snapshot.flags == (constants::SNAPSHOT_HAS_REFERENCE | constants::SNAPSHOT_HAS_QUOTE |
+                                     constants::SNAPSHOT_HAS_TRADE) &&
+                  !table.Read("TEFL4     ", &snapshot) && !table.IsShared();
+
+    std::cout << "Snapshot merge test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Test that the last price of a sweep is its final match
+bool test_sweep_last_price()
+{
+    QuoteSnapshotTable table(16);
+    TFEProcessor processor;
+    processor.AddSink(&table);
+    std::vector<char> sweep = MakeI020Packet({{2250075, 3}, {2250100, 7}, {2250150, 2}}, 91530123456ULL, 1);
+    processor.ProcessBatch(sweep.data(), sweep.size());
+
+    QuoteSnapshot snapshot;
+    bool passed = table.Read("TXFL4     ", &snapshot) && snapshot.last_price == 2250150 &&
+                  snapshot.last_quantity == 2 && snapshot.trade_time == 91530123456ULL &&
+                  snapshot.update_count == 3 && snapshot.flags == constants::SNAPSHOT_HAS_TRADE;
+
+    std::cout << "Sweep last price test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Test that a concurrent reader never sees a half-written snapshot
+bool test_concurrent_reads()
+{
+    QuoteSnapshotTable table(16);
+    TornReadCheck check;
+    check.table = &table;
+    check.done.store(false);
+    check.reads = 0;
+    check.torn = 0;
+
+    pthread_t reader;
+    pthread_create(&reader, nullptr, ReadLoop, &check);
+    for (common::i64 i = 1; i <= 2000000; ++i)
+    {
+        table.OnMessage(MakeFilled("TXFL4     ", MessageType::QUOTE, i));
+    }
+    check.done.store(true, std::memory_order_release);
+    pthread_join(reader, nullptr);
+
+    bool passed = check.torn == 0;
+    std::cout << "Concurrent reads test: " << (passed ? "PASSED" : "FAILED")
+              << " (" << check.reads << " reads, " << check.torn << " torn)" << std::endl;
+    return passed;
+}
+
+// Test that another process view of the file sees the same snapshots
+bool test_mapped_reader()
+{
+    char path[64];
+    std::snprintf(path, sizeof(path), "/tmp/quote_snapshot_test_%d", static_cast<int>(getpid()));
+
+    bool passed;
+    {
+        QuoteSnapshotTable table(16, path);
+        table.OnMessage(MakeFilled("TXFL4     ", MessageType::QUOTE, 2250000));
+
+        QuoteSnapshotReader reader;
+        QuoteSnapshot snapshot;
+        passed = table.IsShared() && reader.Open(path) && reader.GetSize() == 1 &&
+                 reader.Read("TXFL4     ", &snapshot) && snapshot.bid_price == 2250000 &&
+                 reader.Find("MXFL4     ") == constants::INVALID_SYMBOL;
+
+        // Products added later are found on the next miss
+        table.OnMessage(MakeFilled("MXFL4     ", MessageType::TRADE, 42));
+        passed = passed && reader.Find("MXFL4     ") == 1 && reader.Read(1, &snapshot) && snapshot.last_price == 42;
+    }
+    unlink(path);
+
+    std::cout << "Mapped reader test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+int main()
+{
+    std::cout << "==== Quote Snapshot Unit Tests ====\n"
+              << std::endl;
+
+    // Define all test cases
+    TestCase test_cases[] = {
+        {"Snapshot Merge", test_snapshot_merge},
+        {"Sweep Last Price", test_sweep_last_price},
+        {"Concurrent Reads", test_concurrent_reads},
+        {"Mapped Reader", test_mapped_reader}};
+
+    // Run all tests and count failures
+    size_t num_tests = sizeof(test_cases) / sizeof(TestCase);
+    size_t passed_tests = 0;
+
+    for (size_t i = 0; i < num_tests; ++i)
+    {
+        std::cout << "\nRunning test: " << test_cases[i].name << std::endl;
+        if (test_cases[i].test_func())
+        {
+            passed_tests++;
+        }
+    }
+
+    // Print summary
+    std::cout << "\n==== Test Results ====\n";
+    std::cout << "Passed: " << passed_tests << "/" << num_tests
+              << " (" << (passed_tests * 100 / num_tests) << "%)" << std::endl;
+
+    // Return 0 if all tests passed, otherwise return the number of failures
+    return (passed_tests == num_tests) ? 0 : (num_tests - passed_tests);
+}
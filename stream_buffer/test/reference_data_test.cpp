@@ -0,0 +1,322 @@
+#include "processing/reference_data.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+using namespace stream_buffer;
+using namespace stream_buffer::processing;
+
+// Unit test framework structure
+struct TestCase
+{
+    const char *name;
+    bool (*test_func)();
+};
+
+namespace
+{
+    std::string MakePath()
+    {
+        char path[] = "/tmp/reference_data_test.XXXXXX";
+        int fd = mkstemp(path);
+        if (fd < 0)
+        {
+            return std::string();
+        }
+        close(fd);
+        return path;
+    }
+
+    void MakeProductId(common::u32 number, char *product_id)
+    {
+        char text[constants::PRODUCT_ID_SIZE + 1];
+        std::snprintf(text, sizeof(text), "TXO%05uL4", number);
+        std::memcpy(product_id, text, constants::PRODUCT_ID_SIZE);
+    }
+
+    ReferenceRecord MakeRecord(const char *product_id, common::i64 reference_price)
+    {
+        ReferenceRecord record;
+        std::memset(&record, 0, sizeof(record));
+        std::memcpy(record.product_id, product_id, sizeof(record.product_id));
+        record.transmission_code = '4';
+        record.decimal_locator = 1;
+        record.reference_price = reference_price;
+        record.delivery_date = 20241218;
+        return record;
+    }
+
+    struct Pair
+    {
+        common::i64 first;
+        common::i64 second;
+    };
+
+    struct TornReadCheck
+    {
+        core::SeqLock<Pair> *lock;
+        std::atomic<bool> done;
+        size_t reads;
+        size_t torn;
+    };
+
+    // Every stored pair has second == -first, a torn copy breaks that
+    void *ReadPairs(void *arg)
+    {
+        TornReadCheck *check = static_cast<TornReadCheck *>(arg);
+        Pair pair;
+        while (!check->done.load(std::memory_order_acquire))
+        {
+            check->lock->Load(&pair);
+            check->torn += pair.second != -pair.first ? 1 : 0;
+            check->reads++;
+        }
+        return nullptr;
+    }
+
+    struct PublishCheck
+    {
+        const ReferenceDataStore *store;
+        std::atomic<bool> done;
+        size_t reads;
+        size_t empty;
+    };
+
+    // Every symbol a reader can see must already have its record
+    void *ReadNewest(void *arg)
+    {
+        PublishCheck *check = static_cast<PublishCheck *>(arg);
+        ReferenceRecord record;
+        while (!check->done.load(std::memory_order_acquire))
+        {
+            common::u32 size = check->store->GetSize();
+            if (size > 0 && check->store->GetRecord(size - 1, &record))
+            {
+                check->empty += record.update_count == 0 || record.reference_price == 0 ? 1 : 0;
+                check->reads++;
+            }
+        }
+        return nullptr;
+    }
+} // anonymous namespace
+
+// A reader never sees a half-written value
+bool test_seqlock()
+{
+    core::SeqLock<Pair> lock;
+    Pair pair;
+    lock.Load(&pair);
+    bool passed = pair.first == 0 && pair.second == 0 && lock.GetSequence() == 0;
+
+    TornReadCheck check;
+    check.lock = &lock;
+    check.done.store(false);
+    check.reads = 0;
+    check.torn = 0;
+    pthread_t reader;
+    passed = passed && pthread_create(&reader, nullptr, ReadPairs, &check) == 0;
+
+    for (common::i64 i = 1; i <= 200000; ++i)
+    {
+        Pair value = {i, -i};
+        lock.Store(value);
+    }
+    check.done.store(true, std::memory_order_release);
+    pthread_join(reader, nullptr);
+
+    passed = passed && check.torn == 0 && lock.GetSequence() == 400000;
+    passed = passed && lock.TryLoad(&pair) && pair.first == 200000 && lock.Peek().second == -200000;
+
+    std::cout << "SeqLock test: " << (passed ? "PASSED" : "FAILED")
+              << " (" << check.reads << " reads, " << check.torn << " torn)" << std::endl;
+    return passed;
+}
+
+// Symbols are dense, stable and capped at the capacity
+bool test_symbol_index()
+{
+    SymbolIndex index(100);
+    char product_id[constants::PRODUCT_ID_SIZE];
+    bool passed = index.Find("TXFL4     ") == constants::INVALID_SYMBOL && index.GetCapacity() == 100;
+
+    for (common::u32 i = 0; i < 100; ++i)
+    {
+        MakeProductId(17000 + i, product_id);
+        passed = passed && index.Insert(product_id) == i;
+    }
+    passed = passed && index.GetSize() == 100;
+
+    // Inserting a known product returns its symbol even when full
+    MakeProductId(17042, product_id);
+    passed = passed && index.Insert(product_id) == 42 && index.Find(product_id) == 42;
+
+    // A new product does not fit
+    passed = passed && index.Insert("TXFL4     ") == constants::INVALID_SYMBOL;
+    passed = passed && index.Find("TXFL4     ") == constants::INVALID_SYMBOL && index.GetSize() == 100;
+
+    char copy[constants::PRODUCT_ID_SIZE];
+    passed = passed && index.GetProductId(99, copy) && std::memcmp(copy, "TXO17099L4", sizeof(copy)) == 0;
+    passed = passed && !index.GetProductId(100, copy);
+
+    std::cout << "Symbol Index test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Updates count per product; a full store drops new products
+bool test_update()
+{
+    ReferenceDataStore store(2);
+    ReferenceRecord record;
+    bool passed = store.Update(MakeRecord("TXFL4     ", 172500)) == 0;
+    passed = passed && store.Update(MakeRecord("TXFL4     ", 172600)) == 0;
+    passed = passed && store.Update(MakeRecord("MXFL4     ", 172700)) == 1;
+    passed = passed && store.Update(MakeRecord("TEFL4     ", 172800)) == constants::INVALID_SYMBOL;
+
+    passed = passed && store.GetSize() == 2 && store.Lookup("TXFL4     ", &record);
+    passed = passed && record.reference_price == 172600 && record.update_count == 2;
+    passed = passed && record.GetReferencePrice().ToString() == "17260.0";
+    passed = passed && store.GetDecimalLocator(1) == 1 && store.GetDecimalLocator(2) == 0;
+    passed = passed && !store.Lookup("TEFL4     ", &record) && !store.GetRecord(2, &record);
+
+    // Restore keeps the saved count
+    record.update_count = 7;
+    passed = passed && store.Restore(record) == 0 && store.GetRecord(0, &record) && record.update_count == 7;
+
+    std::cout << "Update test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// A new symbol is only visible once its record is stored
+bool test_publish_order()
+{
+    const common::u32 count = 20000;
+    ReferenceDataStore store(count);
+    PublishCheck check;
+    check.store = &store;
+    check.done.store(false);
+    check.reads = 0;
+    check.empty = 0;
+    pthread_t reader;
+    bool passed = pthread_create(&reader, nullptr, ReadNewest, &check) == 0;
+
+    char product_id[constants::PRODUCT_ID_SIZE];
+    for (common::u32 i = 0; i < count; ++i)
+    {
+        MakeProductId(i, product_id);
+        store.Update(MakeRecord(product_id, 1000 + i));
+    }
+    check.done.store(true, std::memory_order_release);
+    pthread_join(reader, nullptr);
+
+    passed = passed && check.empty == 0 && store.GetSize() == count;
+
+    std::cout << "Publish Order test: " << (passed ? "PASSED" : "FAILED")
+              << " (" << check.reads << " reads, " << check.empty << " empty)" << std::endl;
+    return passed;
+}
+
+// A snapshot restores every record as it was saved
+bool test_snapshot_round_trip()
+{
+    std::string path = MakePath();
+    bool passed = !path.empty();
+    {
+        ReferenceDataStore store(16);
+        store.Update(MakeRecord("TXFL4     ", 172500));
+        store.Update(MakeRecord("TXFL4     ", 172550));
+        store.Update(MakeRecord("TXO17000L4", 1230));
+        passed = passed && store.SaveSnapshot(path);
+    }
+
+    ReferenceDataStore store(16);
+    ReferenceRecord record;
+    passed = passed && store.LoadSnapshot(path) == 2 && store.GetSize() == 2;
+    passed = passed && store.Lookup("TXFL4     ", &record) && record.reference_price == 172550;
+    passed = passed && record.update_count == 2 && record.delivery_date == 20241218;
+    passed = passed && store.Lookup("TXO17000L4", &record) && record.update_count == 1;
+
+    // A smaller store keeps what fits
+    ReferenceDataStore small(1);
+    passed = passed && small.LoadSnapshot(path) == 1;
+
+    unlink(path.c_str());
+    std::cout << "Snapshot Round Trip test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Missing, truncated and foreign files load nothing
+bool test_snapshot_rejected()
+{
+    std::string path = MakePath();
+    ReferenceDataStore store(16);
+    bool passed = !path.empty() && store.LoadSnapshot(path + ".missing") == -1;
+
+    // Shorter than the header
+    passed = passed && store.LoadSnapshot(path) == -1;
+
+    {
+        ReferenceDataStore saved(16);
+        saved.Update(MakeRecord("TXFL4     ", 172500));
+        saved.Update(MakeRecord("MXFL4     ", 172500));
+        passed = passed && saved.SaveSnapshot(path);
+    }
+
+    // Cut off in the last record
+    struct stat file_stat;
+    passed = passed && stat(path.c_str(), &file_stat) == 0;
+    passed = passed && truncate(path.c_str(), file_stat.st_size - 8) == 0;
+    passed = passed && store.LoadSnapshot(path) == -1;
+    passed = passed && truncate(path.c_str(), file_stat.st_size) == 0;
+
+    // Another file format
+    int fd = open(path.c_str(), O_WRONLY);
+    passed = passed && fd >= 0 && pwrite(fd, "SBTICKS", 8, 0) == 8;
+    close(fd);
+    passed = passed && store.LoadSnapshot(path) == -1 && store.GetSize() == 0;
+
+    unlink(path.c_str());
+    std::cout << "Snapshot Rejected test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+int main()
+{
+    std::cout << "==== Reference Data Unit Tests ====\n"
+              << std::endl;
+
+    // Define all test cases
+    TestCase test_cases[] = {
+        {"SeqLock", test_seqlock},
+        {"Symbol Index", test_symbol_index},
+        {"Update", test_update},
+        {"Publish Order", test_publish_order},
+        {"Snapshot Round Trip", test_snapshot_round_trip},
+        {"Snapshot Rejected", test_snapshot_rejected}};
+
+    // Run all tests and count failures
+    size_t num_tests = sizeof(test_cases) / sizeof(TestCase);
+    size_t passed_tests = 0;
+
+    for (size_t i = 0; i < num_tests; ++i)
+    {
+        std::cout << "\nRunning test: " << test_cases[i].name << std::endl;
+        if (test_cases[i].test_func())
+        {
+            passed_tests++;
+        }
+    }
+
+    // Print summary
+    std::cout << "\n==== Test Results ====\n";
+    std::cout << "Passed: " << passed_tests << "/" << num_tests
+              << " (" << (passed_tests * 100 / num_tests) << "%)" << std::endl;
+
+    // Return 0 if all tests passed, otherwise return the number of failures
+    return (passed_tests == num_tests) ? 0 : (num_tests - passed_tests);
+}
@@ -0,0 +1,212 @@
+#include "core/spsc_queue.h"
+#include "processing/sharded_dispatcher.h"
+#include "processing/symbol_index.h"
+#include "tfe_test_messages.h"
+#include <pthread.h>
+#include <iostream>
+#include <map>
+#include <string>
+
+using namespace stream_buffer;
+using namespace stream_buffer::processing;
+using namespace stream_buffer::testing;
+
+// Unit test framework structure
+struct TestCase
+{
+    const char *name;
+    bool (*test_func)();
+};
+
+namespace
+{
+    constexpr size_t PRODUCT_COUNT = 64;
+    constexpr size_t MESSAGE_COUNT = 200000;
+
+    // Sink checking that every product arrives in order on one thread
+    class OrderCheckingSink : public IMessageSink
+    {
+    public:
+        OrderCheckingSink() : messages(0), out_of_order(0), wrong_thread(0), flushes(0), has_thread_(false) {}
+
+        void OnMessage(const NormalizedMessage &message) override
+        {
+            if (!has_thread_)
+            {
+                thread_ = pthread_self();
+                has_thread_ = true;
+            }
+            else if (!pthread_equal(thread_, pthread_self()))
+            {
+                wrong_thread++;
+            }
+
+            std::string product(message.product_id, sizeof(message.product_id));
+            std::map<std::string, common::u32>::iterator it = last_seq.find(product);
+            if (it != last_seq.end() && message.information_seq <= it->second)
+            {
+                out_of_order++;
+            }
+            last_seq[product] = message.information_seq;
+            messages++;
+        }
+
+        void Flush() override { flushes++; }
+
+        size_t messages;
+        size_t out_of_order;
+        size_t wrong_thread;
+        size_t flushes;
+        std::map<std::string, common::u32> last_seq;
+
+    private:
+        pthread_t thread_;
+        bool has_thread_;
+    };
+
+    // Push a numbered stream through a dispatcher and collect the sinks
+    bool RunDispatcher(size_t workers, bool threaded, std::vector<OrderCheckingSink *> *sinks,
+                       ShardedDispatcher **out)
+    {
+        std::vector<std::unique_ptr<IMessageSink>> worker_sinks;
+        for (size_t i = 0; i < workers; ++i)
+        {
+            OrderCheckingSink *sink = new OrderCheckingSink();
+            sinks->push_back(sink);
+            worker_sinks.emplace_back(sink);
+        }
+
+        // Small queues exercise the backpressure path
+        ShardedDispatcher *dispatcher = new ShardedDispatcher(std::move(worker_sinks), 256);
+        if (threaded && !dispatcher->Start())
+        {
+            delete dispatcher;
+            return false;
+        }
+
+        for (size_t i = 0; i < MESSAGE_COUNT; ++i)
+        {
+            dispatcher->OnMessage(MakeMessage(MakeProductId('P', i % PRODUCT_COUNT), MessageType::TRADE,
+                                              static_cast<common::u32>(i + 1)));
+        }
+        dispatcher->Drain();
+        *out = dispatcher;
+        return true;
+    }
+} // anonymous namespace
+
+// Test queue ordering, capacity and wrap-around
+bool test_spsc_queue()
+{
+    core::SpscQueue<int> queue(5);
+    bool passed = queue.GetCapacity() == 8 && queue.IsEmpty();
+
+    int value = 0;
+    for (int round = 0; round < 3 && passed; ++round)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            passed = passed && queue.TryPush(round * 10 + i);
+        }
+        passed = passed && !queue.TryPush(99) && queue.GetSize() == 8;
+        for (int i = 0; i < 8; ++i)
+        {
+            passed = passed && queue.TryPop(&value) && value == round * 10 + i;
+        }
+        passed = passed && !queue.TryPop(&value);
+    }
+
+    std::cout << "SPSC queue test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Test that products keep their order and stay on one worker
+bool test_sharded_ordering()
+{
+    std::vector<OrderCheckingSink *> sinks;
+    ShardedDispatcher *dispatcher = nullptr;
+    if (!RunDispatcher(4, true, &sinks, &dispatcher))
+    {
+        std::cout << "Sharded ordering test: FAILED (could not start workers)" << std::endl;
+        return false;
+    }
+
+    size_t total = 0;
+    bool passed = true;
+    std::map<std::string, size_t> owner;
+    for (size_t i = 0; i < sinks.size(); ++i)
+    {
+        total += sinks[i]->messages;
+        passed = passed && sinks[i]->out_of_order == 0 && sinks[i]->wrong_thread == 0 &&
+                 dispatcher->GetProcessedCount(i) == sinks[i]->messages;
+        for (std::map<std::string, common::u32>::const_iterator it = sinks[i]->last_seq.begin();
+             it != sinks[i]->last_seq.end(); ++it)
+        {
+            passed = passed && owner.insert(std::make_pair(it->first, i)).second &&
+                     dispatcher->GetShard(it->first.data()) == i;
+        }
+    }
+    passed = passed && total == MESSAGE_COUNT && owner.size() == PRODUCT_COUNT;
+
+    std::cout << "Sharded ordering test: " << (passed ? "PASSED" : "FAILED")
+              << " (" << total << " messages, " << dispatcher->GetBackpressureCount()
+              << " full-queue waits)" << std::endl;
+
+    dispatcher->Stop();
+    delete dispatcher;
+    return passed;
+}
+
+// Test delivery on the caller thread before Start
+bool test_inline_dispatch()
+{
+    std::vector<OrderCheckingSink *> sinks;
+    ShardedDispatcher *dispatcher = nullptr;
+    RunDispatcher(3, false, &sinks, &dispatcher);
+
+    size_t total = 0;
+    bool passed = true;
+    for (size_t i = 0; i < sinks.size(); ++i)
+    {
+        total += sinks[i]->messages;
+        passed = passed && sinks[i]->out_of_order == 0 && sinks[i]->flushes == 1;
+    }
+    passed = passed && total == MESSAGE_COUNT;
+
+    std::cout << "Inline dispatch test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    delete dispatcher;
+    return passed;
+}
+
+int main()
+{
+    std::cout << "==== Sharded Dispatcher Unit Tests ====\n"
+              << std::endl;
+
+    // Define all test cases
+    TestCase test_cases[] = {
+        {"SPSC Queue", test_spsc_queue},
+        {"Sharded Ordering", test_sharded_ordering},
+        {"Inline Dispatch", test_inline_dispatch}};
+
+    // Run all tests and count failures
+    size_t num_tests = sizeof(test_cases) / sizeof(TestCase);
+    size_t passed_tests = 0;
+
+    for (size_t i = 0; i < num_tests; ++i)
+    {
+        std::cout << "\nRunning test: " << test_cases[i].name << std::endl;
+        if (test_cases[i].test_func())
+        {
+            passed_tests++;
+        }
+    }
+
+    // Print summary
+    std::cout << "\n==== Test Results ====\n";
+    std::cout << "Passed: " << passed_tests << "/" << num_tests
+              << " (" << (passed_tests * 100 / num_tests) << "%)" << std::endl;
+
+    // Return 0 if all tests passed, otherwise return the number of failures
+    return (passed_tests == num_tests) ? 0 : (num_tests - passed_tests);
+}
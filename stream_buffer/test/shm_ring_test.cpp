@@ -0,0 +1,145 @@
+#include "ipc/shm_publisher.h"
+#include "ipc/shm_reader.h"
+#include "tfe_test_messages.h"
+#include <unistd.h>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+using namespace stream_buffer;
+using namespace stream_buffer::ipc;
+using namespace stream_buffer::testing;
+
+// Unit test framework structure
+struct TestCase
+{
+    const char *name;
+    bool (*test_func)();
+};
+
+namespace
+{
+    std::string RingName()
+    {
+        char name[64];
+        std::snprintf(name, sizeof(name), "/stream_buffer_test_%d", static_cast<int>(getpid()));
+        return name;
+    }
+
+    processing::NormalizedMessage MakeTrade(common::u32 seq)
+    {
+        processing::NormalizedMessage message = MakeMessage("TXFL4", processing::MessageType::TRADE, seq);
+        message.price = 2250000 + seq;
+        message.quantity = seq % 7;
+        return message;
+    }
+} // anonymous namespace
+
+// Test that a reader sees every published message in order
+bool test_publish_and_read()
+{
+    ShmPublisher publisher;
+    ShmReader reader;
+    bool passed = publisher.Open(RingName(), 16) && reader.Open(RingName()) && reader.GetCapacity() == 16;
+
+    processing::NormalizedMessage message;
+    passed = passed && !reader.TryRead(&message);
+    for (common::u32 i = 1; i <= 40 && passed; ++i)
+    {
+        publisher.OnMessage(MakeTrade(i));
+        passed = reader.TryRead(&message) && message.information_seq == i &&
+                 message.price == 2250000 + i && !reader.TryRead(&message);
+    }
+    passed = passed && reader.GetLostCount() == 0 && publisher.GetPublishedCount() == 40;
+
+    std::cout << "Publish and read test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Test start positions and recovery of a reader that fell behind
+bool test_overrun_and_start()
+{
+    ShmPublisher publisher;
+    bool passed = publisher.Open(RingName(), 8);
+    for (common::u32 i = 1; i <= 5; ++i)
+    {
+        publisher.OnMessage(MakeTrade(i));
+    }
+
+    ShmReader latest, oldest;
+    passed = passed && latest.Open(RingName()) && oldest.Open(RingName(), ShmReader::StartPosition::OLDEST);
+
+    processing::NormalizedMessage message;
+    passed = passed && !latest.TryRead(&message) && oldest.GetBacklog() == 5 &&
+             oldest.TryRead(&message) && message.information_seq == 1;
+
+    // Lap both readers: the ring keeps only the last 8 messages
+    for (common::u32 i = 6; i <= 30; ++i)
+    {
+        publisher.OnMessage(MakeTrade(i));
+    }
+    passed = passed && latest.TryRead(&message) && message.information_seq > 6 &&
+             latest.GetLostCount() == message.information_seq - 6;
+
+    common::u32 last = 0;
+    size_t read = 0;
+    while (oldest.TryRead(&message))
+    {
+        passed = passed && (last == 0 || message.information_seq == last + 1);
+        last = message.information_seq;
+        read++;
+    }
+    passed = passed && last == 30 && read + oldest.GetLostCount() == 29;
+
+    std::cout << "Overrun and start test: " << (passed ? "PASSED" : "FAILED")
+              << " (lost " << latest.GetLostCount() << "/" << oldest.GetLostCount() << ")" << std::endl;
+    return passed;
+}
+
+// Test that readers notice a closed writer and the ring is removed
+bool test_close()
+{
+    ShmPublisher publisher;
+    ShmReader reader;
+    bool passed = publisher.Open(RingName(), 8) && reader.Open(RingName()) && !reader.IsWriterClosed();
+    publisher.Close();
+
+    ShmReader late;
+    passed = passed && reader.IsWriterClosed() && !late.Open(RingName());
+
+    std::cout << "Close test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+int main()
+{
+    std::cout << "==== Shared-Memory Ring Unit Tests ====\n"
+              << std::endl;
+
+    // Define all test cases
+    TestCase test_cases[] = {
+        {"Publish And Read", test_publish_and_read},
+        {"Overrun And Start", test_overrun_and_start},
+        {"Close", test_close}};
+
+    // Run all tests and count failures
+    size_t num_tests = sizeof(test_cases) / sizeof(TestCase);
+    size_t passed_tests = 0;
+
+    for (size_t i = 0; i < num_tests; ++i)
+    {
+        std::cout << "\nRunning test: " << test_cases[i].name << std::endl;
+        if (test_cases[i].test_func())
+        {
+            passed_tests++;
+        }
+    }
+
+    // Print summary
+    std::cout << "\n==== Test Results ====\n";
+    std::cout << "Passed: " << passed_tests << "/" << num_tests
+              << " (" << (passed_tests * 100 / num_tests) << "%)" << std::endl;
+
+    // Return 0 if all tests passed, otherwise return the number of failures
+    return (passed_tests == num_tests) ? 0 : (num_tests - passed_tests);
+}
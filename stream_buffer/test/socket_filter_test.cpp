@@ -0,0 +1,212 @@
+#include "network/multicast.h"
+#include "network/socket_filter.h"
+#include "processing/tfe.h"
+#include "tfe_test_packets.h"
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <vector>
+#include <sys/time.h>
+
+using namespace stream_buffer;
+using namespace stream_buffer::testing;
+
+// Unit test framework structure
+struct TestCase
+{
+    const char *name;
+    bool (*test_func)();
+};
+
+namespace
+{
+    const char *TEST_GROUP_IP = "239.255.0.29";
+    const char *LOOPBACK_IP = "127.0.0.1";
+
+    // Open a receiving socket joined on loopback, with the I010 filter attached if asked
+    int OpenReceiver(bool filtered, int *port)
+    {
+        common::MulticastConfig config(
+            common::SocketDomain::IPV4, common::SocketType::UDP, 0,
+            TEST_GROUP_IP, 0, "lo", LOOPBACK_IP, 0);
+        if (filtered)
+        {
+            config.socket_filter_message_types.push_back(std::make_pair('1', '1'));
+        }
+
+        int socket_fd = network::CreateSocket(config);
+        if (socket_fd < 0)
+        {
+            return -1;
+        }
+
+        struct sockaddr_in bound_addr = {};
+        socklen_t addr_len = sizeof(bound_addr);
+        getsockname(socket_fd, reinterpret_cast<sockaddr *>(&bound_addr), &addr_len);
+        *port = ntohs(bound_addr.sin_port);
+
+        if (network::JoinMulticastGroup(socket_fd, TEST_GROUP_IP, *port, "lo", LOOPBACK_IP) < 0)
+        {
+            close(socket_fd);
+            return -1;
+        }
+
+        // Do not block forever if the filter drops everything
+        struct timeval timeout = {1, 0};
+        setsockopt(socket_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        return socket_fd;
+    }
+
+    int OpenLoopbackSender()
+    {
+        int socket_fd = socket(AF_INET, SOCK_DGRAM, 0);
+        if (socket_fd < 0)
+        {
+            return -1;
+        }
+
+        struct in_addr interface_addr;
+        interface_addr.s_addr = inet_addr(LOOPBACK_IP);
+        int loop = 1;
+        if (setsockopt(socket_fd, IPPROTO_IP, IP_MULTICAST_IF, &interface_addr, sizeof(interface_addr)) < 0 ||
+            setsockopt(socket_fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) < 0)
+        {
+            close(socket_fd);
+            return -1;
+        }
+        return socket_fd;
+    }
+
+    bool SendPacket(int socket_fd, int port, const std::vector<char> &packet)
+    {
+        struct sockaddr_in group_addr = {};
+        group_addr.sin_family = AF_INET;
+        group_addr.sin_port = htons(port);
+        group_addr.sin_addr.s_addr = inet_addr(TEST_GROUP_IP);
+        return sendto(socket_fd, packet.data(), packet.size(), 0,
+                      reinterpret_cast<sockaddr *>(&group_addr), sizeof(group_addr)) ==
+               static_cast<ssize_t>(packet.size());
+    }
+} // anonymous namespace
+
+// Test the generated program layout
+bool test_build_program()
+{
+    std::vector<std::pair<char, char>> types;
+    types.push_back(std::make_pair('1', '1'));
+    types.push_back(std::make_pair('2', '1'));
+
+    std::vector<struct sock_filter> program;
+    bool built = network::BuildMessageTypeFilter(types, &program);
+    bool passed = built && program.size() == 5 &&
+                  program[0].k == network::constants::TFE_TRANSMISSION_CODE_OFFSET &&
+                  program[1].k == 0x3131 && program[1].jt == 2 &&
+                  program[2].k == 0x3231 && program[2].jt == 1 &&
+                  program[3].k == 0 && program[4].k == 0xFFFFFFFF;
+
+    std::cout << "Test build program: " << (passed ? "PASSED" : "FAILED")
+              << " (" << program.size() << " instructions)" << std::endl;
+    return passed;
+}
+
+// Test that an empty subscription does not produce a program
+bool test_build_empty_program()
+{
+    std::vector<std::pair<char, char>> types;
+    std::vector<struct sock_filter> program;
+    bool passed = !network::BuildMessageTypeFilter(types, &program);
+
+    std::cout << "Test build empty program: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Test that filtered packets never reach MulticastReceiver::ReceiveData over loopback multicast
+bool test_loopback_filtering()
+{
+    int port = 0;
+    int control_port = 0;
+    int receiver_fd = OpenReceiver(true, &port);
+    int control_fd = OpenReceiver(false, &control_port);
+    int sender_fd = OpenLoopbackSender();
+    if (receiver_fd < 0 || control_fd < 0 || sender_fd < 0)
+    {
+        std::cout << "Test loopback filtering: SKIPPED (loopback multicast unavailable)" << std::endl;
+        if (receiver_fd >= 0)
+            close(receiver_fd);
+        if (control_fd >= 0)
+            close(control_fd);
+        if (sender_fd >= 0)
+            close(sender_fd);
+        return true;
+    }
+
+    // Unsubscribed types first, then the subscribed one, to both receivers
+    const char types[][2] = {{'2', '1'}, {'4', '1'}, {'1', '1'}};
+    bool sent = true;
+    for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); ++i)
+    {
+        std::vector<char> packet = MakePacket(types[i][0], types[i][1], nullptr, 0);
+        sent = sent && SendPacket(sender_fd, port, packet) && SendPacket(sender_fd, control_port, packet);
+    }
+
+    // Without a filter the first unsubscribed packet arrives, proving loopback delivers
+    network::MulticastReceiver control(control_fd);
+    char buffer[256];
+    int delivered = control.ReceiveData(buffer, sizeof(buffer));
+    bool control_arrived = sent && delivered > 2 && buffer[1] == '2' && buffer[2] == '1';
+
+    network::MulticastReceiver receiver(receiver_fd);
+    int first = receiver.ReceiveData(buffer, sizeof(buffer));
+    bool first_is_subscribed = first > 2 && buffer[1] == '1' && buffer[2] == '1';
+
+    // Nothing else may be queued
+    int second = receiver.ReceiveData(buffer, sizeof(buffer));
+
+    close(sender_fd);
+    close(control_fd);
+    close(receiver_fd);
+
+    if (!control_arrived)
+    {
+        std::cout << "Test loopback filtering: SKIPPED (loopback multicast not delivered)" << std::endl;
+        return true;
+    }
+
+    bool passed = first_is_subscribed && second == 0;
+    std::cout << "Test loopback filtering: " << (passed ? "PASSED" : "FAILED")
+              << " (first receive returned " << first << ", second " << second << ")" << std::endl;
+    return passed;
+}
+
+int main()
+{
+    std::cout << "==== Socket Filter Tests ====\n"
+              << std::endl;
+
+    // Define all test cases
+    TestCase test_cases[] = {
+        {"Build Program", test_build_program},
+        {"Build Empty Program", test_build_empty_program},
+        {"Loopback Filtering", test_loopback_filtering}};
+
+    // Run all tests and count failures
+    size_t num_tests = sizeof(test_cases) / sizeof(TestCase);
+    size_t passed_tests = 0;
+
+    for (size_t i = 0; i < num_tests; ++i)
+    {
+        std::cout << "\nRunning test: " << test_cases[i].name << std::endl;
+        if (test_cases[i].test_func())
+        {
+            passed_tests++;
+        }
+    }
+
+    // Print summary
+    std::cout << "\n==== Test Results ====\n";
+    std::cout << "Passed: " << passed_tests << "/" << num_tests
+              << " (" << (passed_tests * 100 / num_tests) << "%)" << std::endl;
+
+    // Return 0 if all tests passed, otherwise return the number of failures
+    return (passed_tests == num_tests) ? 0 : (num_tests - passed_tests);
+}
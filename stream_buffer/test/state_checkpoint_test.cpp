@@ -0,0 +1,254 @@
+#include "processing/state_checkpoint.h"
+#include "tfe_test_messages.h"
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+using namespace stream_buffer;
+using namespace stream_buffer::processing;
+using namespace stream_buffer::testing;
+
+// Unit test framework structure
+struct TestCase
+{
+    const char *name;
+    bool (*test_func)();
+};
+
+namespace
+{
+    const common::u32 MAX_SYMBOLS = 64;
+
+    std::string MakePath()
+    {
+        char path[] = "/tmp/state_checkpoint_test.XXXXXX";
+        int fd = mkstemp(path);
+        if (fd < 0)
+        {
+            return std::string();
+        }
+        close(fd);
+        return path;
+    }
+
+    ReferenceRecord MakeRecord(const char *product_id, common::i64 reference_price)
+    {
+        ReferenceRecord record;
+        std::memset(&record, 0, sizeof(record));
+        std::memcpy(record.product_id, product_id, sizeof(record.product_id));
+        record.transmission_code = '1';
+        record.decimal_locator = 2;
+        record.reference_price = reference_price;
+        return record;
+    }
+
+    NormalizedMessage MakeQuote(const char *product_id, char transmission_code, common::u32 seq, common::i64 bid)
+    {
+        NormalizedMessage message = MakeMessage(product_id, MessageType::QUOTE, seq);
+        message.transmission_code = transmission_code;
+        message.information_time = 90000000000ULL + seq;
+        message.price_scale = 2;
+        message.bid_price = bid;
+        message.bid_quantity = 3;
+        message.ask_price = bid + 100;
+        message.ask_quantity = 4;
+        return message;
+    }
+
+    // Feed a message to the book and the checkpointer as the processing thread would
+    void Apply(const NormalizedMessage &message, QuoteSnapshotTable *quotes, StateCheckpointer *checkpointer)
+    {
+        quotes->OnMessage(message);
+        checkpointer->OnMessage(message);
+    }
+} // anonymous namespace
+
+// Everything checkpointed comes back in a fresh process
+bool test_round_trip()
+{
+    std::string path = MakePath();
+    bool passed = !path.empty();
+    {
+        ReferenceDataStore reference(MAX_SYMBOLS);
+        QuoteSnapshotTable quotes(MAX_SYMBOLS);
+        StateCheckpointer checkpointer(path, &reference, &quotes, 1000, MAX_SYMBOLS);
+        passed = passed && checkpointer.Open() && checkpointer.Restore() == 0;
+
+        reference.Update(MakeRecord("TXFL4     ", 1725000));
+        reference.Update(MakeRecord("MXFL4     ", 1725000));
+        reference.Update(MakeRecord("MXFL4     ", 1725050));
+        Apply(MakeQuote("TXFL4     ", '2', 41, 1724900), &quotes, &checkpointer);
+        Apply(MakeQuote("MXFL4     ", '2', 42, 1724800), &quotes, &checkpointer);
+        Apply(MakeQuote("TXO17000L4", '5', 7, 12300), &quotes, &checkpointer);
+        passed = passed && checkpointer.Checkpoint() && checkpointer.GetGeneration() == 1;
+        passed = passed && checkpointer.GetLastChangedSlots() == 5;
+    }
+
+    ReferenceDataStore reference(MAX_SYMBOLS);
+    QuoteSnapshotTable quotes(MAX_SYMBOLS);
+    StateCheckpointer checkpointer(path, &reference, &quotes, 1000, MAX_SYMBOLS);
+    passed = passed && checkpointer.Open() && checkpointer.GetLastCheckpointTimeNs() != 0;
+    passed = passed && checkpointer.Restore() == 1 && checkpointer.GetRestoredGeneration() == 1;
+    passed = passed && checkpointer.GetRestoredAgeNs() >= 0 && checkpointer.GetRestoreDurationNs() > 0;
+    passed = passed && checkpointer.Format().compare(0, 34, "checkpoint generation=1 written=0 ") == 0;
+
+    ReferenceRecord record;
+    passed = passed && reference.GetSize() == 2 && reference.Lookup("MXFL4     ", &record);
+    passed = passed && record.reference_price == 1725050 && record.decimal_locator == 2;
+    passed = passed && record.update_count == 2;
+
+    QuoteSnapshot snapshot;
+    passed = passed && quotes.GetSize() == 3 && quotes.Read("TXO17000L4", &snapshot);
+    passed = passed && snapshot.bid_price == 12300 && snapshot.ask_quantity == 4;
+    passed = passed && (snapshot.flags & constants::SNAPSHOT_HAS_QUOTE) != 0;
+
+    passed = passed && checkpointer.GetLastSequence('2', MessageType::QUOTE) == 42;
+    passed = passed && checkpointer.GetLastSequence('5', MessageType::QUOTE) == 7;
+    passed = passed && checkpointer.GetLastSequence('2', MessageType::TRADE) == 0;
+
+    // Updates after the restore carry on from the restored book
+    quotes.OnMessage(MakeQuote("TXFL4     ", '2', 43, 1725000));
+    passed = passed && quotes.Read("TXFL4     ", &snapshot) && snapshot.update_count == 2;
+
+    unlink(path.c_str());
+    std::cout << "Round Trip test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Checkpoints alternate between regions, rewrite only what changed, and survive a torn write
+bool test_double_buffer()
+{
+    std::string path = MakePath();
+    bool passed = !path.empty();
+    {
+        ReferenceDataStore reference(MAX_SYMBOLS);
+        QuoteSnapshotTable quotes(MAX_SYMBOLS);
+        StateCheckpointer checkpointer(path, &reference, &quotes, 1000, MAX_SYMBOLS);
+        passed = passed && checkpointer.Open();
+
+        for (common::u32 i = 0; i < 10; ++i)
+        {
+            char product_id[11];
+            std::snprintf(product_id, sizeof(product_id), "TXO%05uL4", 17000 + i * 100);
+            Apply(MakeQuote(product_id, '5', i + 1, 100 + i), &quotes, &checkpointer);
+        }
+        passed = passed && checkpointer.Checkpoint() && checkpointer.GetLastChangedSlots() == 10;
+
+        // Nothing new: no checkpoint
+        passed = passed && !checkpointer.Checkpoint() && checkpointer.GetGeneration() == 1;
+
+        // Region 0 was empty, so every slot is written again
+        Apply(MakeQuote("TXO17000L4", '5', 11, 200), &quotes, &checkpointer);
+        passed = passed && checkpointer.Checkpoint() && checkpointer.GetLastChangedSlots() == 10;
+
+        // Region 1 holds generation 1: only the updated book differs
+        Apply(MakeQuote("TXO17100L4", '5', 12, 300), &quotes, &checkpointer);
+        passed = passed && checkpointer.Checkpoint() && checkpointer.GetLastChangedSlots() == 2;
+        passed = passed && checkpointer.GetGeneration() == 3 && checkpointer.GetCheckpointCount() == 3;
+    }
+
+    // Tear generation 3 in region 1: the restart falls back to generation 2
+    int fd = open(path.c_str(), O_RDWR);
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    CheckpointFileHeader header;
+    passed = passed && fd >= 0 && pread(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header));
+    off_t torn = static_cast<off_t>(header.region_offset + header.region_size + sizeof(CheckpointRegionHeader) +
+                                    MAX_SYMBOLS * sizeof(ReferenceRecord) + sizeof(QuoteSnapshot) + 20);
+    char garbage = 0x5A;
+    passed = passed && header.region_offset == page && pwrite(fd, &garbage, 1, torn) == 1;
+    close(fd);
+
+    ReferenceDataStore reference(MAX_SYMBOLS);
+    QuoteSnapshotTable quotes(MAX_SYMBOLS);
+    StateCheckpointer checkpointer(path, &reference, &quotes, 1000, MAX_SYMBOLS);
+    passed = passed && checkpointer.Open() && checkpointer.Restore() == 2;
+    QuoteSnapshot snapshot;
+    passed = passed && quotes.Read("TXO17000L4", &snapshot) && snapshot.bid_price == 200;
+    passed = passed && quotes.Read("TXO17100L4", &snapshot) && snapshot.bid_price == 101;
+    passed = passed && checkpointer.GetLastSequence('5', MessageType::QUOTE) == 11;
+
+    // The next checkpoint replaces the torn region
+    Apply(MakeQuote("TXO17100L4", '5', 13, 400), &quotes, &checkpointer);
+    passed = passed && checkpointer.Checkpoint() && checkpointer.GetGeneration() == 3;
+
+    unlink(path.c_str());
+    std::cout << "Double Buffer test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// The checkpoint thread saves periodically and once more on Stop
+bool test_thread()
+{
+    std::string path = MakePath();
+    bool passed = !path.empty();
+    {
+        QuoteSnapshotTable quotes(MAX_SYMBOLS);
+        StateCheckpointer checkpointer(path, nullptr, &quotes, 10, MAX_SYMBOLS);
+        passed = passed && checkpointer.Open() && checkpointer.Start();
+
+        Apply(MakeQuote("TXFL4     ", '2', 1, 100), &quotes, &checkpointer);
+        for (int i = 0; i < 200 && checkpointer.GetCheckpointCount() == 0; ++i)
+        {
+            struct timespec delay = {0, 5000000};
+            nanosleep(&delay, nullptr);
+        }
+        passed = passed && checkpointer.GetCheckpointCount() >= 1;
+
+        // Stop catches the last update even if the interval has not elapsed
+        Apply(MakeQuote("TXFL4     ", '2', 2, 150), &quotes, &checkpointer);
+        checkpointer.Stop();
+    }
+
+    QuoteSnapshotTable quotes(MAX_SYMBOLS);
+    StateCheckpointer checkpointer(path, nullptr, &quotes, 10, MAX_SYMBOLS);
+    QuoteSnapshot snapshot;
+    passed = passed && checkpointer.Open() && checkpointer.Restore() >= 2;
+    passed = passed && quotes.Read("TXFL4     ", &snapshot) && snapshot.bid_price == 150;
+    passed = passed && checkpointer.GetLastSequence('2', MessageType::QUOTE) == 2;
+
+    // A file of another layout starts over
+    StateCheckpointer resized(path, nullptr, &quotes, 10, MAX_SYMBOLS * 2);
+    passed = passed && resized.Open() && resized.Restore() == 0;
+
+    unlink(path.c_str());
+    std::cout << "Thread test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+int main()
+{
+    std::cout << "==== State Checkpoint Unit Tests ====\n"
+              << std::endl;
+
+    // Define all test cases
+    TestCase test_cases[] = {
+        {"Round Trip", test_round_trip},
+        {"Double Buffer", test_double_buffer},
+        {"Thread", test_thread}};
+
+    // Run all tests and count failures
+    size_t num_tests = sizeof(test_cases) / sizeof(TestCase);
+    size_t passed_tests = 0;
+
+    for (size_t i = 0; i < num_tests; ++i)
+    {
+        std::cout << "\nRunning test: " << test_cases[i].name << std::endl;
+        if (test_cases[i].test_func())
+        {
+            passed_tests++;
+        }
+    }
+
+    // Print summary
+    std::cout << "\n==== Test Results ====\n";
+    std::cout << "Passed: " << passed_tests << "/" << num_tests
+              << " (" << (passed_tests * 100 / num_tests) << "%)" << std::endl;
+
+    // Return 0 if all tests passed, otherwise return the number of failures
+    return (passed_tests == num_tests) ? 0 : (num_tests - passed_tests);
+}
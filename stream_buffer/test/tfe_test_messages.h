@@ -0,0 +1,36 @@
+#pragma once
+
+// NormalizedMessage builders shared by the tests
+
+#include "processing/normalized_message.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace stream_buffer
+{
+    namespace testing
+    {
+        // Build a message of one type for a product, padded with spaces to ten characters; every other field is zero
+        inline processing::NormalizedMessage MakeMessage(const std::string &product_id, processing::MessageType type,
+                                                         common::u32 information_seq = 0)
+        {
+            processing::NormalizedMessage message;
+            std::memset(&message, 0, sizeof(message));
+            std::memset(message.product_id, ' ', sizeof(message.product_id));
+            std::memcpy(message.product_id, product_id.data(),
+                        product_id.size() < sizeof(message.product_id) ? product_id.size() : sizeof(message.product_id));
+            message.type = type;
+            message.information_seq = information_seq;
+            return message;
+        }
+
+        // Ten character product id of a letter and a number, for tests that need many products
+        inline std::string MakeProductId(char prefix, size_t number)
+        {
+            char id[16];
+            std::snprintf(id, sizeof(id), "%c%09zu", prefix, number);
+            return std::string(id);
+        }
+    } // namespace testing
+} // namespace stream_buffer
@@ -0,0 +1,112 @@
+#pragma once
+
+// TFE packet builders shared by the tests and benchmarks
+
+#include "processing/tfe.h"
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace stream_buffer
+{
+    namespace testing
+    {
+        // Store a value as packed BCD in a big-endian field
+        inline void EncodeBcd(common::u64 value, common::u8 *data, size_t length)
+        {
+            for (size_t i = length; i-- > 0;)
+            {
+                data[i] = static_cast<common::u8>((value % 10) | ((value / 10 % 10) << 4));
+                value /= 100;
+            }
+        }
+
+        // Build a packet around a body with a correct checksum, stamped hhmmssmmmuuu and seq
+        inline std::vector<char> MakePacket(char transmission_code, char message_kind, const void *body, size_t body_size,
+                                            common::u64 information_time = 0, common::u64 information_seq = 0)
+        {
+            namespace tfe = processing::tfe;
+            std::vector<char> packet(tfe::CalculatePacketSize(body_size), 0);
+            tfe::Header *header = reinterpret_cast<tfe::Header *>(packet.data());
+            header->esc_code = static_cast<char>(tfe::ESC_CODE);
+            header->transmission_code = transmission_code;
+            header->message_kind = message_kind;
+            EncodeBcd(information_time, header->information_time, sizeof(header->information_time));
+            EncodeBcd(information_seq, header->information_seq, sizeof(header->information_seq));
+            header->version_no = 0x01;
+            EncodeBcd(body_size, header->body_length, sizeof(header->body_length));
+            if (body_size > 0)
+            {
+                std::memcpy(packet.data() + sizeof(tfe::Header), body, body_size);
+            }
+
+            size_t checksum_pos = packet.size() - tfe::TERMINAL_CODE_SIZE - tfe::CHECK_SUM_SIZE;
+            packet[checksum_pos] = static_cast<char>(tfe::ComputeChecksum(packet.data(), checksum_pos + 1));
+            packet[packet.size() - 2] = 0x0D;
+            packet[packet.size() - 1] = static_cast<char>(tfe::TERMINAL_CODE);
+            return packet;
+        }
+
+        // Build an I010 packet for TXFL4 with a reference price of 55
+        inline std::vector<char> MakeI010Packet(common::u64 information_time = 0, common::u64 information_seq = 0)
+        {
+            processing::tfe::BodyI010 body;
+            std::memset(&body, 0, sizeof(body));
+            std::memcpy(body.prod_id_s, "TXFL4     ", sizeof(body.prod_id_s));
+            body.reference_price[4] = 0x55;
+            return MakePacket('1', '1', &body, sizeof(body), information_time, information_seq);
+        }
+
+        // Build an I080 packet for TXFL4 with a single bid and ask level
+        inline std::vector<char> MakeI080Packet(common::u64 information_time = 0, common::u64 information_seq = 0)
+        {
+            processing::tfe::BodyI080 body;
+            std::memset(&body, 0, sizeof(body));
+            std::memcpy(body.prod_id_s, "TXFL4     ", sizeof(body.prod_id_s));
+            body.buy[0].price_sign = '0';
+            EncodeBcd(2250000, body.buy[0].price, sizeof(body.buy[0].price));
+            EncodeBcd(5, body.buy[0].quantity, sizeof(body.buy[0].quantity));
+            body.sell[0].price_sign = '0';
+            EncodeBcd(2250100, body.sell[0].price, sizeof(body.sell[0].price));
+            EncodeBcd(8, body.sell[0].quantity, sizeof(body.sell[0].quantity));
+            return MakePacket('2', '2', &body, sizeof(body), information_time, information_seq);
+        }
+
+        // Build an I020 body for TXFL4 with one match per price and quantity pair, and the totals trailer
+        inline std::vector<char> MakeI020Body(const std::vector<std::pair<common::i64, common::i64>> &matches)
+        {
+            namespace tfe = processing::tfe;
+            size_t items = matches.empty() ? 0 : matches.size() - 1;
+            std::vector<char> body(sizeof(tfe::BodyI020) + items * sizeof(tfe::MatchItem) + sizeof(tfe::MatchTotals), 0);
+            tfe::BodyI020 *trade = reinterpret_cast<tfe::BodyI020 *>(body.data());
+            std::memcpy(trade->prod_id_s, "TXFL4     ", sizeof(trade->prod_id_s));
+            EncodeBcd(91530123456ULL, trade->match_time, sizeof(trade->match_time));
+            EncodeBcd(items, &trade->match_display_item, sizeof(trade->match_display_item));
+
+            common::i64 total = 0;
+            for (size_t i = 0; i < matches.size(); ++i)
+            {
+                // The first match in the fixed part has the same layout as the items after it
+                tfe::MatchItem *item = reinterpret_cast<tfe::MatchItem *>(
+                    i == 0 ? &trade->first_match_price_sign
+                           : body.data() + sizeof(tfe::BodyI020) + (i - 1) * sizeof(tfe::MatchItem));
+                item->match_price_sign = matches[i].first < 0 ? '-' : '0';
+                EncodeBcd(matches[i].first < 0 ? -matches[i].first : matches[i].first,
+                          item->match_price, sizeof(item->match_price));
+                EncodeBcd(matches[i].second, item->match_qty, sizeof(item->match_qty));
+                total += matches[i].second;
+            }
+            tfe::MatchTotals *totals = reinterpret_cast<tfe::MatchTotals *>(&body[body.size() - sizeof(tfe::MatchTotals)]);
+            EncodeBcd(total, totals->match_total_qty, sizeof(totals->match_total_qty));
+            return body;
+        }
+
+        // Build an I020 packet for TXFL4, see MakeI020Body
+        inline std::vector<char> MakeI020Packet(const std::vector<std::pair<common::i64, common::i64>> &matches,
+                                                common::u64 information_time = 0, common::u64 information_seq = 0)
+        {
+            std::vector<char> body = MakeI020Body(matches);
+            return MakePacket('2', '1', body.data(), body.size(), information_time, information_seq);
+        }
+    } // namespace testing
+} // namespace stream_buffer
@@ -0,0 +1,299 @@
+#include "processing/tfe.h"
+#include "processing/tfe_decoder.h"
+#include "processing/tfe_processor.h"
+#include "utils/checksum.h"
+#include "tfe_test_packets.h"
+#include <iostream>
+#include <cstring>
+#include <vector>
+
+using namespace stream_buffer;
+using namespace stream_buffer::processing;
+using namespace stream_buffer::testing;
+
+// Unit test framework structure
+struct TestCase
+{
+    const char *name;
+    bool (*test_func)();
+};
+
+namespace
+{
+    // Keeps every message it is given
+    class CollectingSink : public IMessageSink
+    {
+    public:
+        std::vector<NormalizedMessage> messages;
+
+        void OnMessage(const NormalizedMessage &message) override { messages.push_back(message); }
+    };
+
+    // Handler recording what the decoder delivered
+    class RecordingHandler : public HandlerBase
+    {
+    public:
+        size_t messages = 0;
+        size_t i010 = 0;
+        size_t unknown = 0;
+        size_t resync_bytes = 0;
+        std::vector<common::Price> trade_prices;
+        std::vector<common::i64> trade_quantities;
+        common::Price bid, ask;
+        common::i64 bid_qty = 0, ask_qty = 0;
+
+        void OnMessage(const MessageView &) { messages++; }
+        void OnI010(const I010View &) { i010++; }
+        void OnTrade(const TradeView &view)
+        {
+            for (size_t i = 0; i < view.GetMatchCount(); ++i)
+            {
+                common::Price price;
+                common::i64 quantity = 0;
+                if (view.GetMatch(i, &price, &quantity))
+                {
+                    trade_prices.push_back(price);
+                    trade_quantities.push_back(quantity);
+                }
+            }
+        }
+        void OnQuote(const QuoteView &view)
+        {
+            view.GetBid(0, &bid, &bid_qty);
+            view.GetAsk(0, &ask, &ask_qty);
+        }
+        void OnUnknown(const MessageView &) { unknown++; }
+        void OnResync(const char *, size_t skipped) { resync_bytes += skipped; }
+    };
+} // anonymous namespace
+
+// Test the vector kernel against a byte-at-a-time reference for every tail length
+bool test_xor_checksum_lengths()
+{
+    std::vector<uint8_t> data(300);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = static_cast<uint8_t>(i * 131 + 7);
+    }
+
+    bool passed = utils::xor_checksum(data.data(), 0) == 0;
+    for (size_t offset = 0; offset < 3; ++offset)
+    {
+        uint8_t expected = 0;
+        for (size_t length = 1; offset + length <= data.size(); ++length)
+        {
+            expected ^= data[offset + length - 1];
+            if (utils::xor_checksum(data.data() + offset, length) != expected)
+            {
+                std::cout << "Mismatch at offset " << offset << " length " << length << std::endl;
+                passed = false;
+            }
+        }
+    }
+
+    std::cout << "Test XOR checksum lengths: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Test that a well-formed packet validates
+bool test_valid_checksum()
+{
+    std::vector<char> packet = MakeI010Packet();
+    bool passed = tfe::ValidateChecksum(packet.data(), packet.size() - tfe::TERMINAL_CODE_SIZE);
+
+    std::cout << "Test valid checksum: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Test that a single flipped bit is rejected
+bool test_corrupted_checksum()
+{
+    std::vector<char> packet = MakeI010Packet();
+    packet[sizeof(tfe::Header) + 3] ^= 0x10;
+    bool passed = !tfe::ValidateChecksum(packet.data(), packet.size() - tfe::TERMINAL_CODE_SIZE);
+
+    std::cout << "Test corrupted checksum: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Test single-pass header decode against the field-by-field decoder
+bool test_decode_header()
+{
+    std::vector<char> packet = MakeI010Packet(91530123456ULL, 42);
+    const tfe::Header *header = reinterpret_cast<const tfe::Header *>(packet.data());
+    tfe::DecodedHeader decoded = tfe::DecodedHeader();
+    bool passed = tfe::DecodeHeader(packet.data(), &decoded) &&
+                  decoded.information_time == 91530123456ULL &&
+                  decoded.information_time_ns == ((9 * 60 + 15) * 60 + 30) * 1000000000LL + 123456000LL &&
+                  static_cast<long long>(decoded.information_time) ==
+                      utils::decode_bcd(header->information_time, sizeof(header->information_time)) &&
+                  decoded.information_seq == 42 &&
+                  decoded.version_no == 1 &&
+                  decoded.body_length == header->GetBodyLength() &&
+                  decoded.transmission_code == '1' &&
+                  decoded.message_kind == '1';
+
+    std::cout << "Test decode header: " << (passed ? "PASSED" : "FAILED")
+              << " (time " << decoded.information_time << ", seq " << decoded.information_seq
+              << ", length " << decoded.body_length << ")" << std::endl;
+    return passed;
+}
+
+// Test that each class of header corruption is rejected
+bool test_decode_invalid_header()
+{
+    tfe::DecodedHeader decoded;
+    std::vector<char> bad_esc = MakeI010Packet();
+    bad_esc[0] = 0x1C;
+    std::vector<char> bad_nibble = MakeI010Packet();
+    bad_nibble[11] = static_cast<char>(0x4A); // information_seq byte with a non-BCD low nibble
+    std::vector<char> bad_high_nibble = MakeI010Packet();
+    bad_high_nibble[15] = static_cast<char>(0xB2); // body_length byte with a non-BCD high nibble
+    std::vector<char> bad_kind = MakeI010Packet();
+    bad_kind[2] = 'a';
+    std::vector<char> too_long = MakeI010Packet();
+    too_long[14] = 0x50; // 5032 bytes
+
+    bool passed = !tfe::DecodeHeader(bad_esc.data(), &decoded) &&
+                  !tfe::DecodeHeader(bad_nibble.data(), &decoded) &&
+                  !tfe::DecodeHeader(bad_high_nibble.data(), &decoded) &&
+                  !tfe::DecodeHeader(bad_kind.data(), &decoded) &&
+                  !tfe::DecodeHeader(too_long.data(), &decoded);
+
+    std::cout << "Test decode invalid header: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Decode a mixed stream through a statically bound handler
+bool test_decoder_dispatch()
+{
+    std::vector<char> stream;
+    std::vector<char> i010 = MakeI010Packet();
+    std::vector<char> i020 = MakeI020Packet({{2250075, 3}, {-125, 7}});
+    std::vector<char> i080 = MakeI080Packet();
+    std::vector<char> other = MakePacket('3', '1', "\x00\x01", 2);
+    const char garbage[] = {0x01, 0x02, 0x03};
+
+    stream.reserve(2 * i010.size() + sizeof(garbage) + i020.size() + i080.size() + other.size());
+    stream.insert(stream.end(), i010.begin(), i010.end());
+    stream.insert(stream.end(), garbage, garbage + sizeof(garbage));
+    stream.insert(stream.end(), i020.begin(), i020.end());
+    stream.insert(stream.end(), i080.begin(), i080.end());
+    stream.insert(stream.end(), other.begin(), other.end());
+    stream.insert(stream.end(), i010.begin(), i010.begin() + 20); // partial packet
+
+    RecordingHandler handler;
+    Decoder<RecordingHandler> decoder(handler);
+    core::BatchResult result = decoder.Decode(stream.data(), stream.size());
+
+    bool passed = result.message_count == 4 &&
+                  result.bytes_consumed == stream.size() - 20 &&
+                  handler.messages == 4 && handler.i010 == 1 && handler.unknown == 1 &&
+                  handler.resync_bytes == sizeof(garbage) &&
+                  handler.trade_prices.size() == 2 &&
+                  handler.trade_prices[0] == common::Price(2250075, 0) && handler.trade_quantities[0] == 3 &&
+                  handler.trade_prices[1] == common::Price(-125, 0) && handler.trade_quantities[1] == 7 &&
+                  handler.bid == common::Price(2250000, 0) && handler.bid_qty == 5 &&
+                  handler.ask == common::Price(2250100, 0) && handler.ask_qty == 8;
+
+    std::cout << "Decoder dispatch test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// A match count above the items present stops before the totals trailer
+bool test_trade_match_count()
+{
+    std::vector<char> body = MakeI020Body({{2250075, 3}, {2250100, 7}});
+    std::vector<char> packet = MakePacket('2', '1', body.data(), body.size());
+    tfe::DecodedHeader header;
+    bool passed = tfe::DecodeHeader(packet.data(), &header);
+    TradeView view(header, packet.data(), constants::INVALID_SYMBOL, 0);
+    common::Price price;
+    common::i64 quantity = 0;
+    passed = passed && view.GetMatchCount() == 2 && view.GetMatch(1, &price, &quantity) &&
+             price == common::Price(2250100, 0) && quantity == 7;
+
+    // The body holds one item but claims five
+    tfe::BodyI020 *trade = reinterpret_cast<tfe::BodyI020 *>(body.data());
+    EncodeBcd(5, &trade->match_display_item, sizeof(trade->match_display_item));
+    packet = MakePacket('2', '1', body.data(), body.size());
+    passed = passed && tfe::DecodeHeader(packet.data(), &header);
+    TradeView overstated(header, packet.data(), constants::INVALID_SYMBOL, 0);
+    passed = passed && overstated.GetMatchCount() == 2 && !overstated.GetMatch(2, &price, &quantity);
+
+    // Without the trailer only the first match is there
+    packet = MakePacket('2', '1', body.data(), sizeof(tfe::BodyI020));
+    passed = passed && tfe::DecodeHeader(packet.data(), &header);
+    TradeView truncated(header, packet.data(), constants::INVALID_SYMBOL, 0);
+    passed = passed && truncated.GetMatchCount() == 1 && truncated.GetMatch(0, &price, &quantity) && quantity == 3;
+
+    std::cout << "Trade match count test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Every match of a sweep reaches the sinks as a trade of its own
+bool test_trade_matches()
+{
+    std::vector<char> stream = MakeI020Packet({{2250075, 3}, {2250100, 7}, {2250150, 2}}, 91530123456ULL, 42);
+    std::vector<char> quote = MakeI080Packet(91530123457ULL, 43);
+    stream.insert(stream.end(), quote.begin(), quote.end());
+
+    TFEProcessor processor;
+    CollectingSink sink;
+    processor.AddSink(&sink);
+    core::BatchResult result = processor.ProcessBatch(stream.data(), stream.size());
+
+    const common::i64 prices[] = {2250075, 2250100, 2250150};
+    const common::i64 quantities[] = {3, 7, 2};
+    bool passed = result.message_count == 2 && sink.messages.size() == 4;
+    for (size_t i = 0; i < 3 && passed; ++i)
+    {
+        const NormalizedMessage &message = sink.messages[i];
+        passed = message.type == MessageType::TRADE && message.price == prices[i] && message.quantity == quantities[i] &&
+                 message.information_seq == 42 && message.information_time == 91530123456ULL &&
+                 std::memcmp(message.product_id, "TXFL4     ", 10) == 0;
+    }
+    passed = passed && sink.messages[3].type == MessageType::QUOTE && sink.messages[3].information_seq == 43;
+
+    std::cout << "Trade matches test: " << (passed ? "PASSED" : "FAILED")
+              << " (" << sink.messages.size() << " messages)" << std::endl;
+    return passed;
+}
+
+int main()
+{
+    std::cout << "==== TFE Unit Tests ====\n"
+              << std::endl;
+
+    // Define all test cases
+    TestCase test_cases[] = {
+        {"XOR Checksum Lengths", test_xor_checksum_lengths},
+        {"Valid Checksum", test_valid_checksum},
+        {"Corrupted Checksum", test_corrupted_checksum},
+        {"Decode Header", test_decode_header},
+        {"Decode Invalid Header", test_decode_invalid_header},
+        {"Decoder Dispatch", test_decoder_dispatch},
+        {"Trade Match Count", test_trade_match_count},
+        {"Trade Matches", test_trade_matches}};
+
+    // Run all tests and count failures
+    size_t num_tests = sizeof(test_cases) / sizeof(TestCase);
+    size_t passed_tests = 0;
+
+    for (size_t i = 0; i < num_tests; ++i)
+    {
+        std::cout << "\nRunning test: " << test_cases[i].name << std::endl;
+        if (test_cases[i].test_func())
+        {
+            passed_tests++;
+        }
+    }
+
+    // Print summary
+    std::cout << "\n==== Test Results ====\n";
+    std::cout << "Passed: " << passed_tests << "/" << num_tests
+              << " (" << (passed_tests * 100 / num_tests) << "%)" << std::endl;
+
+    // Return 0 if all tests passed, otherwise return the number of failures
+    return (passed_tests == num_tests) ? 0 : (num_tests - passed_tests);
+}
@@ -0,0 +1,492 @@
+#include "processing/tfe_processor.h"
+#include "processing/tick_store.h"
+#include "tfe_test_packets.h"
+#include "tfe_test_messages.h"
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace stream_buffer;
+using namespace stream_buffer::processing;
+using namespace stream_buffer::testing;
+
+// Unit test framework structure
+struct TestCase
+{
+    const char *name;
+    bool (*test_func)();
+};
+
+namespace
+{
+    const common::i64 NS_PER_SECOND = 1000000000LL;
+
+    // A fresh store directory under /tmp
+    std::string MakeStoreDirectory()
+    {
+        char path[] = "/tmp/tick_store_test.XXXXXX";
+        return mkdtemp(path) ? std::string(path) : std::string();
+    }
+
+    void RemoveStoreDirectory(const std::string &directory)
+    {
+        for (size_t t = 0; t < constants::MESSAGE_TYPE_COUNT; ++t)
+        {
+            unlink((directory + "/" + GetTickFileName(static_cast<MessageType>(t))).c_str());
+            unlink((directory + "/" + GetTickIndexName(static_cast<MessageType>(t))).c_str());
+        }
+        unlink((directory + "/" + TICK_SYMBOLS_FILE).c_str());
+        rmdir(directory.c_str());
+    }
+
+    std::vector<char> ReadFile(const std::string &path)
+    {
+        std::vector<char> data;
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return data;
+        }
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) == 0)
+        {
+            data.resize(static_cast<size_t>(file_stat.st_size));
+            if (pread(fd, data.data(), data.size(), 0) != static_cast<ssize_t>(data.size()))
+            {
+                data.clear();
+            }
+        }
+        close(fd);
+        return data;
+    }
+
+    TickFileHeader ReadHeader(const std::vector<char> &file)
+    {
+        TickFileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        if (file.size() >= sizeof(header))
+        {
+            std::memcpy(&header, file.data(), sizeof(header));
+        }
+        return header;
+    }
+
+    // Value of a column at a row of a block
+    template <typename T>
+    T ReadColumn(const std::vector<char> &file, const TickFileHeader &header, size_t block, TickColumn column,
+                 size_t row)
+    {
+        T value;
+        size_t offset = header.data_offset + block * header.block_size +
+                        GetTickColumnOffset(header.column_mask, header.block_rows, column) + row * sizeof(T);
+        std::memcpy(&value, file.data() + offset, sizeof(T));
+        return value;
+    }
+
+    // Trade at 09:00:00 plus i seconds
+    NormalizedMessage MakeTrade(const char *product_id, common::u32 i)
+    {
+        NormalizedMessage message = MakeMessage(product_id, MessageType::TRADE, i + 1);
+        message.information_time = 90000000000ULL + (i / 60) * 100000000ULL + (i % 60) * 1000000ULL;
+        message.information_time_ns = (9 * 3600 + i) * NS_PER_SECOND;
+        message.price_scale = 1;
+        message.price = 170000 + i;
+        message.quantity = i % 5 + 1;
+        return message;
+    }
+
+    NormalizedMessage MakeQuote(const char *product_id, common::u32 i)
+    {
+        NormalizedMessage message = MakeMessage(product_id, MessageType::QUOTE, i + 1);
+        message.information_time = 90000000000ULL + i * 1000ULL;
+        message.information_time_ns = 9 * 3600 * NS_PER_SECOND + i * 1000000LL;
+        message.price_scale = 2;
+        message.bid_price = 9900 + i;
+        message.bid_quantity = 10;
+        message.ask_price = 10000 + i;
+        message.ask_quantity = 20;
+        return message;
+    }
+} // anonymous namespace
+
+// Columns are laid out in order and stay aligned to their width
+bool test_layout()
+{
+    bool passed = NsToInformationTime(((13 * 60 + 45) * 60 + 30) * NS_PER_SECOND + 123456000LL) == 134530123456ULL;
+    passed = passed && NsToInformationTime(0) == 0;
+
+    common::u32 mask = GetTickColumnMask(MessageType::TRADE);
+    passed = passed && (mask & (1u << static_cast<unsigned>(TickColumn::QUANTITY))) != 0;
+    passed = passed && (mask & (1u << static_cast<unsigned>(TickColumn::BID_PRICE))) == 0;
+    passed = passed && GetTickColumnOffset(mask, 8, TickColumn::TIME) == sizeof(TickBlockHeader);
+    passed = passed && GetTickColumnOffset(mask, 8, TickColumn::SEQ) == sizeof(TickBlockHeader) + 64;
+    passed = passed && GetTickColumnOffset(mask, 8, TickColumn::PRICE) == sizeof(TickBlockHeader) + 64 + 32 + 32 + 8;
+    for (size_t c = 0; c < TICK_COLUMN_COUNT; ++c)
+    {
+        TickColumn column = static_cast<TickColumn>(c);
+        passed = passed && GetTickColumnOffset(mask, 4096, column) % GetTickColumnWidth(column) == 0;
+    }
+
+    passed = passed && GetTickFileName(MessageType::QUOTE) == "quote.ticks";
+    passed = passed && GetTickIndexName(MessageType::PRODUCT_INFO) == "i010.index";
+
+    std::cout << "Layout test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Rows land in per-type files, split into indexed blocks
+bool test_writer()
+{
+    std::string directory = MakeStoreDirectory();
+    TickStoreWriter writer(8);
+    bool passed = !directory.empty() && writer.Open(directory);
+
+    for (common::u32 i = 0; i < 20 && passed; ++i)
+    {
+        passed = writer.Append(MakeTrade(i % 2 ? "MXFL4     " : "TXFL4     ", i));
+    }
+    for (common::u32 i = 0; i < 3 && passed; ++i)
+    {
+        passed = writer.Append(MakeQuote("TXFL4     ", i));
+    }
+    writer.Flush();
+    passed = passed && writer.GetRowCount(MessageType::TRADE) == 20;
+
+    std::vector<char> trades = ReadFile(directory + "/trade.ticks");
+    TickFileHeader header = ReadHeader(trades);
+    passed = passed && std::memcmp(header.magic, "SBTICKS", 8) == 0 && header.version == constants::TICK_STORE_VERSION;
+    passed = passed && header.message_type == static_cast<common::u8>(MessageType::TRADE);
+    passed = passed && header.block_rows == 8 && header.block_count == 3 && header.row_count == 20;
+    passed = passed && trades.size() == header.data_offset + 3 * header.block_size;
+
+    // Row 13 is the sixth row of the second block
+    passed = passed && ReadColumn<common::i64>(trades, header, 1, TickColumn::PRICE, 5) == 170013;
+    passed = passed && ReadColumn<common::i64>(trades, header, 1, TickColumn::TIME, 5) ==
+                           9 * 3600 * NS_PER_SECOND + 13 * NS_PER_SECOND;
+    passed = passed && ReadColumn<common::u32>(trades, header, 1, TickColumn::SEQ, 5) == 14;
+    passed = passed && ReadColumn<common::u32>(trades, header, 1, TickColumn::SYMBOL, 5) == 1;
+    passed = passed && ReadColumn<common::u8>(trades, header, 1, TickColumn::PRICE_SCALE, 5) == 1;
+    passed = passed && ReadColumn<common::i64>(trades, header, 1, TickColumn::QUANTITY, 5) == 4;
+
+    std::vector<char> index = ReadFile(directory + "/trade.index");
+    passed = passed && index.size() == 3 * sizeof(TickIndexEntry);
+    if (passed)
+    {
+        TickIndexEntry last;
+        std::memcpy(&last, index.data() + 2 * sizeof(TickIndexEntry), sizeof(last));
+        passed = last.block == 2 && last.first_row == 16 && last.row_count == 4;
+        passed = passed && last.min_time_ns == 9 * 3600 * NS_PER_SECOND + 16 * NS_PER_SECOND;
+        passed = passed && last.max_time_ns == 9 * 3600 * NS_PER_SECOND + 19 * NS_PER_SECOND;
+    }
+
+    std::vector<char> quotes = ReadFile(directory + "/quote.ticks");
+    TickFileHeader quote_header = ReadHeader(quotes);
+    passed = passed && quote_header.row_count == 3 && quote_header.block_count == 1;
+    passed = passed && ReadColumn<common::i64>(quotes, quote_header, 0, TickColumn::ASK_PRICE, 2) == 10002;
+    passed = passed && ReadHeader(ReadFile(directory + "/i010.ticks")).row_count == 0;
+
+    std::vector<char> symbols = ReadFile(directory + "/symbols");
+    passed = passed && symbols.size() == 2 * constants::PRODUCT_ID_SIZE;
+    passed = passed && std::memcmp(symbols.data(), "TXFL4     MXFL4     ", symbols.size()) == 0;
+
+    writer.Close();
+    RemoveStoreDirectory(directory);
+
+    std::cout << "Writer test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Readers see rows only once they are flushed, and full blocks as soon as the next starts
+bool test_publish()
+{
+    std::string directory = MakeStoreDirectory();
+    TickStoreWriter writer(8);
+    bool passed = !directory.empty() && writer.Open(directory);
+
+    for (common::u32 i = 0; i < 5 && passed; ++i)
+    {
+        passed = writer.Append(MakeTrade("TXFL4     ", i));
+    }
+    passed = passed && ReadHeader(ReadFile(directory + "/trade.ticks")).row_count == 0;
+    writer.Flush();
+    passed = passed && ReadHeader(ReadFile(directory + "/trade.ticks")).row_count == 5;
+
+    for (common::u32 i = 5; i < 10 && passed; ++i)
+    {
+        passed = writer.Append(MakeTrade("TXFL4     ", i));
+    }
+    TickFileHeader header = ReadHeader(ReadFile(directory + "/trade.ticks"));
+    passed = passed && header.row_count == 8 && header.block_count == 1;
+
+    writer.Close();
+    passed = passed && ReadHeader(ReadFile(directory + "/trade.ticks")).row_count == 10;
+    RemoveStoreDirectory(directory);
+
+    std::cout << "Publish test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// A restart appends after the published rows and keeps the symbols
+bool test_reopen()
+{
+    std::string directory = MakeStoreDirectory();
+    bool passed = !directory.empty();
+    {
+        TickStoreWriter writer(8);
+        passed = passed && writer.Open(directory);
+        for (common::u32 i = 0; i < 10 && passed; ++i)
+        {
+            passed = writer.Append(MakeTrade(i % 2 ? "MXFL4     " : "TXFL4     ", i));
+        }
+        passed = passed && writer.Append(MakeQuote("TXFL4     ", 0));
+        writer.Close();
+
+        // Reopening the same writer continues too
+        passed = passed && writer.Open(directory) && writer.GetRowCount(MessageType::TRADE) == 10;
+    }
+
+    // A product id cut short when the process died
+    int fd = open((directory + "/" + TICK_SYMBOLS_FILE).c_str(), O_WRONLY | O_APPEND);
+    passed = passed && fd >= 0 && write(fd, "TEFL", 4) == 4;
+    close(fd);
+
+    // Blocks of another size cannot be appended to
+    TickStoreWriter resized(16);
+    passed = passed && !resized.Open(directory);
+
+    TickStoreWriter writer(8);
+    passed = passed && writer.Open(directory) && writer.GetRowCount(MessageType::TRADE) == 10;
+    for (common::u32 i = 10; i < 15 && passed; ++i)
+    {
+        passed = writer.Append(MakeTrade(i == 12 ? "TEFL4     " : "TXFL4     ", i));
+    }
+    writer.Close();
+
+    std::vector<char> trades = ReadFile(directory + "/trade.ticks");
+    TickFileHeader header = ReadHeader(trades);
+    passed = passed && header.row_count == 15 && header.block_count == 2;
+    passed = passed && ReadColumn<common::u32>(trades, header, 1, TickColumn::SEQ, 1) == 10;
+    passed = passed && ReadColumn<common::u32>(trades, header, 1, TickColumn::SEQ, 2) == 11;
+    passed = passed && ReadColumn<common::u32>(trades, header, 1, TickColumn::SYMBOL, 4) == 2;
+
+    std::vector<char> index = ReadFile(directory + "/trade.index");
+    passed = passed && index.size() == 2 * sizeof(TickIndexEntry);
+    if (passed)
+    {
+        TickIndexEntry last;
+        std::memcpy(&last, index.data() + sizeof(TickIndexEntry), sizeof(last));
+        passed = last.block == 1 && last.first_row == 8 && last.row_count == 7;
+        passed = passed && last.min_time_ns == 9 * 3600 * NS_PER_SECOND + 8 * NS_PER_SECOND;
+        passed = passed && last.max_time_ns == 9 * 3600 * NS_PER_SECOND + 14 * NS_PER_SECOND;
+    }
+
+    std::vector<char> symbols = ReadFile(directory + "/" + TICK_SYMBOLS_FILE);
+    passed = passed && symbols.size() == 3 * constants::PRODUCT_ID_SIZE;
+    passed = passed && std::memcmp(symbols.data(), "TXFL4     MXFL4     TEFL4     ", symbols.size()) == 0;
+
+    TickStoreReader reader;
+    TickQuery query;
+    std::vector<NormalizedMessage> messages;
+    passed = passed && reader.Open(directory) && reader.Query(query, &messages, nullptr) == 15;
+    for (size_t i = 0; i < messages.size() && passed; ++i)
+    {
+        passed = messages[i].information_seq == i + 1 && messages[i].price == static_cast<common::i64>(170000 + i);
+    }
+    passed = passed && std::memcmp(messages[12].product_id, "TEFL4     ", 10) == 0;
+    passed = passed && reader.GetRowCount(MessageType::QUOTE) == 1;
+
+    reader.Close();
+    RemoveStoreDirectory(directory);
+
+    std::cout << "Reopen test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// A full queue drops messages instead of blocking the producer
+bool test_sink()
+{
+    std::string directory = MakeStoreDirectory();
+    bool passed = !directory.empty();
+    {
+        TickStoreSink sink(directory, 4, 8);
+        for (common::u32 i = 0; i < 10; ++i)
+        {
+            sink.OnMessage(MakeTrade("TXFL4     ", i));
+        }
+        passed = passed && sink.GetDroppedCount() == 6;
+
+        passed = passed && sink.Start();
+        for (common::u32 i = 10; i < 12; ++i)
+        {
+            sink.OnMessage(MakeTrade("TXFL4     ", i));
+        }
+        sink.Stop();
+        passed = passed && sink.GetWrittenCount() + sink.GetDroppedCount() == 12;
+        passed = passed && sink.GetWrittenCount() >= 4;
+
+        TickFileHeader header = ReadHeader(ReadFile(directory + "/trade.ticks"));
+        passed = passed && header.row_count == sink.GetWrittenCount();
+    }
+    RemoveStoreDirectory(directory);
+
+    std::cout << "Sink test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Queries return exactly the rows in range and read only the blocks that can hold them
+bool test_query()
+{
+    std::string directory = MakeStoreDirectory();
+    TickStoreWriter writer(8);
+    bool passed = !directory.empty() && writer.Open(directory);
+
+    // 400 trades a second apart alternating between two products, then one late out-of-order trade
+    for (common::u32 i = 0; i < 400 && passed; ++i)
+    {
+        passed = writer.Append(MakeTrade(i % 2 ? "MXFL4     " : "TXFL4     ", i));
+    }
+    passed = passed && writer.Append(MakeTrade("TXFA5     ", 100));
+    writer.Flush();
+
+    TickStoreReader reader;
+    passed = passed && reader.Open(directory);
+    passed = passed && reader.GetSymbolCount() == 3 && reader.GetRowCount(MessageType::TRADE) == 401;
+    passed = passed && reader.Find("MXFL4     ") == 1 && reader.Find("ZZZ       ") == constants::INVALID_SYMBOL;
+    passed = passed && reader.FindPrefix("TXF").size() == 2 && reader.FindPrefix("").size() == 3;
+
+    // 09:01:40 to 09:01:50: trades 100 to 109, plus the late one
+    TickQuery query;
+    query.type = MessageType::TRADE;
+    query.begin_ns = 9 * 3600 * NS_PER_SECOND + 100 * NS_PER_SECOND;
+    query.end_ns = query.begin_ns + 10 * NS_PER_SECOND;
+    query.symbols = reader.FindPrefix("TXF");
+    std::vector<NormalizedMessage> messages;
+    TickQueryStats stats;
+    passed = passed && reader.Query(query, &messages, &stats) == 6;
+    for (size_t i = 0; i < messages.size() && passed; ++i)
+    {
+        const NormalizedMessage &message = messages[i];
+        passed = message.type == MessageType::TRADE && message.price == 170000 + message.information_seq - 1;
+        passed = passed && std::memcmp(message.product_id, "TXF", 3) == 0;
+        passed = passed && message.information_time == 90000000000ULL + 100000000ULL + (message.information_seq - 61) * 1000000ULL;
+        passed = passed && message.information_time_ns == (9 * 3600 + message.information_seq - 1) * NS_PER_SECOND;
+    }
+    passed = passed && messages.size() == 6 && std::memcmp(messages[5].product_id, "TXFA5     ", 10) == 0;
+
+    // Two blocks hold trades 100 to 109, the last one holds the late trade
+    passed = passed && stats.blocks == 51 && stats.blocks_read == 3 && stats.rows_matched == 6;
+    TickQueryStats range_stats = stats;
+
+    // Empty and inverted ranges read nothing
+    query.begin_ns = 10 * 3600 * NS_PER_SECOND;
+    query.end_ns = 11 * 3600 * NS_PER_SECOND;
+    passed = passed && reader.Query(query, &messages, &stats) == 0 && stats.blocks_read == 0;
+    query.end_ns = query.begin_ns;
+    passed = passed && reader.Query(query, &messages, &stats) == 0;
+
+    // Rows published after opening appear once the store is opened again
+    passed = passed && writer.Append(MakeTrade("MXFL4     ", 500));
+    writer.Flush();
+    passed = passed && reader.GetRowCount(MessageType::TRADE) == 401;
+    passed = passed && reader.Open(directory) && reader.GetRowCount(MessageType::TRADE) == 402;
+    TickQuery everything;
+    everything.symbols.push_back(reader.Find("MXFL4     "));
+    messages.clear();
+    passed = passed && reader.Query(everything, &messages) == 201 && messages.back().information_seq == 501;
+
+    reader.Close();
+    writer.Close();
+    RemoveStoreDirectory(directory);
+
+    std::cout << "Query test: " << (passed ? "PASSED" : "FAILED") << " (" << range_stats.blocks_read << " of "
+              << range_stats.blocks << " blocks read)" << std::endl;
+    return passed;
+}
+
+// Every match of a sweep decoded by the processor is stored as a row of its own
+bool test_processor()
+{
+    std::string directory = MakeStoreDirectory();
+    bool passed = !directory.empty();
+    {
+        std::vector<char> stream = MakeI020Packet({{2250075, 3}, {2250100, 7}, {2250150, 2}}, 91530123456ULL, 1);
+        std::vector<char> single = MakeI020Packet({{2250200, 4}}, 91530223456ULL, 2);
+        stream.insert(stream.end(), single.begin(), single.end());
+
+        TickStoreSink sink(directory, 64, 8);
+        TFEProcessor processor;
+        processor.AddSink(&sink);
+        passed = passed && sink.Start();
+        passed = passed && processor.ProcessBatch(stream.data(), stream.size()).message_count == 2;
+        sink.Stop();
+        passed = passed && sink.GetWrittenCount() == 4 && sink.GetDroppedCount() == 0;
+    }
+
+    TickStoreReader reader;
+    passed = passed && reader.Open(directory) && reader.GetRowCount(MessageType::TRADE) == 4;
+    TickQuery query;
+    query.symbols.push_back(reader.Find("TXFL4     "));
+    std::vector<NormalizedMessage> messages;
+    passed = passed && reader.Query(query, &messages) == 4;
+
+    const common::i64 prices[] = {2250075, 2250100, 2250150, 2250200};
+    const common::i64 quantities[] = {3, 7, 2, 4};
+    const common::i64 sweep_ns = ((9 * 60 + 15) * 60 + 30) * NS_PER_SECOND + 123456000LL;
+    common::i64 volume = 0;
+    for (size_t i = 0; i < messages.size() && passed; ++i)
+    {
+        passed = messages[i].price == prices[i] && messages[i].quantity == quantities[i];
+        passed = passed && messages[i].information_seq == (i < 3 ? 1u : 2u);
+        passed = passed && messages[i].information_time_ns == sweep_ns + (i < 3 ? 0 : 100000000LL);
+        volume += messages[i].quantity;
+    }
+    passed = passed && volume == 16;
+    reader.Close();
+    RemoveStoreDirectory(directory);
+
+    std::cout << "Processor test: " << (passed ? "PASSED" : "FAILED")
+              << " (" << messages.size() << " rows)" << std::endl;
+    return passed;
+}
+
+int main()
+{
+    std::cout << "==== Tick Store Unit Tests ====\n"
+              << std::endl;
+
+    // Define all test cases
+    TestCase test_cases[] = {
+        {"Layout", test_layout},
+        {"Writer", test_writer},
+        {"Publish", test_publish},
+        {"Reopen", test_reopen},
+        {"Sink", test_sink},
+        {"Query", test_query},
+        {"Processor", test_processor}};
+
+    // Run all tests and count failures
+    size_t num_tests = sizeof(test_cases) / sizeof(TestCase);
+    size_t passed_tests = 0;
+
+    for (size_t i = 0; i < num_tests; ++i)
+    {
+        std::cout << "\nRunning test: " << test_cases[i].name << std::endl;
+        if (test_cases[i].test_func())
+        {
+            passed_tests++;
+        }
+    }
+
+    // Print summary
+    std::cout << "\n==== Test Results ====\n";
+    std::cout << "Passed: " << passed_tests << "/" << num_tests
+              << " (" << (passed_tests * 100 / num_tests) << "%)" << std::endl;
+
+    // Return 0 if all tests passed, otherwise return the number of failures
+    return (passed_tests == num_tests) ? 0 : (num_tests - passed_tests);
+}
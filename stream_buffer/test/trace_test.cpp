@@ -0,0 +1,200 @@
+#include "utils/trace.h"
+#include "processing/tfe_processor.h"
+#include "tfe_test_packets.h"
+#include <pthread.h>
+#include <unistd.h>
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace stream_buffer;
+using namespace stream_buffer::utils;
+using namespace stream_buffer::testing;
+
+// Unit test framework structure
+struct TestCase
+{
+    const char *name;
+    bool (*test_func)();
+};
+
+namespace
+{
+    std::string DumpToString()
+    {
+        std::string path = "/tmp/stream_buffer_trace_test." + std::to_string(getpid()) + ".json";
+        if (!Tracer::DumpChromeTrace(path))
+        {
+            return std::string();
+        }
+        std::ifstream file(path.c_str());
+        std::stringstream text;
+        text << file.rdbuf();
+        unlink(path.c_str());
+        return text.str();
+    }
+
+    size_t CountOccurrences(const std::string &text, const std::string &pattern)
+    {
+        size_t count = 0;
+        for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1))
+        {
+            count++;
+        }
+        return count;
+    }
+
+    void *RecordOverCapacity(void *arg)
+    {
+        (void)arg;
+        Tracer::SetThreadName("writer");
+        for (size_t i = 0; i < constants::TRACE_RING_CAPACITY + 10; ++i)
+        {
+            TRACE_SCOPE(trace, TraceEvent::APPEND);
+            trace.SetArg(i);
+        }
+        return nullptr;
+    }
+} // anonymous namespace
+
+// Nothing is recorded while tracing is off
+bool test_disabled()
+{
+    Tracer::Enable(false);
+    Tracer::Clear();
+    {
+        TRACE_SCOPE(trace, TraceEvent::RECEIVE);
+        trace.SetArg(1);
+    }
+    bool passed = Tracer::GetRecordedCount() == 0;
+
+    std::cout << "Disabled test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Nested scopes become complete events with their arguments
+bool test_dump()
+{
+    Tracer::Enable(true);
+    Tracer::Clear();
+    Tracer::SetThreadName("main");
+    {
+        TRACE_SCOPE(outer, TraceEvent::DECODE);
+        outer.SetArg(42);
+        TRACE_SCOPE(inner, TraceEvent::LOCK);
+        usleep(1000);
+    }
+    Tracer::Enable(false);
+
+    std::string text = DumpToString();
+    bool passed = Tracer::GetRecordedCount() == 2;
+    passed = passed && text.find("{\"traceEvents\":[") == 0 && text.find("]}") != std::string::npos;
+    passed = passed && text.find("\"args\":{\"name\":\"main\"}") != std::string::npos;
+    passed = passed && text.find("{\"name\":\"decode\",\"cat\":\"pipeline\",\"ph\":\"X\",\"ts\":") != std::string::npos;
+    passed = passed && text.find("\"args\":{\"bytes\":42}") != std::string::npos;
+    passed = passed && CountOccurrences(text, "\"name\":\"lock\"") == 1;
+
+    // The inner event ends first and the outer one starts at the origin
+    passed = passed && text.find("\"name\":\"lock\"") < text.find("\"name\":\"decode\"");
+    passed = passed && text.find("\"name\":\"decode\",\"cat\":\"pipeline\",\"ph\":\"X\",\"ts\":0.000") != std::string::npos;
+
+    // The 1 ms sleep shows up as a duration near 1000 us
+    size_t dur = text.find("\"dur\":", text.find("\"name\":\"lock\""));
+    double lock_us = dur == std::string::npos ? 0.0 : std::atof(text.c_str() + dur + 6);
+    passed = passed && lock_us > 900.0 && lock_us < 100000.0;
+
+    std::cout << "Dump test: " << (passed ? "PASSED" : "FAILED") << " (lock " << lock_us << " us)" << std::endl;
+    return passed;
+}
+
+// Each thread keeps only its most recent events
+bool test_ring_wrap()
+{
+    Tracer::Enable(true);
+    Tracer::Clear();
+
+    pthread_t threads[2];
+    for (size_t i = 0; i < 2; ++i)
+    {
+        pthread_create(&threads[i], nullptr, RecordOverCapacity, nullptr);
+    }
+    for (size_t i = 0; i < 2; ++i)
+    {
+        pthread_join(threads[i], nullptr);
+    }
+    Tracer::Enable(false);
+
+    std::string text = DumpToString();
+    bool passed = Tracer::GetRecordedCount() == 2 * (constants::TRACE_RING_CAPACITY + 10);
+    passed = passed && CountOccurrences(text, "\"ph\":\"X\"") == 2 * constants::TRACE_RING_CAPACITY;
+    passed = passed && CountOccurrences(text, "\"args\":{\"name\":\"writer\"}") == 2;
+
+    // The first ten events of each thread were overwritten
+    passed = passed && text.find("\"args\":{\"bytes\":9}") == std::string::npos;
+    passed = passed && CountOccurrences(text, "\"args\":{\"bytes\":10}") == 2;
+
+    std::cout << "Ring wrap test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+// The decoder traces the batch and every packet dispatched
+bool test_decoder_events()
+{
+    std::vector<char> quote = MakeI080Packet();
+    std::vector<char> stream(quote);
+    stream.insert(stream.end(), quote.begin(), quote.end());
+
+    Tracer::Enable(true);
+    Tracer::Clear();
+    processing::TFEProcessor processor;
+    core::BatchResult result = processor.ProcessBatch(stream.data(), stream.size());
+    Tracer::Enable(false);
+
+    std::string text = DumpToString();
+    bool passed = result.message_count == 2;
+    passed = passed && CountOccurrences(text, "\"name\":\"decode\"") == 1;
+    passed = passed && CountOccurrences(text, "\"name\":\"dispatch\"") == 2;
+    passed = passed && text.find("\"args\":{\"bytes\":" + std::to_string(stream.size()) + "}") != std::string::npos;
+    passed = passed && CountOccurrences(text, "\"args\":{\"bytes\":" + std::to_string(quote.size()) + "}") == 2;
+
+    std::cout << "Decoder events test: " << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed;
+}
+
+int main()
+{
+    std::cout << "==== Trace Unit Tests ====\n"
+              << std::endl;
+
+    // Define all test cases
+    TestCase test_cases[] = {
+        {"Disabled", test_disabled},
+        {"Dump", test_dump},
+        {"Ring Wrap", test_ring_wrap},
+        {"Decoder Events", test_decoder_events}};
+
+    // Run all tests and count failures
+    size_t num_tests = sizeof(test_cases) / sizeof(TestCase);
+    size_t passed_tests = 0;
+
+    for (size_t i = 0; i < num_tests; ++i)
+    {
+        std::cout << "\nRunning test: " << test_cases[i].name << std::endl;
+        if (test_cases[i].test_func())
+        {
+            passed_tests++;
+        }
+    }
+
+    // Print summary
+    std::cout << "\n==== Test Results ====\n";
+    std::cout << "Passed: " << passed_tests << "/" << num_tests
+              << " (" << (passed_tests * 100 / num_tests) << "%)" << std::endl;
+
+    // Return 0 if all tests passed, otherwise return the number of failures
+    return (passed_tests == num_tests) ? 0 : (num_tests - passed_tests);
+}
@@ -0,0 +1,136 @@
+#include "utils/tsc_clock.h"
+#include <iostream>
+#include <ctime>
+
+using namespace stream_buffer;
+using namespace stream_buffer::utils;
+
+// Unit test framework structure
+struct TestCase
+{
+    const char *name;
+    bool (*test_func)();
+};
+
+namespace
+{
+    const common::i64 TOLERANCE_NS = 1000000; // 1 ms, generous for a loaded VM
+
+    common::i64 ReadRealtimeNs()
+    {
+        timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        return static_cast<common::i64>(now.tv_sec) * 1000000000LL + now.tv_nsec;
+    }
+
+    common::i64 Distance(common::i64 a, common::i64 b)
+    {
+        return a > b ? a - b : b - a;
+    }
+} // anonymous namespace
+
+// Converted ticks agree with clock_gettime for both clocks
+bool test_conversion()
+{
+    TscClock clock;
+    common::i64 monotonic = TscClock::ReadMonotonicNs();
+    common::i64 converted = clock.NowMonotonicNs();
+    common::i64 realtime = ReadRealtimeNs();
+    common::i64 converted_realtime = clock.NowRealtimeNs();
+
+    bool passed = Distance(converted, monotonic) < TOLERANCE_NS;
+    passed = passed && Distance(converted_realtime, realtime) < TOLERANCE_NS;
+    passed = passed && clock.GetFrequency() > 1e6;
+    passed = passed && (!clock.IsUsingTsc() || TscClock::HasInvariantTsc());
+
+    std::cout << "Conversion test: " << (passed ? "PASSED" : "FAILED") << " ("
+              << (clock.IsUsingTsc() ? "TSC" : "clock_gettime") << " at " << clock.GetFrequency() / 1e6
+              << " MHz, off by " << (converted - monotonic) << " ns)" << std::endl;
+    return passed;
+}
+
+// A measured sleep has the right length and readings never go back
+bool test_duration()
+{
+    TscClock clock;
+    common::u64 start = clock.ReadTicks();
+    timespec pause = {0, 10000000};
+    nanosleep(&pause, nullptr);
+    common::i64 elapsed = clock.ToDurationNs(clock.ReadTicksOrdered() - start);
+    bool passed = elapsed >= 10000000 && elapsed < 10000000 + 5 * TOLERANCE_NS;
+
+    common::i64 previous = clock.NowMonotonicNs();
+    for (int i = 0; i < 100000 && passed; ++i)
+    {
+        common::i64 now = clock.NowMonotonicNs();
+        passed = now >= previous;
+        previous = now;
+    }
+
+    std::cout << "Duration test: " << (passed ? "PASSED" : "FAILED") << " (10 ms sleep measured as "
+              << elapsed << " ns)" << std::endl;
+    return passed;
+}
+
+// A resync re-anchors both clocks and reports how far the conversion had drifted
+bool test_resync()
+{
+    TscClock clock;
+    timespec pause = {0, 20000000};
+    nanosleep(&pause, nullptr);
+
+    common::u64 before = clock.ReadTicks();
+    bool passed = clock.Resync() && clock.GetResyncCount() == 1;
+    passed = passed && clock.GetMaxErrorNs() < TOLERANCE_NS;
+    passed = passed && Distance(clock.ToMonotonicNs(clock.ReadTicks()), TscClock::ReadMonotonicNs()) < TOLERANCE_NS;
+    passed = passed && Distance(clock.ToRealtimeNs(clock.ReadTicks()), ReadRealtimeNs()) < TOLERANCE_NS;
+
+    // Ticks from before the re-anchor still convert
+    passed = passed && clock.ToMonotonicNs(before) <= clock.ToMonotonicNs(clock.ReadTicks());
+
+    // The process-wide clock resyncs on its own once the interval has passed
+    TscClock &shared = GetClock();
+    common::u64 resyncs = shared.GetResyncCount();
+    timespec interval = {constants::TSC_RESYNC_INTERVAL_MS / 1000,
+                         (constants::TSC_RESYNC_INTERVAL_MS % 1000) * 1000000 + 1000000};
+    nanosleep(&interval, nullptr);
+    shared.NowMonotonicNs();
+    passed = passed && shared.GetResyncCount() == resyncs + 1;
+
+    std::cout << "Resync test: " << (passed ? "PASSED" : "FAILED") << " (max error "
+              << clock.GetMaxErrorNs() << " ns)" << std::endl;
+    return passed;
+}
+
+int main()
+{
+    std::cout << "==== TSC Clock Unit Tests ====\n"
+              << std::endl;
+
+    // Define all test cases
+    TestCase test_cases[] = {
+        {"Conversion", test_conversion},
+        {"Duration", test_duration},
+        {"Resync", test_resync}};
+
+    // Run all tests and count failures
+    size_t num_tests = sizeof(test_cases) / sizeof(TestCase);
+    size_t passed_tests = 0;
+
+    for (size_t i = 0; i < num_tests; ++i)
+    {
+        std::cout << "\nRunning test: " << test_cases[i].name << std::endl;
+        if (test_cases[i].test_func())
+        {
+            passed_tests++;
+        }
+    }
+
+    // Print summary
+    std::cout << "\n==== Test Results ====\n";
+    std::cout << "Passed: " << passed_tests << "/" << num_tests
+              << " (" << (passed_tests * 100 / num_tests) << "%)" << std::endl;
+
+    // Return 0 if all tests passed, otherwise return the number of failures
+    return (passed_tests == num_tests) ? 0 : (num_tests - passed_tests);
+}
@@ -0,0 +1,241 @@
+// Print the ticks recorded in a tick store for a product and time range
+//
+// Usage: stream_buffer-query <store> [-t trade|quote|i010] [-p product] [-b time] [-e time] [-c] [-s]
+//   store        Directory given as "tick_store"
+//   -t type      Message type, trade by default
+//   -p product   Product id, or a prefix such as TXF for every product starting with it
+//   -b time      First time of day, hh:mm:ss[.uuuuuu], inclusive
+//   -e time      Last time of day, hh:mm:ss[.uuuuuu], exclusive
+//   -c           Print the number of rows only
+//   -s           Print the blocks and rows scanned, and the query time, to stderr
+
+#include "processing/tick_store.h"
+#include <time.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace stream_buffer;
+using namespace stream_buffer::processing;
+
+namespace
+{
+    void PrintUsage(const char *program)
+    {
+        std::fprintf(stderr, "Usage: %s <store> [-t trade|quote|i010] [-p product] [-b hh:mm:ss[.uuuuuu]] "
+                             "[-e hh:mm:ss[.uuuuuu]] [-c] [-s]\n",
+                     program);
+    }
+
+    bool ParseType(const char *text, MessageType *type)
+    {
+        if (std::strcmp(text, "trade") == 0 || std::strcmp(text, "i020") == 0)
+        {
+            *type = MessageType::TRADE;
+        }
+        else if (std::strcmp(text, "quote") == 0 || std::strcmp(text, "i080") == 0)
+        {
+            *type = MessageType::QUOTE;
+        }
+        else if (std::strcmp(text, "i010") == 0)
+        {
+            *type = MessageType::PRODUCT_INFO;
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+
+    // hh:mm:ss[.uuuuuu] to nanoseconds since midnight
+    bool ParseTime(const char *text, common::i64 *time_ns)
+    {
+        unsigned hours = 0, minutes = 0, seconds = 0;
+        int consumed = 0;
+        if (std::sscanf(text, "%u:%u:%u%n", &hours, &minutes, &seconds, &consumed) != 3 ||
+            hours > 24 || minutes > 59 || seconds > 59)
+        {
+            return false;
+        }
+
+        common::i64 fraction_ns = 0;
+        const char *rest = text + consumed;
+        if (*rest == '.')
+        {
+            common::i64 scale = 100000000LL;
+            for (++rest; *rest >= '0' && *rest <= '9' && scale > 0; ++rest, scale /= 10)
+            {
+                fraction_ns += (*rest - '0') * scale;
+            }
+        }
+        if (*rest != '\0')
+        {
+            return false;
+        }
+
+        *time_ns = ((hours * 60LL + minutes) * 60LL + seconds) * 1000000000LL + fraction_ns;
+        return true;
+    }
+
+    void FormatTime(common::u64 information_time, char *out, size_t size)
+    {
+        std::snprintf(out, size, "%02llu:%02llu:%02llu.%06llu",
+                      static_cast<unsigned long long>(information_time / 10000000000ULL),
+                      static_cast<unsigned long long>(information_time / 100000000ULL % 100),
+                      static_cast<unsigned long long>(information_time / 1000000ULL % 100),
+                      static_cast<unsigned long long>(information_time % 1000000ULL));
+    }
+
+    void PrintMessage(const NormalizedMessage &message)
+    {
+        char time[32];
+        FormatTime(message.information_time, time, sizeof(time));
+        int id_length = constants::PRODUCT_ID_SIZE;
+        while (id_length > 0 && message.product_id[id_length - 1] == ' ')
+        {
+            --id_length;
+        }
+
+        switch (message.type)
+        {
+        case MessageType::PRODUCT_INFO:
+            std::printf("%s %u %.*s reference=%s\n", time, message.information_seq, id_length, message.product_id,
+                        message.GetPrice().ToString().c_str());
+            break;
+        case MessageType::TRADE:
+            std::printf("%s %u %.*s %s x %lld\n", time, message.information_seq, id_length, message.product_id,
+                        message.GetPrice().ToString().c_str(), static_cast<long long>(message.quantity));
+            break;
+        case MessageType::QUOTE:
+            std::printf("%s %u %.*s %lld @ %s / %s @ %lld\n", time, message.information_seq, id_length,
+                        message.product_id, static_cast<long long>(message.bid_quantity),
+                        message.GetBidPrice().ToString().c_str(), message.GetAskPrice().ToString().c_str(),
+                        static_cast<long long>(message.ask_quantity));
+            break;
+        }
+    }
+
+    double NowMs()
+    {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return static_cast<double>(now.tv_sec) * 1000.0 + static_cast<double>(now.tv_nsec) / 1000000.0;
+    }
+} // anonymous namespace
+
+int main(int argc, char *argv[])
+{
+    std::string directory;
+    std::string product;
+    TickQuery query;
+    bool count_only = false;
+    bool print_stats = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "-t") == 0 && has_value)
+        {
+            if (!ParseType(argv[++i], &query.type))
+            {
+                std::fprintf(stderr, "Unknown message type %s\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (std::strcmp(argv[i], "-p") == 0 && has_value)
+        {
+            product = argv[++i];
+        }
+        else if ((std::strcmp(argv[i], "-b") == 0 || std::strcmp(argv[i], "-e") == 0) && has_value)
+        {
+            common::i64 *bound = argv[i][1] == 'b' ? &query.begin_ns : &query.end_ns;
+            if (!ParseTime(argv[++i], bound))
+            {
+                std::fprintf(stderr, "Invalid time %s, expected hh:mm:ss[.uuuuuu]\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (std::strcmp(argv[i], "-c") == 0)
+        {
+            count_only = true;
+        }
+        else if (std::strcmp(argv[i], "-s") == 0)
+        {
+            print_stats = true;
+        }
+        else if (argv[i][0] == '-' || !directory.empty())
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        else
+        {
+            directory = argv[i];
+        }
+    }
+    if (directory.empty())
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    double start_ms = NowMs();
+    TickStoreReader reader;
+    if (!reader.Open(directory))
+    {
+        std::fprintf(stderr, "Cannot open tick store %s\n", directory.c_str());
+        return 1;
+    }
+
+    // A full product id matches exactly, anything shorter as a prefix
+    if (!product.empty())
+    {
+        if (product.size() > constants::PRODUCT_ID_SIZE)
+        {
+            std::fprintf(stderr, "Product id %s is longer than %zu characters\n", product.c_str(),
+                         constants::PRODUCT_ID_SIZE);
+            return 1;
+        }
+        std::string padded = product + std::string(constants::PRODUCT_ID_SIZE - product.size(), ' ');
+        common::u32 symbol = reader.Find(padded.c_str());
+        query.symbols = symbol != constants::INVALID_SYMBOL ? std::vector<common::u32>(1, symbol)
+                                                            : reader.FindPrefix(product);
+        if (query.symbols.empty())
+        {
+            if (count_only)
+            {
+                std::printf("0\n");
+            }
+            return 0;
+        }
+    }
+
+    std::vector<NormalizedMessage> messages;
+    TickQueryStats stats;
+    reader.Query(query, &messages, &stats);
+    double query_ms = NowMs() - start_ms;
+
+    if (count_only)
+    {
+        std::printf("%zu\n", messages.size());
+    }
+    else
+    {
+        for (size_t i = 0; i < messages.size(); ++i)
+        {
+            PrintMessage(messages[i]);
+        }
+    }
+
+    if (print_stats)
+    {
+        std::fprintf(stderr, "%llu rows matched, %llu of %llu blocks read (%llu rows), %.3f ms\n",
+                     static_cast<unsigned long long>(stats.rows_matched),
+                     static_cast<unsigned long long>(stats.blocks_read),
+                     static_cast<unsigned long long>(stats.blocks),
+                     static_cast<unsigned long long>(stats.rows_read), query_ms);
+    }
+    return 0;
+}
@@ -0,0 +1,124 @@
+// Print the metrics of a running stream_buffer
+//
+// Usage: stream_buffer-stat [socket] [-w seconds]
+//   socket       Stats socket given as "stats_socket", "/tmp/stream_buffer.stats" by default
+//   -w seconds   Keep printing every interval, with per-second rates for counters
+
+#include "ipc/stats_server.h"
+#include <signal.h>
+#include <time.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <string>
+
+using namespace stream_buffer;
+
+namespace
+{
+    volatile sig_atomic_t g_stop = 0;
+
+    void HandleSignal(int)
+    {
+        g_stop = 1;
+    }
+
+    // Counter values by name from "counter <name> <value>" lines
+    std::map<std::string, unsigned long long> ParseCounters(const std::string &text)
+    {
+        std::map<std::string, unsigned long long> counters;
+        std::istringstream lines(text);
+        std::string kind, name;
+        unsigned long long value = 0;
+        std::string line;
+        while (std::getline(lines, line))
+        {
+            std::istringstream fields(line);
+            if (fields >> kind >> name >> value && kind == "counter")
+            {
+                counters[name] = value;
+            }
+        }
+        return counters;
+    }
+
+    void PrintRates(const std::string &text, const std::map<std::string, unsigned long long> &previous,
+                    double seconds)
+    {
+        std::istringstream lines(text);
+        std::string line;
+        while (std::getline(lines, line))
+        {
+            std::istringstream fields(line);
+            std::string kind, name;
+            unsigned long long value = 0;
+            std::map<std::string, unsigned long long>::const_iterator it;
+            if (fields >> kind >> name >> value && kind == "counter" &&
+                (it = previous.find(name)) != previous.end() && value >= it->second)
+            {
+                std::printf("%s  (%.0f/s)\n", line.c_str(), static_cast<double>(value - it->second) / seconds);
+            }
+            else
+            {
+                std::printf("%s\n", line.c_str());
+            }
+        }
+    }
+} // anonymous namespace
+
+int main(int argc, char *argv[])
+{
+    std::string path = "/tmp/stream_buffer.stats";
+    int interval = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "-w") == 0 && i + 1 < argc)
+        {
+            interval = std::atoi(argv[++i]);
+        }
+        else if (argv[i][0] == '-')
+        {
+            std::fprintf(stderr, "Usage: %s [socket] [-w seconds]\n", argv[0]);
+            return 1;
+        }
+        else
+        {
+            path = argv[i];
+        }
+    }
+
+    signal(SIGINT, HandleSignal);
+    signal(SIGTERM, HandleSignal);
+
+    std::string text;
+    if (!ipc::QueryStats(path, &text))
+    {
+        std::fprintf(stderr, "Cannot read stats from %s: %s\n", path.c_str(), std::strerror(errno));
+        return 1;
+    }
+    std::printf("%s", text.c_str());
+
+    while (interval > 0 && !g_stop)
+    {
+        std::map<std::string, unsigned long long> previous = ParseCounters(text);
+        struct timespec delay = {interval, 0};
+        nanosleep(&delay, nullptr);
+        if (g_stop)
+        {
+            break;
+        }
+
+        if (!ipc::QueryStats(path, &text))
+        {
+            std::fprintf(stderr, "stream_buffer at %s went away\n", path.c_str());
+            return 1;
+        }
+        std::printf("\n");
+        PrintRates(text, previous, static_cast<double>(interval));
+        std::fflush(stdout);
+    }
+    return 0;
+}